@@ -0,0 +1,63 @@
+#include "host/aht20_mock.h"
+
+#include <string.h>
+
+#include "host/host_i2c.h"
+#include "lib/aht20/aht20.h"
+
+static int mock_write(void *ctx, const uint8_t *src, size_t len) {
+    AHT20_Mock *m = (AHT20_Mock *)ctx;
+    if (len >= 1 && src[0] == AHT20_CMD_TRIGGER) {
+        m->triggered_at = time_us_64();
+        m->converting = true;
+        m->triggers++;
+    }
+    return (int)len;
+}
+
+static int mock_read(void *ctx, uint8_t *dst, size_t len) {
+    AHT20_Mock *m = (AHT20_Mock *)ctx;
+    uint8_t frame[6] = {AHT20_STATUS_CALIBRATED, 0, 0, 0, 0, 0};
+
+    if (m->converting &&
+        (m->stuck_busy || time_us_64() - m->triggered_at < m->conversion_us)) {
+        frame[0] |= AHT20_STATUS_BUSY;
+        m->busy_reads++;
+    } else {
+        // Codificação inversa de aht20_decode (20 bits cada)
+        float h = m->humidity * 1048576.0f / 100.0f + 0.5f;
+        float t = (m->temperature + 50.0f) * 1048576.0f / 200.0f + 0.5f;
+        uint32_t raw_h = h <= 0 ? 0 : (h >= 1048575.0f ? 1048575u : (uint32_t)h);
+        uint32_t raw_t = t <= 0 ? 0 : (t >= 1048575.0f ? 1048575u : (uint32_t)t);
+        frame[1] = (uint8_t)(raw_h >> 12);
+        frame[2] = (uint8_t)(raw_h >> 4);
+        frame[3] = (uint8_t)(((raw_h & 0x0F) << 4) | (raw_t >> 16));
+        frame[4] = (uint8_t)(raw_t >> 8);
+        frame[5] = (uint8_t)raw_t;
+        if (len >= 6 && m->converting) {
+            m->converting = false;
+            m->data_reads++;
+        }
+    }
+
+    memcpy(dst, frame, len < sizeof(frame) ? len : sizeof(frame));
+    return (int)len;
+}
+
+void aht20_mock_init(AHT20_Mock *mock) {
+    memset(mock, 0, sizeof(*mock));
+    mock->temperature = 25.0f;
+    mock->humidity = 50.0f;
+    mock->conversion_us = AHT20_MEASURE_TIME_US;
+}
+
+host_i2c_device_t aht20_mock_device(AHT20_Mock *mock) {
+    host_i2c_device_t dev = {mock_write, mock_read, mock};
+    return dev;
+}
+
+bool aht20_mock_attach(AHT20_Mock *mock, i2c_inst_t *i2c) {
+    aht20_mock_init(mock);
+    host_i2c_device_t dev = aht20_mock_device(mock);
+    return host_i2c_attach(i2c, AHT20_I2C_ADDR, &dev);
+}
@@ -0,0 +1,43 @@
+// Modelo de um AHT20 sobre o barramento simulado: a conversão leva
+// conversion_us de tempo (virtual) e o sensor responde "busy" até lá.
+#ifndef AHT20_MOCK_H
+#define AHT20_MOCK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hardware/i2c.h"
+#include "host/host_i2c.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    float temperature;        // Valor entregue na próxima conversão
+    float humidity;
+    uint64_t conversion_us;   // Duração simulada da conversão
+    bool stuck_busy;          // Nunca termina (teste de timeout)
+
+    // Estado interno / estatísticas
+    uint64_t triggered_at;
+    bool converting;
+    uint32_t triggers;
+    uint32_t busy_reads;
+    uint32_t data_reads;
+} AHT20_Mock;
+
+// Valores padrão (25 °C, 50 %, 80 ms), sem registrar no barramento
+void aht20_mock_init(AHT20_Mock *mock);
+
+// Callbacks do sensor, para quem o coloca atrás de outro dispositivo (mux)
+host_i2c_device_t aht20_mock_device(AHT20_Mock *mock);
+
+// aht20_mock_init + registro no barramento
+bool aht20_mock_attach(AHT20_Mock *mock, i2c_inst_t *i2c);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AHT20_MOCK_H
@@ -0,0 +1,55 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "host/host_bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "lib/latency/latency.h"
+
+typedef struct {
+    uint64_t total_us;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t count;
+} stage_stats_t;
+
+static stage_stats_t stages[LAT_NUM_STAGES];
+static uint64_t first_ns = 0;
+
+// Relógio real para a vazão: o tempo virtual de sleep_ms não entra.
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+void host_bench_record(int stage, uint32_t us) {
+    if (stage < 0 || stage >= LAT_NUM_STAGES) return;
+    if (first_ns == 0) first_ns = now_ns();
+    stage_stats_t *s = &stages[stage];
+    s->total_us += us;
+    if (s->count == 0 || us < s->min_us) s->min_us = us;
+    if (us > s->max_us) s->max_us = us;
+    s->count++;
+}
+
+void host_bench_finish(void) {
+    fflush(stdout);
+    const uint64_t samples = stages[LAT_INFERENCIA].count;
+    const double elapsed_s = first_ns ? (double)(now_ns() - first_ns) / 1e9 : 0.0;
+
+    fprintf(stderr, "[BENCH] amostras: %llu em %.3f s -> %.0f amostras/s\n",
+            (unsigned long long)samples, elapsed_s,
+            elapsed_s > 0.0 ? (double)samples / elapsed_s : 0.0);
+    fprintf(stderr, "[BENCH] %-10s %12s %12s %12s\n", "estagio", "media(us)",
+            "min(us)", "max(us)");
+    for (int i = 0; i < LAT_NUM_STAGES; i++) {
+        const stage_stats_t *s = &stages[i];
+        if (s->count == 0) continue;
+        fprintf(stderr, "[BENCH] %-10s %12.3f %12u %12u\n", latency_stage_name((LatencyStage)i),
+                (double)s->total_us / (double)s->count, s->min_us, s->max_us);
+    }
+    exit(0);
+}
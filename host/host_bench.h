@@ -0,0 +1,22 @@
+// Vazão e latência por estágio do loop principal no build host. Os estágios
+// são os de lib/latency: LATENCY_END registra aqui cada duração medida.
+#ifndef HOST_BENCH_H
+#define HOST_BENCH_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Duração de um estágio (LatencyStage) em us
+void host_bench_record(int stage, uint32_t us);
+
+// Imprime o relatório em stderr e encerra o processo (fim do replay).
+void host_bench_finish(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_BENCH_H
@@ -0,0 +1,19 @@
+// Threads do build host no papel de um core do RP2040: get_core_num() passa a
+// devolver `core` e o __wfe() do core 0 só avança o relógio virtual quando o
+// core 1 também está parado em __wfe (sem evento pendente), como no hardware,
+// onde o tempo não "pula" enquanto o outro core trabalha.
+#ifndef HOST_CORE_H
+#define HOST_CORE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void host_core_enter(unsigned int core);
+void host_core_leave(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_CORE_H
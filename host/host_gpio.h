@@ -0,0 +1,21 @@
+// Interrupções de GPIO no build host: o teste dispara a borda e o callback
+// registrado com gpio_set_irq_enabled_with_callback roda na thread que chamou,
+// no papel da ISR.
+#ifndef HOST_GPIO_H
+#define HOST_GPIO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// false se o pino não tem essas bordas habilitadas
+bool host_gpio_irq(unsigned int gpio, uint32_t events);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_GPIO_H
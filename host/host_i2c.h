@@ -0,0 +1,43 @@
+// Barramento I2C simulado do build host: dispositivos são registrados por
+// (instância, endereço) e recebem as transferências de i2c_*_blocking.
+#ifndef HOST_I2C_H
+#define HOST_I2C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hardware/i2c.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HOST_I2C_MAX_DEVICES 24  // Dois barramentos com até 8 muxes cada (host/tca9548a_mock.h)
+
+typedef struct {
+    // Retornam bytes transferidos ou PICO_ERROR_GENERIC (NACK)
+    int (*write)(void *ctx, const uint8_t *src, size_t len);
+    int (*read)(void *ctx, uint8_t *dst, size_t len);
+    void *ctx;
+} host_i2c_device_t;
+
+// Retorna false se não houver espaço na tabela
+bool host_i2c_attach(i2c_inst_t *i2c, uint8_t addr, const host_i2c_device_t *dev);
+void host_i2c_detach_all(void);
+
+// Transações (write + read) desde o último host_i2c_detach_all
+uint32_t host_i2c_transactions(i2c_inst_t *i2c);
+
+// Com timing ligado cada transferência avança o relógio virtual pelo tempo
+// de fio no baudrate do i2c_init: start, endereço + bytes a 9 bits (ACK) e
+// stop. Desligado (padrão), o barramento não gasta tempo.
+void host_i2c_set_timing(bool enabled);
+
+// Tempo de fio acumulado desde o último host_i2c_detach_all (só com timing)
+uint64_t host_i2c_bus_us(i2c_inst_t *i2c);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_I2C_H
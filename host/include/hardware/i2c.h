@@ -0,0 +1,35 @@
+// I2C do build host. Sem backend registrado não há dispositivos no barramento
+// e toda transferência falha com PICO_ERROR_GENERIC.
+#ifndef PICO_HOST_HARDWARE_I2C_H
+#define PICO_HOST_HARDWARE_I2C_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct i2c_inst {
+    int hw_index;
+    unsigned int baudrate;
+} i2c_inst_t;
+
+extern i2c_inst_t i2c0_inst;
+extern i2c_inst_t i2c1_inst;
+
+#define i2c0 (&i2c0_inst)
+#define i2c1 (&i2c1_inst)
+
+unsigned int i2c_init(i2c_inst_t *i2c, unsigned int baudrate);
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src,
+                       size_t len, bool nostop);
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len,
+                      bool nostop);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICO_HOST_HARDWARE_I2C_H
@@ -0,0 +1,33 @@
+// Shim host de hardware/sync.h. __wfe() avança o relógio virtual até o próximo
+// alarme e roda os callbacks vencidos (ver pico/time.h); com uma thread no papel
+// do core 1, só quando ela também espera em __wfe (ver host/host_core.h).
+#ifndef PICO_HOST_HARDWARE_SYNC_H
+#define PICO_HOST_HARDWARE_SYNC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void __wfe(void);
+void __sev(void);
+
+// Spinlocks de hardware (32, como no RP2040): trava por troca atômica, e o
+// valor "salvo" das interrupções não tem uso no host
+#define NUM_SPIN_LOCKS 32u
+typedef volatile uint32_t spin_lock_t;
+
+spin_lock_t *spin_lock_instance(unsigned int lock_num);
+spin_lock_t *spin_lock_init(unsigned int lock_num);
+int spin_lock_claim_unused(bool required);
+void spin_lock_unclaim(unsigned int lock_num);
+uint32_t spin_lock_blocking(spin_lock_t *lock);
+void spin_unlock(spin_lock_t *lock, uint32_t saved_irq);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICO_HOST_HARDWARE_SYNC_H
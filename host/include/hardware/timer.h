@@ -0,0 +1,6 @@
+#ifndef PICO_HOST_HARDWARE_TIMER_H
+#define PICO_HOST_HARDWARE_TIMER_H
+
+#include "pico/time.h"
+
+#endif // PICO_HOST_HARDWARE_TIMER_H
@@ -0,0 +1,35 @@
+// Core 1 emulado por uma thread POSIX. O FIFO inter-core é uma fila bloqueante
+// em cada sentido, com a mesma profundidade do RP2040 (8 palavras).
+#ifndef PICO_HOST_MULTICORE_H
+#define PICO_HOST_MULTICORE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void multicore_reset_core1(void);
+void multicore_launch_core1(void (*entry)(void));
+
+void multicore_fifo_push_blocking(uint32_t data);
+uint32_t multicore_fifo_pop_blocking(void);
+bool multicore_fifo_rvalid(void);
+bool multicore_fifo_wready(void);
+
+// No RP2040 as variantes inline não saem da RAM; aqui são as mesmas filas
+static inline void multicore_fifo_push_blocking_inline(uint32_t data) {
+    multicore_fifo_push_blocking(data);
+}
+static inline uint32_t multicore_fifo_pop_blocking_inline(void) {
+    return multicore_fifo_pop_blocking();
+}
+
+unsigned int get_core_num(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICO_HOST_MULTICORE_H
@@ -0,0 +1,35 @@
+// Shim mínimo do Pico SDK para o build host (Linux).
+// Só cobre o subconjunto de APIs usado pelo firmware e pelo pico-tflmicro.
+#ifndef PICO_HOST_STDLIB_H
+#define PICO_HOST_STDLIB_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "pico/time.h"
+#include "hardware/gpio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef unsigned int uint;
+
+#define PICO_OK              0
+#define PICO_ERROR_GENERIC  -1
+#define PICO_ERROR_TIMEOUT  -2
+
+// Sem XIP no host: código "em RAM" é uma função comum
+#define __not_in_flash_func(func_name) func_name
+
+bool stdio_init_all(void);
+
+// Sem console no host: PICO_ERROR_TIMEOUT, ou o roteiro de PREDAGUARD_SERIAL
+int getchar_timeout_us(uint32_t timeout_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICO_HOST_STDLIB_H
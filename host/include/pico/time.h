@@ -0,0 +1,55 @@
+// Relógio do build host.
+// time_us_64() = tempo real monotônico + tempo "dormido". sleep_ms/sleep_us não
+// bloqueiam: apenas avançam o relógio virtual, então o loop roda o mais rápido
+// possível e as latências medidas continuam refletindo o trabalho real de CPU.
+//
+// Alarmes (add_repeating_timer_us) também correm no relógio virtual: não há
+// interrupção, os callbacks vencidos rodam em __wfe(), sleep_* e
+// tight_loop_contents(), na ordem dos vencimentos. Um loop que atrasa além de
+// um período vê os ticks perdidos de uma vez, como no alarme real.
+#ifndef PICO_HOST_TIME_H
+#define PICO_HOST_TIME_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef uint64_t absolute_time_t;
+
+uint64_t time_us_64(void);
+uint32_t time_us_32(void);
+absolute_time_t get_absolute_time(void);
+uint32_t to_ms_since_boot(absolute_time_t t);
+uint64_t to_us_since_boot(absolute_time_t t);
+
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+
+typedef struct repeating_timer repeating_timer_t;
+typedef bool (*repeating_timer_callback_t)(repeating_timer_t *rt);
+
+// delay_us < 0: período medido entre os disparos (taxa fixa), como no SDK
+struct repeating_timer {
+    int64_t delay_us;
+    uint64_t next_due_us;
+    repeating_timer_callback_t callback;
+    void *user_data;
+    bool active;
+};
+
+bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t callback,
+                            void *user_data, repeating_timer_t *out);
+bool add_repeating_timer_ms(int32_t delay_ms, repeating_timer_callback_t callback,
+                            void *user_data, repeating_timer_t *out);
+bool cancel_repeating_timer(repeating_timer_t *timer);
+
+void tight_loop_contents(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICO_HOST_TIME_H
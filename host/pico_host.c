@@ -0,0 +1,460 @@
+// Implementação host (Linux) do subconjunto do Pico SDK usado pelo firmware.
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "pico/multicore.h"
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "hardware/sync.h"
+#include "host/host_core.h"
+#include "host/host_gpio.h"
+#include "host/host_i2c.h"
+
+// ============================================================
+// RELÓGIO
+// ============================================================
+static uint64_t boot_us = 0;
+static uint64_t slept_us = 0;
+
+static uint64_t monotonic_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+uint64_t time_us_64(void) {
+    if (boot_us == 0) boot_us = monotonic_us();
+    return monotonic_us() - boot_us + __atomic_load_n(&slept_us, __ATOMIC_RELAXED);
+}
+
+uint32_t time_us_32(void) { return (uint32_t)time_us_64(); }
+absolute_time_t get_absolute_time(void) { return time_us_64(); }
+uint32_t to_ms_since_boot(absolute_time_t t) { return (uint32_t)(t / 1000u); }
+uint64_t to_us_since_boot(absolute_time_t t) { return t; }
+
+static void advance_to(uint64_t target_us);
+
+void sleep_us(uint64_t us) { advance_to(time_us_64() + us); }
+void sleep_ms(uint32_t ms) { sleep_us((uint64_t)ms * 1000u); }
+
+bool stdio_init_all(void) {
+    time_us_64(); // fixa o instante de "boot"
+    return true;
+}
+
+// Serial simulada: PREDAGUARD_SERIAL="L@600,Z@1200" entrega cada caractere
+// quando o relógio passa do segundo indicado (sem "@s", de imediato)
+static const char *serial_script = NULL;
+static bool serial_loaded = false;
+
+int getchar_timeout_us(uint32_t timeout_us) {
+    (void)timeout_us;
+    if (!serial_loaded) {
+        serial_loaded = true;
+        serial_script = getenv("PREDAGUARD_SERIAL");
+    }
+    if (!serial_script || !*serial_script) return PICO_ERROR_TIMEOUT;
+    const char c = serial_script[0];
+    char *next = (char *)serial_script + 1;
+    if (*next == '@') {
+        const double at_s = strtod(next + 1, &next);
+        if (time_us_64() < (uint64_t)(at_s * 1e6)) return PICO_ERROR_TIMEOUT;
+    }
+    serial_script = *next == ',' ? next + 1 : next;
+    return (unsigned char)c;
+}
+
+// ============================================================
+// ALARMES (relógio virtual)
+// Só o core 0 usa alarmes; os callbacks rodam na thread que espera.
+// ============================================================
+#define HOST_MAX_TIMERS 8
+
+static repeating_timer_t *timers[HOST_MAX_TIMERS];
+
+bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t callback,
+                            void *user_data, repeating_timer_t *out) {
+    if (delay_us == 0) return false;
+    for (int i = 0; i < HOST_MAX_TIMERS; i++) {
+        if (timers[i] && timers[i]->active) continue;
+        out->delay_us = delay_us;
+        out->next_due_us = time_us_64() + (uint64_t)(delay_us < 0 ? -delay_us : delay_us);
+        out->callback = callback;
+        out->user_data = user_data;
+        out->active = true;
+        timers[i] = out;
+        return true;
+    }
+    return false;
+}
+
+bool add_repeating_timer_ms(int32_t delay_ms, repeating_timer_callback_t callback,
+                            void *user_data, repeating_timer_t *out) {
+    return add_repeating_timer_us((int64_t)delay_ms * 1000, callback, user_data, out);
+}
+
+bool cancel_repeating_timer(repeating_timer_t *timer) {
+    bool was_active = timer->active;
+    timer->active = false;
+    for (int i = 0; i < HOST_MAX_TIMERS; i++) {
+        if (timers[i] == timer) timers[i] = NULL;
+    }
+    return was_active;
+}
+
+// Próximo alarme ativo a vencer (NULL se não há nenhum)
+static repeating_timer_t *earliest_timer(void) {
+    repeating_timer_t *first = NULL;
+    for (int i = 0; i < HOST_MAX_TIMERS; i++) {
+        repeating_timer_t *t = timers[i];
+        if (t && t->active && (!first || t->next_due_us < first->next_due_us)) first = t;
+    }
+    return first;
+}
+
+// Roda os callbacks vencidos até `now_us`, em ordem de vencimento
+static void fire_due_timers(uint64_t now_us) {
+    repeating_timer_t *t;
+    while ((t = earliest_timer()) && t->next_due_us <= now_us) {
+        uint64_t due = t->next_due_us;
+        if (!t->callback(t)) {
+            cancel_repeating_timer(t);
+            continue;
+        }
+        // Taxa fixa (delay < 0): grade a partir do vencimento anterior;
+        // delay > 0: a partir do fim do callback
+        t->next_due_us = t->delay_us < 0 ? due + (uint64_t)(-t->delay_us)
+                                         : now_us + (uint64_t)t->delay_us;
+    }
+}
+
+// Avança o relógio virtual até `target_us`, disparando os alarmes no caminho
+static void advance_to(uint64_t target_us) {
+    if (get_core_num() == 0) {
+        repeating_timer_t *t;
+        while ((t = earliest_timer()) && t->next_due_us <= target_us) {
+            uint64_t now = time_us_64();
+            if (t->next_due_us > now) {
+                __atomic_fetch_add(&slept_us, t->next_due_us - now, __ATOMIC_RELAXED);
+            }
+            fire_due_timers(time_us_64());
+        }
+    }
+    uint64_t now = time_us_64();
+    if (target_us > now) __atomic_fetch_add(&slept_us, target_us - now, __ATOMIC_RELAXED);
+}
+
+void tight_loop_contents(void) {
+    if (get_core_num() == 0) fire_due_timers(time_us_64());
+}
+
+// Registrador de evento de cada core (SEV acende nos dois, WFE consome)
+static bool core_event[2];
+static bool core_waiting[2];
+static int cores_bound[2]; // Threads atuando como cada core
+
+void __sev(void) {
+    __atomic_store_n(&core_event[0], true, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&core_event[1], true, __ATOMIC_SEQ_CST);
+}
+
+// Core 1 parado sem nada que o acorde: o relógio virtual pode avançar
+static bool core1_idle(void) {
+    return __atomic_load_n(&cores_bound[1], __ATOMIC_SEQ_CST) == 0 ||
+           (__atomic_load_n(&core_waiting[1], __ATOMIC_SEQ_CST) &&
+            !__atomic_load_n(&core_event[1], __ATOMIC_SEQ_CST));
+}
+
+// Evento pendente: retorna na hora. Core 1: espera um SEV. Core 0: sem
+// alarme vencido, "dorme" até o próximo, se o core 1 também estiver parado;
+// sem alarme nenhum, retorna (acordar sem motivo é permitido para WFE)
+void __wfe(void) {
+    const unsigned int core = get_core_num();
+    if (__atomic_exchange_n(&core_event[core], false, __ATOMIC_SEQ_CST)) return;
+
+    if (core != 0) {
+        __atomic_store_n(&core_waiting[core], true, __ATOMIC_SEQ_CST);
+        while (!__atomic_load_n(&core_event[core], __ATOMIC_SEQ_CST)) sched_yield();
+        __atomic_store_n(&core_waiting[core], false, __ATOMIC_SEQ_CST);
+        __atomic_store_n(&core_event[core], false, __ATOMIC_SEQ_CST);
+        return;
+    }
+
+    if (!core1_idle()) {
+        // Core 1 trabalhando: o tempo corre normalmente
+        sched_yield();
+        fire_due_timers(time_us_64());
+        return;
+    }
+    repeating_timer_t *t = earliest_timer();
+    uint64_t now = time_us_64();
+    if (t && t->next_due_us > now) {
+        __atomic_fetch_add(&slept_us, t->next_due_us - now, __ATOMIC_RELAXED);
+    }
+    fire_due_timers(time_us_64());
+}
+
+// ============================================================
+// GPIO
+// ============================================================
+static bool gpio_level[HOST_NUM_GPIOS];
+
+void gpio_init(unsigned int gpio) { if (gpio < HOST_NUM_GPIOS) gpio_level[gpio] = false; }
+void gpio_set_dir(unsigned int gpio, bool out) { (void)gpio; (void)out; }
+void gpio_put(unsigned int gpio, bool value) { if (gpio < HOST_NUM_GPIOS) gpio_level[gpio] = value; }
+bool gpio_get(unsigned int gpio) { return gpio < HOST_NUM_GPIOS ? gpio_level[gpio] : false; }
+void gpio_pull_up(unsigned int gpio) { (void)gpio; }
+void gpio_set_function(unsigned int gpio, enum gpio_function fn) { (void)gpio; (void)fn; }
+// Como no SDK: um callback só para todos os pinos, bordas habilitadas por pino
+static gpio_irq_callback_t gpio_callback = NULL;
+static uint32_t gpio_irq_events[HOST_NUM_GPIOS];
+
+void gpio_set_irq_enabled_with_callback(unsigned int gpio, uint32_t events,
+                                        bool enabled,
+                                        gpio_irq_callback_t callback) {
+    if (gpio >= HOST_NUM_GPIOS) return;
+    if (enabled) {
+        gpio_irq_events[gpio] |= events;
+    } else {
+        gpio_irq_events[gpio] &= ~events;
+    }
+    gpio_callback = callback;
+}
+
+bool host_gpio_irq(unsigned int gpio, uint32_t events) {
+    if (gpio >= HOST_NUM_GPIOS || !gpio_callback || !(gpio_irq_events[gpio] & events)) return false;
+    gpio_callback(gpio, gpio_irq_events[gpio] & events);
+    return true;
+}
+
+// ============================================================
+// I2C (barramento simulado, ver host_i2c.h)
+// ============================================================
+i2c_inst_t i2c0_inst = {0, 0};
+i2c_inst_t i2c1_inst = {1, 0};
+
+typedef struct {
+    i2c_inst_t *i2c;
+    uint8_t addr;
+    host_i2c_device_t dev;
+} attached_device_t;
+
+static attached_device_t devices[HOST_I2C_MAX_DEVICES];
+static int num_devices = 0;
+static uint32_t transactions[2];
+static bool bus_timing = false;
+static uint64_t bus_us[2];
+
+bool host_i2c_attach(i2c_inst_t *i2c, uint8_t addr, const host_i2c_device_t *dev) {
+    if (num_devices >= HOST_I2C_MAX_DEVICES) return false;
+    devices[num_devices].i2c = i2c;
+    devices[num_devices].addr = addr;
+    devices[num_devices].dev = *dev;
+    num_devices++;
+    return true;
+}
+
+void host_i2c_detach_all(void) {
+    num_devices = 0;
+    transactions[0] = transactions[1] = 0;
+    bus_us[0] = bus_us[1] = 0;
+}
+
+uint32_t host_i2c_transactions(i2c_inst_t *i2c) {
+    return transactions[i2c->hw_index];
+}
+
+void host_i2c_set_timing(bool enabled) { bus_timing = enabled; }
+
+uint64_t host_i2c_bus_us(i2c_inst_t *i2c) {
+    return bus_us[i2c->hw_index];
+}
+
+// Conta a transação e, com timing, gasta o tempo de fio dela
+static void bus_transfer(i2c_inst_t *i2c, size_t len) {
+    transactions[i2c->hw_index]++;
+    if (!bus_timing || i2c->baudrate == 0) return;
+    const uint64_t bits = (1 + len) * 9 + 2;
+    const uint64_t us = (bits * 1000000u + i2c->baudrate - 1) / i2c->baudrate;
+    bus_us[i2c->hw_index] += us;
+    sleep_us(us);
+}
+
+static const host_i2c_device_t *find_device(i2c_inst_t *i2c, uint8_t addr) {
+    for (int i = 0; i < num_devices; i++) {
+        if (devices[i].i2c == i2c && devices[i].addr == addr) return &devices[i].dev;
+    }
+    return NULL;
+}
+
+unsigned int i2c_init(i2c_inst_t *i2c, unsigned int baudrate) {
+    i2c->baudrate = baudrate;
+    return baudrate;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src,
+                       size_t len, bool nostop) {
+    (void)nostop;
+    bus_transfer(i2c, len);
+    const host_i2c_device_t *dev = find_device(i2c, addr);
+    return dev ? dev->write(dev->ctx, src, len) : PICO_ERROR_GENERIC;
+}
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len,
+                      bool nostop) {
+    (void)nostop;
+    bus_transfer(i2c, len);
+    const host_i2c_device_t *dev = find_device(i2c, addr);
+    return dev ? dev->read(dev->ctx, dst, len) : PICO_ERROR_GENERIC;
+}
+
+// ============================================================
+// MULTICORE (core 1 = pthread)
+// ============================================================
+#define FIFO_DEPTH 8
+
+typedef struct {
+    uint32_t data[FIFO_DEPTH];
+    int head;
+    int count;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+} host_fifo_t;
+
+// fifos[n] é lido pelo core n
+static host_fifo_t fifos[2] = {
+    {{0}, 0, 0, PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER},
+    {{0}, 0, 0, PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER},
+};
+
+static _Thread_local unsigned int this_core = 0;
+static pthread_t core1_thread;
+static bool core1_running = false;
+
+static void *core1_trampoline(void *arg) {
+    host_core_enter(1);
+    void (*entry)(void) = (void (*)(void))arg;
+    entry();
+    host_core_leave();
+    return NULL;
+}
+
+unsigned int get_core_num(void) { return this_core; }
+
+void host_core_enter(unsigned int core) {
+    this_core = core;
+    __atomic_fetch_add(&cores_bound[core], 1, __ATOMIC_SEQ_CST);
+}
+
+void host_core_leave(void) {
+    __atomic_fetch_sub(&cores_bound[this_core], 1, __ATOMIC_SEQ_CST);
+    this_core = 0;
+}
+
+void multicore_reset_core1(void) {
+    // Uma thread não pode ser abortada: esperamos o entry do core 1 retornar.
+    if (core1_running) {
+        pthread_join(core1_thread, NULL);
+        core1_running = false;
+    }
+    pthread_mutex_lock(&fifos[1].lock);
+    fifos[1].head = fifos[1].count = 0;
+    pthread_mutex_unlock(&fifos[1].lock);
+}
+
+void multicore_launch_core1(void (*entry)(void)) {
+    multicore_reset_core1();
+    pthread_create(&core1_thread, NULL, core1_trampoline, (void *)entry);
+    core1_running = true;
+}
+
+void multicore_fifo_push_blocking(uint32_t data) {
+    host_fifo_t *f = &fifos[this_core ^ 1u];
+    pthread_mutex_lock(&f->lock);
+    while (f->count == FIFO_DEPTH) pthread_cond_wait(&f->changed, &f->lock);
+    f->data[(f->head + f->count) % FIFO_DEPTH] = data;
+    f->count++;
+    pthread_cond_broadcast(&f->changed);
+    pthread_mutex_unlock(&f->lock);
+}
+
+// No SDK a espera é em __wfe: core 1 parado no FIFO conta como ocioso para
+// o relógio virtual (ex.: worker persistente do pico-tflmicro)
+uint32_t multicore_fifo_pop_blocking(void) {
+    host_fifo_t *f = &fifos[this_core];
+    pthread_mutex_lock(&f->lock);
+    if (f->count == 0) {
+        __atomic_store_n(&core_waiting[this_core], true, __ATOMIC_SEQ_CST);
+        while (f->count == 0) pthread_cond_wait(&f->changed, &f->lock);
+        __atomic_store_n(&core_waiting[this_core], false, __ATOMIC_SEQ_CST);
+    }
+    uint32_t data = f->data[f->head];
+    f->head = (f->head + 1) % FIFO_DEPTH;
+    f->count--;
+    pthread_cond_broadcast(&f->changed);
+    pthread_mutex_unlock(&f->lock);
+    return data;
+}
+
+bool multicore_fifo_rvalid(void) {
+    host_fifo_t *f = &fifos[this_core];
+    pthread_mutex_lock(&f->lock);
+    bool valid = f->count > 0;
+    pthread_mutex_unlock(&f->lock);
+    return valid;
+}
+
+bool multicore_fifo_wready(void) {
+    host_fifo_t *f = &fifos[this_core ^ 1u];
+    pthread_mutex_lock(&f->lock);
+    bool ready = f->count < FIFO_DEPTH;
+    pthread_mutex_unlock(&f->lock);
+    return ready;
+}
+
+// ============================================================
+// SPINLOCKS
+// ============================================================
+static spin_lock_t spin_locks[NUM_SPIN_LOCKS];
+static uint32_t spin_locks_claimed;
+
+spin_lock_t *spin_lock_instance(unsigned int lock_num) { return &spin_locks[lock_num]; }
+
+spin_lock_t *spin_lock_init(unsigned int lock_num) {
+    spin_lock_t *lock = spin_lock_instance(lock_num);
+    __atomic_store_n(lock, 0u, __ATOMIC_RELEASE);
+    return lock;
+}
+
+// Primeiro livre, de cima para baixo (os de baixo são os de uso fixo no SDK)
+int spin_lock_claim_unused(bool required) {
+    for (int n = (int)NUM_SPIN_LOCKS - 1; n >= 0; n--) {
+        const uint32_t bit = 1u << n;
+        if (!(__atomic_fetch_or(&spin_locks_claimed, bit, __ATOMIC_SEQ_CST) & bit)) return n;
+    }
+    if (required) {
+        fprintf(stderr, "spin_lock_claim_unused: nenhum spinlock livre\n");
+        abort();
+    }
+    return -1;
+}
+
+void spin_lock_unclaim(unsigned int lock_num) {
+    spin_lock_init(lock_num);
+    __atomic_fetch_and(&spin_locks_claimed, ~(1u << lock_num), __ATOMIC_SEQ_CST);
+}
+
+uint32_t spin_lock_blocking(spin_lock_t *lock) {
+    while (__atomic_exchange_n(lock, 1u, __ATOMIC_ACQUIRE)) sched_yield();
+    return 0;
+}
+
+void spin_unlock(spin_lock_t *lock, uint32_t saved_irq) {
+    (void)saved_irq;
+    __atomic_store_n(lock, 0u, __ATOMIC_RELEASE);
+}
@@ -0,0 +1,71 @@
+#include "host/tca9548a_mock.h"
+
+#include <string.h>
+
+#include "pico/stdlib.h"
+
+static int mux_write(void *ctx, const uint8_t *src, size_t len) {
+    TCA9548A_Mock *m = (TCA9548A_Mock *)ctx;
+    if (len >= 1) {
+        m->control = src[len - 1];  // Bytes seguidos: vale o último
+        m->control_writes++;
+    }
+    return (int)len;
+}
+
+static int mux_read(void *ctx, uint8_t *dst, size_t len) {
+    TCA9548A_Mock *m = (TCA9548A_Mock *)ctx;
+    memset(dst, m->control, len);
+    return (int)len;
+}
+
+// Único dispositivo visível no endereço roteado; NULL se nenhum ou mais de um
+static const host_i2c_device_t *visible_device(TCA9548A_MockBus *bus) {
+    const host_i2c_device_t *found = NULL;
+    int visible = 0;
+    for (int i = 0; i < bus->num_muxes; i++) {
+        const TCA9548A_Mock *m = &bus->muxes[i];
+        for (int p = 0; p < TCA9548A_MOCK_PORTS; p++) {
+            if (!(m->control & (1u << p)) || !m->connected[p]) continue;
+            found = &m->port[p];
+            visible++;
+        }
+    }
+    if (visible > 1) {
+        bus->collisions++;
+        return NULL;
+    }
+    if (found) bus->forwarded++;
+    return found;
+}
+
+static int routed_write(void *ctx, const uint8_t *src, size_t len) {
+    const host_i2c_device_t *dev = visible_device((TCA9548A_MockBus *)ctx);
+    return dev ? dev->write(dev->ctx, src, len) : PICO_ERROR_GENERIC;
+}
+
+static int routed_read(void *ctx, uint8_t *dst, size_t len) {
+    const host_i2c_device_t *dev = visible_device((TCA9548A_MockBus *)ctx);
+    return dev ? dev->read(dev->ctx, dst, len) : PICO_ERROR_GENERIC;
+}
+
+bool tca9548a_mock_attach(TCA9548A_MockBus *bus, i2c_inst_t *i2c, int num_muxes, uint8_t device_addr) {
+    memset(bus, 0, sizeof(*bus));
+    if (num_muxes < 0 || num_muxes > TCA9548A_MOCK_MAX_MUXES) return false;
+    bus->device_addr = device_addr;
+    bus->num_muxes = num_muxes;
+    for (int i = 0; i < num_muxes; i++) {
+        TCA9548A_Mock *m = &bus->muxes[i];
+        m->addr = (uint8_t)(0x70 + i);
+        const host_i2c_device_t dev = {mux_write, mux_read, m};
+        if (!host_i2c_attach(i2c, m->addr, &dev)) return false;
+    }
+    const host_i2c_device_t routed = {routed_write, routed_read, bus};
+    return host_i2c_attach(i2c, device_addr, &routed);
+}
+
+void tca9548a_mock_connect(TCA9548A_MockBus *bus, int mux, int port, const host_i2c_device_t *dev) {
+    TCA9548A_Mock *m = &bus->muxes[mux];
+    m->connected[port] = true;
+    m->port[port] = *dev;
+}
@@ -0,0 +1,49 @@
+// Multiplexadores TCA9548A sobre o barramento simulado. Cada mux responde no
+// próprio endereço (registrador de controle) e os dispositivos ligados às
+// portas respondem no endereço deles só enquanto a porta estiver ligada.
+// Mais de um dispositivo visível no mesmo endereço (duas portas, ou dois
+// muxes com porta ligada) faz a transferência falhar e conta como colisão.
+#ifndef TCA9548A_MOCK_H
+#define TCA9548A_MOCK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hardware/i2c.h"
+#include "host/host_i2c.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TCA9548A_MOCK_MAX_MUXES 8
+#define TCA9548A_MOCK_PORTS     8
+
+typedef struct {
+    uint8_t addr;
+    uint8_t control;                // Portas ligadas
+    bool connected[TCA9548A_MOCK_PORTS];
+    host_i2c_device_t port[TCA9548A_MOCK_PORTS];
+    uint32_t control_writes;
+} TCA9548A_Mock;
+
+typedef struct {
+    uint8_t device_addr;            // Endereço dos dispositivos atrás dos muxes
+    TCA9548A_Mock muxes[TCA9548A_MOCK_MAX_MUXES];
+    int num_muxes;
+    uint32_t forwarded;             // Transferências entregues a um dispositivo
+    uint32_t collisions;
+} TCA9548A_MockBus;
+
+// Registra num_muxes muxes (0x70, 0x71, ...) no barramento, todos com as
+// portas desligadas, e o endereço device_addr roteado através deles
+bool tca9548a_mock_attach(TCA9548A_MockBus *bus, i2c_inst_t *i2c, int num_muxes, uint8_t device_addr);
+
+// Liga um dispositivo (ex.: aht20_mock_device) na porta `port` do mux `mux`
+void tca9548a_mock_connect(TCA9548A_MockBus *bus, int mux, int port, const host_i2c_device_t *dev);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TCA9548A_MOCK_H
@@ -0,0 +1,121 @@
+// Leitura não bloqueante dos dois AHT20 sobre o barramento simulado.
+#include "host/aht20_mock.h"
+#include "host/host_i2c.h"
+#include "host/tests/host_test.h"
+#include "lib/sensors/sensors.h"
+
+static AHT20_Mock mock_1, mock_2;
+
+static void setup(void) {
+    host_i2c_detach_all();
+    aht20_mock_attach(&mock_1, I2C_PORT_0);
+    aht20_mock_attach(&mock_2, I2C_PORT_1);
+    init_i2c_sensor();
+    init_aht20();
+}
+
+HOST_TEST(PollBeforeConversionTimeDoesNotTouchBus) {
+    setup();
+    AHT20_Async s;
+    aht20_async_init(&s, I2C_PORT_0);
+    HOST_EXPECT(aht20_async_start(&s));
+
+    uint32_t before = host_i2c_transactions(I2C_PORT_0);
+    HOST_EXPECT_EQ(aht20_async_poll(&s), AHT20_ASYNC_CONVERTING);
+    HOST_EXPECT_EQ(host_i2c_transactions(I2C_PORT_0), before);
+
+    sleep_ms(AHT20_MEASURE_TIME_US / 1000);
+    HOST_EXPECT_EQ(aht20_async_poll(&s), AHT20_ASYNC_READY);
+    HOST_EXPECT_EQ(host_i2c_transactions(I2C_PORT_0), before + 1);
+    HOST_EXPECT_NEAR(s.data.temperature, 25.0, 0.01);
+    HOST_EXPECT_NEAR(s.data.humidity, 50.0, 0.01);
+}
+
+HOST_TEST(SlowSensorStaysConvertingUntilDone) {
+    setup();
+    mock_1.conversion_us = AHT20_MEASURE_TIME_US + 30000;
+    AHT20_Async s;
+    aht20_async_init(&s, I2C_PORT_0);
+    aht20_async_start(&s);
+
+    sleep_ms(AHT20_MEASURE_TIME_US / 1000);
+    HOST_EXPECT_EQ(aht20_async_poll(&s), AHT20_ASYNC_CONVERTING);
+    HOST_EXPECT_EQ(mock_1.busy_reads, 1);
+    sleep_ms(30);
+    HOST_EXPECT_EQ(aht20_async_poll(&s), AHT20_ASYNC_READY);
+}
+
+HOST_TEST(StuckSensorTimesOut) {
+    setup();
+    mock_1.stuck_busy = true;
+    AHT20_Async s;
+    aht20_async_init(&s, I2C_PORT_0);
+    aht20_async_start(&s);
+
+    sleep_ms(AHT20_MEASURE_TIMEOUT_US / 1000);
+    HOST_EXPECT_EQ(aht20_async_poll(&s), AHT20_ASYNC_ERROR);
+}
+
+HOST_TEST(MissingSensorReportsError) {
+    host_i2c_detach_all();
+    AHT20_Async s;
+    aht20_async_init(&s, I2C_PORT_1);
+    HOST_EXPECT(!aht20_async_start(&s));
+    HOST_EXPECT_EQ(aht20_async_poll(&s), AHT20_ASYNC_ERROR);
+}
+
+HOST_TEST(BothBusesConvertInParallel) {
+    setup();
+    mock_1.temperature = 40.0f; mock_1.humidity = 30.0f;
+    mock_2.temperature = 28.0f; mock_2.humidity = 75.0f;
+
+    uint64_t t0 = time_us_64();
+    SensorReadings r = get_sensor_readings();
+    uint64_t elapsed = time_us_64() - t0;
+
+    // Uma conversão de latência (não duas em série)
+    HOST_EXPECT(elapsed >= AHT20_MEASURE_TIME_US);
+    HOST_EXPECT(elapsed < 2 * AHT20_MEASURE_TIME_US);
+    HOST_EXPECT_EQ(mock_1.triggers, 1);
+    HOST_EXPECT_EQ(mock_2.triggers, 1);
+    HOST_EXPECT_NEAR(r.aht_temp_1, 40.0, 0.01);
+    HOST_EXPECT_NEAR(r.humidity_1, 30.0, 0.01);
+    HOST_EXPECT_NEAR(r.aht_temp_2, 28.0, 0.01);
+    HOST_EXPECT_NEAR(r.humidity_2, 75.0, 0.01);
+}
+
+HOST_TEST(OverlappedCycleHidesConversion) {
+    setup();
+    SensorReadings r;
+    sensors_start_conversion();
+    HOST_EXPECT(!sensors_poll(&r));
+
+    // Trabalho do loop (inferência, serial, sleep) maior que a conversão
+    sleep_ms(100);
+    uint64_t t0 = time_us_64();
+    r = sensors_wait_readings();
+    HOST_EXPECT(time_us_64() - t0 < 1000);
+    HOST_EXPECT_NEAR(r.aht_temp_2, 25.0, 0.01);
+}
+
+HOST_TEST(BlockingReadStillWorks) {
+    setup();
+    mock_2.temperature = -10.0f;
+    mock_2.humidity = 90.0f;
+    AHT20_Data d;
+    HOST_EXPECT(aht20_read(I2C_PORT_1, &d));
+    HOST_EXPECT_NEAR(d.temperature, -10.0, 0.01);
+    HOST_EXPECT_NEAR(d.humidity, 90.0, 0.01);
+}
+
+int main(void) {
+    stdio_init_all();
+    HOST_RUN_TEST(PollBeforeConversionTimeDoesNotTouchBus);
+    HOST_RUN_TEST(SlowSensorStaysConvertingUntilDone);
+    HOST_RUN_TEST(StuckSensorTimesOut);
+    HOST_RUN_TEST(MissingSensorReportsError);
+    HOST_RUN_TEST(BothBusesConvertInParallel);
+    HOST_RUN_TEST(OverlappedCycleHidesConversion);
+    HOST_RUN_TEST(BlockingReadStillWorks);
+    HOST_TESTS_END();
+}
@@ -0,0 +1,45 @@
+// modelo_predator_arena.h precisa bater com a medição atual: se o modelo ou o
+// TFLM mudarem, este teste pede para rodar o arena_sizer de novo.
+#include "host/tests/host_test.h"
+#include "host/tools/arena_probe.h"
+#include "modelo_predator.h"
+#include "modelo_predator_arena.h"
+#include "tflm_lut.h"
+#include "tflm_wrapper.h"
+
+static ArenaReport report;
+
+HOST_TEST(HeaderMatchesModel) {
+    HOST_EXPECT_EQ(modelo_tflite_len, MODELO_ARENA_MODEL_LEN);
+    HOST_EXPECT_EQ(tflm_lut_model_hash(modelo_tflite, modelo_tflite_len), MODELO_ARENA_MODEL_HASH);
+}
+
+HOST_TEST(HeaderMatchesMeasurement) {
+    HOST_EXPECT_EQ(report.min_arena_bytes, (size_t)MODELO_ARENA_MIN_BYTES);
+    HOST_EXPECT(MODELO_ARENA_SIZE >= MODELO_ARENA_MIN_BYTES);
+    HOST_EXPECT_EQ(MODELO_ARENA_SIZE % 16, 0);
+}
+
+HOST_TEST(BreakdownIsConsistent) {
+    HOST_EXPECT(report.persistent_bytes > 0);
+    HOST_EXPECT(report.non_persistent_bytes > 0);
+    HOST_EXPECT(report.scratch_bytes <= report.non_persistent_bytes);
+    HOST_EXPECT(report.used_bytes <= report.min_arena_bytes);
+}
+
+HOST_TEST(FirmwareArenaIsEnough) {
+    HOST_EXPECT_EQ(tflm_init(), 0);
+    HOST_EXPECT(tflm_arena_used_bytes() <= MODELO_ARENA_SIZE);
+    float in[2] = {0.5f, -0.5f};
+    TflmDecision d;
+    HOST_EXPECT_EQ(tflm_classify(in, &d), 0);
+}
+
+int main(void) {
+    HOST_EXPECT(arena_probe(tflite::GetModel(modelo_tflite), &report));
+    HOST_RUN_TEST(HeaderMatchesModel);
+    HOST_RUN_TEST(HeaderMatchesMeasurement);
+    HOST_RUN_TEST(BreakdownIsConsistent);
+    HOST_RUN_TEST(FirmwareArenaIsEnough);
+    HOST_TESTS_END();
+}
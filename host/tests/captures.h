@@ -0,0 +1,40 @@
+// Acesso às capturas gravadas em Notebooks/Data para os testes host.
+#ifndef HOST_TESTS_CAPTURES_H
+#define HOST_TESTS_CAPTURES_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "modelo_predator_norm.h"
+
+static const char *const host_captures[] = {
+    PREDAGUARD_DATA_DIR "/idle_differential_bruto.csv",
+    PREDAGUARD_DATA_DIR "/gaming_differential_bruto.csv",
+    PREDAGUARD_DATA_DIR "/obstrucao_differential_bruto.csv",
+    PREDAGUARD_DATA_DIR "/dataset_pronto_treino.csv",
+};
+#define HOST_NUM_CAPTURES ((int)(sizeof(host_captures) / sizeof(host_captures[0])))
+
+// Constantes de normalização de main.c
+static const float HOST_MEAN_DELTA_T = MODELO_NORM_MEAN_DELTA_T;
+static const float HOST_STD_DELTA_T  = MODELO_NORM_STD_DELTA_T;
+static const float HOST_MEAN_DELTA_U = MODELO_NORM_MEAN_DELTA_U;
+static const float HOST_STD_DELTA_U  = MODELO_NORM_STD_DELTA_U;
+
+// Lê a próxima linha com timestamp,t_ex,u_ex,t_amb,u_amb em v[0..4].
+// Linhas que não parseiam (cabeçalho) são puladas; retorna 0 no fim do arquivo.
+static inline int host_read_capture_row(FILE *fp, float v[5]) {
+    char line[256];
+    while (fgets(line, sizeof(line), fp)) {
+        char *s = line, *end;
+        int n = 0;
+        for (; n < 5; n++, s = end + 1) {
+            v[n] = strtof(s, &end);
+            if (end == s || (n < 4 && *end != ',')) break;
+        }
+        if (n == 5) return 1;
+    }
+    return 0;
+}
+
+#endif // HOST_TESTS_CAPTURES_H
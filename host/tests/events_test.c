@@ -0,0 +1,153 @@
+// Fila de eventos das interrupções (lib/events) e botões tratados fora da ISR.
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+
+#include "host/host_gpio.h"
+#include "host/tests/host_test.h"
+#include "lib/buttons/buttons.h"
+#include "lib/events/events.h"
+
+HOST_TEST(PopsOldestAcrossLanes) {
+    static EventQueue q;
+    event_queue_init(&q);
+    HOST_EXPECT(event_push(&q, 1, EVENT_TIMER, 0, 0, 300));
+    HOST_EXPECT(event_push(&q, 0, EVENT_BUTTON, BTN_A, 0, 100));
+    HOST_EXPECT(event_push(&q, 2, EVENT_DATA_READY, 1, 0, 200));
+    HOST_EXPECT(event_push(&q, 0, EVENT_BUTTON, BTN_B, 0, 400));
+    // Carimbos perto da volta do time_us_32
+    HOST_EXPECT(event_push(&q, 3, EVENT_TIMER, 3, 0, 0xFFFFFF00u));
+    const uint32_t expected[] = {0xFFFFFF00u, 100, 200, 300, 400};
+    Event ev;
+    for (int i = 0; i < 5; i++) {
+        HOST_EXPECT(event_pop(&q, &ev));
+        HOST_EXPECT_EQ(ev.time_us, expected[i]);
+    }
+    HOST_EXPECT(!event_pop(&q, &ev));
+    HOST_EXPECT_EQ(q.popped, 5u);
+}
+
+HOST_TEST(FullLaneDropsWithoutBlocking) {
+    static EventQueue q;
+    event_queue_init(&q);
+    for (uint32_t i = 0; i < EVENT_LANE_DEPTH; i++) {
+        HOST_EXPECT(event_push(&q, 0, EVENT_BUTTON, 0, (uint16_t)i, i));
+    }
+    HOST_EXPECT(!event_push(&q, 0, EVENT_BUTTON, 0, 99, 99));
+    HOST_EXPECT(event_push(&q, 1, EVENT_TIMER, 0, 0, 5));  // Outra faixa segue livre
+    HOST_EXPECT_EQ(q.lanes[0].dropped, 1u);
+    HOST_EXPECT_EQ(q.lanes[0].pushed, (uint32_t)EVENT_LANE_DEPTH);
+    Event ev;
+    HOST_EXPECT(event_pop(&q, &ev));
+    HOST_EXPECT(event_push(&q, 0, EVENT_BUTTON, 0, 100, 100));  // Liberou um lugar
+}
+
+HOST_TEST(ButtonsDebounceInTaskContext) {
+    static EventQueue q;
+    event_queue_init(&q);
+    init_buttons(&q, EVENT_LANE_IRQ);
+    sleep_us(BUTTON_DEBOUNCE_US);  // Longe do carimbo inicial
+
+    HOST_EXPECT(host_gpio_irq(BTN_A, GPIO_IRQ_EDGE_FALL));
+    HOST_EXPECT(host_gpio_irq(BTN_A, GPIO_IRQ_EDGE_FALL));  // Repique: mesma janela
+    HOST_EXPECT(!host_gpio_irq(BTN_A, GPIO_IRQ_EDGE_RISE)); // Borda não habilitada
+    HOST_EXPECT_EQ(offset, 0);  // A ISR não mexe no estado
+    HOST_EXPECT_EQ(q.lanes[EVENT_LANE_IRQ].isr_count, 2u);
+
+    Event ev;
+    int handled = 0;
+    while (event_pop(&q, &ev)) handled += buttons_handle(&ev);
+    HOST_EXPECT_EQ(handled, 2);
+    HOST_EXPECT_EQ(offset, -5);
+    HOST_EXPECT(lock_humidity);
+
+    sleep_us(BUTTON_DEBOUNCE_US);
+    host_gpio_irq(BTN_B, GPIO_IRQ_EDGE_FALL);
+    while (event_pop(&q, &ev)) buttons_handle(&ev);
+    HOST_EXPECT_EQ(offset, 0);
+    HOST_EXPECT(!lock_humidity);
+
+    const Event timer = {0, EVENT_TIMER, 0, 0};
+    HOST_EXPECT(!buttons_handle(&timer));
+}
+
+// ------------------------------------------------------------
+// Estresse: três produtores (um por faixa) contra o consumidor. Sem perda,
+// sem duplicata e em ordem dentro de cada faixa; faixa cheia conta descarte
+// e o produtor tenta de novo, como uma ISR que reenviaria na próxima borda.
+// ------------------------------------------------------------
+#define STRESS_PRODUCERS 3
+#define STRESS_EVENTS    200000u
+
+static EventQueue stress_queue;
+static uint32_t stress_failed[STRESS_PRODUCERS];
+
+static void *producer(void *arg) {
+    const int lane = (int)(intptr_t)arg;
+    for (uint32_t i = 0; i < STRESS_EVENTS; i++) {
+        for (;;) {
+            const uint32_t t0 = time_us_32();
+            const bool ok = event_push(&stress_queue, lane, EVENT_DATA_READY, (uint8_t)lane,
+                                       (uint16_t)i, i);
+            event_isr_end(&stress_queue, lane, t0);
+            if (ok) break;
+            stress_failed[lane]++;
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+HOST_TEST(ConcurrentProducersStress) {
+    event_queue_init(&stress_queue);
+    memset(stress_failed, 0, sizeof(stress_failed));
+    pthread_t threads[STRESS_PRODUCERS];
+    for (int i = 0; i < STRESS_PRODUCERS; i++) {
+        pthread_create(&threads[i], NULL, producer, (void *)(intptr_t)i);
+    }
+
+    uint32_t next[STRESS_PRODUCERS] = {0};
+    uint32_t received = 0, out_of_order = 0;
+    while (received < STRESS_PRODUCERS * STRESS_EVENTS) {
+        Event ev;
+        if (!event_pop(&stress_queue, &ev)) {
+            sched_yield();
+            continue;
+        }
+        received++;
+        if (ev.source >= STRESS_PRODUCERS || ev.type != EVENT_DATA_READY) {
+            out_of_order++;
+            continue;
+        }
+        // Carimbo = número de sequência da faixa
+        if (ev.time_us != next[ev.source] || ev.arg != (uint16_t)ev.time_us) out_of_order++;
+        next[ev.source] = ev.time_us + 1;
+    }
+    for (int i = 0; i < STRESS_PRODUCERS; i++) pthread_join(threads[i], NULL);
+
+    Event ev;
+    HOST_EXPECT(!event_pop(&stress_queue, &ev));
+    HOST_EXPECT_EQ(out_of_order, 0u);
+    uint32_t worst_us = 0;
+    for (int i = 0; i < STRESS_PRODUCERS; i++) {
+        const EventLane *l = &stress_queue.lanes[i];
+        HOST_EXPECT_EQ(next[i], STRESS_EVENTS);
+        HOST_EXPECT_EQ(l->pushed, STRESS_EVENTS);
+        HOST_EXPECT_EQ(l->dropped, stress_failed[i]);
+        if (l->isr_max_us > worst_us) worst_us = l->isr_max_us;
+    }
+    HOST_EXPECT_EQ(stress_queue.popped, STRESS_PRODUCERS * STRESS_EVENTS);
+    printf("  %u eventos, %u descartes com faixa cheia, pior push %u us\n",
+           STRESS_PRODUCERS * STRESS_EVENTS,
+           stress_failed[0] + stress_failed[1] + stress_failed[2], worst_us);
+}
+
+int main(void) {
+    HOST_RUN_TEST(PopsOldestAcrossLanes);
+    HOST_RUN_TEST(FullLaneDropsWithoutBlocking);
+    HOST_RUN_TEST(ButtonsDebounceInTaskContext);
+    HOST_RUN_TEST(ConcurrentProducersStress);
+    HOST_TESTS_END();
+}
@@ -0,0 +1,130 @@
+// Motor de janelas deslizantes contra a recomputação em lote (double) sobre
+// as capturas gravadas.
+#include <math.h>
+
+#include "host/tests/captures.h"
+#include "host/tests/host_test.h"
+#include "lib/features/features.h"
+
+// Mesma codificação do replay (lib/sensors/sensors_csv.c)
+static int32_t encode(float value, float offset, float span) {
+    return (int32_t)lround((value + offset) * (double)AHT20_RAW_FULL_SCALE / span);
+}
+
+#define HISTORY_MAX 20000
+static int32_t hist_t[HISTORY_MAX], hist_u[HISTORY_MAX];
+
+typedef struct {
+    int checked;
+    int mean_errors, var_errors, minmax_errors, slope_errors;
+} BatchResult;
+
+// Confere a janela contra history[end-n .. end-1] recomputado do zero
+static void check_against_batch(const FeatWindow *w, const int32_t *history, int end,
+                                BatchResult *res) {
+    const int n = end < w->window ? end : w->window;
+    const int32_t *y = &history[end - n];
+    double sum = 0, sum_xy = 0;
+    int32_t lo = y[0], hi = y[0];
+    for (int i = 0; i < n; i++) {
+        sum += y[i];
+        sum_xy += (double)i * y[i];
+        if (y[i] < lo) lo = y[i];
+        if (y[i] > hi) hi = y[i];
+    }
+    const double mean = sum / n;
+    double var = 0;
+    for (int i = 0; i < n; i++) var += (y[i] - mean) * (y[i] - mean);
+    var /= n;
+
+    res->checked++;
+    res->mean_errors += fabs(feat_mean(w) - mean) > 0.5 + 1e-9;
+    res->var_errors += fabs((double)feat_variance(w) - var) > 0.5 + 1e-9 * var;
+    res->minmax_errors += feat_min(w) != lo || feat_max(w) != hi;
+    if (n >= 2) {
+        const double mean_i = (n - 1) / 2.0;
+        const double slope = (sum_xy - mean_i * sum) / ((double)n * (n * (double)n - 1) / 12.0);
+        const double q16 = fmin(fmax(slope * 65536.0, INT32_MIN), INT32_MAX);
+        res->slope_errors += fabs(feat_slope_q16(w) - q16) > 0.5 + 1e-6;
+    }
+}
+
+static void run_captures(uint16_t window) {
+    BatchResult t = {0}, u = {0};
+    for (int f = 0; f < HOST_NUM_CAPTURES; f++) {
+        FILE *fp = fopen(host_captures[f], "r");
+        HOST_EXPECT(fp != NULL);
+        if (!fp) continue;
+        FeatureEngine e;
+        HOST_EXPECT(feat_engine_init(&e, window));
+        float v[5];
+        int rows = 0;
+        while (rows < HISTORY_MAX && host_read_capture_row(fp, v)) {
+            SensorReadings r = {0};
+            r.raw_temp_1 = (uint32_t)encode(v[1], 50.0f, 200.0f);
+            r.raw_humidity_1 = (uint32_t)encode(v[2], 0.0f, 100.0f);
+            r.raw_temp_2 = (uint32_t)encode(v[3], 50.0f, 200.0f);
+            r.raw_humidity_2 = (uint32_t)encode(v[4], 0.0f, 100.0f);
+            feat_engine_push(&e, &r);
+
+            hist_t[rows] = (int32_t)r.raw_temp_1 - (int32_t)r.raw_temp_2;
+            hist_u[rows] = (int32_t)r.raw_humidity_1 - (int32_t)r.raw_humidity_2;
+            rows++;
+            check_against_batch(&e.delta_t, hist_t, rows, &t);
+            check_against_batch(&e.delta_u, hist_u, rows, &u);
+        }
+        fclose(fp);
+    }
+    printf("  janela %u: %d amostras conferidas\n", window, t.checked);
+    HOST_EXPECT(t.checked > 10000);
+    HOST_EXPECT_EQ(t.mean_errors + u.mean_errors, 0);
+    HOST_EXPECT_EQ(t.var_errors + u.var_errors, 0);
+    HOST_EXPECT_EQ(t.minmax_errors + u.minmax_errors, 0);
+    HOST_EXPECT_EQ(t.slope_errors + u.slope_errors, 0);
+}
+
+HOST_TEST(RejectsInvalidWindow) {
+    FeatWindow w;
+    HOST_EXPECT(!feat_window_init(&w, 0));
+    HOST_EXPECT(!feat_window_init(&w, FEAT_MAX_WINDOW + 1));
+    HOST_EXPECT(feat_window_init(&w, FEAT_MAX_WINDOW));
+    HOST_EXPECT_EQ(feat_mean(&w), 0);
+    HOST_EXPECT_EQ(feat_slope_q16(&w), 0);
+}
+
+HOST_TEST(LinearRampHasExactSlope) {
+    FeatWindow w;
+    feat_window_init(&w, 16);
+    for (int i = 0; i < 100; i++) feat_window_push(&w, 1000 - 3 * i);
+    HOST_EXPECT_EQ(feat_slope_q16(&w), -3 * 65536);
+    HOST_EXPECT_EQ(feat_min(&w), 1000 - 3 * 99);
+    HOST_EXPECT_EQ(feat_max(&w), 1000 - 3 * 84);
+    HOST_EXPECT_EQ(feat_variance(&w), (uint64_t)lround(9.0 * (16 * 16 - 1) / 12.0));
+}
+
+HOST_TEST(ExtremeCodesDoNotOverflow) {
+    FeatWindow w;
+    feat_window_init(&w, FEAT_MAX_WINDOW);
+    const int32_t big = (1 << 21) - 1;
+    for (int i = 0; i < 3 * FEAT_MAX_WINDOW; i++) feat_window_push(&w, (i & 1) ? big : -big);
+    HOST_EXPECT_EQ(feat_mean(&w), 0);
+    HOST_EXPECT_EQ(feat_variance(&w), (uint64_t)big * big);
+    HOST_EXPECT_EQ(feat_min(&w), -big);
+    HOST_EXPECT_EQ(feat_max(&w), big);
+}
+
+HOST_TEST(MatchesBatchWindow1) { run_captures(1); }
+HOST_TEST(MatchesBatchWindow2) { run_captures(2); }
+HOST_TEST(MatchesBatchWindow20) { run_captures(20); }
+HOST_TEST(MatchesBatchWindowMax) { run_captures(FEAT_MAX_WINDOW); }
+
+int main(void) {
+    HOST_RUN_TEST(RejectsInvalidWindow);
+    HOST_RUN_TEST(LinearRampHasExactSlope);
+    HOST_RUN_TEST(ExtremeCodesDoNotOverflow);
+    HOST_RUN_TEST(MatchesBatchWindow1);
+    HOST_RUN_TEST(MatchesBatchWindow2);
+    HOST_RUN_TEST(MatchesBatchWindow20);
+    HOST_RUN_TEST(MatchesBatchWindowMax);
+    HOST_TESTS_END();
+}
@@ -0,0 +1,41 @@
+// Rack simulado para lib/fleet: pares de AHT20_Mock atrás de muxes TCA9548A,
+// exaustão em i2c0 e ambiente em i2c1, canal c no mux 0x70 + c/8, porta c%8.
+#ifndef HOST_TESTS_FLEET_RIG_H
+#define HOST_TESTS_FLEET_RIG_H
+
+#include "host/aht20_mock.h"
+#include "host/host_i2c.h"
+#include "host/tca9548a_mock.h"
+#include "lib/fleet/fleet.h"
+
+typedef struct {
+    TCA9548A_MockBus bus[2];                        // FleetSide
+    AHT20_Mock sensor[2][FLEET_MAX_CHANNELS];
+    int num_channels;
+} HostFleetRig;
+
+// Barramentos a 400 kHz; com bus_timing cada transferência gasta o tempo de fio
+static inline void host_fleet_rig_attach(HostFleetRig *rig, int num_channels, bool bus_timing) {
+    host_i2c_detach_all();
+    host_i2c_set_timing(bus_timing);
+    i2c_init(i2c0, 400 * 1000);
+    i2c_init(i2c1, 400 * 1000);
+    rig->num_channels = num_channels;
+    const int muxes = (num_channels + TCA9548A_MOCK_PORTS - 1) / TCA9548A_MOCK_PORTS;
+    for (int side = 0; side < 2; side++) {
+        tca9548a_mock_attach(&rig->bus[side], side == FLEET_EXHAUST ? i2c0 : i2c1, muxes, AHT20_I2C_ADDR);
+        for (int c = 0; c < num_channels; c++) {
+            aht20_mock_init(&rig->sensor[side][c]);
+            const host_i2c_device_t dev = aht20_mock_device(&rig->sensor[side][c]);
+            tca9548a_mock_connect(&rig->bus[side], c / TCA9548A_MOCK_PORTS, c % TCA9548A_MOCK_PORTS, &dev);
+        }
+    }
+}
+
+// Espera o ciclo em passos de 100 us de relógio virtual
+static inline void host_fleet_rig_cycle(Fleet *f) {
+    fleet_start(f);
+    while (!fleet_poll(f)) sleep_us(100);
+}
+
+#endif // HOST_TESTS_FLEET_RIG_H
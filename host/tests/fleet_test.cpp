@@ -0,0 +1,151 @@
+// Frota atrás de muxes (lib/fleet) no barramento simulado: cada canal lê os
+// próprios sensores, as conversões se sobrepõem, sensor ausente ou travado
+// só afeta o canal dele, e o Invoke em lote decide igual ao de uma linha.
+#include <string.h>
+
+#include <vector>
+
+#include "host/tests/captures.h"
+#include "host/tests/fleet_rig.h"
+#include "host/tests/host_test.h"
+#include "tflm_wrapper.h"
+
+static HostFleetRig rig;
+static Fleet fleet;
+
+HOST_TEST(EachChannelReadsItsOwnPair) {
+    const int n = 12;  // Dois muxes por barramento, o segundo pela metade
+    host_fleet_rig_attach(&rig, n, false);
+    for (int c = 0; c < n; c++) {
+        rig.sensor[FLEET_EXHAUST][c].temperature = 30.0f + c;
+        rig.sensor[FLEET_AMBIENT][c].temperature = 20.0f + 0.5f * c;
+        rig.sensor[FLEET_AMBIENT][c].humidity = 40.0f + c;
+    }
+    HOST_EXPECT_EQ(fleet_init(&fleet, i2c0, i2c1, n), n);
+
+    host_fleet_rig_cycle(&fleet);
+    for (int c = 0; c < n; c++) {
+        SensorReadings r;
+        fleet_readings(&fleet, c, &r);
+        HOST_EXPECT_NEAR(r.aht_temp_1, 30.0f + c, 0.01);
+        HOST_EXPECT_NEAR(r.aht_temp_2, 20.0f + 0.5f * c, 0.01);
+        HOST_EXPECT_NEAR(r.humidity_2, 40.0f + c, 0.01);
+        HOST_EXPECT_EQ(rig.sensor[FLEET_EXHAUST][c].triggers, 1);
+        HOST_EXPECT_EQ(rig.sensor[FLEET_AMBIENT][c].data_reads, 1);
+    }
+    HOST_EXPECT_EQ(rig.bus[FLEET_EXHAUST].collisions, 0);
+    HOST_EXPECT_EQ(rig.bus[FLEET_AMBIENT].collisions, 0);
+    HOST_EXPECT_EQ(fleet.stats.read_errors, 0);
+}
+
+HOST_TEST(ConversionsOverlapAcrossChannels) {
+    const int n = FLEET_MAX_CHANNELS;
+    host_fleet_rig_attach(&rig, n, true);
+    HOST_EXPECT_EQ(fleet_init(&fleet, i2c0, i2c1, n), n);
+
+    const uint64_t bus_before = host_i2c_bus_us(i2c0) + host_i2c_bus_us(i2c1);
+    host_fleet_rig_cycle(&fleet);
+    // Um core só conduz os dois barramentos: os tempos de fio se somam
+    const uint64_t bus_cycle = host_i2c_bus_us(i2c0) + host_i2c_bus_us(i2c1) - bus_before;
+    printf("  %d canais: ciclo %lu us, %llu us de barramento (sequencial: %d us)\n", n,
+           (unsigned long)fleet.stats.last_cycle_us, (unsigned long long)bus_cycle,
+           n * AHT20_MEASURE_TIME_US);
+    // Trigger e leitura de um canal custam ~0.4 ms de fio nos dois lados: o
+    // ciclo é uma conversão mais o barramento, não n conversões
+    HOST_EXPECT(fleet.stats.last_cycle_us >= AHT20_MEASURE_TIME_US);
+    HOST_EXPECT(fleet.stats.last_cycle_us < AHT20_MEASURE_TIME_US + bus_cycle + 1000);
+    HOST_EXPECT(bus_cycle > 0);
+    for (int c = 0; c < n; c++) HOST_EXPECT_EQ(rig.sensor[FLEET_EXHAUST][c].busy_reads, 0);
+    HOST_EXPECT_EQ(fleet.stats.read_errors, 0);
+    host_i2c_set_timing(false);
+}
+
+HOST_TEST(FaultsStayInTheirChannel) {
+    const int n = 10;
+    host_fleet_rig_attach(&rig, n, false);
+    rig.bus[FLEET_AMBIENT].muxes[0].connected[3] = false;  // Canal 3 sem sensor ambiente
+    HOST_EXPECT_EQ(fleet_init(&fleet, i2c0, i2c1, n), n - 1);
+    rig.sensor[FLEET_EXHAUST][8].stuck_busy = true;         // Canal 8 travado (segundo mux)
+    rig.sensor[FLEET_EXHAUST][9].temperature = 61.0f;
+
+    host_fleet_rig_cycle(&fleet);
+    HOST_EXPECT(fleet.stats.last_cycle_us >= AHT20_MEASURE_TIMEOUT_US);
+    HOST_EXPECT_EQ(fleet.channels[3].errors, 0);  // Ausente, não perdido
+    HOST_EXPECT_EQ(fleet.channels[8].errors, 1);
+    HOST_EXPECT_EQ(fleet.stats.read_errors, 1);
+    SensorReadings r;
+    fleet_readings(&fleet, 8, &r);
+    HOST_EXPECT_EQ(r.raw_temp_1, AHT20_RAW_TEMP_ZERO_C);
+    fleet_readings(&fleet, 9, &r);
+    HOST_EXPECT_NEAR(r.aht_temp_1, 61.0f, 0.01);
+    HOST_EXPECT_EQ(rig.bus[FLEET_EXHAUST].collisions, 0);
+    HOST_EXPECT_EQ(rig.bus[FLEET_AMBIENT].collisions, 0);
+}
+
+HOST_TEST(AbsentSensorIsNotALostReading) {
+    const int n = 4;
+    host_fleet_rig_attach(&rig, n, false);
+    rig.bus[FLEET_EXHAUST].muxes[0].connected[2] = false;  // Canal 2 sem sensor de exaustão
+    HOST_EXPECT_EQ(fleet_init(&fleet, i2c0, i2c1, n), n - 1);
+    HOST_EXPECT(!fleet.channels[2].present[FLEET_EXHAUST]);
+
+    for (int cycle = 0; cycle < 5; cycle++) host_fleet_rig_cycle(&fleet);
+    HOST_EXPECT_EQ(fleet.stats.cycles, 5u);
+    HOST_EXPECT_EQ(fleet.stats.read_errors, 0u);
+    for (int c = 0; c < n; c++) HOST_EXPECT_EQ(fleet.channels[c].errors, 0u);
+    HOST_EXPECT_EQ(rig.sensor[FLEET_AMBIENT][2].data_reads, 5);
+}
+
+HOST_TEST(BatchMatchesSingleRowInvoke) {
+    const TflmCachePolicy off = {TFLM_CACHE_OFF, 0.0f, 0};
+    tflm_cache_configure(&off);
+    HOST_EXPECT(tflm_batch_init(TFLM_BATCH_MAX + 1) != 0);
+    HOST_EXPECT_EQ(tflm_batch_capacity(), 0);
+    HOST_EXPECT_EQ(tflm_batch_init(TFLM_BATCH_MAX), 0);
+    HOST_EXPECT_EQ(tflm_batch_capacity(), TFLM_BATCH_MAX);
+    printf("  arena do lote: %d bytes (uma linha: %d)\n", tflm_batch_arena_used_bytes(),
+           tflm_arena_used_bytes());
+
+    std::vector<float> inputs;
+    for (int f = 0; f < HOST_NUM_CAPTURES; f++) {
+        FILE* fp = fopen(host_captures[f], "r");
+        HOST_EXPECT(fp != nullptr);
+        if (!fp) continue;
+        float v[5];
+        while (host_read_capture_row(fp, v)) {
+            inputs.push_back(((v[1] - v[3]) - HOST_MEAN_DELTA_T) / HOST_STD_DELTA_T);
+            inputs.push_back(((v[2] - v[4]) - HOST_MEAN_DELTA_U) / HOST_STD_DELTA_U);
+        }
+        fclose(fp);
+    }
+    const int rows = (int)inputs.size() / 2;
+    std::vector<TflmDecision> single(rows), batched(rows);
+    for (int i = 0; i < rows; i++) tflm_classify(&inputs[2 * i], &single[i]);
+
+    // Lotes cheios, incompletos, de uma linha e maiores que a capacidade
+    const int sizes[] = {TFLM_BATCH_MAX, 7, 1, TFLM_BATCH_MAX + 13};
+    int mismatches = 0, done = 0;
+    for (int i = 0; done < rows; i++) {
+        int n = sizes[i % 4];
+        if (n > rows - done) n = rows - done;
+        HOST_EXPECT_EQ(tflm_classify_batch(&inputs[2 * done], n, &batched[done]), 0);
+        done += n;
+    }
+    for (int i = 0; i < rows; i++) {
+        mismatches += batched[i].class_index != single[i].class_index ||
+                      batched[i].confidence_q != single[i].confidence_q;
+    }
+    printf("  %d linhas, %d divergências\n", rows, mismatches);
+    HOST_EXPECT(rows > 10000);
+    HOST_EXPECT_EQ(mismatches, 0);
+}
+
+int main(void) {
+    HOST_EXPECT_EQ(tflm_init_ex(TFLM_STRIP_SOFTMAX), 0);
+    HOST_RUN_TEST(EachChannelReadsItsOwnPair);
+    HOST_RUN_TEST(ConversionsOverlapAcrossChannels);
+    HOST_RUN_TEST(FaultsStayInTheirChannel);
+    HOST_RUN_TEST(AbsentSensorIsNotALostReading);
+    HOST_RUN_TEST(BatchMatchesSingleRowInvoke);
+    HOST_TESTS_END();
+}
@@ -0,0 +1,133 @@
+// Portão estatístico (lib/gate + modelo_predator_gate.h) contra o interpreter:
+// as regiões são do modelo atual, toda amostra gravada resolvida pelo portão
+// tem a decisão da rede, e uma grade deslocada da usada no ajuste também bate.
+#include <math.h>
+#include <string.h>
+
+#include "host/tests/captures.h"
+#include "host/tests/host_test.h"
+#include "lib/gate/gate.h"
+#include "lib/model_slot/model_slot.h"
+#include "modelo_predator.h"
+#include "modelo_predator_gate.h"
+#include "tflm_wrapper.h"
+
+static int network(float z0, float z1) {
+    const float z[2] = {z0, z1};
+    TflmDecision d;
+    tflm_classify(z, &d);
+    return d.class_index;
+}
+
+// Códigos brutos como no replay (lib/sensors/sensors_csv.c)
+static uint32_t encode(float value, float offset, float span) {
+    float code = (value + offset) * (float)AHT20_RAW_FULL_SCALE / span + 0.5f;
+    if (code <= 0.0f) return 0;
+    if (code >= (float)(AHT20_RAW_FULL_SCALE - 1)) return AHT20_RAW_FULL_SCALE - 1;
+    return (uint32_t)code;
+}
+
+HOST_TEST(RegionsMatchCurrentModel) {
+    HOST_EXPECT_EQ(modelo_gate.model_crc32, model_slot_crc32(0, modelo_tflite, modelo_tflite_len));
+    HOST_EXPECT_EQ(tflm_model_crc32(), modelo_gate.model_crc32);
+
+    Gate g;
+    gate_init(&g, &modelo_gate);
+    HOST_EXPECT(gate_select_model(&g, tflm_model_crc32()));
+    HOST_EXPECT(!gate_select_model(&g, tflm_model_crc32() ^ 1u));
+    SensorReadings r;
+    memset(&r, 0, sizeof(r));
+    uint8_t conf;
+    HOST_EXPECT_EQ(gate_apply(&g, &r, &conf), -1);
+    HOST_EXPECT_EQ(g.samples, 0);  // Desligado não conta
+}
+
+HOST_TEST(ResolvedSamplesMatchNetwork) {
+    Gate g;
+    gate_init(&g, &modelo_gate);
+    HOST_EXPECT(gate_select_model(&g, tflm_model_crc32()));
+    int mismatches = 0;
+    for (int f = 0; f < HOST_NUM_CAPTURES; f++) {
+        FILE* fp = fopen(host_captures[f], "r");
+        HOST_EXPECT(fp != nullptr);
+        if (!fp) continue;
+        float v[5];
+        while (host_read_capture_row(fp, v)) {
+            SensorReadings r;
+            r.raw_temp_1 = encode(v[1], 50.0f, 200.0f);
+            r.raw_humidity_1 = encode(v[2], 0.0f, 100.0f);
+            r.raw_temp_2 = encode(v[3], 50.0f, 200.0f);
+            r.raw_humidity_2 = encode(v[4], 0.0f, 100.0f);
+            uint8_t conf;
+            const int cls = gate_apply(&g, &r, &conf);
+            if (cls < 0) continue;
+            mismatches += cls != network(((v[1] - v[3]) - HOST_MEAN_DELTA_T) / HOST_STD_DELTA_T,
+                                         ((v[2] - v[4]) - HOST_MEAN_DELTA_U) / HOST_STD_DELTA_U);
+        }
+        fclose(fp);
+    }
+    printf("  %u de %u amostras resolvidas pelo portão (%.1f%%), %d divergências\n", g.resolved,
+           g.samples, 100.0 * g.resolved / g.samples, mismatches);
+    HOST_EXPECT_EQ(mismatches, 0);
+    HOST_EXPECT(g.resolved * 10 >= g.samples * 9);  // Ordem de grandeza a menos de Invokes
+}
+
+// Grade 2x mais fina que a do gate_fit e deslocada de meio passo
+HOST_TEST(DenseGridInsideRegionsMatchesNetwork) {
+    const int n = 2 * 256;
+    int inside = 0, mismatches = 0;
+    for (int c = 0; c < modelo_gate.num_classes; c++) {
+        const GateClass& k = modelo_gate.classes[c];
+        for (int i = 0; i < n; i++) {
+            const int32_t x = k.lo[0] + (int32_t)(((int64_t)(k.hi[0] - k.lo[0]) * (2 * i + 1)) / (2 * n));
+            for (int j = 0; j < n; j++) {
+                const int32_t y = k.lo[1] + (int32_t)(((int64_t)(k.hi[1] - k.lo[1]) * (2 * j + 1)) / (2 * n));
+                const int cls = gate_classify(&modelo_gate, x, y);
+                if (cls < 0) continue;
+                inside++;
+                const float z0 = (x * 200.0f / AHT20_RAW_FULL_SCALE - HOST_MEAN_DELTA_T) / HOST_STD_DELTA_T;
+                const float z1 = (y * 100.0f / AHT20_RAW_FULL_SCALE - HOST_MEAN_DELTA_U) / HOST_STD_DELTA_U;
+                mismatches += cls != network(z0, z1);
+            }
+        }
+    }
+    printf("  %d pontos dentro das regiões, %d divergências\n", inside, mismatches);
+    HOST_EXPECT(inside > 0);
+    HOST_EXPECT_EQ(mismatches, 0);
+}
+
+HOST_TEST(FixedPointEdges) {
+    GateParams p;
+    memset(&p, 0, sizeof(p));
+    p.mode = GATE_BOX;
+    p.num_classes = 2;
+    p.classes[0] = {{0, 0}, {100, 100}, {50, 50}, 0, 0, 0, 0, 0, 200};
+    p.classes[1] = {{90, 90}, {200, 200}, {145, 145}, 0, 0, 0, 0, 0, 100};
+    HOST_EXPECT_EQ(gate_classify(&p, 0, 100), 0);       // Bordas inclusivas
+    HOST_EXPECT_EQ(gate_classify(&p, 200, 200), 1);
+    HOST_EXPECT_EQ(gate_classify(&p, 95, 95), -1);      // Sobreposição: a rede decide
+    HOST_EXPECT_EQ(gate_classify(&p, -1, 50), -1);
+    HOST_EXPECT_EQ(gate_classify(&p, INT32_MIN, INT32_MAX), -1);
+
+    // Círculo de raio 1000 códigos com shift 4: dx = 62 -> q = 3844 + 0 <= 3906
+    p.mode = GATE_MAHALANOBIS;
+    p.num_classes = 1;
+    p.classes[0] = {{-1000, -1000}, {1000, 1000}, {0, 0}, 4, 1, 0, 1, 62 * 62 + 62, 255};
+    HOST_EXPECT_EQ(gate_classify(&p, 0, 0), 0);
+    HOST_EXPECT_EQ(gate_classify(&p, 1000, 0), 0);
+    HOST_EXPECT_EQ(gate_classify(&p, 1000, 1000), -1);  // Canto da caixa, fora do círculo
+    HOST_EXPECT_EQ(gate_classify(&p, -700, 700), 0);
+    HOST_EXPECT_EQ(gate_classify(&p, -800, 800), -1);
+
+    p.mode = GATE_OFF;
+    HOST_EXPECT_EQ(gate_classify(&p, 0, 0), -1);
+}
+
+int main(void) {
+    HOST_EXPECT_EQ(tflm_init_ex(TFLM_STRIP_SOFTMAX), 0);
+    HOST_RUN_TEST(RegionsMatchCurrentModel);
+    HOST_RUN_TEST(ResolvedSamplesMatchNetwork);
+    HOST_RUN_TEST(DenseGridInsideRegionsMatchesNetwork);
+    HOST_RUN_TEST(FixedPointEdges);
+    HOST_TESTS_END();
+}
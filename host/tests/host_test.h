@@ -0,0 +1,61 @@
+// Macros mínimas para os testes host (ctest usa o código de saída).
+// Mesma ideia do micro_test.h do TFLM, sem o loop infinito da versão Pico.
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <stdio.h>
+
+static int host_tests_failed = 0;
+static int host_tests_run = 0;
+
+#define HOST_TEST(name) \
+    static void name(void); \
+    static void name(void)
+
+#define HOST_RUN_TEST(name)                         \
+    do {                                            \
+        int failed_before = host_tests_failed;      \
+        printf("Testing %s\n", #name);              \
+        name();                                     \
+        host_tests_run++;                           \
+        if (host_tests_failed != failed_before) {   \
+            printf("  FAILED %s\n", #name);         \
+        }                                           \
+    } while (0)
+
+#define HOST_EXPECT(x)                                                        \
+    do {                                                                      \
+        if (!(x)) {                                                           \
+            printf("%s:%d: expectativa falhou: %s\n", __FILE__, __LINE__, #x); \
+            host_tests_failed++;                                              \
+        }                                                                     \
+    } while (0)
+
+#define HOST_EXPECT_EQ(x, y)                                                     \
+    do {                                                                         \
+        long long _x = (long long)(x), _y = (long long)(y);                     \
+        if (_x != _y) {                                                          \
+            printf("%s:%d: %s (%lld) != %s (%lld)\n", __FILE__, __LINE__, #x,    \
+                   _x, #y, _y);                                                  \
+            host_tests_failed++;                                                 \
+        }                                                                        \
+    } while (0)
+
+#define HOST_EXPECT_NEAR(x, y, eps)                                              \
+    do {                                                                         \
+        double _x = (double)(x), _y = (double)(y);                              \
+        if (_x - _y > (eps) || _y - _x > (eps)) {                                \
+            printf("%s:%d: %s (%f) !~ %s (%f)\n", __FILE__, __LINE__, #x, _x,    \
+                   #y, _y);                                                      \
+            host_tests_failed++;                                                 \
+        }                                                                        \
+    } while (0)
+
+#define HOST_TESTS_END()                                                  \
+    do {                                                                  \
+        printf("%d/%d tests passed\n", host_tests_run - host_tests_failed, \
+               host_tests_run);                                           \
+        return host_tests_failed == 0 ? 0 : 1;                            \
+    } while (0)
+
+#endif // HOST_TEST_H
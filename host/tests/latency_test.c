@@ -0,0 +1,69 @@
+// Histogramas de latência (lib/latency): baldes log2, mín/máx/média e zerar.
+#include <string.h>
+
+#include "host/tests/host_test.h"
+#include "lib/latency/latency.h"
+
+HOST_TEST(BucketsArePowersOfTwo) {
+    HOST_EXPECT_EQ(latency_bucket(0), 0);
+    HOST_EXPECT_EQ(latency_bucket(1), 1);
+    HOST_EXPECT_EQ(latency_bucket(2), 2);
+    HOST_EXPECT_EQ(latency_bucket(3), 2);
+    HOST_EXPECT_EQ(latency_bucket(4), 3);
+    HOST_EXPECT_EQ(latency_bucket(1023), 10);
+    HOST_EXPECT_EQ(latency_bucket(1024), 11);
+    HOST_EXPECT_EQ(latency_bucket(1u << 22), LATENCY_BUCKETS - 1);
+    HOST_EXPECT_EQ(latency_bucket(UINT32_MAX), LATENCY_BUCKETS - 1);  // Último aberto
+}
+
+HOST_TEST(RecordAccumulates) {
+    latency_reset();
+    latency_record(LAT_INVOKE, 100);
+    latency_record(LAT_INVOKE, 30);
+    latency_record(LAT_INVOKE, 500);
+    latency_record(LAT_GPIO, 0);
+    const LatencyHistogram *h = latency_histogram(LAT_INVOKE);
+    HOST_EXPECT_EQ(h->count, 3u);
+    HOST_EXPECT_EQ(h->min_us, 30u);
+    HOST_EXPECT_EQ(h->max_us, 500u);
+    HOST_EXPECT_EQ(h->total_us, 630u);
+    HOST_EXPECT_EQ(h->buckets[latency_bucket(100)], 1u);
+    HOST_EXPECT_EQ(h->buckets[latency_bucket(30)], 1u);
+    HOST_EXPECT_EQ(h->buckets[latency_bucket(500)], 1u);
+    HOST_EXPECT_EQ(latency_histogram(LAT_GPIO)->buckets[0], 1u);
+    HOST_EXPECT_EQ(latency_histogram(LAT_I2C)->count, 0u);
+    latency_dump();
+}
+
+HOST_TEST(ResetClearsEveryStage) {
+    for (int s = 0; s < LAT_NUM_STAGES; s++) latency_record((LatencyStage)s, 7);
+    latency_reset();
+    for (int s = 0; s < LAT_NUM_STAGES; s++) {
+        const LatencyHistogram *h = latency_histogram((LatencyStage)s);
+        HOST_EXPECT_EQ(h->count, 0u);
+        HOST_EXPECT_EQ(h->max_us, 0u);
+        HOST_EXPECT_EQ(h->total_us, 0u);
+    }
+    // Mín volta a valer depois de zerar
+    latency_record(LAT_SERIAL, 900);
+    HOST_EXPECT_EQ(latency_histogram(LAT_SERIAL)->min_us, 900u);
+}
+
+HOST_TEST(MacrosMeasureTheBlock) {
+    latency_reset();
+    LATENCY_BEGIN(t0);
+    sleep_us(1500);  // Relógio virtual
+    LATENCY_END(LAT_PREPROC, t0);
+    const LatencyHistogram *h = latency_histogram(LAT_PREPROC);
+    HOST_EXPECT_EQ(h->count, 1u);
+    HOST_EXPECT(h->min_us >= 1500u && h->min_us < 1500u + 100000u);
+    HOST_EXPECT_EQ(strcmp(latency_stage_name(LAT_PREPROC), "preproc"), 0);
+}
+
+int main(void) {
+    HOST_RUN_TEST(BucketsArePowersOfTwo);
+    HOST_RUN_TEST(RecordAccumulates);
+    HOST_RUN_TEST(ResetClearsEveryStage);
+    HOST_RUN_TEST(MacrosMeasureTheBlock);
+    HOST_TESTS_END();
+}
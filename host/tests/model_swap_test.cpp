@@ -0,0 +1,227 @@
+// Troca de modelo em execução: imagens inválidas são recusadas sem afetar o
+// modelo ativo, a troca acontece entre duas inferências sem mudar nenhuma
+// decisão, e a gravação de slot sobrevive a uma queda de energia.
+#include <string.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "host/tests/captures.h"
+#include "host/tests/host_test.h"
+#include "lib/model_slot/model_slot.h"
+#include "lib/recorder/flash_file.h"
+#include "modelo_predator.h"
+#include "modelo_predator_arena.h"
+#include "tflm_wrapper.h"
+
+static std::vector<uint8_t> pack(uint32_t generation, uint32_t schema = TFLM_MODEL_SCHEMA_VERSION,
+                                 uint32_t arena = MODELO_ARENA_SIZE) {
+    std::vector<uint8_t> image(MODEL_SLOT_HEADER_BYTES + modelo_tflite_len);
+    const uint32_t len = model_slot_pack(modelo_tflite, modelo_tflite_len, schema, arena, generation,
+                                         image.data(), (uint32_t)image.size());
+    image.resize(len);
+    return image;
+}
+
+// Serviço até READY/FAILED; retorna o estado final
+static TflmSwapState run_swap(const std::vector<uint8_t>& image) {
+    if (tflm_swap_begin(image.data(), (uint32_t)image.size()) != 0) return TFLM_SWAP_FAILED;
+    TflmSwapState s;
+    while ((s = tflm_swap_service()) == TFLM_SWAP_CHECKING || s == TFLM_SWAP_PREPARING) {
+    }
+    return s;
+}
+
+// Entradas z-score de todas as capturas
+static std::vector<float> load_inputs(void) {
+    std::vector<float> inputs;
+    for (int f = 0; f < HOST_NUM_CAPTURES; f++) {
+        FILE* fp = fopen(host_captures[f], "r");
+        if (!fp) continue;
+        float v[5];
+        while (host_read_capture_row(fp, v)) {
+            inputs.push_back(((v[1] - v[3]) - HOST_MEAN_DELTA_T) / HOST_STD_DELTA_T);
+            inputs.push_back(((v[2] - v[4]) - HOST_MEAN_DELTA_U) / HOST_STD_DELTA_U);
+        }
+        fclose(fp);
+    }
+    return inputs;
+}
+
+HOST_TEST(RejectsInvalidImages) {
+    const uint32_t epoch = tflm_model_epoch();
+    TflmSwapStats before;
+    tflm_swap_stats(&before);
+    int8_t* input_before = tflm_input_ptr(nullptr);
+
+    std::vector<uint8_t> bad_magic = pack(1);
+    bad_magic[0] ^= 0x01;
+    std::vector<uint8_t> bad_header = pack(1);
+    bad_header[24] ^= 0x01;  // Geração sem recalcular o CRC do cabeçalho
+    std::vector<uint8_t> bad_model = pack(1);
+    bad_model[MODEL_SLOT_HEADER_BYTES + modelo_tflite_len / 2] ^= 0x10;
+    std::vector<uint8_t> truncated = pack(1);
+    truncated.resize(truncated.size() - 1);
+    std::vector<uint8_t> old_schema = pack(1, TFLM_MODEL_SCHEMA_VERSION - 1);
+    std::vector<uint8_t> huge_arena = pack(1, TFLM_MODEL_SCHEMA_VERSION, 1u << 20);
+    std::vector<uint8_t> erased(MODEL_SLOT_BYTES, 0xFF);
+    // CRC certo sobre bytes que não são um flatbuffer
+    std::vector<uint8_t> garbage(MODEL_SLOT_HEADER_BYTES + 512);
+    std::vector<uint8_t> junk(512);
+    for (size_t i = 0; i < junk.size(); i++) junk[i] = (uint8_t)(i * 37 + 11);
+    model_slot_pack(junk.data(), (uint32_t)junk.size(), TFLM_MODEL_SCHEMA_VERSION, 0, 1,
+                    garbage.data(), (uint32_t)garbage.size());
+
+    const std::vector<uint8_t>* cases[] = {&bad_magic, &bad_header, &bad_model, &truncated,
+                                           &old_schema, &huge_arena, &erased, &garbage};
+    for (const std::vector<uint8_t>* c : cases) {
+        HOST_EXPECT_EQ(run_swap(*c), TFLM_SWAP_FAILED);
+        HOST_EXPECT_EQ(tflm_swap_commit(), 1);
+        tflm_swap_cancel();
+    }
+
+    TflmSwapStats after;
+    tflm_swap_stats(&after);
+    HOST_EXPECT_EQ(after.rejected - before.rejected, 8);
+    HOST_EXPECT_EQ(after.swaps, before.swaps);
+    HOST_EXPECT_EQ(tflm_model_epoch(), epoch);
+    HOST_EXPECT(tflm_input_ptr(nullptr) == input_before);
+
+    // O modelo ativo continua respondendo
+    float inputs[2] = {0.5f, -0.5f};
+    TflmDecision d;
+    HOST_EXPECT_EQ(tflm_classify(inputs, &d), 0);
+}
+
+// Inferência contínua sobre as capturas; a cada 997 amostras começa uma troca
+// com um passo de serviço entre duas inferências, como no loop do firmware
+HOST_TEST(SwapBetweenInferencesKeepsDecisions) {
+    const std::vector<float> inputs = load_inputs();
+    const int rows = (int)(inputs.size() / 2);
+    HOST_EXPECT(rows > 10000);
+
+    std::vector<int> reference(rows);
+    for (int i = 0; i < rows; i++) {
+        TflmDecision d;
+        tflm_classify(&inputs[2 * i], &d);
+        reference[i] = d.class_index;
+    }
+
+    const std::vector<uint8_t> images[2] = {pack(2), pack(3)};
+    const int arena_before = tflm_arena_used_bytes();
+    TflmSwapStats before;
+    tflm_swap_stats(&before);
+    int mismatches = 0, swaps = 0, max_gap = 0, started_at = -1;
+    uint32_t max_commit_us = 0, max_step_us = 0, max_prepare_us = 0;
+    for (int i = 0; i < rows; i++) {
+        if (i % 997 == 0 && started_at < 0) {
+            HOST_EXPECT_EQ(tflm_swap_begin(images[swaps % 2].data(), (uint32_t)images[swaps % 2].size()), 0);
+            started_at = i;
+        }
+        if (started_at >= 0) {
+            const TflmSwapState s = tflm_swap_service();
+            HOST_EXPECT(s != TFLM_SWAP_FAILED);
+            if (s == TFLM_SWAP_READY) {
+                int8_t* old_input = tflm_input_ptr(nullptr);
+                HOST_EXPECT_EQ(tflm_swap_commit(), 0);
+                HOST_EXPECT(tflm_input_ptr(nullptr) != old_input);  // Outra instância
+                TflmSwapStats st;
+                tflm_swap_stats(&st);
+                if (st.commit_us > max_commit_us) max_commit_us = st.commit_us;
+                if (st.max_step_us > max_step_us) max_step_us = st.max_step_us;
+                if (st.prepare_us > max_prepare_us) max_prepare_us = st.prepare_us;
+                if (i - started_at > max_gap) max_gap = i - started_at;
+                started_at = -1;
+                swaps++;
+            }
+        }
+        TflmDecision d;
+        HOST_EXPECT_EQ(tflm_classify(&inputs[2 * i], &d), 0);
+        mismatches += d.class_index != reference[i];
+    }
+
+    TflmSwapStats after;
+    tflm_swap_stats(&after);
+    printf("  %d amostras, %d trocas, %d decisões divergentes | preparo máx %u us em até %d passos "
+           "(passo máx %u us) | troca máx %u us | arena %d + %d = pico %d de 2 x %d bytes\n",
+           rows, swaps, mismatches, max_prepare_us, max_gap + 1, max_step_us, max_commit_us,
+           after.active_arena_bytes, after.peak_arena_bytes - after.active_arena_bytes,
+           after.peak_arena_bytes, after.arena_capacity_bytes);
+    HOST_EXPECT(swaps >= 10);
+    HOST_EXPECT_EQ(mismatches, 0);
+    HOST_EXPECT_EQ(after.swaps - before.swaps, swaps);
+    HOST_EXPECT_EQ(after.rejected, before.rejected);
+    HOST_EXPECT_EQ(tflm_arena_used_bytes(), arena_before);  // Nada vaza entre trocas
+    HOST_EXPECT_EQ(after.peak_arena_bytes, 2 * arena_before);
+    HOST_EXPECT(after.peak_arena_bytes <= 2 * after.arena_capacity_bytes);
+    HOST_EXPECT(max_commit_us < 1000);
+}
+
+HOST_TEST(SlotWriterSurvivesPowerLoss) {
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/model_swap_test_%d.bin", (int)getpid());
+    unlink(path);
+    FlashFile file;
+    FlashDevice dev;
+    HOST_EXPECT(flash_file_open(&file, path, MODEL_SLOT_REGION_BYTES, false, &dev));
+
+    // Pedaços de tamanho ímpar, como chegam pela serial
+    auto write_slot = [&](int slot, const std::vector<uint8_t>& image) {
+        ModelSlotWriter w;
+        bool ok = model_slot_writer_begin(&w, &dev, slot, (uint32_t)image.size());
+        for (size_t pos = 0; ok && pos < image.size(); pos += 77) {
+            const size_t n = image.size() - pos < 77 ? image.size() - pos : 77;
+            ok = model_slot_writer_put(&w, image.data() + pos, (uint32_t)n);
+        }
+        return ok && model_slot_writer_finish(&w);
+    };
+    const std::vector<uint8_t> gen4 = pack(4), gen5 = pack(5), gen6 = pack(6);
+    HOST_EXPECT(write_slot(0, gen4));
+    HOST_EXPECT(write_slot(1, gen5));
+
+    std::vector<uint8_t> region(MODEL_SLOT_REGION_BYTES);
+    auto newest = [&](ModelSlotHeader* h) {
+        dev.read(dev.ctx, 0, region.data(), MODEL_SLOT_REGION_BYTES);
+        const uint8_t* images[MODEL_SLOT_COUNT] = {region.data(), region.data() + MODEL_SLOT_BYTES};
+        return model_slot_newest(images, TFLM_MODEL_SCHEMA_VERSION, h);
+    };
+    ModelSlotHeader h;
+    HOST_EXPECT_EQ(newest(&h), 1);
+    HOST_EXPECT_EQ(h.generation, 5);
+    HOST_EXPECT(memcmp(region.data() + MODEL_SLOT_BYTES, gen5.data(), gen5.size()) == 0);
+    HOST_EXPECT_EQ(run_swap(std::vector<uint8_t>(region.begin() + MODEL_SLOT_BYTES, region.end())),
+                   TFLM_SWAP_READY);
+    tflm_swap_cancel();
+
+    // Queda em qualquer ponto da regravação do slot 0: ou fica o slot 1, ou a
+    // imagem nova completa; nunca um cabeçalho válido com o modelo pela metade
+    int survived = 0;
+    for (uint32_t budget = 0; budget < 2 * FLASH_DEV_SECTOR_BYTES + gen6.size(); budget += 613) {
+        flash_file_close(&file);
+        HOST_EXPECT(flash_file_open(&file, path, 0, false, &dev));
+        flash_file_cut_power_after(&file, budget, budget);
+        write_slot(0, gen6);
+        flash_file_close(&file);
+        HOST_EXPECT(flash_file_open(&file, path, 0, false, &dev));
+        const int slot = newest(&h);
+        if (slot == 0) {
+            HOST_EXPECT_EQ(h.generation, 6);
+            HOST_EXPECT(memcmp(region.data(), gen6.data(), gen6.size()) == 0);
+        } else {
+            HOST_EXPECT_EQ(slot, 1);
+            survived++;
+        }
+    }
+    HOST_EXPECT(survived > 0);
+    HOST_EXPECT_EQ(file.nor_violations, 0);
+    flash_file_close(&file);
+    unlink(path);
+}
+
+int main(void) {
+    HOST_EXPECT_EQ(tflm_init_ex(TFLM_STRIP_SOFTMAX), 0);
+    HOST_RUN_TEST(RejectsInvalidImages);
+    HOST_RUN_TEST(SwapBetweenInferencesKeepsDecisions);
+    HOST_RUN_TEST(SlotWriterSurvivesPowerLoss);
+    HOST_TESTS_END();
+}
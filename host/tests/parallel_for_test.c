@@ -0,0 +1,460 @@
+// Worker persistente do core 1 no pico-tflmicro (parallel_for), blocos pegos
+// por quem estiver livre, e kernels CMSIS-NN divididos entre os cores (matmul,
+// depthwise, fully connected), comparados com uma referência escalar.
+#define _POSIX_C_SOURCE 200809L
+
+#include <sched.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host/tests/host_test.h"
+#include "pico/multicore.h"
+#include "pico/time.h"
+#include "tensorflow/lite/micro/pico/parallel_for.h"
+#include "third_party/cmsis_nn/Include/arm_nnfunctions.h"
+#include "third_party/cmsis_nn/Include/arm_nnsupportfunctions.h"
+
+#define MAX_ITEMS 64
+
+static int item_core[MAX_ITEMS];
+static int item_hits[MAX_ITEMS];
+
+static void mark_items(int32_t begin, int32_t end, void *ctx) {
+    (void)ctx;
+    for (int32_t i = begin; i < end; i++) {
+        item_core[i] = (int)get_core_num();
+        __atomic_fetch_add(&item_hits[i], 1, __ATOMIC_RELAXED);
+    }
+}
+
+static void clear_items(void) {
+    memset(item_core, -1, sizeof(item_core));
+    memset(item_hits, 0, sizeof(item_hits));
+}
+
+// Blocos em que parallel_for corta n itens
+static uint32_t expected_chunks(int32_t n) {
+    const int32_t total = TFLM_PARALLEL_WORKERS * TFLM_PARALLEL_CHUNKS_PER_WORKER;
+    const int32_t chunk = (n + total - 1) / total;
+    return (uint32_t)((n + chunk - 1) / chunk);
+}
+
+HOST_TEST(CoversRangeExactlyOnce) {
+    tflm_parallel_reset_stats();
+    uint32_t chunks = 0;
+    // Tamanhos pares e ímpares, menores e maiores que um bloco por core
+    for (int32_t n = 2; n <= MAX_ITEMS; n += (n < 20 ? 1 : 7)) {
+        clear_items();
+        tflm_parallel_for(0, n, mark_items, NULL);
+        for (int32_t i = 0; i < n; i++) HOST_EXPECT_EQ(item_hits[i], 1);
+        HOST_EXPECT_EQ(item_hits[n], 0);
+        chunks += expected_chunks(n);
+    }
+    // Intervalo que não começa em zero
+    clear_items();
+    tflm_parallel_for(10, 15, mark_items, NULL);
+    HOST_EXPECT_EQ(item_hits[9] + item_hits[15], 0);
+    for (int32_t i = 10; i < 15; i++) HOST_EXPECT_EQ(item_hits[i], 1);
+    chunks += expected_chunks(5);
+
+    TflmParallelStats st;
+    tflm_parallel_get_stats(&st);
+    HOST_EXPECT_EQ(st.jobs, 26u);
+    HOST_EXPECT_EQ(st.launches, 1u);  // Um lançamento só para todas as chamadas
+    HOST_EXPECT_EQ(st.chunks[0] + st.chunks[1], chunks);
+}
+
+// ------------------------------------------------------------
+// Roubo de trabalho: o core que pegar o primeiro bloco trava nele até o outro
+// esvaziar o resto do intervalo, como um core parado por uma interrupção longa
+// ------------------------------------------------------------
+#define STEAL_ITEMS 32
+#define STEAL_WAIT_US 2000000u
+
+static int steal_done;
+
+static void stall_first_chunk(int32_t begin, int32_t end, void *ctx) {
+    (void)ctx;
+    if (begin == 0) {
+        const uint64_t t0 = time_us_64();
+        while (__atomic_load_n(&steal_done, __ATOMIC_ACQUIRE) < STEAL_ITEMS - (end - begin) &&
+               time_us_64() - t0 < STEAL_WAIT_US) {
+            sched_yield();
+        }
+    }
+    mark_items(begin, end, NULL);
+    __atomic_fetch_add(&steal_done, end - begin, __ATOMIC_RELEASE);
+}
+
+HOST_TEST(IdleCoreTakesRemainingChunks) {
+    tflm_parallel_reset_stats();
+    clear_items();
+    steal_done = 0;
+    tflm_parallel_for(0, STEAL_ITEMS, stall_first_chunk, NULL);
+    for (int32_t i = 0; i < STEAL_ITEMS; i++) HOST_EXPECT_EQ(item_hits[i], 1);
+
+    TflmParallelStats st;
+    tflm_parallel_get_stats(&st);
+    const int stalled = item_core[0], other = 1 - stalled;
+    HOST_EXPECT(stalled == 0 || stalled == 1);
+    HOST_EXPECT_EQ(st.chunks[stalled], 1u);
+    HOST_EXPECT_EQ(st.chunks[other], expected_chunks(STEAL_ITEMS) - 1);
+    // O outro core acabou antes e esperou pelo bloco travado
+    HOST_EXPECT(st.busy_us[stalled] >= st.busy_us[other]);
+    HOST_EXPECT(st.idle_us[other] >= st.idle_us[stalled]);
+    printf("  core 0: %lu blocos, ocupado %llu us, ocioso %llu us\n", (unsigned long)st.chunks[0],
+           (unsigned long long)st.busy_us[0], (unsigned long long)st.idle_us[0]);
+    printf("  core 1: %lu blocos, ocupado %llu us, ocioso %llu us\n", (unsigned long)st.chunks[1],
+           (unsigned long long)st.busy_us[1], (unsigned long long)st.idle_us[1]);
+}
+
+HOST_TEST(TinyRangesRunInline) {
+    tflm_parallel_reset_stats();
+    clear_items();
+    tflm_parallel_for(0, 0, mark_items, NULL);
+    tflm_parallel_for(5, 3, mark_items, NULL);
+    tflm_parallel_for(3, 4, mark_items, NULL);
+    HOST_EXPECT_EQ(item_hits[3], 1);
+    HOST_EXPECT_EQ(item_core[3], 0);
+    TflmParallelStats st;
+    tflm_parallel_get_stats(&st);
+    HOST_EXPECT_EQ(st.jobs, 0u);
+    HOST_EXPECT_EQ(st.inline_runs, 3u);
+}
+
+// Chamada aninhada (de dentro de um job, nos dois cores) roda no próprio core
+static void nested_items(int32_t begin, int32_t end, void *ctx) {
+    (void)ctx;
+    tflm_parallel_for(begin, end, mark_items, NULL);
+}
+
+HOST_TEST(NestedCallsRunInline) {
+    tflm_parallel_reset_stats();
+    clear_items();
+    tflm_parallel_for(0, 40, nested_items, NULL);
+    for (int32_t i = 0; i < 40; i++) HOST_EXPECT_EQ(item_hits[i], 1);
+    TflmParallelStats st;
+    tflm_parallel_get_stats(&st);
+    HOST_EXPECT_EQ(st.jobs, 1u);
+    HOST_EXPECT_EQ(st.inline_runs, expected_chunks(40));  // Uma por bloco
+}
+
+// ------------------------------------------------------------
+// arm_nn_mat_mult_nt_t_s8 contra a conta direta
+// ------------------------------------------------------------
+static uint32_t rng_state = 12345u;
+static int8_t rand_s8(void) {
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return (int8_t)(rng_state >> 24);
+}
+
+static void mat_mult_reference(const int8_t *lhs, const int8_t *rhs, const int32_t *bias,
+                               int8_t *dst, const int32_t *mult, const int32_t *shift,
+                               int32_t lhs_rows, int32_t rhs_rows, int32_t rhs_cols,
+                               int32_t lhs_offset, int32_t dst_offset, int32_t act_min,
+                               int32_t act_max) {
+    for (int32_t i = 0; i < lhs_rows; i++) {
+        for (int32_t j = 0; j < rhs_rows; j++) {
+            int32_t acc = bias[j];
+            for (int32_t k = 0; k < rhs_cols; k++) {
+                acc += (lhs[i * rhs_cols + k] + lhs_offset) * rhs[j * rhs_cols + k];
+            }
+            acc = arm_nn_requantize(acc, mult[j], shift[j]) + dst_offset;
+            acc = acc < act_min ? act_min : acc > act_max ? act_max : acc;
+            dst[i * rhs_rows + j] = (int8_t)acc;
+        }
+    }
+}
+
+static bool check_mat_mult(int32_t lhs_rows, int32_t rhs_rows, int32_t rhs_cols) {
+    int8_t *lhs = malloc((size_t)(lhs_rows * rhs_cols));
+    int8_t *rhs = malloc((size_t)(rhs_rows * rhs_cols));
+    int32_t *bias = malloc(sizeof(int32_t) * (size_t)rhs_rows);
+    int32_t *mult = malloc(sizeof(int32_t) * (size_t)rhs_rows);
+    int32_t *shift = malloc(sizeof(int32_t) * (size_t)rhs_rows);
+    int8_t *got = malloc((size_t)(lhs_rows * rhs_rows));
+    int8_t *want = malloc((size_t)(lhs_rows * rhs_rows));
+    for (int32_t i = 0; i < lhs_rows * rhs_cols; i++) lhs[i] = rand_s8();
+    for (int32_t i = 0; i < rhs_rows * rhs_cols; i++) rhs[i] = rand_s8();
+    for (int32_t j = 0; j < rhs_rows; j++) {
+        bias[j] = rand_s8() * 37;
+        mult[j] = 0x40000000 + rand_s8() * 0x100000;
+        shift[j] = -6 - (j % 4);
+    }
+    const int32_t lhs_offset = 11, dst_offset = -3;
+    mat_mult_reference(lhs, rhs, bias, want, mult, shift, lhs_rows, rhs_rows, rhs_cols,
+                       lhs_offset, dst_offset, -128, 127);
+    memset(got, 0x5A, (size_t)(lhs_rows * rhs_rows));
+    const arm_cmsis_nn_status status =
+        arm_nn_mat_mult_nt_t_s8(lhs, rhs, bias, got, mult, shift, lhs_rows, rhs_rows, rhs_cols,
+                                lhs_offset, dst_offset, -128, 127, rhs_rows, rhs_cols);
+    const bool ok = status == ARM_CMSIS_NN_SUCCESS &&
+                    memcmp(got, want, (size_t)(lhs_rows * rhs_rows)) == 0;
+    if (!ok) printf("  matmul %dx%d x %d difere\n", lhs_rows, rhs_cols, rhs_rows);
+    free(lhs); free(rhs); free(bias); free(mult); free(shift); free(got); free(want);
+    return ok;
+}
+
+HOST_TEST(MatMulMatchesReference) {
+    // Linhas do rhs ímpares, menores que um par por core, menos pares que blocos
+    // e linhas do lhs ímpares
+    static const int32_t shapes[][3] = {
+        {1, 1, 3}, {2, 2, 4}, {3, 3, 5}, {4, 5, 8}, {7, 7, 9}, {1, 4, 1}, {1, 35, 2},
+        {9, 16, 27}, {16, 33, 12}, {25, 64, 72}, {31, 95, 16}, {3, 129, 7},
+    };
+    tflm_parallel_reset_stats();
+    for (size_t s = 0; s < sizeof(shapes) / sizeof(shapes[0]); s++) {
+        HOST_EXPECT(check_mat_mult(shapes[s][0], shapes[s][1], shapes[s][2]));
+    }
+    // Chamadas repetidas reaproveitam o mesmo worker
+    for (int rep = 0; rep < 50; rep++) HOST_EXPECT(check_mat_mult(8, 10 + rep % 3, 20));
+    TflmParallelStats st;
+    tflm_parallel_get_stats(&st);
+    HOST_EXPECT_EQ(st.launches, 0u);
+    HOST_EXPECT(st.jobs > 50u);
+}
+
+// ------------------------------------------------------------
+// Fully connected (arm_nn_vec_mat_mult_t_s8 e _per_ch_s8, divididos por
+// neurônio de saída) contra a conta direta
+// ------------------------------------------------------------
+static bool check_fully_connected(int32_t batches, int32_t in_n, int32_t out_n,
+                                  int32_t filter_offset, bool per_channel) {
+    int8_t *input = malloc((size_t)(batches * in_n));
+    int8_t *weights = malloc((size_t)(out_n * in_n));
+    int32_t *bias = malloc(sizeof(int32_t) * (size_t)out_n);
+    int32_t *mult = malloc(sizeof(int32_t) * (size_t)out_n);
+    int32_t *shift = malloc(sizeof(int32_t) * (size_t)out_n);
+    int8_t *got = malloc((size_t)(batches * out_n));
+    int8_t *want = malloc((size_t)(batches * out_n));
+    for (int32_t i = 0; i < batches * in_n; i++) input[i] = rand_s8();
+    for (int32_t i = 0; i < out_n * in_n; i++) weights[i] = rand_s8();
+    for (int32_t j = 0; j < out_n; j++) {
+        bias[j] = rand_s8() * 29;
+        // Por tensor: o mesmo multiplicador para todos os neurônios
+        mult[j] = per_channel ? 0x40000000 + rand_s8() * 0x100000 : 0x50000000;
+        shift[j] = per_channel ? -6 - (j % 3) : -7;
+    }
+    const int32_t input_offset = 9, output_offset = -4;
+    for (int32_t b = 0; b < batches; b++)
+        for (int32_t j = 0; j < out_n; j++) {
+            int32_t acc = bias[j];
+            for (int32_t k = 0; k < in_n; k++) {
+                acc += (input[b * in_n + k] + input_offset) * (weights[j * in_n + k] + filter_offset);
+            }
+            acc = arm_nn_requantize(acc, mult[j], shift[j]) + output_offset;
+            acc = acc < -128 ? -128 : acc > 127 ? 127 : acc;
+            want[b * out_n + j] = (int8_t)acc;
+        }
+
+    const cmsis_nn_fc_params params = {input_offset, filter_offset, output_offset, {-128, 127}};
+    const cmsis_nn_dims input_dims = {batches, 1, 1, in_n};
+    const cmsis_nn_dims filter_dims = {in_n, 1, 1, out_n};
+    const cmsis_nn_dims bias_dims = {1, 1, 1, out_n};
+    const cmsis_nn_dims output_dims = {batches, 1, 1, out_n};
+    // Sem MVE o kernel não usa as somas do filtro
+    const cmsis_nn_context ctx = {NULL, 0};
+    memset(got, 0x5A, (size_t)(batches * out_n));
+    arm_cmsis_nn_status status;
+    if (per_channel) {
+        const cmsis_nn_per_channel_quant_params quant = {mult, shift};
+        status = arm_fully_connected_per_channel_s8(&ctx, &params, &quant, &input_dims, input,
+                                                    &filter_dims, weights, &bias_dims, bias,
+                                                    &output_dims, got);
+    } else {
+        const cmsis_nn_per_tensor_quant_params quant = {mult[0], shift[0]};
+        status = arm_fully_connected_s8(&ctx, &params, &quant, &input_dims, input, &filter_dims,
+                                        weights, &bias_dims, bias, &output_dims, got);
+    }
+    const bool ok = status == ARM_CMSIS_NN_SUCCESS &&
+                    memcmp(got, want, (size_t)(batches * out_n)) == 0;
+    if (!ok) {
+        printf("  fully connected %dx%d -> %d (offset %d, %s) difere\n", batches, in_n, out_n,
+               filter_offset, per_channel ? "por canal" : "por tensor");
+    }
+    free(input); free(weights); free(bias); free(mult); free(shift); free(got); free(want);
+    return ok;
+}
+
+HOST_TEST(FullyConnectedMatchesReference) {
+    // batches, entradas, neurônios: neurônios ímpares, menos grupos que blocos,
+    // um grupo só e camadas maiores que um bloco por core
+    static const int32_t shapes[][3] = {
+        {1, 1, 1}, {1, 3, 2}, {1, 5, 3}, {2, 7, 5}, {1, 16, 7}, {3, 9, 10},
+        {1, 33, 31}, {4, 20, 64}, {1, 64, 95}, {2, 128, 129}, {1, 4, 200},
+    };
+    tflm_parallel_reset_stats();
+    for (size_t s = 0; s < sizeof(shapes) / sizeof(shapes[0]); s++) {
+        for (int per_channel = 0; per_channel < 2; per_channel++) {
+            // Com offset no filtro os kernels seguem outro caminho
+            HOST_EXPECT(check_fully_connected(shapes[s][0], shapes[s][1], shapes[s][2], 0,
+                                              per_channel));
+            HOST_EXPECT(check_fully_connected(shapes[s][0], shapes[s][1], shapes[s][2], 3,
+                                              per_channel));
+        }
+    }
+    TflmParallelStats st;
+    tflm_parallel_get_stats(&st);
+    HOST_EXPECT(st.jobs > 0u);
+    HOST_EXPECT(st.inline_runs > 0u);  // {1, 1, 1}: um grupo, fica no core 0
+
+    // Desligado, nada vai para o core 1 e a saída é a mesma
+    tflm_parallel_set_enabled(false);
+    tflm_parallel_reset_stats();
+    HOST_EXPECT(check_fully_connected(2, 128, 129, 0, true));
+    tflm_parallel_get_stats(&st);
+    HOST_EXPECT_EQ(st.jobs, 0u);
+    tflm_parallel_set_enabled(true);
+}
+
+// ------------------------------------------------------------
+// Depthwise (wrapper: 3x3, _opt e genérico) contra a conta direta
+// ------------------------------------------------------------
+typedef struct {
+    int32_t batches, in_h, in_w, in_ch, ch_mult, ker, stride, pad, dilation;
+} DwShape;
+
+static bool check_depthwise(const DwShape *d) {
+    const int32_t out_ch = d->in_ch * d->ch_mult;
+    const int32_t span = d->dilation * (d->ker - 1) + 1;
+    const int32_t out_h = (d->in_h + 2 * d->pad - span) / d->stride + 1;
+    const int32_t out_w = (d->in_w + 2 * d->pad - span) / d->stride + 1;
+    const size_t in_size = (size_t)(d->batches * d->in_h * d->in_w * d->in_ch);
+    const size_t out_size = (size_t)(d->batches * out_h * out_w * out_ch);
+    int8_t *input = malloc(in_size);
+    int8_t *kernel = malloc((size_t)(d->ker * d->ker * out_ch));
+    int32_t *bias = malloc(sizeof(int32_t) * (size_t)out_ch);
+    int32_t *mult = malloc(sizeof(int32_t) * (size_t)out_ch);
+    int32_t *shift = malloc(sizeof(int32_t) * (size_t)out_ch);
+    int8_t *got = malloc(out_size);
+    int8_t *want = malloc(out_size);
+    for (size_t i = 0; i < in_size; i++) input[i] = rand_s8();
+    for (int32_t i = 0; i < d->ker * d->ker * out_ch; i++) kernel[i] = rand_s8();
+    for (int32_t c = 0; c < out_ch; c++) {
+        bias[c] = rand_s8() * 23;
+        mult[c] = 0x40000000 + rand_s8() * 0x100000;
+        shift[c] = -5 - (c % 3);
+    }
+    const int32_t input_offset = 7, output_offset = -2;
+
+    for (int32_t b = 0; b < d->batches; b++)
+        for (int32_t oy = 0; oy < out_h; oy++)
+            for (int32_t ox = 0; ox < out_w; ox++)
+                for (int32_t oc = 0; oc < out_ch; oc++) {
+                    const int32_t ic = oc / d->ch_mult;
+                    int32_t acc = bias[oc];
+                    for (int32_t ky = 0; ky < d->ker; ky++)
+                        for (int32_t kx = 0; kx < d->ker; kx++) {
+                            const int32_t iy = oy * d->stride - d->pad + ky * d->dilation;
+                            const int32_t ix = ox * d->stride - d->pad + kx * d->dilation;
+                            if (iy < 0 || iy >= d->in_h || ix < 0 || ix >= d->in_w) continue;
+                            const int8_t v =
+                                input[((b * d->in_h + iy) * d->in_w + ix) * d->in_ch + ic];
+                            acc += (v + input_offset) * kernel[(ky * d->ker + kx) * out_ch + oc];
+                        }
+                    acc = arm_nn_requantize(acc, mult[oc], shift[oc]) + output_offset;
+                    acc = acc < -128 ? -128 : acc > 127 ? 127 : acc;
+                    want[((b * out_h + oy) * out_w + ox) * out_ch + oc] = (int8_t)acc;
+                }
+
+    const cmsis_nn_dw_conv_params params = {input_offset, output_offset, d->ch_mult,
+                                            {d->stride, d->stride}, {d->pad, d->pad},
+                                            {d->dilation, d->dilation}, {-128, 127}};
+    const cmsis_nn_per_channel_quant_params quant = {mult, shift};
+    const cmsis_nn_dims input_dims = {d->batches, d->in_h, d->in_w, d->in_ch};
+    const cmsis_nn_dims filter_dims = {1, d->ker, d->ker, out_ch};
+    const cmsis_nn_dims bias_dims = {1, 1, 1, out_ch};
+    const cmsis_nn_dims output_dims = {d->batches, out_h, out_w, out_ch};
+    cmsis_nn_context ctx = {NULL, 0};
+    ctx.size = arm_depthwise_conv_wrapper_s8_get_buffer_size(&params, &input_dims, &filter_dims,
+                                                             &output_dims);
+    if (ctx.size > 0) ctx.buf = malloc((size_t)ctx.size);
+    memset(got, 0x5A, out_size);
+    const arm_cmsis_nn_status status =
+        arm_depthwise_conv_wrapper_s8(&ctx, &params, &quant, &input_dims, input, &filter_dims,
+                                      kernel, &bias_dims, bias, &output_dims, got);
+    const bool ok = status == ARM_CMSIS_NN_SUCCESS && memcmp(got, want, out_size) == 0;
+    if (!ok) {
+        printf("  depthwise %dx%dx%dx%d k%d s%d p%d d%d m%d difere\n", d->batches, d->in_h,
+               d->in_w, d->in_ch, d->ker, d->stride, d->pad, d->dilation, d->ch_mult);
+    }
+    free(ctx.buf);
+    free(input); free(kernel); free(bias); free(mult); free(shift); free(got); free(want);
+    return ok;
+}
+
+HOST_TEST(DepthwiseMatchesReference) {
+    static const DwShape shapes[] = {
+        // batches, h, w, ch, mult, ker, stride, pad, dil
+        {1, 7, 5, 6, 1, 3, 1, 1, 1},   // 3x3, linhas ímpares, canais fora de múltiplo de 4
+        {1, 9, 9, 8, 1, 3, 2, 1, 1},   // 3x3 com passo 2
+        {1, 1, 4, 4, 1, 3, 1, 1, 1},   // Uma linha de saída: roda inteira no core 0
+        {1, 6, 6, 5, 1, 5, 1, 2, 1},   // 5x5: _opt, que no M0+/host cai no genérico
+        {1, 6, 5, 3, 4, 3, 1, 1, 1},   // Multiplicador 4
+        {3, 5, 4, 3, 2, 3, 1, 2, 2},   // Genérico: lotes e dilatação
+    };
+    tflm_parallel_reset_stats();
+    for (size_t s = 0; s < sizeof(shapes) / sizeof(shapes[0]); s++) {
+        HOST_EXPECT(check_depthwise(&shapes[s]));
+    }
+    TflmParallelStats st;
+    tflm_parallel_get_stats(&st);
+    HOST_EXPECT_EQ(st.jobs, 5u);
+    HOST_EXPECT_EQ(st.inline_runs, 1u);
+}
+
+// ------------------------------------------------------------
+// Custo de despachar: worker persistente contra reset + launch por chamada
+// (o que a matmul fazia antes). Só informativo: depende da máquina.
+// ------------------------------------------------------------
+#define DISPATCH_CALLS 2000
+
+static void noop_items(int32_t begin, int32_t end, void *ctx) {
+    (void)begin; (void)end; (void)ctx;
+}
+
+static void relaunch_entry(void) {
+    multicore_fifo_push_blocking(0);
+}
+
+HOST_TEST(DispatchCost) {
+    uint64_t t0 = time_us_64();
+    for (int i = 0; i < DISPATCH_CALLS; i++) tflm_parallel_for(0, 2, noop_items, NULL);
+    const uint64_t persistent_us = time_us_64() - t0;
+
+    tflm_parallel_stop();
+    t0 = time_us_64();
+    for (int i = 0; i < DISPATCH_CALLS; i++) {
+        multicore_reset_core1();
+        multicore_launch_core1(relaunch_entry);
+        multicore_fifo_pop_blocking();
+    }
+    const uint64_t relaunch_us = time_us_64() - t0;
+    multicore_reset_core1();
+
+    printf("  despacho: persistente %.2f us/chamada, relançando %.2f us/chamada\n",
+           (double)persistent_us / DISPATCH_CALLS, (double)relaunch_us / DISPATCH_CALLS);
+
+    // Depois do stop o próximo parallel_for lança o worker de novo
+    tflm_parallel_reset_stats();
+    clear_items();
+    tflm_parallel_for(0, 4, mark_items, NULL);
+    for (int32_t i = 0; i < 4; i++) HOST_EXPECT_EQ(item_hits[i], 1);
+    TflmParallelStats st;
+    tflm_parallel_get_stats(&st);
+    HOST_EXPECT_EQ(st.launches, 1u);
+    tflm_parallel_stop();
+}
+
+int main(void) {
+    HOST_RUN_TEST(CoversRangeExactlyOnce);
+    HOST_RUN_TEST(IdleCoreTakesRemainingChunks);
+    HOST_RUN_TEST(TinyRangesRunInline);
+    HOST_RUN_TEST(NestedCallsRunInline);
+    HOST_RUN_TEST(MatMulMatchesReference);
+    HOST_RUN_TEST(FullyConnectedMatchesReference);
+    HOST_RUN_TEST(DepthwiseMatchesReference);
+    HOST_RUN_TEST(DispatchCost);
+    HOST_TESTS_END();
+}
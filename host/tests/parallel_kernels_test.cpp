@@ -0,0 +1,133 @@
+// Kernels nos dois cores escolhidos por nó no Prepare (MicroContext::
+// UseParallelKernels): nós pequenos ficam no core 0, os grandes dividem a
+// matmul, e desligar pelo interpreter não muda nenhuma saída.
+#include <string.h>
+
+#include <memory>
+#include <vector>
+
+#include "host/tests/host_test.h"
+#include "host/tests/tflite_model_builder.h"
+
+#include "tensorflow/lite/micro/micro_interpreter.h"
+#include "tensorflow/lite/micro/micro_mutable_op_resolver.h"
+#include "tensorflow/lite/micro/pico/parallel_for.h"
+
+// CONV_2D 1x1 int8 de h x w x in_c para out_c canais: no host cai em
+// arm_convolve_1x1_s8_fast, que divide a matmul entre os cores. Custa
+// h * w * in_c * out_c multiplicações por Invoke.
+static std::vector<uint8_t> conv1x1_model(int h, int w, int in_c, int out_c) {
+    HostModelBuilder m(777u);
+    const float in_scale = 0.05f, out_scale = 0.2f;
+    std::vector<float> filter_scales(out_c), bias_scales(out_c);
+    for (int o = 0; o < out_c; o++) {
+        filter_scales[o] = 0.01f + 0.001f * (float)(o % 5);
+        bias_scales[o] = in_scale * filter_scales[o];
+    }
+    const uint32_t filter = m.add_buffer(m.random_int8((size_t)out_c * in_c));
+    const uint32_t bias = m.add_buffer(HostModelBuilder::bias_int32(out_c));
+
+    const int32_t in = m.add_tensor({1, h, w, in_c}, tflite::TensorType_INT8, 0, {in_scale});
+    const int32_t weights =
+        m.add_tensor({out_c, 1, 1, in_c}, tflite::TensorType_INT8, filter, filter_scales);
+    const int32_t b = m.add_tensor({out_c}, tflite::TensorType_INT32, bias, bias_scales);
+    const int32_t out = m.add_tensor({1, h, w, out_c}, tflite::TensorType_INT8, 0, {out_scale});
+    tflite::Conv2DOptionsT options;
+    options.padding = tflite::Padding_VALID;
+    options.stride_w = options.stride_h = 1;
+    options.dilation_w_factor = options.dilation_h_factor = 1;
+    m.add_operator(m.opcode(tflite::BuiltinOperator_CONV_2D, 3), {in, weights, b}, {out})
+        ->builtin_options.Set(options);
+    return m.finish({in}, {out});
+}
+
+struct KernelRun {
+    bool ok;
+    TflmParallelStats stats;     // Só do Invoke
+    std::vector<int8_t> output;
+};
+
+alignas(16) static uint8_t arena[64 * 1024];
+
+// configure: chama SetParallelKernels(enabled, min_macs) antes do AllocateTensors
+static KernelRun run_model(const std::vector<uint8_t>& fb, bool configure, bool enabled,
+                           int64_t min_macs) {
+    KernelRun run = {};
+    tflite::MicroMutableOpResolver<1> resolver;
+    resolver.AddConv2D();
+    tflite::MicroInterpreter interpreter(tflite::GetModel(fb.data()), resolver, arena,
+                                         sizeof(arena));
+    if (configure && interpreter.SetParallelKernels(enabled, min_macs) != kTfLiteOk) return run;
+    if (interpreter.AllocateTensors() != kTfLiteOk) return run;
+
+    TfLiteTensor* in = interpreter.input(0);
+    for (size_t i = 0; i < in->bytes; i++) in->data.int8[i] = (int8_t)(i * 37 % 251 - 125);
+    tflm_parallel_reset_stats();
+    run.ok = interpreter.Invoke() == kTfLiteOk;
+    tflm_parallel_get_stats(&run.stats);
+
+    const TfLiteTensor* out = interpreter.output(0);
+    run.output.assign(out->data.int8, out->data.int8 + out->bytes);
+    // Depois do Prepare a escolha não muda mais
+    run.ok = run.ok && interpreter.SetParallelKernels(!enabled, 0) == kTfLiteError;
+    return run;
+}
+
+static const int kBigMacs = 8 * 8 * 16 * 16;    // Acima de TFLM_PARALLEL_MIN_MACS
+static const int kSmallMacs = 1 * 1 * 16 * 16;  // Abaixo, com 8 pares de linhas
+
+HOST_TEST(ThresholdIsDecidedPerNode) {
+    static_assert(kSmallMacs < TFLM_PARALLEL_MIN_MACS && kBigMacs >= TFLM_PARALLEL_MIN_MACS,
+                  "ajuste as formas ao TFLM_PARALLEL_MIN_MACS");
+    const KernelRun big = run_model(conv1x1_model(8, 8, 16, 16), false, true, 0);
+    HOST_EXPECT(big.ok);
+    HOST_EXPECT_EQ(big.stats.jobs, 1u);
+    HOST_EXPECT_EQ(big.stats.inline_runs, 0u);
+
+    // A matmul do nó pequeno teria pares para dividir, mas fica no core 0
+    const KernelRun small = run_model(conv1x1_model(1, 1, 16, 16), false, true, 0);
+    HOST_EXPECT(small.ok);
+    HOST_EXPECT_EQ(small.stats.jobs, 0u);
+    HOST_EXPECT_EQ(small.stats.inline_runs, 1u);
+
+    const KernelRun forced = run_model(conv1x1_model(1, 1, 16, 16), true, true, 0);
+    HOST_EXPECT(forced.ok);
+    HOST_EXPECT_EQ(forced.stats.jobs, 1u);
+    HOST_EXPECT(forced.output == small.output);
+}
+
+HOST_TEST(DisabledKeepsEveryNodeOnCore0) {
+    const std::vector<uint8_t> fb = conv1x1_model(8, 8, 16, 16);
+    const KernelRun parallel = run_model(fb, true, true, 0);
+    const KernelRun single = run_model(fb, true, false, 0);
+    HOST_EXPECT(parallel.ok && single.ok);
+    HOST_EXPECT_EQ(parallel.stats.jobs, 1u);
+    HOST_EXPECT_EQ(single.stats.jobs, 0u);
+    HOST_EXPECT_EQ(single.stats.inline_runs, 1u);
+    HOST_EXPECT(!single.output.empty());
+    HOST_EXPECT(single.output == parallel.output);
+
+    // Limite acima do nó: também fica no core 0
+    const KernelRun above = run_model(fb, true, true, kBigMacs + 1);
+    HOST_EXPECT(above.ok);
+    HOST_EXPECT_EQ(above.stats.jobs, 0u);
+}
+
+// O nó repõe a própria escolha a cada Eval, seja qual for o estado deixado
+// por quem chamou parallel_for antes
+HOST_TEST(NodeChoiceOverridesPreviousState) {
+    const std::vector<uint8_t> fb = conv1x1_model(1, 1, 16, 16);
+    tflm_parallel_set_enabled(true);
+    HOST_EXPECT_EQ(run_model(fb, false, true, 0).stats.jobs, 0u);
+    tflm_parallel_set_enabled(false);
+    HOST_EXPECT_EQ(run_model(fb, true, true, 0).stats.jobs, 1u);
+    tflm_parallel_set_enabled(true);
+    tflm_parallel_stop();
+}
+
+int main(void) {
+    HOST_RUN_TEST(ThresholdIsDecidedPerNode);
+    HOST_RUN_TEST(DisabledKeepsEveryNodeOnCore0);
+    HOST_RUN_TEST(NodeChoiceOverridesPreviousState);
+    HOST_TESTS_END();
+}
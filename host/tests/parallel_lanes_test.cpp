@@ -0,0 +1,231 @@
+// Nós independentes em pares, um em cada core (MicroInterpreter::
+// SetParallelLanes): num modelo com dois ramos os pares saem na mesma ordem
+// qualquer que seja a ordem dos nós no flatbuffer, a saída é igual à de um
+// core só, e cada lado usa a própria memória temporária.
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "host/tests/host_test.h"
+#include "host/tests/tflite_model_builder.h"
+
+#include "tensorflow/lite/micro/kernels/kernel_util.h"
+#include "tensorflow/lite/micro/micro_context.h"
+#include "tensorflow/lite/micro/micro_interpreter.h"
+#include "tensorflow/lite/micro/micro_mutable_op_resolver.h"
+#include "tensorflow/lite/micro/micro_profiler.h"
+#include "tensorflow/lite/micro/pico/parallel_for.h"
+
+static const int kWidth = 16;
+static const char kProbeName[] = "LANE_PROBE";
+
+// Nós de largura kWidth sobre o HostModelBuilder: cada um devolve o índice
+// do tensor de saída
+struct LaneModel : HostModelBuilder {
+    int32_t input;
+
+    LaneModel() : HostModelBuilder(4242u) {
+        input = add_tensor({1, kWidth}, tflite::TensorType_INT8, 0, {0.05f});
+    }
+
+    int32_t fully_connected(int32_t in) {
+        const float w_scale = 0.01f, out_scale = 0.1f;
+        const int32_t weights = add_tensor({kWidth, kWidth}, tflite::TensorType_INT8,
+                                           add_buffer(random_int8(kWidth * kWidth)), {w_scale});
+        const int32_t bias = add_tensor({kWidth}, tflite::TensorType_INT32,
+                                        add_buffer(bias_int32(kWidth)), {tensor_scale[in] * w_scale});
+        const int32_t out = add_tensor({1, kWidth}, tflite::TensorType_INT8, 0, {out_scale});
+        add_operator(opcode(tflite::BuiltinOperator_FULLY_CONNECTED), {in, weights, bias}, {out})
+            ->builtin_options.Set(tflite::FullyConnectedOptionsT());
+        return out;
+    }
+
+    int32_t add(int32_t a, int32_t b) {
+        const int32_t out = add_tensor({1, kWidth}, tflite::TensorType_INT8, 0, {0.2f});
+        add_operator(opcode(tflite::BuiltinOperator_ADD), {a, b}, {out})
+            ->builtin_options.Set(tflite::AddOptionsT());
+        return out;
+    }
+
+    int32_t probe(int32_t in) {
+        const int32_t out = add_tensor({1, kWidth}, tflite::TensorType_INT8, 0, {tensor_scale[in]});
+        add_operator(opcode(tflite::BuiltinOperator_CUSTOM, 1, kProbeName), {in}, {out});
+        return out;
+    }
+
+    std::vector<uint8_t> finish(std::vector<int32_t> outputs) {
+        return HostModelBuilder::finish({input}, outputs);
+    }
+};
+
+// Dois ramos de dois FULLY_CONNECTED somados no fim. interleaved: A1 B1 A2 B2,
+// senão A1 A2 B1 B2
+static std::vector<uint8_t> branchy_model(bool interleaved) {
+    LaneModel m;
+    const int32_t in = m.input;
+    int32_t a, b;
+    if (interleaved) {
+        a = m.fully_connected(in);
+        b = m.fully_connected(in);
+        a = m.fully_connected(a);
+        b = m.fully_connected(b);
+    } else {
+        a = m.fully_connected(m.fully_connected(in));
+        b = m.fully_connected(m.fully_connected(in));
+    }
+    return m.finish({m.add(a, b)});
+}
+
+static std::vector<uint8_t> chain_model() {
+    LaneModel m;
+    return m.finish({m.fully_connected(m.fully_connected(m.fully_connected(m.input)))});
+}
+
+// Dois LANE_PROBE lendo a entrada, cada um uma saída do modelo
+static std::vector<uint8_t> probe_model() {
+    LaneModel m;
+    const int32_t in = m.input;
+    const int32_t a = m.probe(in);
+    return m.finish({a, m.probe(in)});
+}
+
+// LANE_PROBE: pede um TfLiteTensor temporário, anota em que core rodou e
+// espera o outro probe chegar, para os dois estarem vivos ao mesmo tempo
+static std::atomic<int> probe_arrived;
+static int probe_worker[2];
+static const void* probe_temp[2];
+
+static TfLiteStatus ProbeEval(TfLiteContext* context, TfLiteNode* node) {
+    tflite::MicroContext* micro_context = tflite::GetMicroContext(context);
+    TfLiteTensor* temp = micro_context->AllocateTempInputTensor(node, 0);
+    const int slot = probe_arrived.fetch_add(1);
+    if (slot < 2) {
+        probe_worker[slot] = tflm_parallel_worker();
+        probe_temp[slot] = temp;
+    }
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (probe_arrived.load() < 2 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+    const TfLiteEvalTensor* in = tflite::micro::GetEvalInput(context, node, 0);
+    TfLiteEvalTensor* out = tflite::micro::GetEvalOutput(context, node, 0);
+    memcpy(out->data.int8, in->data.int8, kWidth);
+    if (temp == nullptr) return kTfLiteError;
+    micro_context->DeallocateTempTfLiteTensor(temp);
+    return kTfLiteOk;
+}
+
+struct LaneRun {
+    bool ok;
+    TflmParallelStats stats;  // Só do Invoke
+    size_t arena_bytes;
+    std::vector<int8_t> output;
+};
+
+alignas(16) static uint8_t arena[64 * 1024];
+
+// kernel_min_macs < 0 mantém o padrão de SetParallelKernels
+static LaneRun run_model(const std::vector<uint8_t>& fb, bool lanes, int64_t kernel_min_macs = -1,
+                         tflite::MicroProfilerInterface* profiler = nullptr) {
+    LaneRun run = {};
+    static TFLMRegistration probe = tflite::micro::RegisterOp(nullptr, nullptr, ProbeEval);
+    tflite::MicroMutableOpResolver<3> resolver;
+    resolver.AddFullyConnected();
+    resolver.AddAdd();
+    resolver.AddCustom(kProbeName, &probe);
+    tflite::MicroInterpreter interpreter(tflite::GetModel(fb.data()), resolver, arena,
+                                         sizeof(arena), nullptr, profiler);
+    if (interpreter.SetParallelLanes(lanes) != kTfLiteOk) return run;
+    if (kernel_min_macs >= 0 && interpreter.SetParallelKernels(true, kernel_min_macs) != kTfLiteOk) {
+        return run;
+    }
+    if (interpreter.AllocateTensors() != kTfLiteOk) return run;
+    run.arena_bytes = interpreter.arena_used_bytes();
+
+    TfLiteTensor* in = interpreter.input(0);
+    for (size_t i = 0; i < in->bytes; i++) in->data.int8[i] = (int8_t)(i * 37 % 251 - 125);
+    probe_arrived = 0;
+    tflm_parallel_reset_stats();
+    run.ok = interpreter.Invoke() == kTfLiteOk;
+    tflm_parallel_get_stats(&run.stats);
+
+    for (size_t o = 0; o < interpreter.outputs_size(); o++) {
+        const TfLiteTensor* out = interpreter.output(o);
+        run.output.insert(run.output.end(), out->data.int8, out->data.int8 + out->bytes);
+    }
+    // O plano de memória já foi feito para a escolha
+    run.ok = run.ok && interpreter.SetParallelLanes(!lanes) == kTfLiteError;
+    return run;
+}
+
+HOST_TEST(BranchesRunInPairs) {
+    for (int interleaved = 0; interleaved < 2; interleaved++) {
+        const std::vector<uint8_t> fb = branchy_model(interleaved);
+        const LaneRun single = run_model(fb, false);
+        const LaneRun lanes = run_model(fb, true);
+        HOST_EXPECT(single.ok && lanes.ok);
+        HOST_EXPECT_EQ(single.stats.jobs, 0u);
+        // A1 com B1, A2 com B2; o ADD roda sozinho
+        HOST_EXPECT_EQ(lanes.stats.jobs, 2u);
+        HOST_EXPECT(!single.output.empty());
+        HOST_EXPECT(lanes.output == single.output);
+        // Saídas que ficam vivas mais cedo só podem aumentar a arena
+        HOST_EXPECT(lanes.arena_bytes >= single.arena_bytes);
+    }
+}
+
+HOST_TEST(ChainIsNotPaired) {
+    const std::vector<uint8_t> fb = chain_model();
+    const LaneRun single = run_model(fb, false);
+    const LaneRun lanes = run_model(fb, true);
+    HOST_EXPECT(single.ok && lanes.ok);
+    HOST_EXPECT_EQ(lanes.stats.jobs, 0u);
+    HOST_EXPECT(lanes.output == single.output);
+}
+
+// Nós que já dividem o próprio kernel entre os cores não entram nos pares
+HOST_TEST(NodesSplittingTheirKernelRunAlone) {
+    const std::vector<uint8_t> fb = branchy_model(true);
+    const LaneRun kernels = run_model(fb, false, 0);
+    const LaneRun both = run_model(fb, true, 0);
+    HOST_EXPECT(kernels.ok && both.ok);
+    HOST_EXPECT(kernels.stats.jobs >= 4u);
+    HOST_EXPECT_EQ(both.stats.jobs, kernels.stats.jobs);
+    HOST_EXPECT(both.output == kernels.output);
+}
+
+HOST_TEST(LanesUseBothCoresAndOwnTemp) {
+    const LaneRun run = run_model(probe_model(), true);
+    HOST_EXPECT(run.ok);
+    HOST_EXPECT_EQ(run.stats.jobs, 1u);
+    HOST_EXPECT_EQ(probe_worker[0] + probe_worker[1], 1);
+    HOST_EXPECT(probe_temp[0] != nullptr && probe_temp[1] != nullptr);
+    HOST_EXPECT(probe_temp[0] != probe_temp[1]);
+    HOST_EXPECT_EQ(run.output.size(), (size_t)(2 * kWidth));
+    HOST_EXPECT(memcmp(run.output.data(), run.output.data() + kWidth, kWidth) == 0);
+}
+
+// Com profiler os nós rodam na ordem original, um por vez
+HOST_TEST(ProfilerKeepsOriginalOrder) {
+    const std::vector<uint8_t> fb = branchy_model(false);
+    tflite::MicroProfiler profiler;
+    const LaneRun profiled = run_model(fb, true, -1, &profiler);
+    const LaneRun single = run_model(fb, false);
+    HOST_EXPECT(profiled.ok);
+    HOST_EXPECT_EQ(profiled.stats.jobs, 0u);
+    HOST_EXPECT(profiled.output == single.output);
+    tflm_parallel_stop();
+}
+
+int main(void) {
+    HOST_RUN_TEST(BranchesRunInPairs);
+    HOST_RUN_TEST(ChainIsNotPaired);
+    HOST_RUN_TEST(NodesSplittingTheirKernelRunAlone);
+    HOST_RUN_TEST(LanesUseBothCoresAndOwnTemp);
+    HOST_RUN_TEST(ProfilerKeepsOriginalOrder);
+    HOST_TESTS_END();
+}
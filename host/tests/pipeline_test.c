@@ -0,0 +1,219 @@
+// Fila SPSC e pipeline entre cores: semântica de um lado só, estresse com
+// uma std::thread no papel do core 1 e o agendador no relógio virtual.
+#include <sched.h>
+#include <string.h>
+
+#include "hardware/sync.h"
+#include "host/tests/host_test.h"
+#include "lib/pipeline/core_task.h"
+#include "lib/pipeline/pipeline.h"
+#include "lib/scheduler/scheduler.h"
+
+// Item com redundância: um slot lido pela metade não passa na conferência
+typedef struct {
+    uint32_t seq;
+    uint32_t check;
+    uint8_t payload[24];
+} StressItem;
+
+static uint32_t item_check(uint32_t seq) { return seq * 2654435761u ^ 0x5bd1e995u; }
+
+static void make_item(StressItem *it, uint32_t seq) {
+    it->seq = seq;
+    it->check = item_check(seq);
+    memset(it->payload, (int)(seq & 0xFF), sizeof(it->payload));
+}
+
+static bool item_ok(const StressItem *it) {
+    if (it->check != item_check(it->seq)) return false;
+    for (size_t i = 0; i < sizeof(it->payload); i++) {
+        if (it->payload[i] != (uint8_t)(it->seq & 0xFF)) return false;
+    }
+    return true;
+}
+
+HOST_TEST(test_rejects_non_power_of_two) {
+    SpscQueue q;
+    StressItem slots[6];
+    HOST_EXPECT(!spsc_init(&q, slots, sizeof(StressItem), 6));
+    HOST_EXPECT(!spsc_init(&q, slots, sizeof(StressItem), 0));
+    HOST_EXPECT(spsc_init(&q, slots, sizeof(StressItem), 4));
+}
+
+HOST_TEST(test_fifo_full_and_wrap) {
+    SpscQueue q;
+    StressItem slots[4], it;
+    spsc_init(&q, slots, sizeof(StressItem), 4);
+    HOST_EXPECT(!spsc_pop(&q, &it));
+
+    uint32_t next_push = 0, next_pop = 0;
+    for (int round = 0; round < 10; round++) {
+        while (true) {
+            make_item(&it, next_push);
+            if (!spsc_push(&q, &it)) break;
+            next_push++;
+        }
+        HOST_EXPECT_EQ(spsc_depth(&q), 4);
+        // Esvazia só uma parte: os índices giram em posições diferentes
+        for (int i = 0; i < 3; i++) {
+            HOST_EXPECT(spsc_pop(&q, &it));
+            HOST_EXPECT_EQ(it.seq, next_pop);
+            next_pop++;
+        }
+    }
+    HOST_EXPECT_EQ(q.max_depth, 4);
+    HOST_EXPECT_EQ(q.dropped, 10);
+    HOST_EXPECT_EQ(q.pushed, next_push);
+    HOST_EXPECT_EQ(q.popped, next_pop);
+}
+
+// ------------------------------------------------------------
+// Estresse entre threads
+// ------------------------------------------------------------
+#define STRESS_ITEMS 2000000u
+
+typedef struct {
+    SpscQueue q;
+    StressItem slots[8];
+    bool retry;                 // true: repete o push até caber (sem perdas)
+    uint32_t attempts;
+    volatile bool done;
+} StressCtx;
+
+static void stress_producer(void *arg) {
+    StressCtx *c = (StressCtx *)arg;
+    for (uint32_t seq = 0; seq < STRESS_ITEMS; seq++) {
+        StressItem it;
+        make_item(&it, seq);
+        c->attempts++;
+        // Cede a CPU ao repetir: com um core só no host a espera ativa
+        // gastaria a fatia de tempo inteira
+        while (!spsc_push(&c->q, &it) && c->retry) {
+            c->attempts++;
+            sched_yield();
+        }
+    }
+    __atomic_store_n(&c->done, true, __ATOMIC_RELEASE);
+}
+
+// Consome até o produtor terminar; retorna itens recebidos
+static uint32_t stress_consume(StressCtx *c, uint32_t *bad, uint32_t *out_of_order) {
+    uint32_t received = 0;
+    int64_t last = -1;
+    while (true) {
+        StressItem it;
+        if (spsc_pop(&c->q, &it)) {
+            if (!item_ok(&it)) (*bad)++;
+            if ((int64_t)it.seq <= last || (c->retry && it.seq != (uint32_t)(last + 1))) (*out_of_order)++;
+            last = it.seq;
+            received++;
+        } else if (__atomic_load_n(&c->done, __ATOMIC_ACQUIRE) && spsc_depth(&c->q) == 0) {
+            return received;
+        } else {
+            sched_yield();
+        }
+    }
+}
+
+HOST_TEST(test_stress_lossless) {
+    static StressCtx c;
+    memset(&c, 0, sizeof(c));
+    spsc_init(&c.q, c.slots, sizeof(StressItem), 8);
+    c.retry = true;
+    HOST_EXPECT(core_task_launch(stress_producer, &c));
+    uint32_t bad = 0, out_of_order = 0;
+    const uint32_t received = stress_consume(&c, &bad, &out_of_order);
+    core_task_join();
+
+    HOST_EXPECT_EQ(received, STRESS_ITEMS);
+    HOST_EXPECT_EQ(bad, 0);
+    HOST_EXPECT_EQ(out_of_order, 0);
+    HOST_EXPECT_EQ(c.q.pushed, STRESS_ITEMS);
+    HOST_EXPECT_EQ(c.q.dropped, c.attempts - STRESS_ITEMS);
+    printf("  %u itens, %u tentativas com a fila cheia, profundidade máx %u\n",
+           received, c.attempts - STRESS_ITEMS, c.q.max_depth);
+}
+
+// Sem repetição: o produtor nunca espera; o que não coube é contado
+HOST_TEST(test_stress_lossy) {
+    static StressCtx c;
+    memset(&c, 0, sizeof(c));
+    spsc_init(&c.q, c.slots, sizeof(StressItem), 8);
+    HOST_EXPECT(core_task_launch(stress_producer, &c));
+    uint32_t bad = 0, out_of_order = 0;
+    const uint32_t received = stress_consume(&c, &bad, &out_of_order);
+    core_task_join();
+
+    HOST_EXPECT_EQ(bad, 0);
+    HOST_EXPECT_EQ(out_of_order, 0);
+    HOST_EXPECT_EQ(c.attempts, STRESS_ITEMS);
+    HOST_EXPECT_EQ(received + c.q.dropped, STRESS_ITEMS);
+    HOST_EXPECT_EQ(received, c.q.pushed);
+    printf("  %u recebidos, %u descartados\n", received, c.q.dropped);
+}
+
+// ------------------------------------------------------------
+// Pipeline no relógio virtual: o core 1 espera o alarme, o core 0 dorme em
+// WFE com a fila vazia. Nenhum tick pode se perder nem o tempo pular
+// enquanto o core 1 trabalha.
+// ------------------------------------------------------------
+#define PIPE_PERIOD_US 500000u
+#define PIPE_TICKS     2000u
+
+typedef struct {
+    SampleScheduler sched;
+    Pipeline pipeline;
+} PipeCtx;
+
+static void pipe_producer(void *arg) {
+    PipeCtx *c = (PipeCtx *)arg;
+    for (uint32_t i = 0; i < PIPE_TICKS; i++) {
+        PipelineSample s;
+        memset(&s, 0, sizeof(s));
+        s.due_us = sched_wait_tick(&c->sched);
+        s.seq = c->sched.ticks_handled;
+        // Trabalho real entre o tick e o push
+        volatile uint32_t spin = 0;
+        for (int k = 0; k < 2000; k++) spin += (uint32_t)k;
+        pipeline_push(&c->pipeline, &s);
+    }
+}
+
+HOST_TEST(test_pipeline_virtual_clock) {
+    static PipeCtx c;
+    pipeline_init(&c.pipeline);
+    const uint64_t start = time_us_64();
+    HOST_EXPECT(sched_init(&c.sched, PIPE_PERIOD_US));
+    HOST_EXPECT(core_task_launch(pipe_producer, &c));
+
+    uint32_t consumed = 0, gaps = 0, last_seq = 0;
+    while (consumed < PIPE_TICKS) {
+        PipelineSample s;
+        if (!pipeline_pop(&c.pipeline, &s)) {
+            __wfe();
+            continue;
+        }
+        if (s.seq != last_seq + 1) gaps++;
+        last_seq = s.seq;
+        consumed++;
+    }
+    core_task_join();
+    sched_stop(&c.sched);
+
+    HOST_EXPECT_EQ(gaps, 0);
+    HOST_EXPECT_EQ(c.sched.overruns, 0);
+    HOST_EXPECT_EQ(c.pipeline.queue.dropped, 0);
+    HOST_EXPECT(c.pipeline.stalls >= PIPE_TICKS - 1); // Core 0 espera a cada período
+    const double elapsed_periods = (double)(time_us_64() - start) / PIPE_PERIOD_US;
+    HOST_EXPECT_NEAR(elapsed_periods, PIPE_TICKS, 1.0);
+    pipeline_report(&c.pipeline);
+}
+
+int main(void) {
+    HOST_RUN_TEST(test_rejects_non_power_of_two);
+    HOST_RUN_TEST(test_fifo_full_and_wrap);
+    HOST_RUN_TEST(test_stress_lossless);
+    HOST_RUN_TEST(test_stress_lossy);
+    HOST_RUN_TEST(test_pipeline_virtual_clock);
+    HOST_TESTS_END();
+}
@@ -0,0 +1,116 @@
+// Caminho inteiro (códigos brutos -> int8) contra o caminho float do firmware
+// (decodificação, diferencial, z-score e quantização de tflm_predict) sobre as
+// capturas gravadas, para alguns parâmetros de quantização de entrada.
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host/tests/captures.h"
+#include "host/tests/host_test.h"
+#include "lib/preproc/preproc.h"
+
+static uint32_t encode(float value, float offset, float span) {
+    double code = ((double)value + offset) * AHT20_RAW_FULL_SCALE / span + 0.5;
+    return code <= 0 ? 0 : (uint32_t)code;
+}
+
+// Mesmo caminho do firmware: decodificação float do aht20.c, main.c e tflm_predict
+static int8_t float_path(uint32_t raw_1, uint32_t raw_2, float span, float offset,
+                         float mean, float std, float scale, int zp) {
+    float v1 = ((float)raw_1 * span / 1048576.0) - offset;
+    float v2 = ((float)raw_2 * span / 1048576.0) - offset;
+    float z = ((v1 - v2) - mean) / std;
+    long q = lroundf(z / scale) + zp;
+    return (int8_t)(q < -128 ? -128 : (q > 127 ? 127 : q));
+}
+
+typedef struct {
+    int rows;
+    int max_diff;
+    int exact;
+} ParityResult;
+
+static ParityResult check_parity(float scale, int zp) {
+    ParityResult res = {0, 0, 0};
+    PreprocFixed p;
+    HOST_EXPECT(preproc_fixed_init(&p, HOST_MEAN_DELTA_T, HOST_STD_DELTA_T, HOST_MEAN_DELTA_U,
+                                   HOST_STD_DELTA_U, scale, zp));
+
+    for (int f = 0; f < HOST_NUM_CAPTURES; f++) {
+        FILE *fp = fopen(host_captures[f], "r");
+        HOST_EXPECT(fp != NULL);
+        if (!fp) continue;
+        float v[5];
+        while (host_read_capture_row(fp, v)) {
+            SensorReadings r;
+            memset(&r, 0, sizeof(r));
+            r.raw_temp_1 = encode(v[1], 50.0f, 200.0f);
+            r.raw_humidity_1 = encode(v[2], 0.0f, 100.0f);
+            r.raw_temp_2 = encode(v[3], 50.0f, 200.0f);
+            r.raw_humidity_2 = encode(v[4], 0.0f, 100.0f);
+
+            int8_t q[2];
+            preproc_fixed_quantize(&p, &r, q);
+            int8_t ref_t = float_path(r.raw_temp_1, r.raw_temp_2, 200.0f, 50.0f,
+                                      HOST_MEAN_DELTA_T, HOST_STD_DELTA_T, scale, zp);
+            int8_t ref_u = float_path(r.raw_humidity_1, r.raw_humidity_2, 100.0f, 0.0f,
+                                      HOST_MEAN_DELTA_U, HOST_STD_DELTA_U, scale, zp);
+
+            int d_t = abs(q[0] - ref_t), d_u = abs(q[1] - ref_u);
+            if (d_t > res.max_diff) res.max_diff = d_t;
+            if (d_u > res.max_diff) res.max_diff = d_u;
+            res.exact += (d_t == 0 && d_u == 0);
+            res.rows++;
+        }
+        fclose(fp);
+    }
+    printf("  scale=%g zp=%d: %d linhas, %d idênticas, diferença máx %d LSB\n",
+           scale, zp, res.rows, res.exact, res.max_diff);
+    return res;
+}
+
+HOST_TEST(ParityTypicalScale) {
+    ParityResult r = check_parity(1.0f / 32.0f, 0);
+    HOST_EXPECT(r.rows > 10000);
+    HOST_EXPECT(r.max_diff <= 1);
+}
+
+HOST_TEST(ParityAsymmetricZeroPoint) {
+    ParityResult r = check_parity(0.0213f, -17);
+    HOST_EXPECT(r.max_diff <= 1);
+}
+
+HOST_TEST(ParityCoarseScaleSaturates) {
+    // Escala pequena: boa parte das amostras satura em -128/127 nos dois caminhos
+    ParityResult r = check_parity(0.004f, 5);
+    HOST_EXPECT(r.max_diff <= 1);
+}
+
+HOST_TEST(FloatInputModelIsRejected) {
+    PreprocFixed p;
+    HOST_EXPECT(!preproc_fixed_init(&p, HOST_MEAN_DELTA_T, HOST_STD_DELTA_T, HOST_MEAN_DELTA_U,
+                                    HOST_STD_DELTA_U, 0.0f, 0));
+}
+
+HOST_TEST(ZeroDifferentialMapsToMeanOffset) {
+    PreprocFixed p;
+    preproc_fixed_init(&p, HOST_MEAN_DELTA_T, HOST_STD_DELTA_T, HOST_MEAN_DELTA_U, HOST_STD_DELTA_U,
+                       1.0f / 32.0f, 3);
+    SensorReadings r;
+    memset(&r, 0, sizeof(r));
+    r.raw_temp_1 = r.raw_temp_2 = 400000;
+    r.raw_humidity_1 = r.raw_humidity_2 = 500000;
+    int8_t q[2];
+    preproc_fixed_quantize(&p, &r, q);
+    HOST_EXPECT_EQ(q[0], lroundf(-HOST_MEAN_DELTA_T / HOST_STD_DELTA_T * 32.0f) + 3);
+    HOST_EXPECT_EQ(q[1], lroundf(-HOST_MEAN_DELTA_U / HOST_STD_DELTA_U * 32.0f) + 3);
+}
+
+int main(void) {
+    HOST_RUN_TEST(ParityTypicalScale);
+    HOST_RUN_TEST(ParityAsymmetricZeroPoint);
+    HOST_RUN_TEST(ParityCoarseScaleSaturates);
+    HOST_RUN_TEST(FloatInputModelIsRejected);
+    HOST_RUN_TEST(ZeroDifferentialMapsToMeanOffset);
+    HOST_TESTS_END();
+}
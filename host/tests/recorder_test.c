@@ -0,0 +1,352 @@
+// Gravador em flash sobre o simulador NOR em arquivo: ida e volta, volta do
+// log circular com desgaste uniforme, amplificação de escrita, queda de
+// energia em todos os pontos de um trecho e vazão.
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "host/tests/host_test.h"
+#include "lib/recorder/flash_file.h"
+#include "lib/recorder/recorder.h"
+
+#define SMALL_REGION (4u * FLASH_DEV_SECTOR_BYTES)
+
+static char flash_path[64];
+
+static void fresh_path(void) {
+    snprintf(flash_path, sizeof(flash_path), "/tmp/recorder_test_%d.bin", (int)getpid());
+    unlink(flash_path);
+}
+
+// Payload de teste: seq + bytes derivados dele, tamanho variável
+static uint8_t make_payload(uint32_t seq, uint8_t *out) {
+    const uint8_t len = (uint8_t)(4 + seq % 29);
+    memcpy(out, &seq, 4);
+    for (uint8_t i = 4; i < len; i++) out[i] = (uint8_t)(seq * 31u + i);
+    return len;
+}
+
+static bool payload_ok(const uint8_t *p, uint8_t len, uint32_t *seq) {
+    memcpy(seq, p, 4);
+    uint8_t expected[RECORDER_MAX_PAYLOAD];
+    return make_payload(*seq, expected) == len && memcmp(expected, p, len) == 0;
+}
+
+typedef struct {
+    uint32_t count;
+    uint32_t first;
+    uint32_t last;
+    uint32_t bad;               // Payload corrompido
+    uint32_t gaps;              // seq fora de ordem ou faltando
+} ReadBack;
+
+static ReadBack read_back(const Recorder *r) {
+    ReadBack rb = {0, 0, 0, 0, 0};
+    RecorderCursor c;
+    uint8_t payload[RECORDER_MAX_PAYLOAD];
+    uint8_t len;
+    recorder_cursor_init(&c, r);
+    while (recorder_cursor_next(&c, payload, &len)) {
+        uint32_t seq;
+        if (!payload_ok(payload, len, &seq)) {
+            rb.bad++;
+            continue;
+        }
+        if (rb.count == 0) {
+            rb.first = seq;
+        } else if (seq != rb.last + 1) {
+            rb.gaps++;
+        }
+        rb.last = seq;
+        rb.count++;
+    }
+    return rb;
+}
+
+static bool append_seq(Recorder *r, uint32_t seq) {
+    uint8_t payload[RECORDER_MAX_PAYLOAD];
+    const uint8_t len = make_payload(seq, payload);
+    return recorder_append(r, payload, len);
+}
+
+HOST_TEST(test_round_trip_and_reopen) {
+    fresh_path();
+    FlashFile file;
+    FlashDevice dev;
+    Recorder r;
+    HOST_EXPECT(flash_file_open(&file, flash_path, SMALL_REGION, false, &dev));
+    HOST_EXPECT(recorder_open(&r, &dev));
+    HOST_EXPECT_EQ(read_back(&r).count, 0);
+    HOST_EXPECT_EQ(file.programmed_bytes, 0); // Abrir não escreve
+
+    for (uint32_t i = 0; i < 500; i++) HOST_EXPECT(append_seq(&r, i));
+    HOST_EXPECT(recorder_flush(&r));
+    ReadBack rb = read_back(&r);
+    HOST_EXPECT_EQ(rb.count, 500);
+    HOST_EXPECT_EQ(rb.first, 0);
+    HOST_EXPECT_EQ(rb.gaps, 0);
+    HOST_EXPECT_EQ(rb.bad, 0);
+
+    // Só páginas inteiras: amplificação ~ (payload + quadro + cabeçalhos) / payload
+    HOST_EXPECT(recorder_write_amplification(&r) < 1.4f);
+    HOST_EXPECT_EQ(file.nor_violations, 0);
+    flash_file_close(&file);
+
+    // Reabre e continua do ponto em que parou
+    HOST_EXPECT(flash_file_open(&file, flash_path, SMALL_REGION, false, &dev));
+    HOST_EXPECT(recorder_open(&r, &dev));
+    HOST_EXPECT_EQ(r.stats.recovered_records, 500);
+    for (uint32_t i = 500; i < 600; i++) HOST_EXPECT(append_seq(&r, i));
+    HOST_EXPECT(recorder_flush(&r));
+    rb = read_back(&r);
+    HOST_EXPECT_EQ(rb.count, 600);
+    HOST_EXPECT_EQ(rb.gaps, 0);
+    HOST_EXPECT_EQ(file.nor_violations, 0);
+    flash_file_close(&file);
+    unlink(flash_path);
+}
+
+// Flush a cada registro reprograma a mesma página (NOR permite: os bytes
+// antigos se repetem) em vez de desperdiçar o resto dela
+HOST_TEST(test_flush_refills_same_page) {
+    fresh_path();
+    FlashFile file;
+    FlashDevice dev;
+    Recorder r;
+    flash_file_open(&file, flash_path, SMALL_REGION, false, &dev);
+    recorder_open(&r, &dev);
+    for (uint32_t i = 0; i < 40; i++) {
+        HOST_EXPECT(append_seq(&r, i));
+        HOST_EXPECT(recorder_flush(&r));
+    }
+    HOST_EXPECT_EQ(file.nor_violations, 0);
+    HOST_EXPECT(r.page <= 4); // 40 registros de ~22 bytes cabem em poucas páginas
+    flash_file_close(&file);
+
+    flash_file_open(&file, flash_path, SMALL_REGION, false, &dev);
+    recorder_open(&r, &dev);
+    const ReadBack rb = read_back(&r);
+    HOST_EXPECT_EQ(rb.count, 40);
+    HOST_EXPECT_EQ(rb.gaps, 0);
+    flash_file_close(&file);
+    unlink(flash_path);
+}
+
+// Várias voltas no log: ficam os mais novos, contíguos, e os setores se
+// desgastam por igual
+HOST_TEST(test_wraps_and_levels_wear) {
+    fresh_path();
+    FlashFile file;
+    FlashDevice dev;
+    Recorder r;
+    flash_file_open(&file, flash_path, SMALL_REGION, false, &dev);
+    recorder_open(&r, &dev);
+    const uint32_t total = 20000; // ~30 voltas em 16 KB
+    for (uint32_t i = 0; i < total; i++) HOST_EXPECT(append_seq(&r, i));
+    HOST_EXPECT(recorder_flush(&r));
+
+    const ReadBack rb = read_back(&r);
+    HOST_EXPECT_EQ(rb.last, total - 1);
+    HOST_EXPECT_EQ(rb.gaps, 0);
+    HOST_EXPECT_EQ(rb.bad, 0);
+    HOST_EXPECT(rb.count > 400); // Pelo menos três setores de dados
+
+    uint32_t wear_min, wear_max;
+    recorder_wear(&r, &wear_min, &wear_max);
+    HOST_EXPECT(wear_max - wear_min <= 1);
+    HOST_EXPECT(wear_min > 20);
+    uint32_t sim_min = UINT32_MAX, sim_max = 0;
+    for (uint32_t s = 0; s < SMALL_REGION / FLASH_DEV_SECTOR_BYTES; s++) {
+        if (file.erase_counts[s] < sim_min) sim_min = file.erase_counts[s];
+        if (file.erase_counts[s] > sim_max) sim_max = file.erase_counts[s];
+    }
+    HOST_EXPECT(sim_max - sim_min <= 1);
+    HOST_EXPECT_EQ(file.nor_violations, 0);
+    printf("  %u registros lidos de %u, apagamentos por setor %u..%u, amplificação %.2fx\n",
+           rb.count, total, sim_min, sim_max, recorder_write_amplification(&r));
+    flash_file_close(&file);
+    unlink(flash_path);
+}
+
+// Corta a energia depois de `budget` bytes gravados/apagados, reabre e confere:
+// nada corrompido, sequência contígua, tudo o que um flush confirmou presente,
+// e o log continua aceitando registros depois da recuperação.
+static void power_loss_case(uint32_t budget, uint32_t prefill, uint32_t *torn_total) {
+    fresh_path();
+    FlashFile file;
+    FlashDevice dev;
+    Recorder r;
+    flash_file_open(&file, flash_path, SMALL_REGION, false, &dev);
+    recorder_open(&r, &dev);
+    uint32_t seq = 0;
+    for (; seq < prefill; seq++) append_seq(&r, seq);
+    recorder_flush(&r);
+    int64_t durable = (int64_t)seq - 1;
+
+    flash_file_cut_power_after(&file, budget, budget * 2654435761u);
+    for (; seq < prefill + 3000; seq++) {
+        if (!append_seq(&r, seq)) break;
+        if (seq % 7 == 6) {
+            if (!recorder_flush(&r)) break;
+            durable = seq;
+        }
+    }
+    flash_file_close(&file);
+
+    flash_file_open(&file, flash_path, SMALL_REGION, false, &dev);
+    HOST_EXPECT(recorder_open(&r, &dev));
+    *torn_total += r.stats.torn_pages;
+    ReadBack rb = read_back(&r);
+    HOST_EXPECT_EQ(rb.bad, 0);
+    HOST_EXPECT_EQ(rb.gaps, 0);
+    if (durable >= 0) HOST_EXPECT(rb.count > 0 && (int64_t)rb.last >= durable);
+
+    // Continua: os novos registros vêm logo depois dos recuperados
+    const uint32_t resume = rb.count ? rb.last + 1 : 0;
+    for (uint32_t i = 0; i < 300; i++) HOST_EXPECT(append_seq(&r, resume + i));
+    HOST_EXPECT(recorder_flush(&r));
+    rb = read_back(&r);
+    HOST_EXPECT_EQ(rb.bad, 0);
+    HOST_EXPECT_EQ(rb.gaps, 0);
+    HOST_EXPECT_EQ(rb.last, resume + 299);
+    HOST_EXPECT_EQ(file.nor_violations, 0);
+    flash_file_close(&file);
+}
+
+HOST_TEST(test_power_loss_anywhere) {
+    uint32_t torn = 0;
+    const int failed_before = host_tests_failed;
+    // Sem volta: cortes em programações de página
+    for (uint32_t budget = 0; budget < 12000 && host_tests_failed == failed_before; budget += 37) {
+        power_loss_case(budget, 0, &torn);
+    }
+    // Log cheio antes do corte: cortes também no meio de apagamentos de setor
+    for (uint32_t budget = 0; budget < 40000 && host_tests_failed == failed_before; budget += 211) {
+        power_loss_case(budget, 700, &torn);
+    }
+    HOST_EXPECT(torn > 0); // O simulador de fato rasgou páginas
+    printf("  páginas rasgadas encontradas na recuperação: %u\n", torn);
+    unlink(flash_path);
+}
+
+typedef struct {
+    uint8_t buf[8192];
+    size_t len;
+} DumpSink;
+
+static void dump_write(void *ctx, const uint8_t *data, size_t len) {
+    DumpSink *sink = (DumpSink *)ctx;
+    memcpy(sink->buf + sink->len, data, len);
+    sink->len += len;
+}
+
+// Dump com texto do printf antes e depois, como sai na USB: o decodificador
+// acha todos os quadros, na ordem
+HOST_TEST(test_dump_frames_resync) {
+    fresh_path();
+    FlashFile file;
+    FlashDevice dev;
+    Recorder r;
+    flash_file_open(&file, flash_path, SMALL_REGION, false, &dev);
+    recorder_open(&r, &dev);
+    for (uint32_t i = 0; i < 50; i++) append_seq(&r, i);
+
+    static DumpSink sink;
+    const char *before = "[REC] dump inicio\n\x5A\x05 lixo";
+    const char *after = "[REC] dump fim: 50 registros\n";
+    sink.len = 0;
+    dump_write(&sink, (const uint8_t *)before, strlen(before));
+    HOST_EXPECT_EQ(recorder_dump(&r, dump_write, &sink), 50); // Faz flush antes
+    dump_write(&sink, (const uint8_t *)after, strlen(after));
+
+    uint32_t found_count = 0, gaps = 0;
+    size_t pos = 0, skipped = 0;
+    while (pos < sink.len) {
+        uint8_t payload[RECORDER_MAX_PAYLOAD];
+        uint8_t plen;
+        bool found;
+        size_t used = recorder_frame_decode(sink.buf + pos, sink.len - pos, payload, &plen, &found);
+        if (used == 0) used = sink.len - pos; // Fim: o resto é texto
+        pos += used;
+        if (!found) {
+            skipped += used;
+            continue;
+        }
+        uint32_t seq;
+        HOST_EXPECT(payload_ok(payload, plen, &seq));
+        if (seq != found_count) gaps++;
+        found_count++;
+    }
+    HOST_EXPECT_EQ(found_count, 50);
+    HOST_EXPECT_EQ(gaps, 0);
+    HOST_EXPECT_EQ(skipped, strlen(before) + strlen(after));
+    flash_file_close(&file);
+    unlink(flash_path);
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Vazão no simulador (mede o código do gravador + E/S do arquivo, não o
+// flash real): amostras do firmware na região de tamanho real
+HOST_TEST(test_throughput) {
+    fresh_path();
+    FlashFile file;
+    FlashDevice dev;
+    Recorder r;
+    flash_file_open(&file, flash_path, RECORDER_REGION_BYTES, false, &dev);
+    recorder_open(&r, &dev);
+
+    const uint32_t total = 100000;
+    uint8_t payload[RECORDER_SAMPLE_BYTES];
+    double t0 = now_s();
+    for (uint32_t i = 0; i < total; i++) {
+        RecorderSample s = {i * 500u, 300000u + i, 500000u, 290000u, 700000u, (uint8_t)(i % 3), 200};
+        recorder_sample_encode(&s, payload);
+        HOST_EXPECT(recorder_append(&r, payload, RECORDER_SAMPLE_BYTES));
+    }
+    recorder_flush(&r);
+    const double write_s = now_s() - t0;
+
+    t0 = now_s();
+    RecorderCursor c;
+    uint8_t buf[RECORDER_MAX_PAYLOAD];
+    uint8_t len;
+    uint32_t read = 0, last_ts = 0, order_errors = 0;
+    recorder_cursor_init(&c, &r);
+    while (recorder_cursor_next(&c, buf, &len)) {
+        RecorderSample s;
+        HOST_EXPECT(recorder_sample_decode(buf, len, &s));
+        if (read > 0 && s.timestamp_ms != last_ts + 500u) order_errors++;
+        last_ts = s.timestamp_ms;
+        read++;
+    }
+    const double read_s = now_s() - t0;
+
+    HOST_EXPECT_EQ(order_errors, 0);
+    HOST_EXPECT_EQ(last_ts, (total - 1) * 500u);
+    HOST_EXPECT(read > 9000); // A região guarda ~9,6 mil amostras
+    HOST_EXPECT(recorder_write_amplification(&r) < 1.35f);
+    printf("  append: %.0f amostras/s | leitura: %.0f amostras/s | %u retidas | "
+           "amplificação %.2fx | %u páginas, %u apagamentos\n",
+           total / write_s, read / read_s, read, recorder_write_amplification(&r),
+           r.stats.page_programs, r.stats.sector_erases);
+    flash_file_close(&file);
+    unlink(flash_path);
+}
+
+int main(void) {
+    HOST_RUN_TEST(test_round_trip_and_reopen);
+    HOST_RUN_TEST(test_flush_refills_same_page);
+    HOST_RUN_TEST(test_wraps_and_levels_wear);
+    HOST_RUN_TEST(test_power_loss_anywhere);
+    HOST_RUN_TEST(test_dump_frames_resync);
+    HOST_RUN_TEST(test_throughput);
+    HOST_TESTS_END();
+}
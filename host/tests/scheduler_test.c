@@ -0,0 +1,128 @@
+// Agendador de amostragem sobre o alarme do relógio virtual.
+#include "host/aht20_mock.h"
+#include "host/host_i2c.h"
+#include "host/tests/host_test.h"
+#include "lib/scheduler/scheduler.h"
+
+#define PERIOD_US 10000u
+
+static SampleScheduler sched;
+
+HOST_TEST(TicksFollowFixedGrid) {
+    HOST_EXPECT(sched_init(&sched, PERIOD_US));
+    for (uint32_t k = 1; k <= 20; k++) {
+        HOST_EXPECT_EQ(sched_wait_tick(&sched), sched.start_us + k * PERIOD_US);
+        sleep_us(PERIOD_US / 4); // Trabalho curto: não desloca a grade
+    }
+    SchedJitter j;
+    sched_jitter(&sched, &j);
+    HOST_EXPECT_EQ(sched.overruns, 0);
+    HOST_EXPECT(j.p99_us < 200); // Só o tempo real de CPU do próprio teste
+    HOST_EXPECT_NEAR(sched_utilization(&sched), 0.25, 0.03);
+    sched_stop(&sched);
+}
+
+HOST_TEST(LateLoopCountsOverrunsAndKeepsGrid) {
+    HOST_EXPECT(sched_init(&sched, PERIOD_US));
+    sched_wait_tick(&sched);
+    sleep_us(PERIOD_US * 5 / 2); // Passa por dois ticks (1,5 período de atraso)
+    uint64_t due = sched_wait_tick(&sched);
+    HOST_EXPECT_EQ(due, sched.start_us + 3 * PERIOD_US);
+    HOST_EXPECT_EQ(sched.overruns, 1);
+    HOST_EXPECT_EQ(sched.ticks_handled, 3);
+    HOST_EXPECT_NEAR(sched.jitter_max_us, PERIOD_US / 2, 200);
+    sched_stop(&sched);
+}
+
+HOST_TEST(JitterPercentiles) {
+    HOST_EXPECT(sched_init(&sched, PERIOD_US));
+    sched_wait_tick(&sched);
+    // Atrasos de 10, 20, ..., 1000 us, sempre dentro do período
+    for (uint32_t i = 1; i <= 100; i++) {
+        sleep_us(PERIOD_US + i * 10 - (time_us_64() - (sched.start_us + sched.ticks_handled * (uint64_t)PERIOD_US)));
+        sched_wait_tick(&sched);
+    }
+    SchedJitter j;
+    sched_jitter(&sched, &j);
+    HOST_EXPECT_EQ(sched.overruns, 0);
+    HOST_EXPECT_NEAR(j.p50_us, 500, 50);
+    HOST_EXPECT_NEAR(j.p90_us, 900, 50);
+    HOST_EXPECT_NEAR(j.p99_us, 990, 50);
+    HOST_EXPECT_NEAR(j.max_us, 1000, 50);
+    sched_stop(&sched);
+}
+
+HOST_TEST(QueueIsFifoAndDropsWhenFull) {
+    HOST_EXPECT(sched_init(&sched, PERIOD_US));
+    SensorReadings r = {0};
+    for (int i = 0; i < SCHED_QUEUE_DEPTH + 1; i++) {
+        uint64_t due = sched_wait_tick(&sched);
+        r.raw_temp_1 = (uint32_t)i;
+        sched_push(&sched, due, &r);
+    }
+    HOST_EXPECT_EQ(sched.samples, SCHED_QUEUE_DEPTH);
+    HOST_EXPECT_EQ(sched.dropped, 1);
+
+    ScheduledSample s;
+    for (int i = 0; i < SCHED_QUEUE_DEPTH; i++) {
+        HOST_EXPECT(sched_pop(&sched, &s));
+        HOST_EXPECT_EQ(s.readings.raw_temp_1, i);
+        HOST_EXPECT_EQ(s.seq, i + 1);
+        HOST_EXPECT_EQ(s.due_us, sched.start_us + (uint64_t)(i + 1) * PERIOD_US);
+    }
+    HOST_EXPECT(!sched_pop(&sched, &s));
+    sched_stop(&sched);
+}
+
+// Loop do firmware com os AHT20 simulados: acima de ~12 Hz a conversão de
+// 80 ms não acompanha e metade dos ticks fica sem amostra
+static void run_acquisition(uint32_t period_us, int ticks) {
+    static AHT20_Mock mock_1, mock_2;
+    host_i2c_detach_all();
+    aht20_mock_attach(&mock_1, I2C_PORT_0);
+    aht20_mock_attach(&mock_2, I2C_PORT_1);
+    init_i2c_sensor();
+    init_aht20();
+    sensors_start_conversion();
+
+    HOST_EXPECT(sched_init(&sched, period_us));
+    for (int i = 0; i < ticks; i++) {
+        uint64_t due = sched_wait_tick(&sched);
+        SensorReadings r;
+        if (sensors_poll(&r)) {
+            sensors_start_conversion();
+            sched_push(&sched, due, &r);
+        } else {
+            sched_drop(&sched);
+        }
+        ScheduledSample s;
+        while (sched_pop(&sched, &s)) {
+        }
+    }
+    sched_stop(&sched);
+}
+
+HOST_TEST(TenHertzKeepsUpWithSensor) {
+    run_acquisition(100000, 50);
+    HOST_EXPECT_EQ(sched.samples, 50);
+    HOST_EXPECT_EQ(sched.dropped, 0);
+    HOST_EXPECT_EQ(sched.overruns, 0);
+}
+
+HOST_TEST(TwentyHertzOutrunsConversion) {
+    run_acquisition(50000, 50);
+    HOST_EXPECT_EQ(sched.samples, 25);
+    HOST_EXPECT_EQ(sched.dropped, 25);
+    HOST_EXPECT_EQ(sched.overruns, 0);
+}
+
+int main(void) {
+    stdio_init_all();
+    HOST_RUN_TEST(TicksFollowFixedGrid);
+    HOST_RUN_TEST(LateLoopCountsOverrunsAndKeepsGrid);
+    HOST_RUN_TEST(JitterPercentiles);
+    HOST_RUN_TEST(QueueIsFifoAndDropsWhenFull);
+    HOST_RUN_TEST(TenHertzKeepsUpWithSensor);
+    HOST_RUN_TEST(TwentyHertzOutrunsConversion);
+    HOST_TESTS_END();
+}
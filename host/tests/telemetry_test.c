@@ -0,0 +1,226 @@
+// Telemetria binária: ida e volta do formato, ressincronização do
+// decodificador e o anel com um sink que aceita pouco ou fica ocupado.
+#include <string.h>
+
+#include "host/tests/host_test.h"
+#include "lib/telemetry/telemetry.h"
+
+static TelemetryRecord sample_record(int i) {
+    TelemetryRecord r;
+    memset(&r, 0, sizeof(r));
+    r.timestamp_ms = 500u * (uint32_t)i;
+    r.delta_t_raw = -12345 + i;
+    r.delta_u_raw = 67890 - i;
+    r.class_index = (uint8_t)(i % 3);
+    r.confidence = (uint8_t)(200 + i);
+    for (int s = 0; s < TELEMETRY_NUM_STAGES; s++) r.stage_us[s] = (uint16_t)(100 * s + i);
+    r.trend_centi_c_min = (int16_t)(-250 + i);
+    return r;
+}
+
+static bool same_record(const TelemetryRecord *a, const TelemetryRecord *b) {
+    return a->seq == b->seq && a->timestamp_ms == b->timestamp_ms &&
+           a->delta_t_raw == b->delta_t_raw && a->delta_u_raw == b->delta_u_raw &&
+           a->class_index == b->class_index && a->confidence == b->confidence &&
+           !memcmp(a->stage_us, b->stage_us, sizeof(a->stage_us)) &&
+           a->trend_centi_c_min == b->trend_centi_c_min;
+}
+
+HOST_TEST(test_encode_decode_round_trip) {
+    TelemetryRecord in = sample_record(7), out;
+    in.seq = 0xBEEF;
+    uint8_t bytes[TELEMETRY_RECORD_BYTES];
+    telemetry_encode(&in, bytes);
+    HOST_EXPECT_EQ(bytes[0], TELEMETRY_SYNC);
+    HOST_EXPECT_EQ(bytes[2], 0xEF); // little-endian
+    HOST_EXPECT_EQ(bytes[3], 0xBE);
+
+    bool found = false;
+    HOST_EXPECT_EQ(telemetry_decode(bytes, sizeof(bytes), &out, &found), TELEMETRY_RECORD_BYTES);
+    HOST_EXPECT(found);
+    HOST_EXPECT(same_record(&in, &out));
+
+    // Incompleto: nada a consumir ainda
+    HOST_EXPECT_EQ(telemetry_decode(bytes, sizeof(bytes) - 1, &out, &found), 0);
+    HOST_EXPECT(!found);
+}
+
+// Texto do stdio (inclusive com 0xA5) e um registro corrompido no meio do
+// fluxo: o decodificador pula o lixo e recupera todos os registros válidos.
+HOST_TEST(test_decode_resyncs) {
+    uint8_t stream[256];
+    size_t len = 0;
+    const char *text = "[SCHED] periodo 500000 us\n\xA5\xA5 lixo";
+    memcpy(stream, text, strlen(text));
+    len += strlen(text);
+
+    TelemetryRecord recs[3];
+    for (int i = 0; i < 3; i++) {
+        recs[i] = sample_record(i);
+        recs[i].seq = (uint16_t)i;
+        telemetry_encode(&recs[i], stream + len);
+        len += TELEMETRY_RECORD_BYTES;
+    }
+    stream[strlen(text) + TELEMETRY_RECORD_BYTES + 10] ^= 0x40; // corrompe o registro 1
+
+    int decoded = 0;
+    size_t pos = 0, skipped = 0;
+    uint16_t seqs[3];
+    while (pos < len) {
+        TelemetryRecord rec;
+        bool found;
+        size_t used = telemetry_decode(stream + pos, len - pos, &rec, &found);
+        if (used == 0) break;
+        pos += used;
+        if (!found) {
+            skipped += used;
+            continue;
+        }
+        HOST_EXPECT(same_record(&rec, &recs[rec.seq]));
+        if (decoded < 3) seqs[decoded] = rec.seq;
+        decoded++;
+    }
+    HOST_EXPECT_EQ(decoded, 2);
+    HOST_EXPECT_EQ(seqs[0], 0);
+    HOST_EXPECT_EQ(seqs[1], 2);
+    HOST_EXPECT_EQ(skipped, strlen(text) + TELEMETRY_RECORD_BYTES);
+    HOST_EXPECT_EQ(pos, len);
+}
+
+// Sink de teste: aceita até `limit` bytes por envio e fica ocupado até
+// `busy_calls` consultas de ready()
+typedef struct {
+    uint8_t out[8192];
+    size_t out_len;
+    size_t limit;
+    int busy_calls;
+    int busy_left;
+    int sends;
+} FakeSink;
+
+static size_t fake_send(void *ctx, const uint8_t *data, size_t len) {
+    FakeSink *s = (FakeSink *)ctx;
+    size_t n = len < s->limit ? len : s->limit;
+    memcpy(s->out + s->out_len, data, n);
+    s->out_len += n;
+    s->busy_left = s->busy_calls;
+    s->sends++;
+    return n;
+}
+
+static bool fake_ready(void *ctx) {
+    FakeSink *s = (FakeSink *)ctx;
+    if (s->busy_left > 0) {
+        s->busy_left--;
+        return false;
+    }
+    return true;
+}
+
+static int decode_all(const uint8_t *buf, size_t len, int first_seq) {
+    int n = 0;
+    size_t pos = 0;
+    while (pos < len) {
+        TelemetryRecord rec;
+        bool found;
+        size_t used = telemetry_decode(buf + pos, len - pos, &rec, &found);
+        if (used == 0 || !found) return -1;
+        TelemetryRecord expected = sample_record(first_seq + n);
+        expected.seq = (uint16_t)(first_seq + n);
+        if (!same_record(&rec, &expected)) return -1;
+        pos += used;
+        n++;
+    }
+    return n;
+}
+
+// Vários giros do anel com envios parciais e sink ocupado: a saída é o
+// fluxo de registros exato, sem bytes repetidos nem perdidos.
+HOST_TEST(test_ring_wraps_with_partial_sink) {
+    static Telemetry t;
+    static FakeSink fake;
+    memset(&fake, 0, sizeof(fake));
+    fake.limit = 7;
+    fake.busy_calls = 1;
+    TelemetrySink sink = {fake_send, fake_ready, &fake};
+    telemetry_init(&t, TELEMETRY_BINARY, &sink);
+
+    const int total = 200; // ~6 voltas no anel de 1 KiB
+    int pushed = 0;
+    for (int round = 0; pushed < total && round < 100000; round++) {
+        if (round % 12 == 0) { // ~7 bytes a cada 2 chamadas: o sink acompanha
+            TelemetryRecord rec = sample_record(pushed);
+            if (telemetry_push(&t, &rec)) pushed++;
+        }
+        telemetry_service(&t);
+    }
+    for (int i = 0; i < 100000 && telemetry_pending(&t); i++) telemetry_service(&t);
+
+    HOST_EXPECT_EQ(pushed, total);
+    HOST_EXPECT_EQ(t.dropped, 0);
+    HOST_EXPECT_EQ(telemetry_pending(&t), 0);
+    HOST_EXPECT_EQ(fake.out_len, (size_t)total * TELEMETRY_RECORD_BYTES);
+    HOST_EXPECT_EQ(decode_all(fake.out, fake.out_len, 0), total);
+}
+
+// Sink travado: o produtor nunca espera, descarta e conta
+HOST_TEST(test_full_ring_drops_without_blocking) {
+    static Telemetry t;
+    static FakeSink fake;
+    memset(&fake, 0, sizeof(fake));
+    fake.limit = 0; // nunca aceita
+    TelemetrySink sink = {fake_send, fake_ready, &fake};
+    telemetry_init(&t, TELEMETRY_BINARY, &sink);
+
+    const int capacity = TELEMETRY_RING_BYTES / TELEMETRY_RECORD_BYTES;
+    for (int i = 0; i < capacity + 10; i++) {
+        TelemetryRecord rec = sample_record(i);
+        telemetry_push(&t, &rec);
+        telemetry_service(&t);
+    }
+    HOST_EXPECT_EQ(t.written, capacity);
+    HOST_EXPECT_EQ(t.dropped, 10);
+
+    // Destrava: sai exatamente o que coube, em ordem
+    fake.limit = 64;
+    for (int i = 0; i < 1000 && telemetry_pending(&t); i++) telemetry_service(&t);
+    HOST_EXPECT_EQ(decode_all(fake.out, fake.out_len, 0), capacity);
+
+    // A numeração continua depois dos descartes: o salto de seq os denuncia
+    TelemetryRecord rec = sample_record(0);
+    HOST_EXPECT(telemetry_push(&t, &rec));
+    HOST_EXPECT_EQ(rec.seq, capacity);
+}
+
+HOST_TEST(test_text_format) {
+    TelemetryRecord r;
+    memset(&r, 0, sizeof(r));
+    r.delta_t_raw = 5243;   // 1,00 °C em códigos de 20 bits (200 °C / 2^20)
+    r.delta_u_raw = -20972; // -2,00 %
+    r.class_index = 2;
+    r.confidence = 255;
+    r.trend_centi_c_min = 125;
+    char line[128];
+    telemetry_format_text(&r, line, sizeof(line));
+    HOST_EXPECT(!strcmp(line, "ΔT: 1.00°C | ΔU: -2.00% | Trend ΔT: +1.25°C/min  -> "
+                              "⚠️ ALERTA: ANOMALIA/OBSTRUÇÃO! (100.0%)\n"));
+}
+
+HOST_TEST(test_saturation) {
+    HOST_EXPECT_EQ(telemetry_stage_us(1234), 1234);
+    HOST_EXPECT_EQ(telemetry_stage_us(70000), 0xFFFF);
+    HOST_EXPECT_EQ(telemetry_centi(1.234f), 123);
+    HOST_EXPECT_EQ(telemetry_centi(-1.235f), -124);
+    HOST_EXPECT_EQ(telemetry_centi(1e6f), 32767);
+    HOST_EXPECT_EQ(telemetry_centi(-1e6f), -32768);
+}
+
+int main(void) {
+    HOST_RUN_TEST(test_encode_decode_round_trip);
+    HOST_RUN_TEST(test_decode_resyncs);
+    HOST_RUN_TEST(test_ring_wraps_with_partial_sink);
+    HOST_RUN_TEST(test_full_ring_drops_without_blocking);
+    HOST_RUN_TEST(test_text_format);
+    HOST_RUN_TEST(test_saturation);
+    HOST_TESTS_END();
+}
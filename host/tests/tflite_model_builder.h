@@ -0,0 +1,110 @@
+// Modelos .tflite pequenos montados em memória para os testes host do
+// pico-tflmicro: tensores int8/int32 quantizados, pesos pseudoaleatórios
+// reproduzíveis e o flatbuffer final.
+#ifndef HOST_TESTS_TFLITE_MODEL_BUILDER_H
+#define HOST_TESTS_TFLITE_MODEL_BUILDER_H
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "tensorflow/lite/micro/micro_interpreter.h"  // TFLITE_SCHEMA_VERSION
+#include "tensorflow/lite/schema/schema_generated.h"
+
+// Um subgrafo, montado aos poucos: add_tensor devolve o índice do tensor
+struct HostModelBuilder {
+    tflite::ModelT model;
+    tflite::SubGraphT* g;
+    std::vector<float> tensor_scale;  // Primeira escala de cada tensor
+    uint32_t rng;
+
+    explicit HostModelBuilder(uint32_t seed) : rng(seed) {
+        model.version = TFLITE_SCHEMA_VERSION;
+        model.buffers.push_back(std::make_unique<tflite::BufferT>());  // 0: vazio
+        model.subgraphs.push_back(std::make_unique<tflite::SubGraphT>());
+        g = model.subgraphs.back().get();
+    }
+
+    // Zero points nulos; várias escalas quantizam por canal em quantized_dimension
+    int32_t add_tensor(std::vector<int32_t> shape, tflite::TensorType type, uint32_t buffer,
+                       std::vector<float> scales, int quantized_dimension = 0) {
+        auto t = std::make_unique<tflite::TensorT>();
+        t->shape = shape;
+        t->type = type;
+        t->buffer = buffer;
+        t->quantization = std::make_unique<tflite::QuantizationParametersT>();
+        t->quantization->scale = scales;
+        t->quantization->zero_point.assign(scales.size(), 0);
+        t->quantization->quantized_dimension = quantized_dimension;
+        g->tensors.push_back(std::move(t));
+        tensor_scale.push_back(scales[0]);
+        return (int32_t)g->tensors.size() - 1;
+    }
+
+    uint32_t add_buffer(const std::vector<uint8_t>& data) {
+        auto b = std::make_unique<tflite::BufferT>();
+        b->data = data;
+        model.buffers.push_back(std::move(b));
+        return (uint32_t)model.buffers.size() - 1;
+    }
+
+    // Índice do código do operador, criado na primeira vez
+    uint32_t opcode(tflite::BuiltinOperator op, int version = 1, const char* custom = nullptr) {
+        for (size_t i = 0; i < model.operator_codes.size(); i++) {
+            if (model.operator_codes[i]->builtin_code == op) return (uint32_t)i;
+        }
+        auto code = std::make_unique<tflite::OperatorCodeT>();
+        code->builtin_code = op;
+        code->deprecated_builtin_code = (int8_t)op;
+        code->version = version;
+        if (custom) code->custom_code = custom;
+        model.operator_codes.push_back(std::move(code));
+        return (uint32_t)model.operator_codes.size() - 1;
+    }
+
+    // O chamador preenche builtin_options no operador devolvido
+    tflite::OperatorT* add_operator(uint32_t opcode_index, std::vector<int32_t> inputs,
+                                    std::vector<int32_t> outputs) {
+        auto op = std::make_unique<tflite::OperatorT>();
+        op->opcode_index = opcode_index;
+        op->inputs = inputs;
+        op->outputs = outputs;
+        g->operators.push_back(std::move(op));
+        return g->operators.back().get();
+    }
+
+    // Pesos int8 de um gerador congruencial, reproduzíveis pela semente
+    std::vector<uint8_t> random_int8(size_t n) {
+        std::vector<uint8_t> data(n);
+        for (size_t i = 0; i < n; i++) {
+            rng = rng * 1664525u + 1013904223u;
+            data[i] = (uint8_t)(rng >> 24);
+        }
+        return data;
+    }
+
+    // Bias int32 de n canais, em -120..120 com o sinal variando entre canais
+    static std::vector<uint8_t> bias_int32(int n) {
+        std::vector<uint8_t> data;
+        for (int o = 0; o < n; o++) {
+            const int32_t b = (o % 7 - 3) * 40;
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&b);
+            data.insert(data.end(), bytes, bytes + sizeof(b));
+        }
+        return data;
+    }
+
+    std::vector<uint8_t> finish(std::vector<int32_t> inputs, std::vector<int32_t> outputs) {
+        g->inputs = inputs;
+        g->outputs = outputs;
+        // O flatbuffers do TFLM não tem alocador padrão implícito
+        flatbuffers::DefaultAllocator alloc;
+        flatbuffers::FlatBufferBuilder fbb(4096, &alloc);
+        tflite::FinishModelBuffer(fbb, tflite::Model::Pack(fbb, &model));
+        return std::vector<uint8_t>(fbb.GetBufferPointer(),
+                                    fbb.GetBufferPointer() + fbb.GetSize());
+    }
+};
+
+#endif // HOST_TESTS_TFLITE_MODEL_BUILDER_H
@@ -0,0 +1,183 @@
+// Cache de resultados do tflm_wrapper: o modo exato não muda nenhuma saída,
+// o modo epsilon respeita o limite de reusos e um modelo com tensor variável
+// passa sempre direto pelo interpreter.
+#include <string.h>
+
+#include <vector>
+
+#include "host/tests/captures.h"
+#include "host/tests/host_test.h"
+#include "lib/model_slot/model_slot.h"
+#include "modelo_predator.h"
+#include "modelo_predator_arena.h"
+#include "tflm_wrapper.h"
+
+#include "tensorflow/lite/schema/schema_generated.h"
+
+static std::vector<float> load_inputs(void) {
+    std::vector<float> inputs;
+    for (int f = 0; f < HOST_NUM_CAPTURES; f++) {
+        FILE* fp = fopen(host_captures[f], "r");
+        if (!fp) continue;
+        float v[5];
+        while (host_read_capture_row(fp, v)) {
+            inputs.push_back(((v[1] - v[3]) - HOST_MEAN_DELTA_T) / HOST_STD_DELTA_T);
+            inputs.push_back(((v[2] - v[4]) - HOST_MEAN_DELTA_U) / HOST_STD_DELTA_U);
+        }
+        fclose(fp);
+    }
+    return inputs;
+}
+
+struct Result {
+    int class_index;
+    float confidence;
+};
+
+static std::vector<Result> classify_all(const std::vector<float>& inputs) {
+    std::vector<Result> out(inputs.size() / 2);
+    for (size_t i = 0; i < out.size(); i++) {
+        TflmDecision d;
+        tflm_classify(&inputs[2 * i], &d);
+        out[i] = {d.class_index, tflm_decision_confidence(&d)};
+    }
+    return out;
+}
+
+static void set_policy(TflmCacheMode mode, float epsilon = 0.0f, uint32_t max_reuse = 0) {
+    const TflmCachePolicy p = {mode, epsilon, max_reuse};
+    tflm_cache_configure(&p);
+    tflm_cache_reset_stats();
+}
+
+HOST_TEST(ExactCacheIsTransparent) {
+    const std::vector<float> inputs = load_inputs();
+    HOST_EXPECT(inputs.size() / 2 > 10000);
+
+    set_policy(TFLM_CACHE_OFF);
+    const std::vector<Result> reference = classify_all(inputs);
+    TflmCacheStats off;
+    tflm_cache_stats(&off);
+    HOST_EXPECT(off.bypass);
+    HOST_EXPECT_EQ(off.bypassed, reference.size());
+    HOST_EXPECT_EQ(off.hits, 0);
+
+    set_policy(TFLM_CACHE_EXACT);
+    const std::vector<Result> cached = classify_all(inputs);
+    int mismatches = 0;
+    for (size_t i = 0; i < cached.size(); i++) {
+        mismatches += cached[i].class_index != reference[i].class_index ||
+                      memcmp(&cached[i].confidence, &reference[i].confidence, sizeof(float)) != 0;
+    }
+    TflmCacheStats st;
+    tflm_cache_stats(&st);
+    printf("  exato: %u consultas, %u acertos (%.1f%%), %u substituições, economia ~%llu us de %llu us\n",
+           st.lookups, st.hits, 100.0 * st.hits / st.lookups, st.evictions,
+           (unsigned long long)st.saved_us, (unsigned long long)(st.invoke_us + st.saved_us));
+    HOST_EXPECT_EQ(mismatches, 0);
+    HOST_EXPECT(!st.bypass);
+    HOST_EXPECT_EQ(st.lookups, cached.size());
+    HOST_EXPECT_EQ(st.hits + st.misses, st.lookups);
+    // O modelo atual tem entrada float: leituras repetidas bit a bit são raras
+    // nas capturas, o ganho grande vem do modo epsilon
+    HOST_EXPECT(st.hits > 0);
+}
+
+HOST_TEST(EpsilonReuseIsBounded) {
+    const std::vector<float> inputs = load_inputs();
+    set_policy(TFLM_CACHE_OFF);
+    const std::vector<Result> reference = classify_all(inputs);
+
+    const uint32_t max_reuse = 4;
+    set_policy(TFLM_CACHE_EPSILON, 0.05f, max_reuse);
+    uint32_t run = 0, longest = 0, prev_hits = 0;
+    int mismatches = 0;
+    for (size_t i = 0; i < reference.size(); i++) {
+        TflmDecision d;
+        tflm_classify(&inputs[2 * i], &d);
+        mismatches += d.class_index != reference[i].class_index;
+        TflmCacheStats st;
+        tflm_cache_stats(&st);
+        run = st.hits != prev_hits ? run + 1 : 0;
+        prev_hits = st.hits;
+        if (run > longest) longest = run;
+    }
+    TflmCacheStats st;
+    tflm_cache_stats(&st);
+    printf("  epsilon 0.05: %u acertos de %u (%.1f%%), %d decisões diferentes do Invoke, "
+           "maior sequência de reusos %u\n",
+           st.hits, st.lookups, 100.0 * st.hits / st.lookups, mismatches, longest);
+    HOST_EXPECT_EQ(longest, max_reuse);
+    HOST_EXPECT(st.hits > 0);
+    HOST_EXPECT(mismatches < (int)reference.size() / 100);
+
+    // Mudança maior que epsilon nunca reusa
+    set_policy(TFLM_CACHE_EPSILON, 0.05f, 0);
+    float a[2] = {0.0f, 0.0f}, b[2] = {0.2f, 0.0f};
+    TflmDecision d;
+    tflm_classify(a, &d);
+    tflm_classify(b, &d);
+    tflm_classify(a, &d);
+    tflm_cache_stats(&st);
+    HOST_EXPECT_EQ(st.hits, 0);
+    HOST_EXPECT_EQ(st.misses, 3);
+}
+
+// O modelo embarcado com a saída da primeira camada marcada como tensor
+// variável: mesmo grafo, mas o TFLM passa a tratá-lo como estado
+static std::vector<uint8_t> stateful_variant(void) {
+    std::unique_ptr<tflite::ModelT> model = tflite::UnPackModel(modelo_tflite);
+    tflite::SubGraphT& g = *model->subgraphs[0];
+    g.tensors[g.operators[0]->outputs[0]]->is_variable = true;
+    // O flatbuffers do TFLM não tem alocador padrão implícito
+    flatbuffers::DefaultAllocator alloc;
+    flatbuffers::FlatBufferBuilder fbb(1024, &alloc);
+    tflite::FinishModelBuffer(fbb, tflite::Model::Pack(fbb, model.get()));
+
+    std::vector<uint8_t> image(MODEL_SLOT_HEADER_BYTES + fbb.GetSize());
+    model_slot_pack(fbb.GetBufferPointer(), fbb.GetSize(), TFLM_MODEL_SCHEMA_VERSION,
+                    MODELO_ARENA_SIZE, 1, image.data(), (uint32_t)image.size());
+    return image;
+}
+
+static bool swap_to(const std::vector<uint8_t>& image) {
+    if (tflm_swap_begin(image.data(), (uint32_t)image.size()) != 0) return false;
+    TflmSwapState s;
+    while ((s = tflm_swap_service()) == TFLM_SWAP_CHECKING || s == TFLM_SWAP_PREPARING) {
+    }
+    return s == TFLM_SWAP_READY && tflm_swap_commit() == 0;
+}
+
+HOST_TEST(VariableTensorsBypassCache) {
+    set_policy(TFLM_CACHE_EXACT);
+    const std::vector<uint8_t> stateful = stateful_variant();
+    HOST_EXPECT(swap_to(stateful));
+
+    float x[2] = {0.3f, -0.7f};
+    TflmDecision d;
+    for (int i = 0; i < 5; i++) HOST_EXPECT_EQ(tflm_classify(x, &d), 0);
+    TflmCacheStats st;
+    tflm_cache_stats(&st);
+    HOST_EXPECT(st.bypass);
+    HOST_EXPECT_EQ(st.bypassed, 5);
+    HOST_EXPECT_EQ(st.hits, 0);
+
+    // De volta a um modelo sem estado: o cache volta a valer
+    std::vector<uint8_t> plain(MODEL_SLOT_HEADER_BYTES + modelo_tflite_len);
+    model_slot_pack(modelo_tflite, modelo_tflite_len, TFLM_MODEL_SCHEMA_VERSION, MODELO_ARENA_SIZE, 2,
+                    plain.data(), (uint32_t)plain.size());
+    HOST_EXPECT(swap_to(plain));
+    tflm_cache_reset_stats();
+    for (int i = 0; i < 5; i++) tflm_classify(x, &d);
+    tflm_cache_stats(&st);
+    HOST_EXPECT(!st.bypass);
+    HOST_EXPECT_EQ(st.hits, 4);
+}
+
+int main(void) {
+    HOST_EXPECT_EQ(tflm_init_ex(TFLM_STRIP_SOFTMAX), 0);
+    HOST_RUN_TEST(ExactCacheIsTransparent);
+    HOST_RUN_TEST(EpsilonReuseIsBounded);
+    HOST_RUN_TEST(VariableTensorsBypassCache);
+    HOST_TESTS_END();
+}
@@ -0,0 +1,80 @@
+// Modo decisão (softmax final removido) contra um interpreter de referência
+// com o grafo completo, sobre todas as capturas gravadas.
+#include <math.h>
+
+#include "host/tests/captures.h"
+#include "host/tests/host_test.h"
+#include "modelo_predator.h"
+#include "tflm_wrapper.h"
+
+#include "tensorflow/lite/micro/micro_interpreter.h"
+#include "tensorflow/lite/micro/micro_mutable_op_resolver.h"
+
+alignas(16) static uint8_t reference_arena[16 * 1024];
+
+HOST_TEST(StrippedSoftmaxMatchesFullGraph) {
+    static tflite::MicroMutableOpResolver<2> resolver;
+    resolver.AddFullyConnected();
+    resolver.AddSoftmax();
+    static tflite::MicroInterpreter reference(tflite::GetModel(modelo_tflite), resolver,
+                                              reference_arena, sizeof(reference_arena));
+    HOST_EXPECT_EQ(reference.AllocateTensors(), kTfLiteOk);
+    TfLiteTensor* ref_in = reference.input(0);
+    TfLiteTensor* ref_out = reference.output(0);
+    HOST_EXPECT_EQ(ref_in->type, kTfLiteFloat32);
+
+    int rows = 0, mismatches = 0;
+    float max_conf_err = 0.0f;
+    for (int f = 0; f < HOST_NUM_CAPTURES; f++) {
+        FILE* fp = fopen(host_captures[f], "r");
+        HOST_EXPECT(fp != nullptr);
+        if (!fp) continue;
+        float v[5];
+        while (host_read_capture_row(fp, v)) {
+            float inputs[2] = {((v[1] - v[3]) - HOST_MEAN_DELTA_T) / HOST_STD_DELTA_T,
+                               ((v[2] - v[4]) - HOST_MEAN_DELTA_U) / HOST_STD_DELTA_U};
+
+            ref_in->data.f[0] = inputs[0];
+            ref_in->data.f[1] = inputs[1];
+            reference.Invoke();
+            int ref_class = 0;
+            for (int i = 1; i < 3; i++) {
+                if (ref_out->data.f[i] > ref_out->data.f[ref_class]) ref_class = i;
+            }
+
+            TflmDecision d;
+            HOST_EXPECT_EQ(tflm_classify(inputs, &d), 0);
+            mismatches += d.class_index != ref_class;
+            float err = fabsf(tflm_decision_confidence(&d) - ref_out->data.f[ref_class]);
+            if (err > max_conf_err) max_conf_err = err;
+            rows++;
+        }
+        fclose(fp);
+    }
+    printf("  %d linhas, %d decisões divergentes, erro máx de confiança %g\n",
+           rows, mismatches, max_conf_err);
+    HOST_EXPECT(rows > 10000);
+    HOST_EXPECT_EQ(mismatches, 0);
+    HOST_EXPECT(max_conf_err < 1e-5f);
+}
+
+HOST_TEST(LegacyPredictStillDequantizes) {
+    float inputs[2] = {0.5f, -0.5f};
+    float outputs[3];
+    tflm_predict(inputs, outputs);
+    TflmDecision d;
+    tflm_classify(inputs, &d);
+    // Com o softmax removido a saída são logits: o argmax continua o mesmo
+    int best = 0;
+    for (int i = 1; i < 3; i++) {
+        if (outputs[i] > outputs[best]) best = i;
+    }
+    HOST_EXPECT_EQ(best, d.class_index);
+}
+
+int main(void) {
+    HOST_EXPECT_EQ(tflm_init_ex(TFLM_STRIP_SOFTMAX), 0);
+    HOST_RUN_TEST(StrippedSoftmaxMatchesFullGraph);
+    HOST_RUN_TEST(LegacyPredictStillDequantizes);
+    HOST_TESTS_END();
+}
@@ -0,0 +1,116 @@
+// Backend de tabela (tflm_lut.c + modelo_predator_lut.h) contra um interpreter
+// de referência: paridade exata nos 65.536 pontos de entrada e concordância
+// sobre as capturas gravadas, pelo caminho inteiro de lib/preproc.
+#include <math.h>
+#include <string.h>
+
+#include "host/tests/captures.h"
+#include "host/tests/host_test.h"
+extern "C" {
+#include "lib/preproc/preproc.h"
+}
+#include "modelo_predator.h"
+#include "modelo_predator_lut.h"
+#include "tflm_lut.h"
+#include "tflm_wrapper.h"
+
+#include "tensorflow/lite/micro/micro_interpreter.h"
+#include "tensorflow/lite/micro/micro_mutable_op_resolver.h"
+
+alignas(16) static uint8_t reference_arena[16 * 1024];
+static TfLiteTensor* ref_in;
+static TfLiteTensor* ref_out;
+static tflite::MicroInterpreter* reference;
+
+static int reference_class(float z0, float z1, float* confidence) {
+    ref_in->data.f[0] = z0;
+    ref_in->data.f[1] = z1;
+    reference->Invoke();
+    int best = 0;
+    for (int i = 1; i < 3; i++) {
+        if (ref_out->data.f[i] > ref_out->data.f[best]) best = i;
+    }
+    *confidence = ref_out->data.f[best];
+    return best;
+}
+
+HOST_TEST(TableMatchesCurrentModel) {
+    HOST_EXPECT_EQ(tflm_lut_model_hash(modelo_tflite, modelo_tflite_len), MODELO_LUT_MODEL_HASH);
+}
+
+HOST_TEST(ExactParityOverWholeDomain) {
+    int class_mismatches = 0, conf_mismatches = 0;
+    for (int q0 = -128; q0 <= 127; q0++) {
+        for (int q1 = -128; q1 <= 127; q1++) {
+            float conf;
+            int ref = reference_class((q0 - MODELO_LUT_INPUT_ZERO_POINT) * MODELO_LUT_INPUT_SCALE,
+                                      (q1 - MODELO_LUT_INPUT_ZERO_POINT) * MODELO_LUT_INPUT_SCALE,
+                                      &conf);
+            int8_t q[2] = {(int8_t)q0, (int8_t)q1};
+            TflmDecision d;
+            HOST_EXPECT_EQ(tflm_classify_quantized(q, &d), 0);
+            class_mismatches += d.class_index != ref;
+#if MODELO_LUT_CONFIDENCE_BITS > 0
+            conf_mismatches += d.confidence_q != lroundf(conf * TFLM_LUT_CONF_MAX);
+#endif
+        }
+    }
+    HOST_EXPECT_EQ(class_mismatches, 0);
+    HOST_EXPECT_EQ(conf_mismatches, 0);
+}
+
+HOST_TEST(AgreementOnRecordedCaptures) {
+    PreprocFixed p;
+    HOST_EXPECT(preproc_fixed_init(&p, HOST_MEAN_DELTA_T, HOST_STD_DELTA_T, HOST_MEAN_DELTA_U,
+                                   HOST_STD_DELTA_U, tflm_input_scale(), tflm_input_zero_point()));
+    int rows = 0, agree = 0;
+    for (int f = 0; f < HOST_NUM_CAPTURES; f++) {
+        FILE* fp = fopen(host_captures[f], "r");
+        HOST_EXPECT(fp != nullptr);
+        if (!fp) continue;
+        float v[5];
+        while (host_read_capture_row(fp, v)) {
+            // Interpreter com o z-score exato em float
+            float conf;
+            int ref = reference_class(((v[1] - v[3]) - HOST_MEAN_DELTA_T) / HOST_STD_DELTA_T,
+                                      ((v[2] - v[4]) - HOST_MEAN_DELTA_U) / HOST_STD_DELTA_U,
+                                      &conf);
+            // Tabela pelo caminho inteiro a partir dos códigos brutos
+            SensorReadings r;
+            memset(&r, 0, sizeof(r));
+            r.raw_temp_1 = (uint32_t)lround((v[1] + 50.0) * AHT20_RAW_FULL_SCALE / 200.0);
+            r.raw_humidity_1 = (uint32_t)lround(v[2] * AHT20_RAW_FULL_SCALE / 100.0);
+            r.raw_temp_2 = (uint32_t)lround((v[3] + 50.0) * AHT20_RAW_FULL_SCALE / 200.0);
+            r.raw_humidity_2 = (uint32_t)lround(v[4] * AHT20_RAW_FULL_SCALE / 100.0);
+            int8_t q[2];
+            preproc_fixed_quantize(&p, &r, q);
+            TflmDecision d;
+            tflm_classify_quantized(q, &d);
+            agree += d.class_index == ref;
+            rows++;
+        }
+        fclose(fp);
+    }
+    printf("  %d linhas, concordância com o interpreter float: %.3f%%\n", rows,
+           100.0 * agree / rows);
+    HOST_EXPECT(rows > 10000);
+    HOST_EXPECT(agree >= rows * 999 / 1000);
+}
+
+int main(void) {
+    static tflite::MicroMutableOpResolver<2> resolver;
+    resolver.AddFullyConnected();
+    resolver.AddSoftmax();
+    static tflite::MicroInterpreter interpreter(tflite::GetModel(modelo_tflite), resolver,
+                                                reference_arena, sizeof(reference_arena));
+    interpreter.AllocateTensors();
+    reference = &interpreter;
+    ref_in = interpreter.input(0);
+    ref_out = interpreter.output(0);
+
+    HOST_EXPECT_EQ(tflm_init(), 0);
+    HOST_RUN_TEST(TableMatchesCurrentModel);
+    HOST_RUN_TEST(ExactParityOverWholeDomain);
+    HOST_RUN_TEST(AgreementOnRecordedCaptures);
+    HOST_TESTS_END();
+}
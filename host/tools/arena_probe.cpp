@@ -0,0 +1,179 @@
+#include "host/tools/arena_probe.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "tensorflow/lite/micro/micro_interpreter.h"
+#include "tensorflow/lite/micro/recording_micro_interpreter.h"
+#include "tflm_ops.h"
+
+namespace {
+
+constexpr size_t kProbeArenaBytes = 256 * 1024;
+alignas(16) uint8_t probe_arena[kProbeArenaBytes];
+
+// ------------------------------------------------------------
+// Contagem de scratch: o RecordingMicroAllocator não registra os pedidos de
+// scratch (ficam na cabeça, junto com as ativações). Cada registro do
+// resolver é copiado com um Prepare que instala um contador no
+// TfLiteContext antes de chamar o Prepare original.
+// ------------------------------------------------------------
+const TFLMRegistration* original_ops[kTflmMaxOps];
+TFLMRegistration counted_ops[kTflmMaxOps];
+int num_counted_ops = 0;
+
+TfLiteStatus (*request_scratch)(TfLiteContext*, size_t, int*) = nullptr;
+size_t scratch_bytes = 0;
+int scratch_requests = 0;
+
+TfLiteStatus CountingRequestScratch(TfLiteContext* context, size_t bytes, int* buffer_idx) {
+    scratch_bytes += bytes;
+    scratch_requests++;
+    return request_scratch(context, bytes, buffer_idx);
+}
+
+template <int N>
+TfLiteStatus CountingPrepare(TfLiteContext* context, TfLiteNode* node) {
+    if (context->RequestScratchBufferInArena != CountingRequestScratch) {
+        request_scratch = context->RequestScratchBufferInArena;
+        context->RequestScratchBufferInArena = CountingRequestScratch;
+    }
+    return original_ops[N]->prepare ? original_ops[N]->prepare(context, node) : kTfLiteOk;
+}
+
+constexpr TfLiteStatus (*kCountingPrepare[])(TfLiteContext*, TfLiteNode*) = {
+    CountingPrepare<0>,  CountingPrepare<1>,  CountingPrepare<2>,  CountingPrepare<3>,
+    CountingPrepare<4>,  CountingPrepare<5>,  CountingPrepare<6>,  CountingPrepare<7>,
+    CountingPrepare<8>,  CountingPrepare<9>,  CountingPrepare<10>, CountingPrepare<11>,
+    CountingPrepare<12>, CountingPrepare<13>, CountingPrepare<14>, CountingPrepare<15>,
+};
+static_assert(sizeof(kCountingPrepare) / sizeof(kCountingPrepare[0]) == kTflmMaxOps,
+              "um CountingPrepare<N> por slot do resolver");
+
+class ScratchCountingResolver : public tflite::MicroOpResolver {
+ public:
+    explicit ScratchCountingResolver(const TflmOpResolver& inner) : inner_(inner) {}
+
+    const TFLMRegistration* FindOp(tflite::BuiltinOperator op) const override {
+        return wrap(inner_.FindOp(op));
+    }
+    const TFLMRegistration* FindOp(const char* op) const override {
+        return wrap(inner_.FindOp(op));
+    }
+    tflite::TfLiteBridgeBuiltinParseFunction GetOpDataParser(tflite::BuiltinOperator op) const override {
+        return inner_.GetOpDataParser(op);
+    }
+
+ private:
+    static const TFLMRegistration* wrap(const TFLMRegistration* reg) {
+        if (!reg) return nullptr;
+        for (int i = 0; i < num_counted_ops; i++) {
+            if (original_ops[i] == reg) return &counted_ops[i];
+        }
+        if (num_counted_ops == kTflmMaxOps) return nullptr;
+        int i = num_counted_ops++;
+        original_ops[i] = reg;
+        counted_ops[i] = *reg;
+        counted_ops[i].prepare = kCountingPrepare[i];
+        return &counted_ops[i];
+    }
+
+    const TflmOpResolver& inner_;
+};
+
+// Mesmo resolver do firmware, com o SOFTMAX padrão (o maior dos dois modos)
+const TflmOpResolver& firmware_resolver() {
+    static TflmOpResolver resolver;
+    static bool ready = false;
+    if (!ready) {
+        tflm_add_ops_except_softmax(resolver);
+        resolver.AddSoftmax();
+        ready = true;
+    }
+    return resolver;
+}
+
+// AllocateTensors + Invoke em uma arena de `bytes` bytes (interpreter comum)
+bool fits(const tflite::Model* model, size_t bytes, size_t* used) {
+    // Com a arena pequena demais até o próprio allocator deixa de caber
+    tflite::MicroAllocator* allocator = tflite::MicroAllocator::Create(probe_arena, bytes);
+    if (!allocator) return false;
+    tflite::MicroInterpreter interpreter(model, firmware_resolver(), allocator);
+    if (interpreter.AllocateTensors() != kTfLiteOk) return false;
+    if (interpreter.Invoke() != kTfLiteOk) return false;
+    *used = interpreter.arena_used_bytes();
+    return true;
+}
+
+// O TFLM nem sempre se recupera de uma alocação que falha no meio do
+// AllocateTensors (ponteiro nulo em kernels), então cada tentativa da busca
+// roda em um processo filho
+bool fits_isolated(const tflite::Model* model, size_t bytes) {
+    fflush(nullptr);
+    pid_t pid = fork();
+    if (pid == 0) {
+        // Os avisos de falta de memória do TFLM são esperados aqui
+        freopen("/dev/null", "w", stderr);
+        freopen("/dev/null", "w", stdout);
+        size_t used;
+        _exit(fits(model, bytes, &used) ? 0 : 1);
+    }
+    int status = 0;
+    if (pid < 0 || waitpid(pid, &status, 0) != pid) return false;
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+}  // namespace
+
+const char* arena_allocation_name(int type) {
+    static const char* const names[] = {
+        "TfLiteEvalTensor",     "TfLiteTensor persistente", "quantizacao persistente",
+        "buffers persistentes", "buffers de variaveis",     "NodeAndRegistration",
+        "OpData",               "compressao",
+    };
+    return type < (int)(sizeof(names) / sizeof(names[0])) ? names[type] : "?";
+}
+
+bool arena_probe(const tflite::Model* model, ArenaReport* report) {
+    memset(report, 0, sizeof(*report));
+
+    // Gravação: detalhamento por tipo + scratch
+    {
+        scratch_bytes = 0;
+        scratch_requests = 0;
+        ScratchCountingResolver resolver(firmware_resolver());
+        tflite::RecordingMicroInterpreter interpreter(model, resolver, probe_arena,
+                                                      kProbeArenaBytes);
+        if (interpreter.AllocateTensors() != kTfLiteOk) return false;
+        const tflite::RecordingMicroAllocator& allocator = interpreter.GetMicroAllocator();
+        const auto* arena = allocator.GetSimpleMemoryAllocator();
+        // O próprio RecordingMicroAllocator mora na cauda; não é do modelo
+        report->persistent_bytes =
+            arena->GetPersistentUsedBytes() - tflite::RecordingMicroAllocator::GetDefaultTailUsage();
+        report->non_persistent_bytes = arena->GetNonPersistentUsedBytes();
+        for (int t = 0; t < (int)tflite::RecordedAllocationType::kNumAllocationTypes; t++) {
+            report->by_type[t] =
+                allocator.GetRecordedAllocation((tflite::RecordedAllocationType)t);
+        }
+        report->scratch_bytes = scratch_bytes;
+        report->scratch_requests = scratch_requests;
+    }
+
+    // Mínimo exato com o MicroAllocator comum (o que o firmware usa): busca
+    // binária no tamanho, em passos do alinhamento da arena
+    size_t used = 0;
+    if (!fits(model, kProbeArenaBytes, &used)) return false;
+    size_t lo = 0, hi = kProbeArenaBytes / 16;
+    while (lo + 1 < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (fits_isolated(model, mid * 16)) {
+            hi = mid;
+        } else {
+            lo = mid;
+        }
+    }
+    report->min_arena_bytes = hi * 16;
+    return fits(model, report->min_arena_bytes, &report->used_bytes);
+}
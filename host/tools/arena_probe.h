@@ -0,0 +1,23 @@
+#pragma once
+// Medição do uso de arena de um modelo com o RecordingMicroAllocator, usada
+// pelo arena_sizer e pelo teste que confere modelo_predator_arena.h.
+#include <stddef.h>
+
+#include "tensorflow/lite/micro/recording_micro_allocator.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+struct ArenaReport {
+    size_t min_arena_bytes;        // Menor arena em que AllocateTensors + Invoke funcionam
+    size_t used_bytes;             // arena_used_bytes() do interpreter comum nessa arena
+    size_t persistent_bytes;       // Cauda: tensores, OpData, buffers persistentes
+    size_t non_persistent_bytes;   // Cabeça: ativações + scratch, sobrepostos pelo planner
+    size_t scratch_bytes;          // Soma dos pedidos de scratch dos kernels
+    int scratch_requests;
+    tflite::RecordedAllocation by_type[(int)tflite::RecordedAllocationType::kNumAllocationTypes];
+};
+
+// Preenche o relatório; false se o modelo não aloca nem em uma arena grande
+bool arena_probe(const tflite::Model* model, ArenaReport* report);
+
+// Nome curto de cada RecordedAllocationType, na ordem do enum
+const char* arena_allocation_name(int type);
@@ -0,0 +1,84 @@
+// Mede a arena que modelo_predator.h realmente precisa e gera
+// modelo_predator_arena.h com o tamanho mínimo alinhado + margem.
+//
+//   arena_sizer [-o arquivo.h] [--margin PCT]
+//
+// O mínimo é exato para o build host (busca binária com o MicroAllocator
+// comum). No RP2040 os ponteiros e as structs do TFLM são menores, então o
+// valor do host é um limite superior.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host/tools/arena_probe.h"
+#include "modelo_predator.h"
+#include "tflm_lut.h"
+
+namespace {
+
+struct Options {
+    const char* output = "modelo_predator_arena.h";
+    int margin_pct = 10;
+};
+
+bool parse_args(int argc, char** argv, Options* opt) {
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-o") && i + 1 < argc) {
+            opt->output = argv[++i];
+        } else if (!strcmp(argv[i], "--margin") && i + 1 < argc) {
+            opt->margin_pct = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "uso: %s [-o arquivo.h] [--margin PCT]\n", argv[0]);
+            return false;
+        }
+    }
+    return opt->margin_pct >= 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parse_args(argc, argv, &opt)) return 2;
+
+    ArenaReport r;
+    if (!arena_probe(tflite::GetModel(modelo_tflite), &r)) {
+        fprintf(stderr, "[ARENA] ERRO: o modelo não aloca nem em 256 KB\n");
+        return 1;
+    }
+    size_t margin = (r.min_arena_bytes * opt.margin_pct + 99) / 100;
+    size_t arena = (r.min_arena_bytes + margin + 15) & ~(size_t)15;
+
+    printf("[ARENA] persistente (cauda):     %6zu bytes\n", r.persistent_bytes);
+    for (int t = 0; t < (int)tflite::RecordedAllocationType::kNumAllocationTypes; t++) {
+        if (r.by_type[t].count == 0) continue;
+        printf("[ARENA]   %-24s %6zu bytes (%zu pedidos, %zu solicitados)\n",
+               arena_allocation_name(t), r.by_type[t].used_bytes, r.by_type[t].count,
+               r.by_type[t].requested_bytes);
+    }
+    printf("[ARENA] não persistente (cabeça): %5zu bytes\n", r.non_persistent_bytes);
+    printf("[ARENA]   scratch                  %6zu bytes (%d pedidos)\n", r.scratch_bytes,
+           r.scratch_requests);
+    printf("[ARENA] mínimo: %zu bytes (arena_used_bytes=%zu), com margem de %d%%: %zu bytes\n",
+           r.min_arena_bytes, r.used_bytes, opt.margin_pct, arena);
+
+    FILE* fp = fopen(opt.output, "w");
+    if (!fp) {
+        fprintf(stderr, "[ARENA] ERRO: não foi possível escrever %s\n", opt.output);
+        return 1;
+    }
+    fprintf(fp, "#ifndef MODELO_PREDATOR_ARENA_H\n#define MODELO_PREDATOR_ARENA_H\n\n");
+    fprintf(fp, "// Gerado por host/tools/arena_sizer a partir de modelo_predator.h. Não edite.\n");
+    fprintf(fp, "// Persistente: %zu bytes, não persistente: %zu bytes (scratch: %zu bytes)\n\n",
+            r.persistent_bytes, r.non_persistent_bytes, r.scratch_bytes);
+    fprintf(fp, "#define MODELO_ARENA_MODEL_LEN  %uu\n", modelo_tflite_len);
+    fprintf(fp, "#define MODELO_ARENA_MODEL_HASH 0x%08xu\n",
+            tflm_lut_model_hash(modelo_tflite, modelo_tflite_len));
+    fprintf(fp, "#define MODELO_ARENA_MIN_BYTES  %zu\n", r.min_arena_bytes);
+    fprintf(fp, "#define MODELO_ARENA_SIZE       %zu  // mínimo + %d%%, alinhado a 16\n\n",
+            arena, opt.margin_pct);
+    fprintf(fp, "#endif // MODELO_PREDATOR_ARENA_H\n");
+    fclose(fp);
+    printf("[ARENA] Escrito %s\n", opt.output);
+    return 0;
+}
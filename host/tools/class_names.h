@@ -0,0 +1,31 @@
+#pragma once
+// Nomes das classes nas ferramentas host (dataset_build, model_eval): os
+// rótulos de label_str no dataset de treino e "C<n>" para os índices além deles.
+#include <stdio.h>
+#include <string.h>
+
+const char* const kClassNames[] = {"IDLE", "GAMING", "OBSTRUCAO"};
+constexpr int kNamedClasses = 3;
+
+// "-" para classe negativa (sem referência). Cada índice tem o próprio buffer,
+// então vários nomes cabem no mesmo printf.
+inline const char* class_name(int c) {
+    constexpr int kSlots = 16;
+    static char buf[kSlots][sizeof("C-2147483648")];
+    if (c < 0) return "-";
+    if (c < kNamedClasses) return kClassNames[c];
+    char* out = buf[c % kSlots];
+    snprintf(out, sizeof(buf[0]), "C%d", c);
+    return out;
+}
+
+// Índice do rótulo em [p, end); ANOMALIA é o nome da classe 2 no firmware.
+// -1 se não for um dos nomes.
+inline int class_from_name(const char* p, const char* end) {
+    const size_t len = (size_t)(end - p);
+    for (int c = 0; c < kNamedClasses; c++) {
+        if (strlen(kClassNames[c]) == len && !memcmp(p, kClassNames[c], len)) return c;
+    }
+    if (len == 8 && !memcmp(p, "ANOMALIA", 8)) return 2;
+    return -1;
+}
@@ -0,0 +1,537 @@
+// Monta o dataset de treino a partir das capturas brutas, no lugar do
+// Notebooks/Pré_Processamento_delta.ipynb, e gera modelo_predator_norm.h.
+//
+//   dataset_build [-o dataset.csv] [--header arquivo.h] [--check] [--threads N]
+//                 [--seed S] [--shard-mb M] [captura.csv[=classe] ...]
+//
+// Cada arquivo é mapeado em memória e cortado em blocos de M MB alinhados a
+// linha; as threads parseiam os blocos (std::from_chars) em duas passadas:
+//  1. linhas válidas por classe e média/desvio (Welford) de todas as linhas;
+//  2. down-sampling para a menor classe, como o notebook: cada classe fica com
+//     k linhas sorteadas uniformemente. A cota de cada bloco sai de um sorteio
+//     sequencial sobre as contagens da passada 1 (sem parsing) e dentro do
+//     bloco a seleção é a de Knuth (algoritmo S). As linhas escolhidas saem em
+//     ordem de arquivo com a coluna classe, e a média e o desvio populacional
+//     (como o StandardScaler) das escolhidas viram as constantes do z-score.
+// Os resultados por bloco são combinados em ordem, então a saída depende da
+// semente e do tamanho de bloco, não do número de threads. A memória fica nos
+// blocos em processamento: no máximo 2 por thread esperam a escrita.
+//
+// A classe vem do sufixo =N no nome do arquivo ou do rótulo da oitava coluna
+// (IDLE, GAMING, OBSTRUCAO ou ANOMALIA), ou da nona (classe numérica).
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "class_names.h"
+
+namespace {
+
+constexpr int kMaxClasses = 8;
+constexpr int kFeatures = 6;
+const char* const kFeatureNames[kFeatures] = {"t_ex", "u_ex", "t_amb", "u_amb", "delta_t", "delta_u"};
+constexpr int kDeltaT = 4;
+constexpr int kDeltaU = 5;
+
+struct Options {
+    const char* output = "dataset_pronto_treino.csv";
+    const char* header = nullptr;
+    bool check = false;             // Compara o header em vez de escrever
+    int threads = 0;
+    uint64_t seed = 42;
+    size_t shard_bytes = 16u << 20;
+    std::vector<std::pair<std::string, int>> inputs;  // Arquivo, classe forçada (-1 = do rótulo)
+};
+
+struct Welford {
+    uint64_t n = 0;
+    double mean = 0.0;
+    double m2 = 0.0;
+
+    void push(double x) {
+        n++;
+        const double d = x - mean;
+        mean += d / (double)n;
+        m2 += d * (x - mean);
+    }
+    // Combinação de Chan et al.: mesma ordem de blocos, mesmo resultado
+    void merge(const Welford& o) {
+        if (o.n == 0) return;
+        if (n == 0) {
+            *this = o;
+            return;
+        }
+        const double total = (double)(n + o.n);
+        const double d = o.mean - mean;
+        mean += d * (double)o.n / total;
+        m2 += o.m2 + d * d * (double)n * (double)o.n / total;
+        n += o.n;
+    }
+    double stddev() const { return n && m2 > 0.0 ? std::sqrt(m2 / (double)n) : 0.0; }
+};
+
+struct MappedFile {
+    std::string path;
+    int forced_class;
+    const char* data = nullptr;
+    size_t size = 0;
+};
+
+struct Shard {
+    int file;
+    size_t begin;                   // Primeira linha que começa no bloco
+    size_t end;
+    // Passada 1
+    uint64_t count[kMaxClasses] = {};
+    uint64_t ignored = 0;
+    Welford all[kFeatures];
+    // Passada 2
+    uint64_t quota[kMaxClasses] = {};
+    Welford selected[kFeatures];
+};
+
+struct Row {
+    double v[kFeatures];
+    int label;
+    const char* text_end;           // Fim do rótulo (saída copia até aqui)
+    bool has_label_text;
+};
+
+// 64 bits de um splitmix64: sementes independentes por bloco
+uint64_t splitmix64(uint64_t* state) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+// Inteiro uniforme em [0, range) (multiplicação de Lemire, sem divisão)
+uint64_t below(uint64_t* state, uint64_t range) {
+    return (uint64_t)(((unsigned __int128)splitmix64(state) * range) >> 64);
+}
+
+// timestamp,t_ex,u_ex,t_amb,u_amb[,delta_t,delta_u[,rotulo[,classe]]]
+bool parse_row(const char* p, const char* end, int forced_class, Row* r) {
+    while (end > p && (end[-1] == '\r' || end[-1] == ' ')) end--;
+    const char* fields[10];
+    const char* field_end[10];
+    int n = 0;
+    const char* s = p;
+    while (n < 10) {
+        const char* comma = (const char*)memchr(s, ',', (size_t)(end - s));
+        fields[n] = s;
+        field_end[n] = comma ? comma : end;
+        n++;
+        if (!comma) break;
+        s = comma + 1;
+    }
+    if (n < 5) return false;
+
+    double ts;
+    if (std::from_chars(fields[0], field_end[0], ts).ptr != field_end[0]) return false;
+    for (int i = 0; i < 4; i++) {
+        if (std::from_chars(fields[i + 1], field_end[i + 1], r->v[i]).ptr != field_end[i + 1]) return false;
+    }
+    if (n >= 7 && std::from_chars(fields[5], field_end[5], r->v[kDeltaT]).ptr == field_end[5] &&
+        std::from_chars(fields[6], field_end[6], r->v[kDeltaU]).ptr == field_end[6]) {
+        // Diferenciais como gravados (o notebook usa essas colunas)
+    } else {
+        r->v[kDeltaT] = r->v[0] - r->v[2];
+        r->v[kDeltaU] = r->v[1] - r->v[3];
+        n = 5;
+    }
+
+    r->has_label_text = n >= 8;
+    r->text_end = r->has_label_text ? field_end[7] : field_end[4];
+    r->label = forced_class;
+    if (r->label < 0 && n >= 8) r->label = class_from_name(fields[7], field_end[7]);
+    if (r->label < 0 && n >= 9) {
+        int c = 0;
+        if (std::from_chars(fields[8], field_end[8], c).ptr == field_end[8]) r->label = c;
+    }
+    return r->label >= 0 && r->label < kMaxClasses;
+}
+
+// Chama fn(linha, fim) para cada linha do bloco
+template <typename Fn>
+void for_each_line(const MappedFile& f, const Shard& s, Fn fn) {
+    const char* p = f.data + s.begin;
+    const char* const end = f.data + s.end;
+    while (p < end) {
+        const char* nl = (const char*)memchr(p, '\n', (size_t)(end - p));
+        const char* line_end = nl ? nl : end;
+        fn(p, line_end);
+        p = line_end + 1;
+    }
+}
+
+// O bloco já foi lido: as páginas dele podem sair da memória
+void release_pages(const MappedFile& f, const Shard& s) {
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    const size_t first = (s.begin + page - 1) / page * page;
+    const size_t last = s.end / page * page;
+    if (last > first) madvise((void*)(f.data + first), last - first, MADV_DONTNEED);
+}
+
+void pass1(const std::vector<MappedFile>& files, Shard* s) {
+    const MappedFile& f = files[s->file];
+    for_each_line(f, *s, [&](const char* p, const char* end) {
+        Row r;
+        if (!parse_row(p, end, f.forced_class, &r)) {
+            s->ignored++;
+            return;
+        }
+        s->count[r.label]++;
+        for (int i = 0; i < kFeatures; i++) s->all[i].push(r.v[i]);
+    });
+    release_pages(f, *s);
+}
+
+// Algoritmo S por classe, com a cota do bloco; linhas escolhidas em `out`
+void pass2(const std::vector<MappedFile>& files, Shard* s, uint64_t seed, std::string* out) {
+    const MappedFile& f = files[s->file];
+    uint64_t rng = seed;
+    uint64_t remaining[kMaxClasses], quota[kMaxClasses];
+    memcpy(remaining, s->count, sizeof(remaining));
+    memcpy(quota, s->quota, sizeof(quota));
+    for_each_line(f, *s, [&](const char* p, const char* end) {
+        Row r;
+        if (!parse_row(p, end, f.forced_class, &r)) return;
+        const int c = r.label;
+        const bool take = quota[c] > 0 && below(&rng, remaining[c]) < quota[c];
+        remaining[c]--;
+        if (!take) return;
+        quota[c]--;
+        for (int i = 0; i < kFeatures; i++) s->selected[i].push(r.v[i]);
+        out->append(p, (size_t)(r.text_end - p));
+        if (!r.has_label_text) {
+            char buf[64];
+            snprintf(buf, sizeof(buf), ",%.17g,%.17g,%s", r.v[kDeltaT], r.v[kDeltaU], class_name(c));
+            out->append(buf);
+        }
+        char cls[16];
+        snprintf(cls, sizeof(cls), ",%d\n", c);
+        out->append(cls);
+    });
+    release_pages(f, *s);
+}
+
+bool map_file(MappedFile* f) {
+    const int fd = open(f->path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+    f->size = (size_t)st.st_size;
+    if (f->size > 0) {
+        void* p = mmap(nullptr, f->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            close(fd);
+            return false;
+        }
+        madvise(p, f->size, MADV_SEQUENTIAL);
+        f->data = (const char*)p;
+    }
+    close(fd);
+    return true;
+}
+
+// Blocos de ~shard_bytes; cada fronteira avança até o início de uma linha
+void cut_shards(const std::vector<MappedFile>& files, size_t shard_bytes, std::vector<Shard>* shards) {
+    for (int i = 0; i < (int)files.size(); i++) {
+        const MappedFile& f = files[i];
+        size_t begin = 0;
+        while (begin < f.size) {
+            size_t end = begin + shard_bytes;
+            if (end >= f.size) {
+                end = f.size;
+            } else {
+                const char* nl = (const char*)memchr(f.data + end, '\n', f.size - end);
+                end = nl ? (size_t)(nl - f.data) + 1 : f.size;
+            }
+            Shard s;
+            s.file = i;
+            s.begin = begin;
+            s.end = end;
+            shards->push_back(s);
+            begin = end;
+        }
+    }
+}
+
+template <typename Fn>
+void run_workers(int threads, Fn fn) {
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++) pool.emplace_back(fn);
+    for (std::thread& t : pool) t.join();
+}
+
+std::string basename_of(const std::string& path) {
+    const size_t slash = path.find_last_of('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+std::string make_header(const Options& opt, const Welford sel[kFeatures], uint64_t per_class, int classes,
+                        uint64_t valid) {
+    std::string sources;
+    for (const auto& in : opt.inputs) sources += (sources.empty() ? "" : ", ") + basename_of(in.first);
+    char buf[2048];
+    snprintf(buf, sizeof(buf),
+             "#ifndef MODELO_PREDATOR_NORM_H\n"
+             "#define MODELO_PREDATOR_NORM_H\n"
+             "\n"
+             "// Gerado por host/tools/dataset_build a partir de %s. Não edite.\n"
+             "// %llu amostras balanceadas (%llu por classe, %d classes) de %llu válidas.\n"
+             "// Z-score das entradas do modelo: média e desvio populacional (StandardScaler)\n"
+             "\n"
+             "#define MODELO_NORM_MEAN_DELTA_T  %.8ff\n"
+             "#define MODELO_NORM_STD_DELTA_T   %.8ff\n"
+             "#define MODELO_NORM_MEAN_DELTA_U  %.8ff\n"
+             "#define MODELO_NORM_STD_DELTA_U   %.8ff\n"
+             "\n"
+             "#endif // MODELO_PREDATOR_NORM_H\n",
+             sources.c_str(), (unsigned long long)(per_class * classes), (unsigned long long)per_class,
+             classes, (unsigned long long)valid, sel[kDeltaT].mean, sel[kDeltaT].stddev(), sel[kDeltaU].mean,
+             sel[kDeltaU].stddev());
+    return buf;
+}
+
+bool parse_args(int argc, char** argv, Options* opt) {
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-o") && i + 1 < argc) {
+            opt->output = argv[++i];
+        } else if (!strcmp(argv[i], "--header") && i + 1 < argc) {
+            opt->header = argv[++i];
+        } else if (!strcmp(argv[i], "--check")) {
+            opt->check = true;
+        } else if (!strcmp(argv[i], "--threads") && i + 1 < argc) {
+            opt->threads = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            opt->seed = strtoull(argv[++i], nullptr, 0);
+        } else if (!strcmp(argv[i], "--shard-mb") && i + 1 < argc) {
+            const double mb = strtod(argv[++i], nullptr);
+            if (!(mb > 0.0)) return false;
+            opt->shard_bytes = (size_t)(mb * (1 << 20)) + 1;
+        } else if (argv[i][0] != '-') {
+            std::string arg = argv[i];
+            int forced = -1;
+            const size_t eq = arg.rfind('=');
+            if (eq != std::string::npos) {
+                forced = atoi(arg.c_str() + eq + 1);
+                arg.resize(eq);
+                if (forced < 0 || forced >= kMaxClasses) return false;
+            }
+            opt->inputs.emplace_back(arg, forced);
+        } else {
+            return false;
+        }
+    }
+    if (opt->check && !opt->header) return false;
+    return true;
+}
+
+double elapsed_ms(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parse_args(argc, argv, &opt)) {
+        fprintf(stderr,
+                "uso: %s [-o dataset.csv] [--header arquivo.h] [--check] [--threads N] [--seed S]\n"
+                "        [--shard-mb M] [captura.csv[=classe] ...]\n",
+                argv[0]);
+        return 2;
+    }
+    if (opt.inputs.empty()) {
+        // Mesmos arquivos e classes do notebook
+        opt.inputs = {{PREDAGUARD_DATA_DIR "/idle_differential_bruto.csv", 0},
+                      {PREDAGUARD_DATA_DIR "/gaming_differential_bruto.csv", 1},
+                      {PREDAGUARD_DATA_DIR "/obstrucao_differential_bruto.csv", 2}};
+    }
+    if (opt.threads <= 0) opt.threads = (int)std::thread::hardware_concurrency();
+    if (opt.threads <= 0) opt.threads = 1;
+
+    std::vector<MappedFile> files;
+    size_t total_bytes = 0;
+    for (const auto& in : opt.inputs) {
+        MappedFile f;
+        f.path = in.first;
+        f.forced_class = in.second;
+        if (!map_file(&f)) {
+            fprintf(stderr, "[DATASET] Não foi possível abrir %s\n", f.path.c_str());
+            return 1;
+        }
+        total_bytes += f.size;
+        files.push_back(f);
+    }
+    std::vector<Shard> shards;
+    cut_shards(files, opt.shard_bytes, &shards);
+    printf("[DATASET] %d arquivos, %.1f MB, %d blocos, %d threads\n", (int)files.size(),
+           total_bytes / 1048576.0, (int)shards.size(), opt.threads);
+
+    // Passada 1: contagens e estatísticas de todas as linhas
+    auto t0 = std::chrono::steady_clock::now();
+    std::atomic<size_t> next{0};
+    run_workers(opt.threads, [&] {
+        for (size_t i; (i = next.fetch_add(1)) < shards.size();) pass1(files, &shards[i]);
+    });
+    uint64_t count[kMaxClasses] = {}, ignored = 0;
+    Welford all[kFeatures];
+    for (const Shard& s : shards) {
+        for (int c = 0; c < kMaxClasses; c++) count[c] += s.count[c];
+        ignored += s.ignored;
+        for (int i = 0; i < kFeatures; i++) all[i].merge(s.all[i]);
+    }
+    const double pass1_ms = elapsed_ms(t0);
+
+    int classes = 0;
+    uint64_t per_class = UINT64_MAX;
+    printf("[DATASET] linhas válidas:");
+    for (int c = 0; c < kMaxClasses; c++) {
+        if (!count[c]) continue;
+        classes++;
+        if (count[c] < per_class) per_class = count[c];
+        printf(" %s %llu", class_name(c), (unsigned long long)count[c]);
+    }
+    printf(" | %llu ignoradas\n", (unsigned long long)ignored);
+    if (classes == 0) {
+        fprintf(stderr, "[DATASET] nenhuma linha válida\n");
+        return 1;
+    }
+
+    // Cotas por bloco: sorteio sequencial sobre as contagens, sem parsing.
+    // Junto com o algoritmo S dentro do bloco, é uma amostra uniforme de
+    // per_class linhas de cada classe.
+    uint64_t rng = opt.seed;
+    for (int c = 0; c < kMaxClasses; c++) {
+        uint64_t pool = count[c], quota = count[c] ? per_class : 0;
+        for (Shard& s : shards) {
+            for (uint64_t i = 0; i < s.count[c] && quota > 0; i++, pool--) {
+                if (below(&rng, pool) < quota) {
+                    s.quota[c]++;
+                    quota--;
+                }
+            }
+        }
+    }
+
+    // Passada 2: seleção e escrita em ordem de bloco, com janela limitada
+    FILE* out = fopen(opt.output, "w");
+    if (!out) {
+        fprintf(stderr, "[DATASET] Não foi possível criar %s\n", opt.output);
+        return 1;
+    }
+    fputs("timestamp,t_ex,u_ex,t_amb,u_amb,delta_t,delta_u,label_str,classe\n", out);
+    t0 = std::chrono::steady_clock::now();
+    const size_t window = 2 * (size_t)opt.threads;
+    std::vector<std::string> pending(shards.size());
+    std::vector<char> ready(shards.size(), 0);
+    size_t written = 0;
+    std::mutex lock;
+    std::condition_variable changed;
+    next = 0;
+    std::thread writer([&] {
+        for (size_t i = 0; i < shards.size(); i++) {
+            std::string text;
+            {
+                std::unique_lock<std::mutex> l(lock);
+                changed.wait(l, [&] { return ready[i] != 0; });
+                text.swap(pending[i]);
+            }
+            fwrite(text.data(), 1, text.size(), out);
+            {
+                std::lock_guard<std::mutex> l(lock);
+                written = i + 1;
+            }
+            changed.notify_all();
+        }
+    });
+    run_workers(opt.threads, [&] {
+        for (size_t i; (i = next.fetch_add(1)) < shards.size();) {
+            {
+                std::unique_lock<std::mutex> l(lock);
+                changed.wait(l, [&] { return i < written + window; });
+            }
+            uint64_t seed = opt.seed ^ (0x5851f42d4c957f2dull * (i + 1));
+            std::string text;
+            pass2(files, &shards[i], splitmix64(&seed), &text);
+            {
+                std::lock_guard<std::mutex> l(lock);
+                pending[i].swap(text);
+                ready[i] = 1;
+            }
+            changed.notify_all();
+        }
+    });
+    writer.join();
+    const bool write_ok = fclose(out) == 0;
+    const double pass2_ms = elapsed_ms(t0);
+
+    Welford sel[kFeatures];
+    for (const Shard& s : shards) {
+        for (int i = 0; i < kFeatures; i++) sel[i].merge(s.selected[i]);
+    }
+    for (MappedFile& f : files) {
+        if (f.data) munmap((void*)f.data, f.size);
+    }
+    if (!write_ok) {
+        fprintf(stderr, "[DATASET] Erro ao escrever %s\n", opt.output);
+        return 1;
+    }
+
+    uint64_t valid = 0;
+    for (int c = 0; c < kMaxClasses; c++) valid += count[c];
+    printf("[DATASET] balanceado: %llu por classe -> %llu linhas em %s\n", (unsigned long long)per_class,
+           (unsigned long long)(sel[0].n), opt.output);
+    printf("%-8s | %12s %12s | %12s %12s\n", "feature", "média", "desvio", "média bal.", "desvio bal.");
+    for (int i = 0; i < kFeatures; i++) {
+        printf("%-8s | %12.6f %12.6f | %12.6f %12.6f\n", kFeatureNames[i], all[i].mean, all[i].stddev(),
+               sel[i].mean, sel[i].stddev());
+    }
+    printf("[DATASET] passada 1: %.1f ms, passada 2: %.1f ms (%.0f MB/s por passada)\n", pass1_ms, pass2_ms,
+           total_bytes / 1048576.0 / ((pass1_ms + pass2_ms) / 2000.0));
+
+    if (!opt.header) return 0;
+    const std::string header = make_header(opt, sel, per_class, classes, valid);
+    if (opt.check) {
+        std::string current;
+        if (FILE* fp = fopen(opt.header, "r")) {
+            char buf[4096];
+            size_t n;
+            while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) current.append(buf, n);
+            fclose(fp);
+        }
+        if (current != header) {
+            printf("[DATASET] %s desatualizado; gerado:\n%s", opt.header, header.c_str());
+            return 1;
+        }
+        printf("[DATASET] %s em dia\n", opt.header);
+        return 0;
+    }
+    FILE* fp = fopen(opt.header, "w");
+    if (!fp || fputs(header.c_str(), fp) < 0 || fclose(fp) != 0) {
+        fprintf(stderr, "[DATASET] Erro ao escrever %s\n", opt.header);
+        return 1;
+    }
+    printf("[DATASET] %s escrito\n", opt.header);
+    return 0;
+}
@@ -0,0 +1,155 @@
+// Escala do fully connected int8 do CMSIS-NN nos dois cores: para cada forma
+// (entradas x neurônios, lote de 1) mede arm_fully_connected_s8 só no core 0
+// e dividido por neurônio de saída entre os cores, e confere que as saídas são
+// iguais byte a byte.
+//
+//   fc_bench [--repeats N] [N | EntradasxNeurônios ...]
+//        (padrão: 16 32 64 128 256 512 1024, formas quadradas)
+//
+// No host o core 1 é uma thread: o ganho só aparece com mais de uma CPU livre
+// e não é o da placa. A coluna "nó" diz se um FULLY_CONNECTED dessa forma
+// usaria os dois cores com o limite padrão (TFLM_PARALLEL_MIN_MACS); abaixo
+// dele a coluna de dois cores mostra o que o limite evita.
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "pico/time.h"
+#include "tensorflow/lite/micro/pico/parallel_for.h"
+#include "third_party/cmsis_nn/Include/arm_nnfunctions.h"
+
+#define FC_BENCH_MAX_SHAPES 32
+
+// MACs medidos por forma quando --repeats não é dado: formas pequenas repetem
+// mais para o tempo não ficar na resolução do relógio
+#define FC_BENCH_MACS_PER_SHAPE (64u * 1024u * 1024u)
+
+typedef struct {
+    int32_t in_n, out_n;
+} Shape;
+
+typedef struct {
+    double single_us;   // Por chamada, só core 0
+    double dual_us;     // Por chamada, dois cores
+    double core1_share; // Fração dos blocos que o core 1 pegou
+    bool same;
+} Result;
+
+static uint32_t rng_state = 2024u;
+static int8_t rand_s8(void) {
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return (int8_t)(rng_state >> 24);
+}
+
+static double time_calls(bool parallel, int repeats, const cmsis_nn_fc_params *params,
+                         const cmsis_nn_per_tensor_quant_params *quant,
+                         const cmsis_nn_dims *input_dims, const int8_t *input,
+                         const cmsis_nn_dims *filter_dims, const int8_t *weights,
+                         const cmsis_nn_dims *bias_dims, const int32_t *bias,
+                         const cmsis_nn_dims *output_dims, int8_t *output) {
+    const cmsis_nn_context ctx = {NULL, 0};
+    tflm_parallel_set_enabled(parallel);
+    // Aquece cache e acorda o worker do core 1 fora da medida
+    arm_fully_connected_s8(&ctx, params, quant, input_dims, input, filter_dims, weights,
+                           bias_dims, bias, output_dims, output);
+    tflm_parallel_reset_stats();
+    const uint64_t t0 = time_us_64();
+    for (int i = 0; i < repeats; i++) {
+        arm_fully_connected_s8(&ctx, params, quant, input_dims, input, filter_dims, weights,
+                               bias_dims, bias, output_dims, output);
+    }
+    return (double)(time_us_64() - t0) / repeats;
+}
+
+static Result run(Shape s, int repeats) {
+    int8_t *input = malloc((size_t)s.in_n);
+    int8_t *weights = malloc((size_t)s.in_n * (size_t)s.out_n);
+    int32_t *bias = malloc(sizeof(int32_t) * (size_t)s.out_n);
+    int8_t *single = malloc((size_t)s.out_n);
+    int8_t *dual = malloc((size_t)s.out_n);
+    for (int32_t i = 0; i < s.in_n; i++) input[i] = rand_s8();
+    for (int32_t i = 0; i < s.in_n * s.out_n; i++) weights[i] = rand_s8();
+    for (int32_t j = 0; j < s.out_n; j++) bias[j] = rand_s8() * 31;
+
+    const cmsis_nn_fc_params params = {5, 0, -3, {-128, 127}};
+    const cmsis_nn_per_tensor_quant_params quant = {0x50000000, -8};
+    const cmsis_nn_dims input_dims = {1, 1, 1, s.in_n};
+    const cmsis_nn_dims filter_dims = {s.in_n, 1, 1, s.out_n};
+    const cmsis_nn_dims bias_dims = {1, 1, 1, s.out_n};
+    const cmsis_nn_dims output_dims = {1, 1, 1, s.out_n};
+
+    Result r;
+    r.single_us = time_calls(false, repeats, &params, &quant, &input_dims, input, &filter_dims,
+                             weights, &bias_dims, bias, &output_dims, single);
+    r.dual_us = time_calls(true, repeats, &params, &quant, &input_dims, input, &filter_dims,
+                           weights, &bias_dims, bias, &output_dims, dual);
+    TflmParallelStats st;
+    tflm_parallel_get_stats(&st);
+    const uint32_t chunks = st.chunks[0] + st.chunks[1];
+    r.core1_share = chunks ? (double)st.chunks[1] / chunks : 0.0;
+    r.same = memcmp(single, dual, (size_t)s.out_n) == 0;
+    tflm_parallel_set_enabled(true);
+
+    free(input); free(weights); free(bias); free(single); free(dual);
+    return r;
+}
+
+static bool parse_shape(const char *arg, Shape *s) {
+    char *end;
+    const long in_n = strtol(arg, &end, 10);
+    long out_n = in_n;
+    if (*end == 'x') out_n = strtol(end + 1, &end, 10);
+    if (*end || in_n <= 0 || out_n <= 0 || in_n > 4096 || out_n > 4096) return false;
+    s->in_n = (int32_t)in_n;
+    s->out_n = (int32_t)out_n;
+    return true;
+}
+
+int main(int argc, char **argv) {
+    static const int32_t defaults[] = {16, 32, 64, 128, 256, 512, 1024};
+    Shape shapes[FC_BENCH_MAX_SHAPES];
+    int n_shapes = 0;
+    int repeats = 0;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--repeats") && i + 1 < argc) {
+            repeats = atoi(argv[++i]);
+        } else if (n_shapes < FC_BENCH_MAX_SHAPES && parse_shape(argv[i], &shapes[n_shapes])) {
+            n_shapes++;
+        } else {
+            fprintf(stderr, "uso: %s [--repeats N] [N | EntradasxNeurônios (até 4096) ...]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    if (n_shapes == 0) {
+        for (size_t i = 0; i < sizeof(defaults) / sizeof(defaults[0]); i++) {
+            shapes[n_shapes++] = (Shape){defaults[i], defaults[i]};
+        }
+    }
+
+    printf("\nfully connected int8, lote 1, %ld CPUs no host, limite do nó %d MACs\n",
+           sysconf(_SC_NPROCESSORS_ONLN), TFLM_PARALLEL_MIN_MACS);
+    printf("     forma |     MACs | nó       | 1 core (us) | 2 cores (us) | ganho | core 1\n");
+    int mismatches = 0;
+    for (int i = 0; i < n_shapes; i++) {
+        const Shape s = shapes[i];
+        const uint32_t macs = (uint32_t)s.in_n * (uint32_t)s.out_n;
+        int n = repeats;
+        if (n <= 0) n = (int)(FC_BENCH_MACS_PER_SHAPE / macs) + 1;
+        const Result r = run(s, n);
+        char name[24];
+        snprintf(name, sizeof(name), "%dx%d", s.in_n, s.out_n);
+        printf("%10s | %8lu | %-8s | %11.2f | %12.2f | %4.2fx | %5.1f%%%s\n", name,
+               (unsigned long)macs, macs >= TFLM_PARALLEL_MIN_MACS ? "2 cores" : "core 0",
+               r.single_us, r.dual_us, r.single_us / r.dual_us, 100.0 * r.core1_share,
+               r.same ? "" : "  DIVERGE");
+        mismatches += !r.same;
+    }
+    tflm_parallel_stop();
+    printf("fc_bench: %d formas, %d divergências\n", n_shapes, mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
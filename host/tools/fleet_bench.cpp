@@ -0,0 +1,159 @@
+// Escala da frota (lib/fleet) no rack simulado: para cada número de canais,
+// ciclos completos de aquisição sobre o barramento com tempo de fio (relógio
+// virtual) e a classificação dos canais com um Invoke por linha e com um
+// Invoke em lote (relógio real do host).
+//
+//   fleet_bench [--cycles N] [canais ...]      (padrão: 8 16 32)
+//
+// Os sensores de cada canal reproduzem as capturas de Notebooks/Data a partir
+// de um ponto diferente, então os canais não decidem todos igual.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <vector>
+
+#include "host/tests/captures.h"
+#include "host/tests/fleet_rig.h"
+#include "tflm_wrapper.h"
+
+namespace {
+
+struct Row {
+    float t_ex, u_ex, t_amb, u_amb;
+};
+
+std::vector<Row> load_rows(void) {
+    std::vector<Row> rows;
+    for (int f = 0; f < HOST_NUM_CAPTURES; f++) {
+        FILE* fp = fopen(host_captures[f], "r");
+        if (!fp) continue;
+        float v[5];
+        while (host_read_capture_row(fp, v)) rows.push_back({v[1], v[2], v[3], v[4]});
+        fclose(fp);
+    }
+    return rows;
+}
+
+double now_us(void) {
+    return std::chrono::duration<double, std::micro>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct Result {
+    int channels;
+    double cycle_us;            // Médio, relógio virtual
+    double bus_us;              // Fio por ciclo, somando os dois barramentos
+    uint32_t read_errors;
+    double single_us;           // Classificação do ciclo, um Invoke por canal
+    double batch_us;            // Classificação do ciclo, lote
+    int mismatches;
+};
+
+HostFleetRig rig;
+Fleet fleet;
+
+bool run(int channels, int cycles, const std::vector<Row>& rows, Result* out) {
+    host_fleet_rig_attach(&rig, channels, true);
+    if (fleet_init(&fleet, i2c0, i2c1, channels) != channels) {
+        fprintf(stderr, "fleet_bench: canais sem sensor com %d canais\n", channels);
+        return false;
+    }
+    // Lote do tamanho da frota: linhas sobrando custariam Invoke à toa
+    if (tflm_batch_init(channels) != 0) return false;
+    const size_t stride = rows.size() / channels;
+    const uint64_t bus_start = host_i2c_bus_us(i2c0) + host_i2c_bus_us(i2c1);
+    std::vector<float> inputs(2 * channels);
+    std::vector<TflmDecision> single(channels), batched(channels);
+    // O tempo de um ciclo de classificação é pequeno: repete para medir
+    const int repeats = 200;
+    double single_us = 0.0, batch_us = 0.0;
+    int mismatches = 0;
+
+    for (int k = 0; k < cycles; k++) {
+        for (int c = 0; c < channels; c++) {
+            const Row& r = rows[(c * stride + k) % rows.size()];
+            rig.sensor[FLEET_EXHAUST][c].temperature = r.t_ex;
+            rig.sensor[FLEET_EXHAUST][c].humidity = r.u_ex;
+            rig.sensor[FLEET_AMBIENT][c].temperature = r.t_amb;
+            rig.sensor[FLEET_AMBIENT][c].humidity = r.u_amb;
+        }
+        host_fleet_rig_cycle(&fleet);
+
+        for (int c = 0; c < channels; c++) {
+            SensorReadings s;
+            fleet_readings(&fleet, c, &s);
+            inputs[2 * c] = ((s.aht_temp_1 - s.aht_temp_2) - HOST_MEAN_DELTA_T) / HOST_STD_DELTA_T;
+            inputs[2 * c + 1] = ((s.humidity_1 - s.humidity_2) - HOST_MEAN_DELTA_U) / HOST_STD_DELTA_U;
+        }
+        double t0 = now_us();
+        for (int i = 0; i < repeats; i++) {
+            for (int c = 0; c < channels; c++) tflm_classify(&inputs[2 * c], &single[c]);
+        }
+        single_us += (now_us() - t0) / repeats;
+        t0 = now_us();
+        for (int i = 0; i < repeats; i++) tflm_classify_batch(inputs.data(), channels, batched.data());
+        batch_us += (now_us() - t0) / repeats;
+        for (int c = 0; c < channels; c++) mismatches += single[c].class_index != batched[c].class_index;
+    }
+
+    out->channels = channels;
+    out->cycle_us = (double)fleet.stats.total_cycle_us / fleet.stats.cycles;
+    out->bus_us = (double)(host_i2c_bus_us(i2c0) + host_i2c_bus_us(i2c1) - bus_start) / cycles;
+    out->read_errors = fleet.stats.read_errors;
+    out->single_us = single_us / cycles;
+    out->batch_us = batch_us / cycles;
+    out->mismatches = mismatches;
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    int cycles = 50;
+    std::vector<int> channels;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--cycles") && i + 1 < argc) {
+            cycles = atoi(argv[++i]);
+        } else if (atoi(argv[i]) > 0 && atoi(argv[i]) <= TFLM_BATCH_MAX) {
+            channels.push_back(atoi(argv[i]));
+        } else {
+            fprintf(stderr, "uso: fleet_bench [--cycles N] [canais (1..%d) ...]\n", TFLM_BATCH_MAX);
+            return 2;
+        }
+    }
+    if (channels.empty()) channels = {8, 16, 32};
+    if (cycles <= 0) cycles = 1;
+
+    const std::vector<Row> rows = load_rows();
+    if (rows.empty()) {
+        fprintf(stderr, "fleet_bench: capturas não encontradas em %s\n", PREDAGUARD_DATA_DIR);
+        return 1;
+    }
+    if (tflm_init_ex(TFLM_STRIP_SOFTMAX) != 0) return 1;
+    // Um Invoke por canal de verdade: o cache esconderia o custo
+    const TflmCachePolicy off = {TFLM_CACHE_OFF, 0.0f, 0};
+    tflm_cache_configure(&off);
+
+    printf("\n%d ciclos por configuração, barramentos a 400 kHz, lote de até %d linhas\n", cycles,
+           TFLM_BATCH_MAX);
+    printf("canais | ciclo (ms) | sequencial (ms) | fio/ciclo (ms) | Hz/canal | "
+           "Invokes (us) | lote (us) | ganho | divergências\n");
+    int total_mismatches = 0;
+    uint32_t total_errors = 0;
+    for (int n : channels) {
+        Result r;
+        if (!run(n, cycles, rows, &r)) return 1;
+        // Sem sobreposição cada canal espera a própria conversão
+        const double sequential_us = n * (double)AHT20_MEASURE_TIME_US + r.bus_us;
+        printf("%6d | %10.1f | %15.1f | %14.2f | %8.1f | %17.1f | %9.1f | %4.1fx | %d\n", r.channels,
+               r.cycle_us / 1000.0, sequential_us / 1000.0, r.bus_us / 1000.0, 1e6 / r.cycle_us,
+               r.single_us, r.batch_us, r.single_us / r.batch_us, r.mismatches);
+        total_mismatches += r.mismatches;
+        total_errors += r.read_errors;
+    }
+    printf("fleet_bench: %d configurações, %lu leituras perdidas, %d divergências\n",
+           (int)channels.size(), (unsigned long)total_errors, total_mismatches);
+    return total_mismatches == 0 && total_errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,416 @@
+// Ajusta o portão estatístico (lib/gate) e gera modelo_predator_gate.h.
+//
+//   gate_fit [--mode box|mahalanobis] [--margin M] [--train dataset.csv] [-o arquivo.h] [captura.csv ...]
+//
+// Por classe, as amostras do dataset de treino em que o rótulo e a rede
+// concordam dão média e covariância de (ΔT, ΔU) em códigos brutos. A região
+// cresce até a primeira amostra gravada ou ponto de uma grade densa em que a
+// rede decide outra classe, encolhe pela margem e é conferida de novo já em
+// ponto fixo (gate_classify). No fim o portão roda sobre as capturas e o
+// arquivo só é escrito se todas as amostras resolvidas baterem com a rede.
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <vector>
+
+#include "host/tests/captures.h"
+#include "lib/aht20/aht20.h"
+#include "lib/gate/gate.h"
+#include "tflm_wrapper.h"
+
+namespace {
+
+constexpr int kNumClasses = 3;
+constexpr int kGrid = 256;              // Pontos por eixo na conferência densa
+constexpr double kSearchSigmas = 8.0;   // Alcance da busca em desvios da classe
+const char* const kClassNames[kNumClasses] = {"IDLE", "GAMING", "ANOMALIA"};
+
+struct Options {
+    const char* output = "modelo_predator_gate.h";
+    const char* train = PREDAGUARD_DATA_DIR "/dataset_pronto_treino.csv";
+    GateMode mode = GATE_MAHALANOBIS;
+    double margin = 0.9;                // Fração do raio (ou da caixa) livre de divergências
+    std::vector<const char*> captures;
+};
+
+bool parse_args(int argc, char** argv, Options* opt) {
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-o") && i + 1 < argc) {
+            opt->output = argv[++i];
+        } else if (!strcmp(argv[i], "--train") && i + 1 < argc) {
+            opt->train = argv[++i];
+        } else if (!strcmp(argv[i], "--margin") && i + 1 < argc) {
+            opt->margin = strtod(argv[++i], nullptr);
+        } else if (!strcmp(argv[i], "--mode") && i + 1 < argc) {
+            i++;
+            if (!strcmp(argv[i], "box")) {
+                opt->mode = GATE_BOX;
+            } else if (!strcmp(argv[i], "mahalanobis")) {
+                opt->mode = GATE_MAHALANOBIS;
+            } else {
+                opt->margin = 0.0;
+            }
+        } else if (argv[i][0] != '-') {
+            opt->captures.push_back(argv[i]);
+        } else {
+            opt->margin = 0.0;
+            break;
+        }
+    }
+    if (!(opt->margin > 0.0 && opt->margin <= 1.0)) {
+        fprintf(stderr,
+                "uso: %s [--mode box|mahalanobis] [--margin M] [--train dataset.csv] [-o arquivo.h] "
+                "[captura.csv ...]\n", argv[0]);
+        return false;
+    }
+    if (opt->captures.empty()) opt->captures.assign(host_captures, host_captures + HOST_NUM_CAPTURES);
+    return true;
+}
+
+// Uma linha gravada: ΔT/ΔU em float (entrada da rede, como no replay) e em
+// códigos brutos (entrada do portão, como no firmware)
+struct Row {
+    float z[2];
+    int32_t raw[2];
+    int label;              // Coluna "classe" do dataset de treino; -1 nas capturas
+    int net;                // Decisão da rede
+    float confidence;
+};
+
+// Mesmo arredondamento do replay (lib/sensors/sensors_csv.c)
+int32_t encode(float value, float offset, float span) {
+    float code = (value + offset) * (float)AHT20_RAW_FULL_SCALE / span + 0.5f;
+    if (code <= 0.0f) return 0;
+    if (code >= (float)(AHT20_RAW_FULL_SCALE - 1)) return AHT20_RAW_FULL_SCALE - 1;
+    return (int32_t)code;
+}
+
+int network(const float z[2], float* confidence) {
+    TflmDecision d;
+    tflm_classify(z, &d);
+    if (confidence) *confidence = tflm_decision_confidence(&d);
+    return d.class_index;
+}
+
+bool load_rows(const char* path, std::vector<Row>* rows) {
+    FILE* fp = fopen(path, "r");
+    if (!fp) {
+        fprintf(stderr, "[GATE] Não foi possível abrir %s\n", path);
+        return false;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), fp)) {
+        float v[5];
+        char *s = line, *end;
+        int n = 0;
+        for (; n < 5; n++, s = end + 1) {
+            v[n] = strtof(s, &end);
+            if (end == s || (n < 4 && *end != ',')) break;
+        }
+        if (n < 5) continue;
+        Row r;
+        r.z[0] = ((v[1] - v[3]) - HOST_MEAN_DELTA_T) / HOST_STD_DELTA_T;
+        r.z[1] = ((v[2] - v[4]) - HOST_MEAN_DELTA_U) / HOST_STD_DELTA_U;
+        r.raw[0] = encode(v[1], 50.0f, 200.0f) - encode(v[3], 50.0f, 200.0f);
+        r.raw[1] = encode(v[2], 0.0f, 100.0f) - encode(v[4], 0.0f, 100.0f);
+        const char* last = strrchr(line, ',');
+        long label = last ? strtol(last + 1, &end, 10) : -1;
+        r.label = (last && end != last + 1 && label >= 0 && label < kNumClasses) ? (int)label : -1;
+        r.net = network(r.z, &r.confidence);
+        rows->push_back(r);
+    }
+    fclose(fp);
+    return true;
+}
+
+// Rede num ponto da grade em códigos brutos (o firmware converte do código)
+int network_at(double dt_raw, double du_raw) {
+    const float z[2] = {
+        (float)((dt_raw * 200.0 / AHT20_RAW_FULL_SCALE - HOST_MEAN_DELTA_T) / HOST_STD_DELTA_T),
+        (float)((du_raw * 100.0 / AHT20_RAW_FULL_SCALE - HOST_MEAN_DELTA_U) / HOST_STD_DELTA_U),
+    };
+    return network(z, nullptr);
+}
+
+struct Stats {
+    double mean[2];
+    double cov[3];          // xx, xy, yy
+    double inv[3];
+    int count;
+};
+
+bool class_stats(const std::vector<Row>& train, int cls, Stats* st) {
+    double sum[2] = {0, 0}, sq[3] = {0, 0, 0};
+    int n = 0;
+    for (const Row& r : train) {
+        if (r.label != cls || r.net != cls) continue;
+        sum[0] += r.raw[0];
+        sum[1] += r.raw[1];
+        n++;
+    }
+    if (n < 3) return false;
+    st->mean[0] = sum[0] / n;
+    st->mean[1] = sum[1] / n;
+    for (const Row& r : train) {
+        if (r.label != cls || r.net != cls) continue;
+        const double dx = r.raw[0] - st->mean[0], dy = r.raw[1] - st->mean[1];
+        sq[0] += dx * dx;
+        sq[1] += dx * dy;
+        sq[2] += dy * dy;
+    }
+    // Piso de um código: uma classe quase constante não vira elipse degenerada
+    st->cov[0] = sq[0] / (n - 1) + 1.0;
+    st->cov[1] = sq[1] / (n - 1);
+    st->cov[2] = sq[2] / (n - 1) + 1.0;
+    const double det = st->cov[0] * st->cov[2] - st->cov[1] * st->cov[1];
+    if (!(det > 0.0)) return false;
+    st->inv[0] = st->cov[2] / det;
+    st->inv[1] = -st->cov[1] / det;
+    st->inv[2] = st->cov[0] / det;
+    st->count = n;
+    return true;
+}
+
+double mahalanobis2(const Stats& st, double x, double y) {
+    const double dx = x - st.mean[0], dy = y - st.mean[1];
+    return st.inv[0] * dx * dx + 2.0 * st.inv[1] * dx * dy + st.inv[2] * dy * dy;
+}
+
+// Shift para que o maior desvio dentro da caixa caiba em int16
+int32_t box_shift(const GateClass& k) {
+    int64_t span = 0;
+    for (int i = 0; i < 2; i++) {
+        const int64_t lo = (int64_t)k.mean[i] - k.lo[i], hi = (int64_t)k.hi[i] - k.mean[i];
+        if (lo > span) span = lo;
+        if (hi > span) span = hi;
+    }
+    int32_t s = 0;
+    while ((span >> s) >= 32767) s++;
+    return s;
+}
+
+// Elipse de raio² r2 em ponto fixo: caixa envolvente, shift e coeficientes
+GateClass quantize_ellipse(const Stats& st, double r2) {
+    GateClass k;
+    memset(&k, 0, sizeof(k));
+    for (int i = 0; i < 2; i++) {
+        const double half = sqrt(r2 * st.cov[i == 0 ? 0 : 2]);
+        k.mean[i] = (int32_t)lround(st.mean[i]);
+        k.lo[i] = (int32_t)floor(st.mean[i] - half);
+        k.hi[i] = (int32_t)ceil(st.mean[i] + half);
+    }
+    k.shift = box_shift(k);
+    // Coeficientes com ~20 bits: a*dx² fica abaixo de 2^50 com |dx| < 2^15
+    const double unit = ldexp(1.0, 2 * k.shift);
+    double biggest = 0.0;
+    for (double v : st.inv) biggest = fmax(biggest, fabs(v * unit));
+    const int scale = 20 - (int)ceil(log2(biggest));
+    k.a = (int32_t)lround(ldexp(st.inv[0] * unit, scale));
+    k.b = (int32_t)lround(ldexp(st.inv[1] * unit, scale));
+    k.c = (int32_t)lround(ldexp(st.inv[2] * unit, scale));
+    k.limit = (int64_t)floor(ldexp(r2, scale));
+    return k;
+}
+
+GateClass box_region(const Stats& st, const double lo[2], const double hi[2]) {
+    GateClass k;
+    memset(&k, 0, sizeof(k));
+    for (int i = 0; i < 2; i++) {
+        k.mean[i] = (int32_t)lround(st.mean[i]);
+        k.lo[i] = (int32_t)ceil(lo[i]);
+        k.hi[i] = (int32_t)floor(hi[i]);
+    }
+    return k;
+}
+
+// A região (sozinha, em ponto fixo) só contém pontos em que a rede decide cls?
+bool region_is_clean(GateMode mode, const GateClass& k, int cls, const std::vector<Row>& rows) {
+    GateParams p;
+    memset(&p, 0, sizeof(p));
+    p.mode = mode;
+    p.num_classes = 1;
+    p.classes[0] = k;
+    for (const Row& r : rows) {
+        if (gate_classify(&p, r.raw[0], r.raw[1]) == 0 && r.net != cls) return false;
+    }
+    for (int i = 0; i <= kGrid; i++) {
+        const double x = k.lo[0] + (double)(k.hi[0] - k.lo[0]) * i / kGrid;
+        for (int j = 0; j <= kGrid; j++) {
+            const double y = k.lo[1] + (double)(k.hi[1] - k.lo[1]) * j / kGrid;
+            if (gate_classify(&p, (int32_t)lround(x), (int32_t)lround(y)) == 0 &&
+                network_at(lround(x), lround(y)) != cls) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Maior raio² sem divergência na busca (grade de ±kSearchSigmas + amostras)
+double free_radius2(const Stats& st, int cls, const std::vector<Row>& rows) {
+    double r2 = kSearchSigmas * kSearchSigmas;  // Elipse inteira dentro da busca
+    const double sx = sqrt(st.cov[0]) * kSearchSigmas, sy = sqrt(st.cov[2]) * kSearchSigmas;
+    for (int i = 0; i <= kGrid; i++) {
+        const double x = lround(st.mean[0] - sx + 2.0 * sx * i / kGrid);
+        for (int j = 0; j <= kGrid; j++) {
+            const double y = lround(st.mean[1] - sy + 2.0 * sy * j / kGrid);
+            const double d2 = mahalanobis2(st, x, y);
+            if (d2 < r2 && network_at(x, y) != cls) r2 = d2;
+        }
+    }
+    for (const Row& r : rows) {
+        const double d2 = mahalanobis2(st, r.raw[0], r.raw[1]);
+        if (d2 < r2 && r.net != cls) r2 = d2;
+    }
+    return r2;
+}
+
+// Região da classe; em Mahalanobis *radius2 recebe o raio² final
+bool fit_class(const Options& opt, const Stats& st, int cls, const std::vector<Row>& rows, GateClass* out,
+               double* radius2) {
+    if (opt.mode == GATE_MAHALANOBIS) {
+        double r2 = free_radius2(st, cls, rows) * opt.margin * opt.margin;
+        for (int tries = 0; tries < 64 && r2 > 1e-3; tries++, r2 *= 0.9) {
+            *out = quantize_ellipse(st, r2);
+            *radius2 = r2;
+            if (region_is_clean(opt.mode, *out, cls, rows)) return true;
+        }
+        return false;
+    }
+    // Caixa: começa nas amostras de treino da classe e encolhe para a média
+    double lo[2] = {1e30, 1e30}, hi[2] = {-1e30, -1e30};
+    for (const Row& r : rows) {
+        if (r.label != cls || r.net != cls) continue;
+        for (int i = 0; i < 2; i++) {
+            lo[i] = fmin(lo[i], r.raw[i]);
+            hi[i] = fmax(hi[i], r.raw[i]);
+        }
+    }
+    for (int i = 0; i < 2; i++) {
+        lo[i] = st.mean[i] - (st.mean[i] - lo[i]) * opt.margin;
+        hi[i] = st.mean[i] + (hi[i] - st.mean[i]) * opt.margin;
+    }
+    for (int tries = 0; tries < 64; tries++) {
+        *out = box_region(st, lo, hi);
+        if (out->lo[0] > out->hi[0] || out->lo[1] > out->hi[1]) return false;
+        if (region_is_clean(opt.mode, *out, cls, rows)) return true;
+        for (int i = 0; i < 2; i++) {
+            lo[i] = st.mean[i] - (st.mean[i] - lo[i]) * 0.9;
+            hi[i] = st.mean[i] + (hi[i] - st.mean[i]) * 0.9;
+        }
+    }
+    return false;
+}
+
+bool write_header(const char* path, const GateParams& p) {
+    FILE* fp = fopen(path, "w");
+    if (!fp) return false;
+    fprintf(fp, "#ifndef MODELO_PREDATOR_GATE_H\n#define MODELO_PREDATOR_GATE_H\n\n");
+    fprintf(fp, "// Gerado por host/tools/gate_fit a partir de modelo_predator.h e do dataset de\n");
+    fprintf(fp, "// treino. Não edite.\n\n");
+    fprintf(fp, "#include \"lib/gate/gate.h\"\n\n");
+    fprintf(fp, "static const GateParams modelo_gate = {\n");
+    fprintf(fp, "    %s, %d, 0x%08xu,\n    {\n", p.mode == GATE_BOX ? "GATE_BOX" : "GATE_MAHALANOBIS",
+            p.num_classes, (unsigned)p.model_crc32);
+    for (int i = 0; i < p.num_classes; i++) {
+        const GateClass& k = p.classes[i];
+        fprintf(fp, "        // %s\n", kClassNames[i]);
+        fprintf(fp, "        {{%ld, %ld}, {%ld, %ld}, {%ld, %ld}, %ld, %ld, %ld, %ld, %lldll, %u},\n",
+                (long)k.lo[0], (long)k.lo[1], (long)k.hi[0], (long)k.hi[1], (long)k.mean[0],
+                (long)k.mean[1], (long)k.shift, (long)k.a, (long)k.b, (long)k.c, (long long)k.limit,
+                (unsigned)k.confidence);
+    }
+    fprintf(fp, "    },\n};\n\n#endif // MODELO_PREDATOR_GATE_H\n");
+    fclose(fp);
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parse_args(argc, argv, &opt)) return 2;
+    if (tflm_init_ex(TFLM_STRIP_SOFTMAX) != 0) return 1;
+    const TflmCachePolicy no_cache = {TFLM_CACHE_OFF, 0.0f, 0};
+    tflm_cache_configure(&no_cache);
+
+    std::vector<Row> train, rows;
+    if (!load_rows(opt.train, &train)) return 1;
+    for (const char* path : opt.captures) {
+        if (!load_rows(path, &rows)) return 1;
+    }
+
+    GateParams p;
+    memset(&p, 0, sizeof(p));
+    p.mode = opt.mode;
+    p.num_classes = kNumClasses;
+    p.model_crc32 = tflm_model_crc32();
+    for (int c = 0; c < kNumClasses; c++) {
+        Stats st;
+        GateClass& k = p.classes[c];
+        double r2 = 0.0;
+        if (!class_stats(train, c, &st) || !fit_class(opt, st, c, rows, &k, &r2)) {
+            // Classe sem região: nunca resolve pelo portão
+            memset(&k, 0, sizeof(k));
+            k.lo[0] = k.lo[1] = 1;
+            printf("[GATE] %s: sem região livre de divergências\n", kClassNames[c]);
+            continue;
+        }
+        printf("[GATE] %s: %d amostras de treino, ΔT [%ld, %ld] ΔU [%ld, %ld] códigos",
+               kClassNames[c], st.count, (long)k.lo[0], (long)k.hi[0], (long)k.lo[1], (long)k.hi[1]);
+        if (opt.mode == GATE_MAHALANOBIS) {
+            printf(", raio %.2f desvios", sqrt(r2));
+        }
+        printf("\n");
+    }
+
+    // Conferência final com todas as regiões juntas, e confiança por região
+    double conf_sum[kNumClasses] = {0, 0, 0};
+    int resolved = 0, disagreements = 0, per_class[kNumClasses] = {0, 0, 0};
+    for (const Row& r : rows) {
+        const int cls = gate_classify(&p, r.raw[0], r.raw[1]);
+        if (cls < 0) continue;
+        resolved++;
+        per_class[cls]++;
+        conf_sum[cls] += r.confidence;
+        disagreements += cls != r.net;
+    }
+    for (int c = 0; c < kNumClasses; c++) {
+        const long conf = per_class[c] ? lround(conf_sum[c] / per_class[c] * 255.0) : 0;
+        p.classes[c].confidence = (uint8_t)(conf > 255 ? 255 : conf);
+    }
+
+    // Custo por amostra: portão sempre + rede só no que sobra
+    auto now = [] { return std::chrono::steady_clock::now(); };
+    const int reps = 50;
+    volatile int sink = 0;
+    auto t0 = now();
+    for (int k = 0; k < reps; k++) {
+        for (const Row& r : rows) sink += gate_classify(&p, r.raw[0], r.raw[1]);
+    }
+    const double gate_us = std::chrono::duration<double, std::micro>(now() - t0).count() / (reps * rows.size());
+    t0 = now();
+    for (const Row& r : rows) sink += network(r.z, nullptr);
+    const double net_us = std::chrono::duration<double, std::micro>(now() - t0).count() / rows.size();
+    const double frac = (double)resolved / rows.size();
+    const double gated_us = gate_us + (1.0 - frac) * net_us;
+
+    printf("[GATE] %zu amostras gravadas: %d resolvidas pelo portão (%.1f%%; IDLE %d, GAMING %d, "
+           "ANOMALIA %d), %d divergências com a rede\n",
+           rows.size(), resolved, 100.0 * frac, per_class[0], per_class[1], per_class[2], disagreements);
+    printf("[GATE] custo médio por amostra: rede %.3f us -> portão %.4f us + rede no resto = %.3f us "
+           "(%.1fx)\n", net_us, gate_us, gated_us, net_us / gated_us);
+    if (disagreements != 0) {
+        fprintf(stderr, "[GATE] ERRO: o portão diverge da rede nas amostras gravadas\n");
+        return 1;
+    }
+    if (!write_header(opt.output, p)) {
+        fprintf(stderr, "[GATE] ERRO: não foi possível escrever %s\n", opt.output);
+        return 1;
+    }
+    printf("[GATE] Escrito %s\n", opt.output);
+    return 0;
+}
@@ -0,0 +1,127 @@
+// Compila modelo_predator.h em uma tabela de decisão (modelo_predator_lut.h).
+//
+//   lut_compiler [-o arquivo.h] [--scale S] [--zero-point Z] [--class-only]
+//
+// As duas entradas são quantizadas em int8 com (scale, zero_point); o
+// interpreter roda nos 65.536 pares e cada entrada guarda o argmax e,
+// opcionalmente, a probabilidade da classe vencedora em 4 bits. Antes de
+// escrever o arquivo a tabela é conferida de novo contra o interpreter: a
+// classe precisa bater em 100% dos pontos.
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include "modelo_predator.h"
+#include "tflm_lut.h"
+#include "tflm_wrapper.h"
+
+namespace {
+
+struct Options {
+    const char* output = "modelo_predator_lut.h";
+    float scale = 1.0f / 32.0f;  // z-score em [-4, 4)
+    int zero_point = 0;
+    bool class_only = false;
+};
+
+bool parse_args(int argc, char** argv, Options* opt) {
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-o") && i + 1 < argc) {
+            opt->output = argv[++i];
+        } else if (!strcmp(argv[i], "--scale") && i + 1 < argc) {
+            opt->scale = strtof(argv[++i], nullptr);
+        } else if (!strcmp(argv[i], "--zero-point") && i + 1 < argc) {
+            opt->zero_point = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--class-only")) {
+            opt->class_only = true;
+        } else {
+            fprintf(stderr, "uso: %s [-o arquivo.h] [--scale S] [--zero-point Z] [--class-only]\n",
+                    argv[0]);
+            return false;
+        }
+    }
+    return opt->scale > 0.0f;
+}
+
+// Roda o interpreter no ponto (q0, q1); retorna a classe e a probabilidade
+int evaluate(const Options& opt, int q0, int q1, float* confidence) {
+    float inputs[2] = {(q0 - opt.zero_point) * opt.scale, (q1 - opt.zero_point) * opt.scale};
+    float outputs[3];
+    tflm_predict(inputs, outputs);
+    int best = 0;
+    for (int i = 1; i < 3; i++) {
+        if (outputs[i] > outputs[best]) best = i;
+    }
+    *confidence = outputs[best];
+    return best;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parse_args(argc, argv, &opt)) return 2;
+    if (tflm_init() != 0) return 1;
+
+    std::vector<uint8_t> table(opt.class_only ? TFLM_LUT_ENTRIES / 4 : TFLM_LUT_ENTRIES, 0);
+    int class_counts[4] = {0, 0, 0, 0};
+    for (int q0 = -128; q0 <= 127; q0++) {
+        for (int q1 = -128; q1 <= 127; q1++) {
+            float conf;
+            int cls = evaluate(opt, q0, q1, &conf);
+            uint32_t idx = tflm_lut_index((int8_t)q0, (int8_t)q1);
+            class_counts[cls]++;
+            if (opt.class_only) {
+                table[idx >> 2] |= (uint8_t)(cls << ((idx & 3) * 2));
+            } else {
+                long nibble = lroundf(conf * TFLM_LUT_CONF_MAX);
+                table[idx] = tflm_lut_pack(cls, (uint8_t)(nibble > 15 ? 15 : nibble));
+            }
+        }
+    }
+
+    // Conferência independente da codificação: decodifica cada entrada e compara
+    int mismatches = 0;
+    for (int q0 = -128; q0 <= 127; q0++) {
+        for (int q1 = -128; q1 <= 127; q1++) {
+            float conf;
+            int cls = evaluate(opt, q0, q1, &conf);
+            uint32_t idx = tflm_lut_index((int8_t)q0, (int8_t)q1);
+            int lut_cls = opt.class_only ? (table[idx >> 2] >> ((idx & 3) * 2)) & 3
+                                         : table[idx] & TFLM_LUT_CLASS_MASK;
+            mismatches += (lut_cls != cls);
+        }
+    }
+    printf("[LUT] %u entradas, classes IDLE=%d GAMING=%d ANOMALIA=%d, divergências=%d\n",
+           TFLM_LUT_ENTRIES, class_counts[0], class_counts[1], class_counts[2], mismatches);
+    if (mismatches != 0) {
+        fprintf(stderr, "[LUT] ERRO: tabela não bate com o interpreter\n");
+        return 1;
+    }
+
+    FILE* fp = fopen(opt.output, "w");
+    if (!fp) {
+        fprintf(stderr, "[LUT] ERRO: não foi possível escrever %s\n", opt.output);
+        return 1;
+    }
+    fprintf(fp, "#ifndef MODELO_PREDATOR_LUT_H\n#define MODELO_PREDATOR_LUT_H\n\n");
+    fprintf(fp, "// Gerado por host/tools/lut_compiler a partir de modelo_predator.h. Não edite.\n");
+    fprintf(fp, "// Tamanho da tabela: %zu bytes\n\n", table.size());
+    fprintf(fp, "#define MODELO_LUT_INPUT_SCALE      %.9gf\n", opt.scale);
+    fprintf(fp, "#define MODELO_LUT_INPUT_ZERO_POINT %d\n", opt.zero_point);
+    fprintf(fp, "#define MODELO_LUT_CONFIDENCE_BITS  %d\n", opt.class_only ? 0 : 4);
+    fprintf(fp, "#define MODELO_LUT_MODEL_HASH       0x%08xu\n\n",
+            tflm_lut_model_hash(modelo_tflite, modelo_tflite_len));
+    fprintf(fp, "const unsigned char modelo_lut[%zu] = {\n", table.size());
+    for (size_t i = 0; i < table.size(); i++) {
+        fprintf(fp, "%s0x%02x%s", (i % 12 == 0) ? "  " : "", table[i],
+                (i + 1 == table.size()) ? "\n" : ((i % 12 == 11) ? ",\n" : ", "));
+    }
+    fprintf(fp, "};\n\n#endif // MODELO_PREDATOR_LUT_H\n");
+    fclose(fp);
+    printf("[LUT] Escrito %s\n", opt.output);
+    return 0;
+}
@@ -0,0 +1,479 @@
+// Avaliação em massa do modelo no host: um interpreter do TFLM por thread
+// sobre o dataset de treino (ou qualquer captura), com matriz de confusão,
+// acerto por classe, linhas em que o modelo discorda da referência e
+// inferências por segundo.
+//
+//   model_eval [--model arquivo.tflite] [--threads N] [--scaling] [--ref COLUNA]
+//              [--show N] [--diff divergencias.csv] [--min-accuracy P] [arquivo.csv[=classe]]
+//
+// A entrada do modelo é a do firmware: z-score de ΔT/ΔU com as constantes de
+// modelo_predator_norm.h, quantizada se o tensor for int8. A referência é a
+// coluna `classe` (ou o rótulo IDLE/GAMING/OBSTRUCAO), outra coluna dada por
+// nome ou índice em --ref (ex.: a predição do Keras exportada pelo notebook),
+// ou a classe do sufixo =N. Cada thread pega blocos de linhas de um contador
+// atômico e grava a predição no índice da linha, então o resultado não
+// depende do número de threads; --scaling repete a avaliação com 1, 2, 4...
+// threads, confere que todas dão a mesma resposta e mostra a escala.
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "class_names.h"
+#include "modelo_predator.h"
+#include "modelo_predator_norm.h"
+#include "tensorflow/lite/micro/micro_interpreter.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+#include "tflm_ops.h"
+
+namespace {
+
+constexpr int kMaxClasses = 8;
+constexpr int kMaxFields = 16;
+constexpr int kChunkRows = 512;
+
+struct Options {
+    const char* model = nullptr;    // nullptr: modelo_predator.h
+    const char* input = PREDAGUARD_DATA_DIR "/dataset_pronto_treino.csv";
+    int forced_class = -1;
+    const char* ref = nullptr;      // Nome ou índice da coluna de referência
+    int threads = 0;
+    bool scaling = false;
+    int show = 10;
+    const char* diff = nullptr;
+    double min_accuracy = -1.0;
+    size_t arena_bytes = 64 * 1024;
+};
+
+struct Row {
+    float z[2];                     // Entradas do modelo
+    float delta[2];                 // ΔT, ΔU
+    int ref;                        // Classe de referência, -1 se não há
+    int line;
+};
+
+struct Prediction {
+    int8_t cls;
+    float prob[kMaxClasses];
+};
+
+struct Dataset {
+    std::vector<Row> rows;
+    int ref_column = -1;
+    std::string ref_name;
+    int skipped = 0;
+};
+
+int parse_class(const char* p, const char* end) {
+    const size_t len = (size_t)(end - p);
+    const int named = class_from_name(p, end);
+    if (named >= 0) return named;
+    // Índice da classe, também escrito como float ("2.0", pandas)
+    double v;
+    if (len && std::from_chars(p, end, v).ptr == end && v >= 0.0 && v < kMaxClasses && v == floor(v)) {
+        return (int)v;
+    }
+    return -1;
+}
+
+int split(char* line, const char* fields[kMaxFields], const char* ends[kMaxFields]) {
+    size_t len = strlen(line);
+    while (len && (line[len - 1] == '\n' || line[len - 1] == '\r')) line[--len] = '\0';
+    int n = 0;
+    char* s = line;
+    while (n < kMaxFields) {
+        char* comma = strchr(s, ',');
+        fields[n] = s;
+        ends[n] = comma ? comma : line + len;
+        n++;
+        if (!comma) break;
+        s = comma + 1;
+    }
+    return n;
+}
+
+bool parse_float(const char* p, const char* end, float* v) {
+    return p != end && std::from_chars(p, end, *v).ptr == end;
+}
+
+// timestamp,t_ex,u_ex,t_amb,u_amb[,delta_t,delta_u[,label_str[,classe]]]
+bool load(const Options& opt, Dataset* ds) {
+    FILE* fp = fopen(opt.input, "r");
+    if (!fp) {
+        fprintf(stderr, "model_eval: não foi possível abrir %s\n", opt.input);
+        return false;
+    }
+    char line[1024];
+    int line_no = 0;
+    bool first = true;
+    while (fgets(line, sizeof(line), fp)) {
+        line_no++;
+        const char* f[kMaxFields];
+        const char* e[kMaxFields];
+        const int n = split(line, f, e);
+        float v[5];
+        bool numeric = n >= 5;
+        for (int i = 0; numeric && i < 5; i++) numeric = parse_float(f[i], e[i], &v[i]);
+
+        if (first) {
+            first = false;
+            // Coluna de referência: por nome no cabeçalho, por índice ou a padrão
+            if (opt.ref) {
+                char* endp;
+                const long idx = strtol(opt.ref, &endp, 10);
+                if (*endp == '\0') ds->ref_column = (int)idx;
+                for (int i = 0; !numeric && i < n && ds->ref_column < 0; i++) {
+                    if (std::string(f[i], e[i]) == opt.ref) ds->ref_column = i;
+                }
+                if (ds->ref_column < 0) {
+                    fprintf(stderr, "model_eval: coluna %s não encontrada\n", opt.ref);
+                    fclose(fp);
+                    return false;
+                }
+                ds->ref_name = opt.ref;
+            } else if (opt.forced_class < 0) {
+                ds->ref_column = n >= 9 ? 8 : (n >= 8 ? 7 : -1);
+                ds->ref_name = n >= 9 ? "classe" : "label_str";
+                if (!numeric && ds->ref_column >= 0) {
+                    ds->ref_name.assign(f[ds->ref_column], e[ds->ref_column]);
+                }
+            } else {
+                ds->ref_name = "=" + std::to_string(opt.forced_class);
+            }
+        }
+        if (!numeric) {
+            ds->skipped++;
+            continue;
+        }
+
+        Row r;
+        if (n < 7 || !parse_float(f[5], e[5], &r.delta[0]) || !parse_float(f[6], e[6], &r.delta[1])) {
+            r.delta[0] = v[1] - v[3];
+            r.delta[1] = v[2] - v[4];
+        }
+        r.z[0] = (r.delta[0] - MODELO_NORM_MEAN_DELTA_T) / MODELO_NORM_STD_DELTA_T;
+        r.z[1] = (r.delta[1] - MODELO_NORM_MEAN_DELTA_U) / MODELO_NORM_STD_DELTA_U;
+        r.ref = opt.forced_class;
+        if (r.ref < 0 && ds->ref_column >= 0 && ds->ref_column < n) {
+            r.ref = parse_class(f[ds->ref_column], e[ds->ref_column]);
+        }
+        r.line = line_no;
+        ds->rows.push_back(r);
+    }
+    fclose(fp);
+    return true;
+}
+
+bool load_model(const Options& opt, std::vector<uint8_t>* storage, const tflite::Model** model) {
+    if (!opt.model) {
+        *model = tflite::GetModel(modelo_tflite);
+        return true;
+    }
+    FILE* fp = fopen(opt.model, "rb");
+    if (!fp) {
+        fprintf(stderr, "model_eval: não foi possível abrir %s\n", opt.model);
+        return false;
+    }
+    fseek(fp, 0, SEEK_END);
+    const long len = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    // Folga para alinhar o flatbuffer em 16
+    storage->resize((size_t)len + 16);
+    uint8_t* data = storage->data() + ((16 - ((uintptr_t)storage->data() & 15)) & 15);
+    const bool ok = len > 0 && fread(data, 1, (size_t)len, fp) == (size_t)len;
+    fclose(fp);
+    if (!ok) return false;
+    *model = tflite::GetModel(data);
+    return true;
+}
+
+// Um interpreter com arena própria, montado na thread que vai usá-lo
+class Worker {
+ public:
+    Worker(const tflite::Model* model, size_t arena_bytes)
+        : arena_(new uint8_t[arena_bytes + 16]) {
+        tflm_add_ops_except_softmax(resolver_);
+        resolver_.AddSoftmax();
+        uint8_t* arena = arena_.get() + ((16 - ((uintptr_t)arena_.get() & 15)) & 15);
+        interpreter_.reset(new tflite::MicroInterpreter(model, resolver_, arena, arena_bytes));
+        // Toda thread do host se apresenta como core 0: com os kernels em dois
+        // cores, várias disputariam o único worker de core 1
+        interpreter_->SetParallelKernels(false);
+        if (interpreter_->AllocateTensors() != kTfLiteOk) return;
+        input_ = interpreter_->input(0);
+        output_ = interpreter_->output(0);
+        classes_ = output_->dims->data[output_->dims->size - 1];
+        ok_ = (input_->type == kTfLiteFloat32 || input_->type == kTfLiteInt8) &&
+              (output_->type == kTfLiteFloat32 || output_->type == kTfLiteInt8) &&
+              classes_ > 0 && classes_ <= kMaxClasses;
+    }
+
+    bool ok() const { return ok_; }
+    int classes() const { return classes_; }
+
+    bool run(const Row& r, Prediction* p) {
+        if (input_->type == kTfLiteInt8) {
+            for (int i = 0; i < 2; i++) {
+                long q = lroundf(r.z[i] / input_->params.scale) + input_->params.zero_point;
+                input_->data.int8[i] = (int8_t)(q < -128 ? -128 : (q > 127 ? 127 : q));
+            }
+        } else {
+            input_->data.f[0] = r.z[0];
+            input_->data.f[1] = r.z[1];
+        }
+        if (interpreter_->Invoke() != kTfLiteOk) return false;
+        int best = 0;
+        for (int c = 0; c < classes_; c++) {
+            p->prob[c] = output_->type == kTfLiteInt8
+                             ? (output_->data.int8[c] - output_->params.zero_point) * output_->params.scale
+                             : output_->data.f[c];
+            if (p->prob[c] > p->prob[best]) best = c;
+        }
+        p->cls = (int8_t)best;
+        return true;
+    }
+
+ private:
+    TflmOpResolver resolver_;
+    std::unique_ptr<uint8_t[]> arena_;
+    std::unique_ptr<tflite::MicroInterpreter> interpreter_;
+    TfLiteTensor* input_ = nullptr;
+    TfLiteTensor* output_ = nullptr;
+    int classes_ = 0;
+    bool ok_ = false;
+};
+
+struct Run {
+    int threads;
+    double ms;
+    bool ok;
+};
+
+Run evaluate(const tflite::Model* model, const Options& opt, const std::vector<Row>& rows, int threads,
+             std::vector<Prediction>* preds, int* classes) {
+    preds->assign(rows.size(), Prediction{});
+    std::atomic<size_t> next{0};
+    std::atomic<int> failures{0};
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++) {
+        pool.emplace_back([&, t] {
+            Worker w(model, opt.arena_bytes);
+            if (t == 0) *classes = w.classes();
+            if (!w.ok()) failures++;
+            // Cronômetro só depois que todos os interpreters estão montados
+            ready++;
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            if (!w.ok()) return;
+            for (size_t begin; (begin = next.fetch_add(kChunkRows)) < rows.size();) {
+                const size_t end = std::min(rows.size(), begin + kChunkRows);
+                for (size_t i = begin; i < end; i++) {
+                    if (!w.run(rows[i], &(*preds)[i])) failures++;
+                }
+            }
+        });
+    }
+    while (ready.load() < threads) std::this_thread::yield();
+    const auto t0 = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (std::thread& t : pool) t.join();
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    return {threads, ms, failures.load() == 0};
+}
+
+void report(const Dataset& ds, const std::vector<Prediction>& preds, int classes, const Options& opt) {
+    long confusion[kMaxClasses][kMaxClasses] = {};
+    long predicted[kMaxClasses] = {};
+    long without_ref = 0, agree = 0, with_ref = 0;
+    for (size_t i = 0; i < ds.rows.size(); i++) {
+        const int p = preds[i].cls, r = ds.rows[i].ref;
+        predicted[p]++;
+        if (r < 0 || r >= classes) {
+            without_ref++;
+            continue;
+        }
+        confusion[r][p]++;
+        with_ref++;
+        agree += r == p;
+    }
+
+    printf("Predições por classe:");
+    for (int c = 0; c < classes; c++) printf(" %s %ld", class_name(c), predicted[c]);
+    printf("\n");
+    if (!with_ref) {
+        printf("Sem coluna de referência: só as predições\n");
+        return;
+    }
+    printf("\nMatriz de confusão (linhas: referência %s, colunas: modelo)\n%-9s", ds.ref_name.c_str(), "");
+    for (int c = 0; c < classes; c++) printf(" %9s", class_name(c));
+    printf(" | %8s\n", "acerto");
+    for (int r = 0; r < classes; r++) {
+        long total = 0;
+        for (int c = 0; c < classes; c++) total += confusion[r][c];
+        printf("%-9s", class_name(r));
+        for (int c = 0; c < classes; c++) printf(" %9ld", confusion[r][c]);
+        if (total) {
+            printf(" | %7.2f%%\n", 100.0 * confusion[r][r] / total);
+        } else {
+            printf(" | %8s\n", "-");
+        }
+    }
+    if (without_ref) printf("%ld linhas sem referência válida\n", without_ref);
+
+    FILE* diff = opt.diff ? fopen(opt.diff, "w") : nullptr;
+    if (opt.diff && !diff) fprintf(stderr, "model_eval: não foi possível criar %s\n", opt.diff);
+    if (diff) {
+        fprintf(diff, "linha,delta_t,delta_u,z_delta_t,z_delta_u,referencia,modelo");
+        for (int c = 0; c < classes; c++) fprintf(diff, ",p_%s", class_name(c));
+        fprintf(diff, "\n");
+    }
+    int shown = 0;
+    for (size_t i = 0; i < ds.rows.size(); i++) {
+        const Row& r = ds.rows[i];
+        const Prediction& p = preds[i];
+        if (r.ref < 0 || r.ref >= classes || r.ref == p.cls) continue;
+        if (shown < opt.show) {
+            if (!shown) printf("\nDivergências (linha do arquivo: ΔT ΔU -> modelo / referência):\n");
+            printf("  %6d: %7.2f %7.2f -> %-8s (p=%.3f) / %s\n", r.line, r.delta[0], r.delta[1],
+                   class_name(p.cls), p.prob[p.cls], class_name(r.ref));
+            shown++;
+        }
+        if (diff) {
+            fprintf(diff, "%d,%.4f,%.4f,%.6f,%.6f,%d,%d", r.line, r.delta[0], r.delta[1], r.z[0], r.z[1],
+                    r.ref, p.cls);
+            for (int c = 0; c < classes; c++) fprintf(diff, ",%.6f", p.prob[c]);
+            fprintf(diff, "\n");
+        }
+    }
+    if (diff) fclose(diff);
+    printf("\nmodel_eval: %ld de %ld linhas concordam com %s (%.2f%%), %ld divergências\n", agree, with_ref,
+           ds.ref_name.c_str(), 100.0 * agree / with_ref, with_ref - agree);
+}
+
+bool parse_args(int argc, char** argv, Options* opt) {
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--model") && i + 1 < argc) {
+            opt->model = argv[++i];
+        } else if (!strcmp(argv[i], "--threads") && i + 1 < argc) {
+            opt->threads = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--scaling")) {
+            opt->scaling = true;
+        } else if (!strcmp(argv[i], "--ref") && i + 1 < argc) {
+            opt->ref = argv[++i];
+        } else if (!strcmp(argv[i], "--show") && i + 1 < argc) {
+            opt->show = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--diff") && i + 1 < argc) {
+            opt->diff = argv[++i];
+        } else if (!strcmp(argv[i], "--min-accuracy") && i + 1 < argc) {
+            opt->min_accuracy = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--arena-kb") && i + 1 < argc) {
+            opt->arena_bytes = (size_t)atoi(argv[++i]) * 1024;
+        } else if (argv[i][0] != '-') {
+            static std::string path;
+            path = argv[i];
+            const size_t eq = path.rfind('=');
+            if (eq != std::string::npos) {
+                opt->forced_class = atoi(path.c_str() + eq + 1);
+                path.resize(eq);
+            }
+            opt->input = path.c_str();
+        } else {
+            return false;
+        }
+    }
+    return opt->arena_bytes > 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parse_args(argc, argv, &opt)) {
+        fprintf(stderr,
+                "uso: %s [--model arquivo.tflite] [--threads N] [--scaling] [--ref COLUNA] [--show N]\n"
+                "        [--diff divergencias.csv] [--min-accuracy P] [--arena-kb K] [arquivo.csv[=classe]]\n",
+                argv[0]);
+        return 2;
+    }
+    if (opt.threads <= 0) opt.threads = (int)std::thread::hardware_concurrency();
+    if (opt.threads <= 0) opt.threads = 1;
+
+    std::vector<uint8_t> model_storage;
+    const tflite::Model* model;
+    if (!load_model(opt, &model_storage, &model)) return 1;
+    Dataset ds;
+    if (!load(opt, &ds)) return 1;
+    if (ds.rows.empty()) {
+        fprintf(stderr, "model_eval: nenhuma linha em %s\n", opt.input);
+        return 1;
+    }
+    printf("model_eval: %zu linhas de %s (%d ignoradas), referência %s\n", ds.rows.size(), opt.input,
+           ds.skipped, ds.ref_name.c_str());
+
+    std::vector<int> counts;
+    if (opt.scaling) {
+        for (int t = 1; t < opt.threads; t *= 2) counts.push_back(t);
+    }
+    counts.push_back(opt.threads);
+
+    std::vector<Prediction> preds, first;
+    int classes = 0, mismatched_runs = 0;
+    double base_ms = 0.0;
+    if (opt.scaling) printf("%7s | %9s | %12s | %7s | %9s\n", "threads", "ms", "inferências/s", "escala", "eficiência");
+    for (int threads : counts) {
+        const Run run = evaluate(model, opt, ds.rows, threads, &preds, &classes);
+        if (!run.ok) {
+            fprintf(stderr, "model_eval: falha ao montar ou rodar o interpreter (arena de %zu bytes)\n",
+                    opt.arena_bytes);
+            return 1;
+        }
+        if (first.empty()) {
+            first = preds;
+            base_ms = run.ms;
+        } else {
+            for (size_t i = 0; i < preds.size(); i++) {
+                if (preds[i].cls != first[i].cls || memcmp(preds[i].prob, first[i].prob, sizeof(preds[i].prob))) {
+                    mismatched_runs++;
+                    break;
+                }
+            }
+        }
+        const double rate = ds.rows.size() / (run.ms / 1000.0);
+        if (opt.scaling) {
+            printf("%7d | %9.2f | %12.0f | %6.2fx | %8.0f%%\n", threads, run.ms, rate, base_ms / run.ms,
+                   100.0 * base_ms / run.ms / threads);
+        } else {
+            printf("%d threads: %.2f ms, %.0f inferências/s\n", threads, run.ms, rate);
+        }
+    }
+    if (opt.scaling) {
+        printf("%d divergências entre execuções\n", mismatched_runs);
+    }
+
+    printf("\n");
+    report(ds, preds, classes, opt);
+
+    if (mismatched_runs) return 1;
+    if (opt.min_accuracy >= 0.0) {
+        long agree = 0, with_ref = 0;
+        for (size_t i = 0; i < ds.rows.size(); i++) {
+            if (ds.rows[i].ref < 0 || ds.rows[i].ref >= classes) continue;
+            with_ref++;
+            agree += ds.rows[i].ref == preds[i].cls;
+        }
+        if (!with_ref || 100.0 * agree / with_ref < opt.min_accuracy) {
+            fprintf(stderr, "model_eval: acerto abaixo de %.2f%%\n", opt.min_accuracy);
+            return 1;
+        }
+    }
+    return 0;
+}
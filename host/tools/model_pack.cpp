@@ -0,0 +1,128 @@
+// Empacota um modelo .tflite como imagem de slot (lib/model_slot): cabeçalho
+// com schema, CRC, arena medida e geração + o flatbuffer.
+//
+//   model_pack [--generation N] [modelo.tflite] -o imagem.bin
+//   model_pack [--generation N] [modelo.tflite] --slot K slots.bin
+//
+// Sem modelo usa o embarcado (modelo_predator.h). A imagem vai para o Pico pelo
+// comando 'U' da serial; --slot grava direto no arquivo de slots do host
+// (PREDAGUARD_MODEL_SLOTS) com a mesma rotina de gravação do firmware.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include "host/tools/arena_probe.h"
+#include "lib/model_slot/model_slot.h"
+#include "lib/recorder/flash_file.h"
+#include "modelo_predator.h"
+#include "tflm_wrapper.h"
+
+namespace {
+
+struct Options {
+    const char* model = nullptr;
+    const char* output = nullptr;
+    const char* slots = nullptr;
+    int slot = -1;
+    uint32_t generation = 1;
+};
+
+bool parse_args(int argc, char** argv, Options* opt) {
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-o") && i + 1 < argc) {
+            opt->output = argv[++i];
+        } else if (!strcmp(argv[i], "--slot") && i + 2 < argc) {
+            opt->slot = atoi(argv[++i]);
+            opt->slots = argv[++i];
+        } else if (!strcmp(argv[i], "--generation") && i + 1 < argc) {
+            opt->generation = (uint32_t)strtoul(argv[++i], nullptr, 0);
+        } else if (argv[i][0] != '-' && !opt->model) {
+            opt->model = argv[i];
+        } else {
+            opt->output = nullptr;
+            opt->slots = nullptr;
+            break;
+        }
+    }
+    if ((!opt->output && !opt->slots) || (opt->slots && (opt->slot < 0 || opt->slot >= MODEL_SLOT_COUNT))) {
+        fprintf(stderr, "uso: %s [--generation N] [modelo.tflite] (-o imagem.bin | --slot K slots.bin)\n",
+                argv[0]);
+        return false;
+    }
+    return true;
+}
+
+bool read_file(const char* path, std::vector<uint8_t>* out) {
+    FILE* fp = fopen(path, "rb");
+    if (!fp) return false;
+    uint8_t buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) out->insert(out->end(), buf, buf + n);
+    fclose(fp);
+    return !out->empty();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parse_args(argc, argv, &opt)) return 2;
+
+    std::vector<uint8_t> model;
+    if (opt.model) {
+        if (!read_file(opt.model, &model)) {
+            fprintf(stderr, "[MODELO] Não foi possível ler %s\n", opt.model);
+            return 1;
+        }
+    } else {
+        model.assign(modelo_tflite, modelo_tflite + modelo_tflite_len);
+    }
+
+    // Mesma margem do arena_sizer; o firmware recusa se passar de TFLM_ARENA_SIZE
+    ArenaReport r;
+    if (!arena_probe(tflite::GetModel(model.data()), &r)) {
+        fprintf(stderr, "[MODELO] ERRO: o modelo não aloca nem em 256 KB\n");
+        return 1;
+    }
+    const uint32_t arena = (uint32_t)((r.min_arena_bytes + (r.min_arena_bytes * 10 + 99) / 100 + 15) & ~(size_t)15);
+
+    std::vector<uint8_t> image(MODEL_SLOT_HEADER_BYTES + model.size());
+    const uint32_t len = model_slot_pack(model.data(), (uint32_t)model.size(), TFLM_MODEL_SCHEMA_VERSION,
+                                         arena, opt.generation, image.data(), (uint32_t)image.size());
+    if (len == 0) {
+        fprintf(stderr, "[MODELO] ERRO: modelo de %zu bytes não cabe no slot (%u)\n", model.size(),
+                MODEL_SLOT_MAX_MODEL);
+        return 1;
+    }
+
+    if (opt.output) {
+        FILE* fp = fopen(opt.output, "wb");
+        if (!fp || fwrite(image.data(), 1, len, fp) != len) {
+            fprintf(stderr, "[MODELO] Não foi possível gravar %s\n", opt.output);
+            if (fp) fclose(fp);
+            return 1;
+        }
+        fclose(fp);
+    }
+    if (opt.slots) {
+        FlashFile file;
+        FlashDevice dev;
+        ModelSlotWriter w;
+        if (!flash_file_open(&file, opt.slots, MODEL_SLOT_REGION_BYTES, false, &dev)) {
+            fprintf(stderr, "[MODELO] Não foi possível abrir %s\n", opt.slots);
+            return 1;
+        }
+        const bool ok = model_slot_writer_begin(&w, &dev, opt.slot, len) &&
+                        model_slot_writer_put(&w, image.data(), len) && model_slot_writer_finish(&w);
+        flash_file_close(&file);
+        if (!ok) {
+            fprintf(stderr, "[MODELO] Falha ao gravar o slot %d\n", opt.slot);
+            return 1;
+        }
+    }
+    printf("[MODELO] imagem de %u bytes: modelo %zu bytes, arena %u bytes, geração %u\n", len,
+           model.size(), arena, opt.generation);
+    return 0;
+}
@@ -0,0 +1,122 @@
+// Converte as amostras do gravador em CSV no formato das capturas
+// *_differential_bruto.csv (timestamp,t_ex,u_ex,t_amb,u_amb,dT,dU,rotulo),
+// que o replay do host (PREDAGUARD_CSV) também lê.
+//
+//   recorder_export [--label NOME] imagem.bin     imagem da região (PREDAGUARD_FLASH)
+//   recorder_export --dump [--label NOME] dump.bin   saída do comando 'D' pela USB
+//
+// Sem --label o rótulo é a classe prevista pelo modelo na hora da gravação.
+#include <stdio.h>
+#include <string.h>
+
+#include "lib/aht20/aht20.h"
+#include "lib/recorder/flash_file.h"
+#include "lib/recorder/recorder.h"
+
+static const char *const class_labels[] = {"IDLE", "GAMING", "OBSTRUCAO"};
+
+typedef struct {
+    const char *label;
+    unsigned long records;
+    unsigned long invalid;
+} ExportState;
+
+static void print_sample(ExportState *st, const uint8_t *payload, uint8_t len) {
+    RecorderSample s;
+    if (!recorder_sample_decode(payload, len, &s)) {
+        st->invalid++;
+        return;
+    }
+    const double t_ex = s.raw_temp_1 * (200.0 / AHT20_RAW_FULL_SCALE) - 50.0;
+    const double u_ex = s.raw_humidity_1 * (100.0 / AHT20_RAW_FULL_SCALE);
+    const double t_amb = s.raw_temp_2 * (200.0 / AHT20_RAW_FULL_SCALE) - 50.0;
+    const double u_amb = s.raw_humidity_2 * (100.0 / AHT20_RAW_FULL_SCALE);
+    const char *label = st->label ? st->label
+                        : s.class_index < 3 ? class_labels[s.class_index] : "?";
+    printf("%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%s\n", s.timestamp_ms / 1000.0, t_ex, u_ex,
+           t_amb, u_amb, t_ex - t_amb, u_ex - u_amb, label);
+    st->records++;
+}
+
+static int export_image(ExportState *st, const char *path) {
+    FlashFile file;
+    FlashDevice dev;
+    Recorder rec;
+    if (!flash_file_open(&file, path, 0, true, &dev) || !recorder_open(&rec, &dev)) {
+        fprintf(stderr, "[REC] %s não é uma imagem válida do gravador\n", path);
+        return 1;
+    }
+    RecorderCursor c;
+    uint8_t payload[RECORDER_MAX_PAYLOAD];
+    uint8_t len;
+    recorder_cursor_init(&c, &rec);
+    while (recorder_cursor_next(&c, payload, &len)) print_sample(st, payload, len);
+    flash_file_close(&file);
+    return 0;
+}
+
+static int export_dump(ExportState *st, const char *path) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        fprintf(stderr, "[REC] Não foi possível abrir %s\n", path);
+        return 1;
+    }
+    uint8_t buf[4096];
+    size_t len = 0;
+    unsigned long skipped = 0;
+    bool eof = false;
+    while (!eof || len > 0) {
+        if (!eof) {
+            const size_t n = fread(buf + len, 1, sizeof(buf) - len, fp);
+            len += n;
+            eof = n == 0;
+        }
+        size_t pos = 0;
+        while (pos < len) {
+            uint8_t payload[RECORDER_MAX_PAYLOAD];
+            uint8_t plen;
+            bool found;
+            size_t used = recorder_frame_decode(buf + pos, len - pos, payload, &plen, &found);
+            if (used == 0) {
+                if (!eof) break; // Quadro incompleto: lê mais
+                used = len - pos;
+            }
+            pos += used;
+            if (found) {
+                print_sample(st, payload, plen);
+            } else {
+                skipped += used; // Texto do printf na mesma USB
+            }
+        }
+        memmove(buf, buf + pos, len - pos);
+        len -= pos;
+    }
+    fclose(fp);
+    fprintf(stderr, "[REC] %lu bytes fora de quadros ignorados\n", skipped);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    ExportState st = {NULL, 0, 0};
+    bool dump = false;
+    const char *path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--dump")) {
+            dump = true;
+        } else if (!strcmp(argv[i], "--label") && i + 1 < argc) {
+            st.label = argv[++i];
+        } else if (argv[i][0] != '-' && !path) {
+            path = argv[i];
+        } else {
+            path = NULL;
+            break;
+        }
+    }
+    if (!path) {
+        fprintf(stderr, "uso: %s [--dump] [--label NOME] arquivo\n", argv[0]);
+        return 2;
+    }
+    const int rc = dump ? export_dump(&st, path) : export_image(&st, path);
+    fprintf(stderr, "[REC] %lu registros exportados, %lu inválidos\n", st.records, st.invalid);
+    return rc;
+}
@@ -0,0 +1,92 @@
+// Decodifica a telemetria binária do firmware (lib/telemetry) em texto ou CSV.
+//
+//   telemetry_decode [--csv] [arquivo]     (sem arquivo: stdin)
+//
+// Bytes que não formam um registro válido (texto do stdio na mesma UART,
+// registros corrompidos) são pulados; o resumo vai para stderr.
+#include <stdio.h>
+#include <string.h>
+
+#include "lib/telemetry/telemetry.h"
+#include "lib/aht20/aht20.h"
+
+static void print_csv(const TelemetryRecord *r) {
+    printf("%u,%lu,%.4f,%.4f,%ld,%ld,%u,%.4f,%u,%u,%u,%u,%.2f\n", r->seq,
+           (unsigned long)r->timestamp_ms, r->delta_t_raw * (200.0 / AHT20_RAW_FULL_SCALE),
+           r->delta_u_raw * (100.0 / AHT20_RAW_FULL_SCALE), (long)r->delta_t_raw,
+           (long)r->delta_u_raw, r->class_index, r->confidence / 255.0,
+           r->stage_us[TELEMETRY_STAGE_SENSORES], r->stage_us[TELEMETRY_STAGE_PREPROC],
+           r->stage_us[TELEMETRY_STAGE_INFERENCIA], r->stage_us[TELEMETRY_STAGE_SAIDA],
+           r->trend_centi_c_min / 100.0);
+}
+
+int main(int argc, char **argv) {
+    bool csv = false;
+    const char *path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--csv")) {
+            csv = true;
+        } else if (argv[i][0] == '-' && argv[i][1]) {
+            fprintf(stderr, "uso: %s [--csv] [arquivo]\n", argv[0]);
+            return 2;
+        } else {
+            path = argv[i];
+        }
+    }
+    FILE *fp = path ? fopen(path, "rb") : stdin;
+    if (!fp) {
+        fprintf(stderr, "[TELEMETRIA] Não foi possível abrir %s\n", path);
+        return 1;
+    }
+    if (csv) {
+        printf("seq,timestamp_ms,delta_t,delta_u,delta_t_raw,delta_u_raw,classe,confianca,"
+               "t_sensores_us,t_preproc_us,t_inferencia_us,t_saida_us,trend_delta_t\n");
+    }
+
+    uint8_t buf[4096];
+    size_t len = 0;
+    unsigned long records = 0, skipped = 0, gaps = 0;
+    bool have_seq = false;
+    uint16_t last_seq = 0;
+    bool eof = false;
+    while (!eof || len > 0) {
+        if (!eof) {
+            size_t n = fread(buf + len, 1, sizeof(buf) - len, fp);
+            len += n;
+            eof = n == 0;
+        }
+        size_t pos = 0;
+        while (pos < len) {
+            TelemetryRecord rec;
+            bool found;
+            size_t used = telemetry_decode(buf + pos, len - pos, &rec, &found);
+            if (used == 0) {
+                if (!eof) break; // Registro incompleto: lê mais
+                used = len - pos;  // Fim do arquivo: o resto é lixo
+            }
+            pos += used;
+            if (!found) {
+                skipped += used;
+                continue;
+            }
+            if (have_seq && (uint16_t)(last_seq + 1) != rec.seq) gaps++;
+            have_seq = true;
+            last_seq = rec.seq;
+            records++;
+            if (csv) {
+                print_csv(&rec);
+            } else {
+                char line[128];
+                telemetry_format_text(&rec, line, sizeof(line));
+                fputs(line, stdout);
+            }
+        }
+        memmove(buf, buf + pos, len - pos);
+        len -= pos;
+        if (eof && pos == 0) break;
+    }
+    if (fp != stdin) fclose(fp);
+    fprintf(stderr, "[TELEMETRIA] %lu registros, %lu bytes ignorados, %lu saltos de seq\n",
+            records, skipped, gaps);
+    return 0;
+}
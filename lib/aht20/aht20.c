@@ -18,6 +18,19 @@ bool aht20_init(i2c_inst_t *i2c) {
     return false;  // Falhou na calibração
 }
 
+// Converte o frame de 6 bytes (status + 20 bits umidade + 20 bits temperatura)
+static void aht20_decode(const uint8_t *buffer, AHT20_Data *data) {
+    // Processa os dados de umidade (20 bits)
+    uint32_t raw_humidity = ((uint32_t)buffer[1] << 12) | ((uint32_t)buffer[2] << 4) | (buffer[3] >> 4);
+    data->humidity = (float)raw_humidity * 100.0 / 1048576.0;
+    data->raw_humidity = raw_humidity;
+
+    // Processa os dados de temperatura (20 bits)
+    uint32_t raw_temp = ((uint32_t)(buffer[3] & 0x0F) << 16) | ((uint32_t)buffer[4] << 8) | buffer[5];
+    data->temperature = ((float)raw_temp * 200.0 / 1048576.0) - 50.0;
+    data->raw_temperature = raw_temp;
+}
+
 bool aht20_read(i2c_inst_t *i2c, AHT20_Data *data) {
     uint8_t trigger_cmd[3] = {AHT20_CMD_TRIGGER, 0x33, 0x00};
     uint8_t buffer[6];
@@ -45,14 +58,7 @@ bool aht20_read(i2c_inst_t *i2c, AHT20_Data *data) {
         return false;
     }
 
-    // Processa os dados de umidade (20 bits)
-    uint32_t raw_humidity = ((uint32_t)buffer[1] << 12) | ((uint32_t)buffer[2] << 4) | (buffer[3] >> 4);
-    data->humidity = (float)raw_humidity * 100.0 / 1048576.0;
-
-    // Processa os dados de temperatura (20 bits)
-    uint32_t raw_temp = ((uint32_t)(buffer[3] & 0x0F) << 16) | ((uint32_t)buffer[4] << 8) | buffer[5];
-    data->temperature = ((float)raw_temp * 200.0 / 1048576.0) - 50.0;
-
+    aht20_decode(buffer, data);
     return true;
 }
 
@@ -66,4 +72,51 @@ void aht20_reset(i2c_inst_t *i2c) {
 bool aht20_check(i2c_inst_t *i2c) {
     uint8_t status;
     return i2c_read_blocking(i2c, AHT20_I2C_ADDR, &status, 1, false) == 1;
-}
\ No newline at end of file
+}
+
+void aht20_async_init(AHT20_Async *s, i2c_inst_t *i2c) {
+    s->i2c = i2c;
+    s->state = AHT20_ASYNC_IDLE;
+    s->trigger_us = 0;
+    s->data.temperature = 0;
+    s->data.humidity = 0;
+    s->data.raw_temperature = AHT20_RAW_TEMP_ZERO_C;
+    s->data.raw_humidity = 0;
+}
+
+bool aht20_async_start(AHT20_Async *s) {
+    uint8_t trigger_cmd[3] = {AHT20_CMD_TRIGGER, 0x33, 0x00};
+
+    if (i2c_write_blocking(s->i2c, AHT20_I2C_ADDR, trigger_cmd, 3, false) != 3) {
+        s->state = AHT20_ASYNC_ERROR;
+        return false;
+    }
+    s->trigger_us = time_us_64();
+    s->state = AHT20_ASYNC_CONVERTING;
+    return true;
+}
+
+AHT20_AsyncState aht20_async_poll(AHT20_Async *s) {
+    if (s->state != AHT20_ASYNC_CONVERTING) {
+        return s->state;
+    }
+
+    uint64_t elapsed = time_us_64() - s->trigger_us;
+    if (elapsed < AHT20_MEASURE_TIME_US) {
+        return AHT20_ASYNC_CONVERTING;  // Ainda não vale a pena ocupar o barramento
+    }
+
+    // O status vem no primeiro byte do frame: uma transação só
+    uint8_t buffer[6];
+    if (i2c_read_blocking(s->i2c, AHT20_I2C_ADDR, buffer, 6, false) != 6) {
+        s->state = AHT20_ASYNC_ERROR;
+    } else if (buffer[0] & AHT20_STATUS_BUSY) {
+        if (elapsed >= AHT20_MEASURE_TIMEOUT_US) {
+            s->state = AHT20_ASYNC_ERROR;
+        }
+    } else {
+        aht20_decode(buffer, &s->data);
+        s->state = AHT20_ASYNC_READY;
+    }
+    return s->state;
+}
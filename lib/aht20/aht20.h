@@ -20,12 +20,38 @@
 #define AHT20_CMD_TRIGGER   0xAC
 #define AHT20_CMD_RESET     0xBA
 
+// Tempo típico de conversão (datasheet: 80 ms) e limite antes de declarar falha
+#define AHT20_MEASURE_TIME_US   80000
+#define AHT20_MEASURE_TIMEOUT_US 150000
+
+// Códigos brutos de 20 bits: U = raw * 100 / 2^20, T = raw * 200 / 2^20 - 50
+#define AHT20_RAW_FULL_SCALE    1048576u
+#define AHT20_RAW_TEMP_ZERO_C   262144u   // Código que decodifica para 0 °C
+
 // Estrutura para armazenar os valores de temperatura e umidade
 typedef struct {
     float temperature;
     float humidity;
+    uint32_t raw_temperature;  // Código bruto (caminho inteiro, ver lib/preproc)
+    uint32_t raw_humidity;
 } AHT20_Data;
 
+// Estados da leitura não bloqueante
+typedef enum {
+    AHT20_ASYNC_IDLE = 0,    // Nenhuma conversão pendente
+    AHT20_ASYNC_CONVERTING,  // Trigger enviado, aguardando o sensor
+    AHT20_ASYNC_READY,       // Resultado disponível em 'data'
+    AHT20_ASYNC_ERROR        // Falha de barramento ou timeout
+} AHT20_AsyncState;
+
+// Leitura não bloqueante: um por sensor, sem alocação
+typedef struct {
+    i2c_inst_t *i2c;
+    AHT20_AsyncState state;
+    uint64_t trigger_us;     // Instante do trigger (time_us_64)
+    AHT20_Data data;
+} AHT20_Async;
+
 // Inicializa o sensor AHT20
 bool aht20_init(i2c_inst_t *i2c);
 
@@ -37,4 +63,14 @@ void aht20_reset(i2c_inst_t *i2c);
 
 bool aht20_check(i2c_inst_t *i2c);
 
-#endif // AHT20_H
\ No newline at end of file
+// Prepara a máquina de estados da leitura não bloqueante
+void aht20_async_init(AHT20_Async *s, i2c_inst_t *i2c);
+
+// Envia o comando de medição e retorna imediatamente
+bool aht20_async_start(AHT20_Async *s);
+
+// Avança a máquina de estados sem bloquear. Antes de AHT20_MEASURE_TIME_US
+// não há tráfego no barramento; depois, uma única leitura de 6 bytes.
+AHT20_AsyncState aht20_async_poll(AHT20_Async *s);
+
+#endif // AHT20_H
\ No newline at end of file
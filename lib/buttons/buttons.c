@@ -1,12 +1,18 @@
 #include "buttons.h"
 
-volatile int8_t offset = 0;
-volatile bool lock_humidity = false;
+int8_t offset = 0;
+bool lock_humidity = false;
 
-// Variável para guardar o tempo do último evento
-static volatile uint32_t last_time = 0;
+static EventQueue *button_queue = NULL;
+static int button_lane = 0;
+
+// Carimbo do último evento aceito
+static uint32_t last_time_us = 0;
+
+void init_buttons(EventQueue *queue, int lane) {
+    button_queue = queue;
+    button_lane = lane;
 
-void init_buttons() {
     gpio_init(BTN_A);
     gpio_set_dir(BTN_A, GPIO_IN);
     gpio_pull_up(BTN_A);
@@ -19,18 +25,25 @@ void init_buttons() {
     gpio_set_irq_enabled_with_callback(BTN_B, GPIO_IRQ_EDGE_FALL, true, &gpio_irq_handler);
 }
 
+// Só carimba e enfileira: debounce e printf ficam para buttons_handle
 void gpio_irq_handler(uint gpio, uint32_t events) {
-    uint32_t current_time = to_ms_since_boot(get_absolute_time());
+    const uint32_t t0 = time_us_32();
+    event_push(button_queue, button_lane, EVENT_BUTTON, (uint8_t)gpio, (uint16_t)events, t0);
+    event_isr_end(button_queue, button_lane, t0);
+}
 
-    if (current_time - last_time < 200) {
-        return; 
+bool buttons_handle(const Event *ev) {
+    if (ev->type != EVENT_BUTTON) return false;
+
+    if (ev->time_us - last_time_us < BUTTON_DEBOUNCE_US) {
+        return true; 
     }
 
-    last_time = current_time;
+    last_time_us = ev->time_us;
 
-    if (gpio == BTN_A) {
+    if (ev->source == BTN_A) {
         offset -= 5;
-    } else if (gpio == BTN_B) {
+    } else if (ev->source == BTN_B) {
         offset += 5;
     }
 
@@ -41,4 +54,5 @@ void gpio_irq_handler(uint gpio, uint32_t events) {
         lock_humidity = false;
         printf("Offset resetado para 0. Lock de umidade desativado.\n");
     }
-}
\ No newline at end of file
+    return true;
+}
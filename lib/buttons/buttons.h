@@ -6,14 +6,22 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include "pico/time.h"
+#include "lib/events/events.h"
 
 #define BTN_A 5
 #define BTN_B 6
 
-extern volatile int8_t offset;
-extern volatile bool lock_humidity;
+#define BUTTON_DEBOUNCE_US 200000u
 
-void init_buttons();
+// Ajustados só em contexto de tarefa (buttons_handle)
+extern int8_t offset;
+extern bool lock_humidity;
+
+// As interrupções dos botões vão para a faixa `lane` da fila
+void init_buttons(EventQueue *queue, int lane);
 void gpio_irq_handler(uint gpio, uint32_t events);
 
-#endif
\ No newline at end of file
+// Trata um evento da fila (debounce pelo carimbo da ISR); false se não é de botão
+bool buttons_handle(const Event *ev);
+
+#endif
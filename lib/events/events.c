@@ -0,0 +1,68 @@
+#include "events.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "pico/time.h"
+
+static inline uint32_t load_acquire(const uint32_t *p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+static inline void store_release(uint32_t *p, uint32_t v) { __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+
+void event_queue_init(EventQueue *q) {
+    memset(q, 0, sizeof(*q));
+}
+
+bool event_push(EventQueue *q, int lane, EventType type, uint8_t source, uint16_t arg,
+                uint32_t time_us) {
+    EventLane *l = &q->lanes[lane];
+    const uint32_t head = l->head;
+    if (head - load_acquire(&l->tail) == EVENT_LANE_DEPTH) {
+        l->dropped++;
+        return false;
+    }
+    Event *e = &l->slots[head & (EVENT_LANE_DEPTH - 1)];
+    e->time_us = time_us;
+    e->type = (uint8_t)type;
+    e->source = source;
+    e->arg = arg;
+    store_release(&l->head, head + 1);
+    l->pushed++;
+    return true;
+}
+
+void event_isr_end(EventQueue *q, int lane, uint32_t started_us) {
+    EventLane *l = &q->lanes[lane];
+    const uint32_t dt = time_us_32() - started_us;
+    if (dt > l->isr_max_us) l->isr_max_us = dt;
+    l->isr_count++;
+}
+
+bool event_pop(EventQueue *q, Event *out) {
+    EventLane *oldest = NULL;
+    for (int i = 0; i < EVENT_MAX_LANES; i++) {
+        EventLane *l = &q->lanes[i];
+        const uint32_t tail = l->tail;
+        if (load_acquire(&l->head) == tail) continue;
+        // Diferença com sinal: vale através da volta do time_us_32
+        if (!oldest || (int32_t)(l->slots[tail & (EVENT_LANE_DEPTH - 1)].time_us -
+                                 oldest->slots[oldest->tail & (EVENT_LANE_DEPTH - 1)].time_us) < 0) {
+            oldest = l;
+        }
+    }
+    if (!oldest) return false;
+    *out = oldest->slots[oldest->tail & (EVENT_LANE_DEPTH - 1)];
+    store_release(&oldest->tail, oldest->tail + 1);
+    q->popped++;
+    return true;
+}
+
+void event_report(const EventQueue *q) {
+    for (int i = 0; i < EVENT_MAX_LANES; i++) {
+        const EventLane *l = &q->lanes[i];
+        if (l->pushed == 0 && l->dropped == 0 && l->isr_count == 0) continue;
+        printf("[EVT] faixa %d: %lu eventos, %lu descartados | %lu ISRs, pior %lu us\n", i,
+               (unsigned long)l->pushed, (unsigned long)l->dropped, (unsigned long)l->isr_count,
+               (unsigned long)l->isr_max_us);
+    }
+    printf("[EVT] %lu tratados\n", (unsigned long)q->popped);
+}
@@ -0,0 +1,80 @@
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================
+// FILA DE EVENTOS DAS INTERRUPÇÕES
+// As ISRs só carimbam e enfileiram o evento; o loop (ou um worker) esvazia a
+// fila e trata em contexto de tarefa: debounce, printf, estado. Nada de
+// trava nem de laço de repetição do lado da ISR, então o tempo dela é fixo.
+//
+// O Cortex-M0+ não tem LDREX/STREX, então em vez de uma fila com CAS cada
+// contexto produtor tem a sua faixa SPSC (mesmo esquema de índices da
+// lib/pipeline/spsc_queue): interrupções do core 0 na mesma prioridade não
+// se aninham e podem dividir uma faixa; o core 1 usa outra. O consumidor
+// entrega sempre o evento mais antigo entre as cabeças das faixas.
+// Faixa cheia: o evento é descartado e contado, a ISR não espera.
+// ============================================================
+
+#define EVENT_MAX_LANES  4
+#define EVENT_LANE_DEPTH 16     // Potência de 2
+
+// Faixas usadas pelo firmware
+#define EVENT_LANE_IRQ   0      // Interrupções do core 0 (GPIO, alarmes)
+#define EVENT_LANE_CORE1 1      // Core 1 (tarefa ou interrupções dele)
+
+typedef enum {
+    EVENT_NONE = 0,
+    EVENT_BUTTON,               // source: GPIO, arg: máscara de bordas
+    EVENT_TIMER,                // source: id do alarme
+    EVENT_DATA_READY,           // source: sensor
+} EventType;
+
+typedef struct {
+    uint32_t time_us;           // Carimbo na entrada da ISR (time_us_32)
+    uint8_t type;               // EventType
+    uint8_t source;
+    uint16_t arg;
+} Event;
+
+typedef struct {
+    Event slots[EVENT_LANE_DEPTH];
+    uint32_t head;              // Escrito só pelo produtor
+    uint32_t tail;              // Escrito só pelo consumidor
+    // Produtor
+    uint32_t pushed;
+    uint32_t dropped;
+    uint32_t isr_count;
+    uint32_t isr_max_us;        // Pior tempo de ISR medido na faixa
+} EventLane;
+
+typedef struct {
+    EventLane lanes[EVENT_MAX_LANES];
+    uint32_t popped;            // Consumidor
+} EventQueue;
+
+void event_queue_init(EventQueue *q);
+
+// Produtor (ISR): passos fixos; false com a faixa cheia
+bool event_push(EventQueue *q, int lane, EventType type, uint8_t source, uint16_t arg,
+                uint32_t time_us);
+
+// Fim da ISR que começou em started_us: guarda o pior tempo da faixa
+void event_isr_end(EventQueue *q, int lane, uint32_t started_us);
+
+// Consumidor: evento mais antigo entre as faixas; false se todas vazias
+bool event_pop(EventQueue *q, Event *out);
+
+void event_report(const EventQueue *q);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EVENTS_H
@@ -0,0 +1,133 @@
+#include "features.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+// °C e %UR por código bruto (só em diferenciais: o offset de -50 °C some)
+#define FEAT_TEMP_PER_CODE (200.0f / (float)AHT20_RAW_FULL_SCALE)
+#define FEAT_HUM_PER_CODE  (100.0f / (float)AHT20_RAW_FULL_SCALE)
+
+bool feat_window_init(FeatWindow *w, uint16_t window) {
+    if (window == 0 || window > FEAT_MAX_WINDOW) return false;
+    memset(w, 0, sizeof(*w));
+    w->window = window;
+    return true;
+}
+
+void feat_window_push(FeatWindow *w, int32_t y) {
+    const uint32_t seq = w->seq++;
+    const uint16_t slot = (uint16_t)(seq % w->window);
+
+    if (w->count == w->window) {
+        // Sai a mais antiga (índice 0): os índices das outras caem 1
+        const int32_t oldest = w->samples[slot];
+        w->sum -= oldest;
+        w->sum_sq -= (int64_t)oldest * oldest;
+        w->sum_xy -= w->sum;
+        w->count--;
+    }
+    w->samples[slot] = y;
+    w->sum_xy += (int64_t)w->count * y;
+    w->sum += y;
+    w->sum_sq += (int64_t)y * y;
+    w->count++;
+
+    // Candidatas que saíram da janela
+    const uint32_t first = w->seq - w->count;
+    if (w->min_len && w->min_q[w->min_head] < first) {
+        w->min_head = (uint16_t)((w->min_head + 1) % FEAT_MAX_WINDOW);
+        w->min_len--;
+    }
+    if (w->max_len && w->max_q[w->max_head] < first) {
+        w->max_head = (uint16_t)((w->max_head + 1) % FEAT_MAX_WINDOW);
+        w->max_len--;
+    }
+    // A nova amostra domina as do fim da fila que não são melhores que ela
+    while (w->min_len &&
+           w->samples[w->min_q[(w->min_head + w->min_len - 1) % FEAT_MAX_WINDOW] % w->window] >= y) {
+        w->min_len--;
+    }
+    w->min_q[(w->min_head + w->min_len++) % FEAT_MAX_WINDOW] = seq;
+    while (w->max_len &&
+           w->samples[w->max_q[(w->max_head + w->max_len - 1) % FEAT_MAX_WINDOW] % w->window] <= y) {
+        w->max_len--;
+    }
+    w->max_q[(w->max_head + w->max_len++) % FEAT_MAX_WINDOW] = seq;
+}
+
+// Divisão inteira com arredondamento ao mais próximo (meio para longe do zero)
+static int64_t div_round(int64_t num, int64_t den) {
+    return (num >= 0) ? (num + den / 2) / den : -((-num + den / 2) / den);
+}
+
+int32_t feat_mean(const FeatWindow *w) {
+    return w->count ? (int32_t)div_round(w->sum, w->count) : 0;
+}
+
+uint64_t feat_variance(const FeatWindow *w) {
+    const int64_t n = w->count;
+    if (n == 0) return 0;
+    // (n Σy² - (Σy)²) / n²
+    return (uint64_t)div_round(n * w->sum_sq - w->sum * w->sum, n * n);
+}
+
+int32_t feat_min(const FeatWindow *w) {
+    return w->min_len ? w->samples[w->min_q[w->min_head] % w->window] : 0;
+}
+
+int32_t feat_max(const FeatWindow *w) {
+    return w->max_len ? w->samples[w->max_q[w->max_head] % w->window] : 0;
+}
+
+int32_t feat_slope_q16(const FeatWindow *w) {
+    const int64_t n = w->count;
+    if (n < 2) return 0;
+    // b = (n Σiy - Σi Σy) / (n Σi² - (Σi)²), com Σi = n(n-1)/2 e o denominador
+    // fechado em n²(n²-1)/12
+    const int64_t sum_i = n * (n - 1) / 2;
+    const int64_t num = n * w->sum_xy - sum_i * w->sum;
+    const int64_t den = n * n * (n * n - 1) / 12;
+    const int64_t q16 = div_round(num * 65536, den);
+    return q16 > INT32_MAX ? INT32_MAX : (q16 < INT32_MIN ? INT32_MIN : (int32_t)q16);
+}
+
+bool feat_engine_init(FeatureEngine *e, uint16_t window) {
+    return feat_window_init(&e->delta_t, window) && feat_window_init(&e->delta_u, window);
+}
+
+void feat_engine_push(FeatureEngine *e, const SensorReadings *r) {
+    feat_window_push(&e->delta_t, (int32_t)r->raw_temp_1 - (int32_t)r->raw_temp_2);
+    feat_window_push(&e->delta_u, (int32_t)r->raw_humidity_1 - (int32_t)r->raw_humidity_2);
+}
+
+void feat_engine_model_inputs(const FeatureEngine *e, const SensorReadings *r,
+                              const FeatNormalization *norm, float *out, int n) {
+    const FeatWindow *t = &e->delta_t;
+    const FeatWindow *u = &e->delta_u;
+    const float kt = FEAT_TEMP_PER_CODE, ku = FEAT_HUM_PER_CODE;
+    const float dt = r->aht_temp_1 - r->aht_temp_2;
+    const float du = r->humidity_1 - r->humidity_2;
+
+    float f[FEAT_NUM_FEATURES];
+    f[FEAT_Z_DELTA_T]     = (dt - norm->mean_delta_t) / norm->std_delta_t;
+    f[FEAT_Z_DELTA_U]     = (du - norm->mean_delta_u) / norm->std_delta_u;
+    f[FEAT_MEAN_DELTA_T]  = (feat_mean(t) * kt - norm->mean_delta_t) / norm->std_delta_t;
+    f[FEAT_MEAN_DELTA_U]  = (feat_mean(u) * ku - norm->mean_delta_u) / norm->std_delta_u;
+    f[FEAT_STD_DELTA_T]   = sqrtf((float)feat_variance(t)) * kt / norm->std_delta_t;
+    f[FEAT_STD_DELTA_U]   = sqrtf((float)feat_variance(u)) * ku / norm->std_delta_u;
+    f[FEAT_SLOPE_DELTA_T] = feat_slope_q16(t) / 65536.0f * kt / norm->std_delta_t;
+    f[FEAT_SLOPE_DELTA_U] = feat_slope_q16(u) / 65536.0f * ku / norm->std_delta_u;
+    f[FEAT_MIN_DELTA_T]   = (feat_min(t) * kt - norm->mean_delta_t) / norm->std_delta_t;
+    f[FEAT_MAX_DELTA_T]   = (feat_max(t) * kt - norm->mean_delta_t) / norm->std_delta_t;
+    f[FEAT_MIN_DELTA_U]   = (feat_min(u) * ku - norm->mean_delta_u) / norm->std_delta_u;
+    f[FEAT_MAX_DELTA_U]   = (feat_max(u) * ku - norm->mean_delta_u) / norm->std_delta_u;
+
+    if (n > FEAT_NUM_FEATURES) n = FEAT_NUM_FEATURES;
+    memcpy(out, f, (size_t)n * sizeof(float));
+}
+
+float feat_engine_trend_delta_t(const FeatureEngine *e, uint32_t period_us) {
+    const float per_sample = feat_slope_q16(&e->delta_t) / 65536.0f * FEAT_TEMP_PER_CODE;
+    return per_sample * (60e6f / (float)period_us);
+}
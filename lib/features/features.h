@@ -0,0 +1,96 @@
+#ifndef FEATURES_H
+#define FEATURES_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "lib/sensors/sensors.h"
+
+// ============================================================
+// FEATURES DE JANELA DESLIZANTE
+// Cada FeatWindow guarda as últimas N amostras inteiras (ex.: ΔT em códigos
+// brutos do AHT20) em um anel de capacidade fixa e mantém, em O(1) por
+// amostra e só com inteiros:
+//   soma, soma dos quadrados -> média e variância
+//   soma de i*y             -> inclinação por mínimos quadrados
+//   filas monotônicas       -> mínimo e máximo (O(1) amortizado)
+// Sem alocação: o chamador é dono da struct.
+//
+// Limite de precisão: |amostra| < 2^21 e N <= FEAT_MAX_WINDOW mantêm todas as
+// somas e produtos intermediários dentro de int64.
+// ============================================================
+
+#define FEAT_MAX_WINDOW 128
+
+typedef struct {
+    int32_t samples[FEAT_MAX_WINDOW];
+    uint16_t window;        // Tamanho configurado (<= FEAT_MAX_WINDOW)
+    uint16_t count;         // Amostras na janela (< window só no começo)
+    uint32_t seq;           // Amostras vistas desde o init
+    int64_t sum;            // Σ y
+    int64_t sum_sq;         // Σ y²
+    int64_t sum_xy;         // Σ i*y, i = 0 (mais antiga) .. count-1
+    // Filas monotônicas com o seq das candidatas a mínimo/máximo
+    uint32_t min_q[FEAT_MAX_WINDOW];
+    uint32_t max_q[FEAT_MAX_WINDOW];
+    uint16_t min_head, min_len;
+    uint16_t max_head, max_len;
+} FeatWindow;
+
+// false se window for 0 ou maior que FEAT_MAX_WINDOW
+bool feat_window_init(FeatWindow *w, uint16_t window);
+void feat_window_push(FeatWindow *w, int32_t y);
+
+// Consultas (janela vazia -> 0). Média e variância arredondadas ao inteiro;
+// inclinação em Q16 (unidades da amostra por amostra, * 65536), saturada em
+// ±32768 códigos/amostra (~6 °C por amostra em ΔT).
+int32_t  feat_mean(const FeatWindow *w);
+uint64_t feat_variance(const FeatWindow *w);   // Populacional
+int32_t  feat_min(const FeatWindow *w);
+int32_t  feat_max(const FeatWindow *w);
+int32_t  feat_slope_q16(const FeatWindow *w);
+
+// ============================================================
+// MOTOR DO PREDAGUARD: janelas de ΔT e ΔU em códigos brutos
+// ============================================================
+typedef struct {
+    FeatWindow delta_t;     // raw_temp_1 - raw_temp_2
+    FeatWindow delta_u;     // raw_humidity_1 - raw_humidity_2
+} FeatureEngine;
+
+// Vetor de entrada do modelo, nesta ordem. As duas primeiras são as entradas
+// do modelo atual (z-score instantâneo); um modelo temporal retreinado usa as
+// seguintes. Médias/mín/máx usam o mesmo z-score; desvio e inclinação são
+// divididos pelo desvio de normalização.
+enum {
+    FEAT_Z_DELTA_T = 0,
+    FEAT_Z_DELTA_U,
+    FEAT_MEAN_DELTA_T,
+    FEAT_MEAN_DELTA_U,
+    FEAT_STD_DELTA_T,
+    FEAT_STD_DELTA_U,
+    FEAT_SLOPE_DELTA_T,     // Por amostra
+    FEAT_SLOPE_DELTA_U,
+    FEAT_MIN_DELTA_T,
+    FEAT_MAX_DELTA_T,
+    FEAT_MIN_DELTA_U,
+    FEAT_MAX_DELTA_U,
+    FEAT_NUM_FEATURES
+};
+
+typedef struct {
+    float mean_delta_t, std_delta_t;
+    float mean_delta_u, std_delta_u;
+} FeatNormalization;
+
+bool feat_engine_init(FeatureEngine *e, uint16_t window);
+void feat_engine_push(FeatureEngine *e, const SensorReadings *r);
+
+// Preenche out[0..n-1] com as primeiras n features da lista acima
+void feat_engine_model_inputs(const FeatureEngine *e, const SensorReadings *r,
+                              const FeatNormalization *norm, float *out, int n);
+
+// Tendência de ΔT em °C por minuto, dado o período de amostragem
+float feat_engine_trend_delta_t(const FeatureEngine *e, uint32_t period_us);
+
+#endif
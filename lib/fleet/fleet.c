@@ -0,0 +1,156 @@
+#include "fleet.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// Liga a porta do canal no barramento do lado dado. Se outro mux estava com
+// porta ligada ele é desligado antes: dois AHT20 no 0x38 ao mesmo tempo
+// colidem no barramento.
+static bool fleet_select(Fleet *f, FleetSide side, int channel) {
+    FleetBus *b = &f->bus[side];
+    const int mux = channel / TCA9548A_PORTS;
+    if (b->active_mux >= 0 && b->active_mux != mux) {
+        if (!tca9548a_set_ports(&b->muxes[b->active_mux], 0)) return false;
+        b->active_mux = -1;
+    }
+    if (!tca9548a_set_ports(&b->muxes[mux], (uint8_t)(1u << (channel % TCA9548A_PORTS)))) return false;
+    b->active_mux = mux;
+    return true;
+}
+
+int fleet_init(Fleet *f, i2c_inst_t *exhaust_bus, i2c_inst_t *ambient_bus, int num_channels) {
+    memset(f, 0, sizeof(*f));
+    if (num_channels < 0) num_channels = 0;
+    if (num_channels > FLEET_MAX_CHANNELS) num_channels = FLEET_MAX_CHANNELS;
+    f->num_channels = num_channels;
+    const int muxes = (num_channels + TCA9548A_PORTS - 1) / TCA9548A_PORTS;
+
+    i2c_inst_t *const buses[2] = {exhaust_bus, ambient_bus};
+    for (int side = 0; side < 2; side++) {
+        FleetBus *b = &f->bus[side];
+        b->i2c = buses[side];
+        b->active_mux = -1;
+        // Depois de um reset só do RP2040 o mux pode ter ficado com portas ligadas
+        for (int m = 0; m < muxes; m++) {
+            tca9548a_init(&b->muxes[m], b->i2c, (uint8_t)(TCA9548A_BASE_ADDR + m));
+            tca9548a_set_ports(&b->muxes[m], 0);
+        }
+    }
+
+    // Comando de init em todos, uma espera só (aht20_init espera por sensor)
+    const uint8_t init_cmd[3] = {AHT20_CMD_INIT, 0x08, 0x00};
+    for (int c = 0; c < num_channels; c++) {
+        for (int side = 0; side < 2; side++) {
+            FleetChannel *ch = &f->channels[c];
+            ch->present[side] = fleet_select(f, (FleetSide)side, c) &&
+                                i2c_write_blocking(f->bus[side].i2c, AHT20_I2C_ADDR, init_cmd, 3, false) == 3;
+            aht20_async_init(&ch->sensor[side], f->bus[side].i2c);
+        }
+    }
+    sleep_ms(50);
+
+    int ok = 0;
+    for (int c = 0; c < num_channels; c++) {
+        FleetChannel *ch = &f->channels[c];
+        for (int side = 0; side < 2; side++) {
+            if (!ch->present[side]) continue;
+            uint8_t status = 0;
+            ch->present[side] = fleet_select(f, (FleetSide)side, c) &&
+                                i2c_read_blocking(f->bus[side].i2c, AHT20_I2C_ADDR, &status, 1, false) == 1 &&
+                                (status & AHT20_STATUS_CALIBRATED);
+        }
+        if (ch->present[FLEET_EXHAUST] && ch->present[FLEET_AMBIENT]) ok++;
+    }
+    return ok;
+}
+
+void fleet_start(Fleet *f) {
+    f->cycle_start_us = time_us_64();
+    f->pending = f->num_channels;
+    for (int c = 0; c < f->num_channels; c++) {
+        FleetChannel *ch = &f->channels[c];
+        ch->done = false;
+        for (int side = 0; side < 2; side++) {
+            AHT20_Async *s = &ch->sensor[side];
+            if (!ch->present[side] || !fleet_select(f, (FleetSide)side, c)) {
+                s->state = AHT20_ASYNC_ERROR;
+                continue;
+            }
+            aht20_async_start(s);
+        }
+    }
+}
+
+bool fleet_poll(Fleet *f) {
+    if (f->pending == 0) return true;
+    for (int c = 0; c < f->num_channels; c++) {
+        FleetChannel *ch = &f->channels[c];
+        if (ch->done) continue;
+        bool converting = false;
+        for (int side = 0; side < 2; side++) {
+            AHT20_Async *s = &ch->sensor[side];
+            if (s->state != AHT20_ASYNC_CONVERTING) continue;
+            // Antes dos 80 ms nem a seleção do mux vai para o barramento
+            if (time_us_64() - s->trigger_us < AHT20_MEASURE_TIME_US) {
+                converting = true;
+                continue;
+            }
+            if (!fleet_select(f, (FleetSide)side, c)) {
+                s->state = AHT20_ASYNC_ERROR;
+            } else if (aht20_async_poll(s) == AHT20_ASYNC_CONVERTING) {
+                converting = true;
+            }
+        }
+        if (converting) continue;
+        ch->done = true;
+        f->pending--;
+        // Sensor ausente desde o fleet_init não é leitura perdida: o
+        // fleet_report já o mostra como ausente
+        for (int side = 0; side < 2; side++) {
+            if (!ch->present[side] || ch->sensor[side].state == AHT20_ASYNC_READY) continue;
+            ch->errors++;
+            f->stats.read_errors++;
+        }
+    }
+    if (f->pending > 0) return false;
+
+    const uint32_t cycle_us = (uint32_t)(time_us_64() - f->cycle_start_us);
+    f->stats.cycles++;
+    f->stats.last_cycle_us = cycle_us;
+    f->stats.total_cycle_us += cycle_us;
+    if (cycle_us > f->stats.max_cycle_us) f->stats.max_cycle_us = cycle_us;
+    return true;
+}
+
+void fleet_readings(const Fleet *f, int channel, SensorReadings *out) {
+    const FleetChannel *ch = &f->channels[channel];
+    const AHT20_Async *ex = &ch->sensor[FLEET_EXHAUST];
+    const AHT20_Async *amb = &ch->sensor[FLEET_AMBIENT];
+    const bool ex_ok = ex->state == AHT20_ASYNC_READY;
+    const bool amb_ok = amb->state == AHT20_ASYNC_READY;
+    out->aht_temp_1 = ex_ok ? ex->data.temperature : 0;
+    out->humidity_1 = ex_ok ? ex->data.humidity : 0;
+    out->raw_temp_1 = ex_ok ? ex->data.raw_temperature : AHT20_RAW_TEMP_ZERO_C;
+    out->raw_humidity_1 = ex_ok ? ex->data.raw_humidity : 0;
+    out->aht_temp_2 = amb_ok ? amb->data.temperature : 0;
+    out->humidity_2 = amb_ok ? amb->data.humidity : 0;
+    out->raw_temp_2 = amb_ok ? amb->data.raw_temperature : AHT20_RAW_TEMP_ZERO_C;
+    out->raw_humidity_2 = amb_ok ? amb->data.raw_humidity : 0;
+}
+
+void fleet_report(const Fleet *f) {
+    const FleetStats *st = &f->stats;
+    printf("[FROTA] %d canais | %lu ciclos, último %lu us, médio %lu us, máx %lu us | %lu leituras perdidas\n",
+           f->num_channels, (unsigned long)st->cycles, (unsigned long)st->last_cycle_us,
+           (unsigned long)(st->cycles ? st->total_cycle_us / st->cycles : 0),
+           (unsigned long)st->max_cycle_us, (unsigned long)st->read_errors);
+    for (int c = 0; c < f->num_channels; c++) {
+        const FleetChannel *ch = &f->channels[c];
+        if (!ch->present[FLEET_EXHAUST] || !ch->present[FLEET_AMBIENT]) {
+            printf("[FROTA] canal %d: %s%s ausente\n", c, ch->present[FLEET_EXHAUST] ? "" : "exaustão ",
+                   ch->present[FLEET_AMBIENT] ? "" : "ambiente");
+        } else if (ch->errors) {
+            printf("[FROTA] canal %d: %lu leituras perdidas\n", c, (unsigned long)ch->errors);
+        }
+    }
+}
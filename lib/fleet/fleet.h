@@ -0,0 +1,91 @@
+#ifndef FLEET_H
+#define FLEET_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "lib/aht20/aht20.h"
+#include "lib/fleet/tca9548a.h"
+#include "lib/sensors/sensors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================
+// FROTA: N PARES EXAUSTÃO/AMBIENTE ATRÁS DE MULTIPLEXADORES
+// Um controlador acompanhando várias máquinas de um rack. Cada canal é um par
+// de AHT20: o de exaustão no barramento de exaustão, o de ambiente no outro,
+// os dois na mesma posição de mux. Canal c usa o mux 0x70 + c/8, porta c%8,
+// nos dois barramentos; só um mux por barramento fica com porta ligada.
+//
+// As conversões se sobrepõem: fleet_start dispara todos os canais em
+// sequência (alguns bytes de barramento cada) e fleet_poll lê cada um quando
+// os 80 ms dele vencem, na mesma ordem. Um ciclo custa ~80 ms + o tempo de
+// barramento dos N canais, e não N x 80 ms.
+// ============================================================
+
+#ifndef FLEET_MAX_CHANNELS
+#define FLEET_MAX_CHANNELS 32
+#endif
+#define FLEET_MAX_MUXES ((FLEET_MAX_CHANNELS + TCA9548A_PORTS - 1) / TCA9548A_PORTS)
+#if FLEET_MAX_MUXES > TCA9548A_MAX_MUXES
+#error "FLEET_MAX_CHANNELS acima de 8 muxes por barramento"
+#endif
+
+typedef enum {
+    FLEET_EXHAUST = 0,
+    FLEET_AMBIENT = 1,
+} FleetSide;
+
+typedef struct {
+    i2c_inst_t *i2c;
+    TCA9548A muxes[FLEET_MAX_MUXES];
+    int active_mux;             // Mux com porta ligada (-1 = nenhum)
+} FleetBus;
+
+typedef struct {
+    AHT20_Async sensor[2];      // FleetSide
+    bool present[2];            // Respondeu calibrado no fleet_init
+    bool done;                  // Já lido (ou falhou) no ciclo atual
+    uint32_t errors;            // Leituras perdidas desde o início
+} FleetChannel;
+
+typedef struct {
+    uint32_t cycles;            // Ciclos completos
+    uint32_t last_cycle_us;     // Do primeiro trigger à última leitura
+    uint32_t max_cycle_us;
+    uint64_t total_cycle_us;
+    uint32_t read_errors;       // Sensores sem leitura em ciclos completos
+} FleetStats;
+
+typedef struct {
+    FleetBus bus[2];            // FleetSide
+    int num_channels;
+    FleetChannel channels[FLEET_MAX_CHANNELS];
+    int pending;                // Canais ainda sem leitura no ciclo atual
+    uint64_t cycle_start_us;
+    FleetStats stats;
+} Fleet;
+
+// Configura os muxes e inicializa todos os sensores (comando de init em
+// todos, uma espera só). Retorna o número de canais com os dois sensores.
+int fleet_init(Fleet *f, i2c_inst_t *exhaust_bus, i2c_inst_t *ambient_bus, int num_channels);
+
+// Dispara a conversão em todos os canais presentes
+void fleet_start(Fleet *f);
+
+// Lê os canais cuja conversão já venceu; true quando o ciclo terminou
+bool fleet_poll(Fleet *f);
+
+// Leitura do canal no último ciclo; sensor com falha lê 0, como em sensors_poll
+void fleet_readings(const Fleet *f, int channel, SensorReadings *out);
+
+// Tempo de ciclo e erros na serial
+void fleet_report(const Fleet *f);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FLEET_H
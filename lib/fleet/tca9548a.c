@@ -0,0 +1,21 @@
+#include "tca9548a.h"
+
+void tca9548a_init(TCA9548A *mux, i2c_inst_t *i2c, uint8_t addr) {
+    mux->i2c = i2c;
+    mux->addr = addr;
+    mux->control = 0;
+    mux->control_known = false;
+    mux->writes = 0;
+}
+
+bool tca9548a_set_ports(TCA9548A *mux, uint8_t ports) {
+    if (mux->control_known && mux->control == ports) return true;
+    mux->writes++;
+    if (i2c_write_blocking(mux->i2c, mux->addr, &ports, 1, false) != 1) {
+        mux->control_known = false;  // Não se sabe o que ficou ligado
+        return false;
+    }
+    mux->control = ports;
+    mux->control_known = true;
+    return true;
+}
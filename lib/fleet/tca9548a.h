@@ -0,0 +1,34 @@
+#ifndef TCA9548A_H
+#define TCA9548A_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hardware/i2c.h"
+
+// ============================================================
+// MULTIPLEXADOR I2C TCA9548A
+// Oito portas atrás de um único endereço (0x70..0x77, pinos A0-A2). O único
+// registrador é o de controle: bit n liga a porta n. Vários AHT20 com o mesmo
+// endereço (0x38) ficam cada um em uma porta e só a ligada responde.
+// ============================================================
+
+#define TCA9548A_BASE_ADDR  0x70
+#define TCA9548A_MAX_MUXES  8    // Endereços possíveis em um barramento
+#define TCA9548A_PORTS      8
+
+typedef struct {
+    i2c_inst_t *i2c;
+    uint8_t addr;
+    uint8_t control;        // Último valor escrito no registrador de controle
+    bool control_known;     // false até a primeira escrita (estado do chip desconhecido)
+    uint32_t writes;        // Escritas no barramento (as repetidas são puladas)
+} TCA9548A;
+
+void tca9548a_init(TCA9548A *mux, i2c_inst_t *i2c, uint8_t addr);
+
+// Liga exatamente as portas de `ports` (bitmask; 0 desliga todas). Sem
+// tráfego se já era o valor ativo. false se o mux não respondeu.
+bool tca9548a_set_ports(TCA9548A *mux, uint8_t ports);
+
+#endif // TCA9548A_H
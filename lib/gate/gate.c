@@ -0,0 +1,59 @@
+#include "gate.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static bool inside(const GateClass *k, GateMode mode, int32_t x, int32_t y) {
+    if (x < k->lo[0] || x > k->hi[0] || y < k->lo[1] || y > k->hi[1]) return false;
+    if (mode == GATE_BOX) return true;
+    // Dentro da caixa |x - média| >> shift < 2^15: os produtos cabem em int64
+    const int64_t dx = (x - k->mean[0]) >> k->shift;
+    const int64_t dy = (y - k->mean[1]) >> k->shift;
+    const int64_t q = k->a * dx * dx + 2 * k->b * dx * dy + k->c * dy * dy;
+    return q <= k->limit;
+}
+
+int gate_classify(const GateParams *p, int32_t delta_t_raw, int32_t delta_u_raw) {
+    if (p->mode == GATE_OFF) return -1;
+    int found = -1;
+    for (int i = 0; i < p->num_classes; i++) {
+        if (!inside(&p->classes[i], p->mode, delta_t_raw, delta_u_raw)) continue;
+        if (found >= 0) return -1;  // Regiões sobrepostas: a rede decide
+        found = i;
+    }
+    return found;
+}
+
+void gate_init(Gate *g, const GateParams *params) {
+    memset(g, 0, sizeof(*g));
+    g->params = params;
+}
+
+bool gate_select_model(Gate *g, uint32_t model_crc32) {
+    g->enabled = g->params && g->params->mode != GATE_OFF && g->params->model_crc32 == model_crc32;
+    return g->enabled;
+}
+
+int gate_apply(Gate *g, const SensorReadings *r, uint8_t *confidence) {
+    if (!g->enabled) return -1;
+    g->samples++;
+    const int cls = gate_classify(g->params, (int32_t)r->raw_temp_1 - (int32_t)r->raw_temp_2,
+                                  (int32_t)r->raw_humidity_1 - (int32_t)r->raw_humidity_2);
+    if (cls < 0) return -1;
+    g->resolved++;
+    g->per_class[cls]++;
+    *confidence = g->params->classes[cls].confidence;
+    return cls;
+}
+
+void gate_report(const Gate *g) {
+    if (!g->enabled) {
+        printf("[GATE] desligado (regiões de outro modelo)\n");
+        return;
+    }
+    printf("[GATE] %lu de %lu amostras sem Invoke (%lu%%) | IDLE %lu, GAMING %lu, ANOMALIA %lu\n",
+           (unsigned long)g->resolved, (unsigned long)g->samples,
+           (unsigned long)(g->samples ? 100u * g->resolved / g->samples : 0u),
+           (unsigned long)g->per_class[0], (unsigned long)g->per_class[1],
+           (unsigned long)g->per_class[2]);
+}
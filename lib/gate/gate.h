@@ -0,0 +1,79 @@
+#ifndef GATE_H
+#define GATE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "lib/sensors/sensors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================
+// PORTÃO ESTATÍSTICO NA FRENTE DO MODELO
+// A maior parte das amostras cai bem dentro de um aglomerado conhecido (IDLE
+// ou GAMING). Cada classe tem uma região no plano (ΔT, ΔU) em códigos brutos
+// do AHT20: uma caixa e, no modo Mahalanobis, a elipse
+//
+//   q = a*dx² + 2*b*dx*dy + c*dy² <= limite,   dx = (ΔT - média) >> shift
+//
+// só com inteiros. Amostra dentro de exatamente uma região sai com a classe
+// dela; fora de todas (ou em mais de uma) vai para o interpreter. As regiões
+// são ajustadas pelo host/tools/gate_fit a partir do dataset de treino e
+// conferidas contra a rede (amostras gravadas + grade densa de pontos), e
+// valem só para o modelo de onde saíram (CRC-32 do flatbuffer).
+// ============================================================
+
+#define GATE_MAX_CLASSES 4
+
+typedef enum {
+    GATE_OFF = 0,
+    GATE_BOX,               // Só a caixa
+    GATE_MAHALANOBIS,       // Caixa (rejeição barata) + elipse
+} GateMode;
+
+typedef struct {
+    int32_t lo[2];          // Caixa em códigos brutos de ΔT e ΔU, inclusiva
+    int32_t hi[2];
+    int32_t mean[2];        // Centro da elipse
+    int32_t shift;          // (x - média) >> shift cabe em int16 dentro da caixa
+    int32_t a, b, c;        // Inversa da covariância, em unidades de limit
+    int64_t limit;
+    uint8_t confidence;     // Confiança média da rede na região (0..255), para a telemetria
+} GateClass;
+
+typedef struct {
+    GateMode mode;
+    int num_classes;
+    uint32_t model_crc32;   // Modelo para o qual as regiões foram conferidas
+    GateClass classes[GATE_MAX_CLASSES];
+} GateParams;
+
+// Classe cuja região contém (ΔT, ΔU), ou -1 se nenhuma ou mais de uma
+int gate_classify(const GateParams *p, int32_t delta_t_raw, int32_t delta_u_raw);
+
+// Estado no loop: liga só com o modelo certo e conta o que resolveu
+typedef struct {
+    const GateParams *params;
+    bool enabled;
+    uint32_t samples;       // Amostras consultadas com o portão ligado
+    uint32_t resolved;      // Sem Invoke
+    uint32_t per_class[GATE_MAX_CLASSES];
+} Gate;
+
+void gate_init(Gate *g, const GateParams *params);
+
+// Liga o portão se o modelo ativo é o das regiões; false se ficou desligado
+bool gate_select_model(Gate *g, uint32_t model_crc32);
+
+// Classe decidida pelo portão (e sua confiança), ou -1: chame o interpreter
+int gate_apply(Gate *g, const SensorReadings *r, uint8_t *confidence);
+
+void gate_report(const Gate *g);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GATE_H
@@ -0,0 +1,53 @@
+#include "latency.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static LatencyHistogram histograms[LAT_NUM_STAGES];
+
+int latency_bucket(uint32_t us) {
+    if (us == 0) return 0;
+    const int b = 32 - __builtin_clz(us);
+    return b < LATENCY_BUCKETS ? b : LATENCY_BUCKETS - 1;
+}
+
+void latency_record(LatencyStage stage, uint32_t us) {
+    LatencyHistogram *h = &histograms[stage];
+    if (h->count == 0 || us < h->min_us) h->min_us = us;
+    if (us > h->max_us) h->max_us = us;
+    h->total_us += us;
+    h->buckets[latency_bucket(us)]++;
+    h->count++;
+}
+
+const LatencyHistogram *latency_histogram(LatencyStage stage) {
+    return &histograms[stage];
+}
+
+// Baldes não vazios como "<limite:contagem"; o último é ">=limite"
+void latency_dump(void) {
+    printf("[LAT] %-10s %8s %8s %8s %8s | baldes (us)\n", "estagio", "n", "min", "media", "max");
+    for (int s = 0; s < LAT_NUM_STAGES; s++) {
+        const LatencyHistogram *h = &histograms[s];
+        if (h->count == 0) continue;
+        printf("[LAT] %-10s %8lu %8lu %8lu %8lu |", latency_stage_name((LatencyStage)s), (unsigned long)h->count,
+               (unsigned long)h->min_us, (unsigned long)(h->total_us / h->count),
+               (unsigned long)h->max_us);
+        for (int b = 0; b < LATENCY_BUCKETS; b++) {
+            if (h->buckets[b] == 0) continue;
+            if (b == 0) {
+                printf(" 0:%lu", (unsigned long)h->buckets[b]);
+            } else if (b == LATENCY_BUCKETS - 1) {
+                printf(" >=%lu:%lu", 1ul << (b - 1), (unsigned long)h->buckets[b]);
+            } else {
+                printf(" <%lu:%lu", 1ul << b, (unsigned long)h->buckets[b]);
+            }
+        }
+        printf("\n");
+    }
+}
+
+void latency_reset(void) {
+    memset(histograms, 0, sizeof(histograms));
+    printf("[LAT] zerado\n");
+}
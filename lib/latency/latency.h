@@ -0,0 +1,90 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <stdint.h>
+
+#include "pico/time.h"
+
+#ifdef PREDAGUARD_HOST
+#include "host/host_bench.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================
+// HISTOGRAMAS DE LATÊNCIA POR ESTÁGIO
+// Cada estágio do loop acumula contagem, mín/máx/soma e um histograma log2
+// de baldes fixos: o balde b conta durações em [2^(b-1), 2^b) us (o balde 0
+// conta 0 us e o último fica aberto). Tudo em uma tabela estática, sem
+// alocação por amostra. Comandos na serial: 'L' imprime, 'Z' imprime e zera.
+//
+// LATENCY_BEGIN/LATENCY_END são o único par de medição de estágios do loop:
+// LATENCY_END devolve a duração em us (usada também nos tempos da telemetria)
+// e a registra no histograma com PREDAGUARD_LATENCY e no relatório do
+// host_bench no build host. Sem nenhum dos dois, sobra só a leitura do timer.
+// No pipeline em dois cores cada estágio tem um core só escrevendo; zerar
+// pelo core 0 pode perder a amostra que o core 1 está gravando naquele instante.
+// ============================================================
+
+#define LATENCY_BUCKETS 24      // Último balde: >= 2^22 us (~4 s)
+
+typedef enum {
+    LAT_I2C = 0,                // Leitura + disparo da conversão dos AHT20
+    LAT_PREPROC,                // Features e normalização/quantização
+    LAT_INFERENCIA,             // Portão + cache + Invoke
+    LAT_INVOKE,                 // Só o Invoke do interpreter (tflm_wrapper)
+    LAT_GPIO,                   // Debounce e LEDs
+    LAT_TELEMETRIA,             // Registro no anel + gravador
+    LAT_SERIAL,                 // Envio da telemetria (printf ou DMA) na folga
+    LAT_AMOSTRA,                // Do tick da amostra até a saída pronta
+    LAT_NUM_STAGES
+} LatencyStage;
+
+typedef struct {
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t total_us;
+    uint32_t buckets[LATENCY_BUCKETS];
+} LatencyHistogram;
+
+// Balde de uma duração
+int latency_bucket(uint32_t us);
+
+void latency_record(LatencyStage stage, uint32_t us);
+const LatencyHistogram *latency_histogram(LatencyStage stage);
+
+// No header para o host_bench, que não linka latency.c
+static inline const char *latency_stage_name(LatencyStage stage) {
+    static const char *const names[LAT_NUM_STAGES] = {
+        "i2c", "preproc", "inferencia", "invoke", "gpio", "telemetria", "serial", "amostra",
+    };
+    return (unsigned)stage < LAT_NUM_STAGES ? names[stage] : "?";
+}
+
+// Uma linha "[LAT]" por estágio com amostras
+void latency_dump(void);
+void latency_reset(void);
+
+static inline uint32_t latency_stage_end(LatencyStage stage, uint32_t t0) {
+    const uint32_t us = time_us_32() - t0;
+#ifdef PREDAGUARD_LATENCY
+    latency_record(stage, us);
+#endif
+#ifdef PREDAGUARD_HOST
+    host_bench_record((int)stage, us);
+#endif
+    (void)stage;
+    return us;
+}
+
+#define LATENCY_BEGIN(t0)       const uint32_t t0 = time_us_32()
+#define LATENCY_END(stage, t0)  latency_stage_end((stage), (t0))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LATENCY_H
@@ -0,0 +1,163 @@
+#include "model_slot.h"
+
+#include <string.h>
+
+// ============================================================
+// CODIFICAÇÃO
+// ============================================================
+static void put_u16(uint8_t *p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static void put_u32(uint8_t *p, uint32_t v) { put_u16(p, (uint16_t)v); put_u16(p + 2, (uint16_t)(v >> 16)); }
+static uint16_t get_u16(const uint8_t *p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint32_t get_u32(const uint8_t *p) { return get_u16(p) | ((uint32_t)get_u16(p + 2) << 16); }
+
+uint32_t model_slot_crc32(uint32_t crc, const uint8_t *data, size_t len) {
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int b = 0; b < 8; b++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+const char *model_slot_status_name(ModelSlotStatus s) {
+    switch (s) {
+        case MODEL_SLOT_OK:         return "ok";
+        case MODEL_SLOT_EMPTY:      return "vazio";
+        case MODEL_SLOT_BAD_MAGIC:  return "magic inválido";
+        case MODEL_SLOT_BAD_HEADER: return "cabeçalho inválido";
+        case MODEL_SLOT_BAD_SIZE:   return "tamanho inválido";
+        case MODEL_SLOT_BAD_SCHEMA: return "versão do schema incompatível";
+        case MODEL_SLOT_BAD_CRC:    return "CRC do modelo inválido";
+    }
+    return "?";
+}
+
+uint32_t model_slot_pack(const uint8_t *model, uint32_t model_bytes, uint32_t schema_version,
+                         uint32_t arena_bytes, uint32_t generation, uint8_t *out, uint32_t cap) {
+    if (model_bytes == 0 || model_bytes > MODEL_SLOT_MAX_MODEL ||
+        cap < MODEL_SLOT_HEADER_BYTES + model_bytes) {
+        return 0;
+    }
+    put_u32(out, MODEL_SLOT_MAGIC);
+    put_u16(out + 4, MODEL_SLOT_HEADER_VERSION);
+    put_u16(out + 6, MODEL_SLOT_HEADER_BYTES);
+    put_u32(out + 8, schema_version);
+    put_u32(out + 12, model_bytes);
+    put_u32(out + 16, model_slot_crc32(0, model, model_bytes));
+    put_u32(out + 20, arena_bytes);
+    put_u32(out + 24, generation);
+    put_u32(out + 28, model_slot_crc32(0, out, 28));
+    memmove(out + MODEL_SLOT_HEADER_BYTES, model, model_bytes);
+    return MODEL_SLOT_HEADER_BYTES + model_bytes;
+}
+
+ModelSlotStatus model_slot_check_header(const uint8_t *image, uint32_t image_len,
+                                        uint32_t expected_schema, ModelSlotHeader *out) {
+    if (image_len < MODEL_SLOT_HEADER_BYTES) return MODEL_SLOT_BAD_SIZE;
+    const uint32_t magic = get_u32(image);
+    if (magic == 0xFFFFFFFFu) return MODEL_SLOT_EMPTY;
+    if (magic != MODEL_SLOT_MAGIC) return MODEL_SLOT_BAD_MAGIC;
+    if (get_u16(image + 4) != MODEL_SLOT_HEADER_VERSION ||
+        get_u16(image + 6) != MODEL_SLOT_HEADER_BYTES ||
+        get_u32(image + 28) != model_slot_crc32(0, image, 28)) {
+        return MODEL_SLOT_BAD_HEADER;
+    }
+    ModelSlotHeader h;
+    h.schema_version = get_u32(image + 8);
+    h.model_bytes = get_u32(image + 12);
+    h.model_crc32 = get_u32(image + 16);
+    h.arena_bytes = get_u32(image + 20);
+    h.generation = get_u32(image + 24);
+    if (h.model_bytes == 0 || h.model_bytes > MODEL_SLOT_MAX_MODEL ||
+        h.model_bytes > image_len - MODEL_SLOT_HEADER_BYTES) {
+        return MODEL_SLOT_BAD_SIZE;
+    }
+    if (h.schema_version != expected_schema) return MODEL_SLOT_BAD_SCHEMA;
+    if (out) *out = h;
+    return MODEL_SLOT_OK;
+}
+
+int model_slot_newest(const uint8_t *const images[MODEL_SLOT_COUNT], uint32_t expected_schema,
+                      ModelSlotHeader *out) {
+    int best = -1;
+    ModelSlotHeader best_h;
+    for (int i = 0; i < MODEL_SLOT_COUNT; i++) {
+        ModelSlotHeader h;
+        if (!images[i] ||
+            model_slot_check_header(images[i], MODEL_SLOT_BYTES, expected_schema, &h) != MODEL_SLOT_OK) {
+            continue;
+        }
+        if (best < 0 || (int32_t)(h.generation - best_h.generation) > 0) {
+            best = i;
+            best_h = h;
+        }
+    }
+    if (best >= 0 && out) *out = best_h;
+    return best;
+}
+
+// ============================================================
+// GRAVAÇÃO
+// ============================================================
+// A primeira página (cabeçalho) só é programada no fim: um envio interrompido
+// deixa o slot sem cabeçalho em vez de um cabeçalho válido com modelo pela metade
+static bool writer_program_page(ModelSlotWriter *w, uint32_t page_start) {
+    const uint32_t offset = w->base + page_start;
+    if (offset % FLASH_DEV_SECTOR_BYTES == 0 &&
+        !w->dev->erase(w->dev->ctx, offset, FLASH_DEV_SECTOR_BYTES)) {
+        return false;
+    }
+    if (page_start == 0) {
+        memcpy(w->first, w->page, FLASH_DEV_PAGE_BYTES);
+        return true;
+    }
+    return w->dev->program(w->dev->ctx, offset, w->page, FLASH_DEV_PAGE_BYTES);
+}
+
+bool model_slot_writer_begin(ModelSlotWriter *w, const FlashDevice *dev, int slot, uint32_t total) {
+    memset(w, 0, sizeof(*w));
+    w->dev = dev;
+    w->failed = slot < 0 || slot >= MODEL_SLOT_COUNT || total < MODEL_SLOT_HEADER_BYTES ||
+                total > MODEL_SLOT_BYTES || dev->size < MODEL_SLOT_REGION_BYTES;
+    w->base = (uint32_t)slot * MODEL_SLOT_BYTES;
+    w->total = total;
+    memset(w->page, 0xFF, sizeof(w->page));
+    return !w->failed;
+}
+
+bool model_slot_writer_put(ModelSlotWriter *w, const uint8_t *data, uint32_t len) {
+    if (w->failed || len > w->total - w->received) {
+        w->failed = true;
+        return false;
+    }
+    while (len > 0) {
+        const uint32_t in_page = w->received % FLASH_DEV_PAGE_BYTES;
+        uint32_t n = FLASH_DEV_PAGE_BYTES - in_page;
+        if (n > len) n = len;
+        memcpy(w->page + in_page, data, n);
+        w->received += n;
+        data += n;
+        len -= n;
+        if (w->received % FLASH_DEV_PAGE_BYTES == 0) {
+            if (!writer_program_page(w, w->received - FLASH_DEV_PAGE_BYTES)) {
+                w->failed = true;
+                return false;
+            }
+            memset(w->page, 0xFF, sizeof(w->page));
+        }
+    }
+    return true;
+}
+
+bool model_slot_writer_finish(ModelSlotWriter *w) {
+    if (w->failed || w->received != w->total) return false;
+    const uint32_t in_page = w->received % FLASH_DEV_PAGE_BYTES;
+    if ((in_page != 0 && !writer_program_page(w, w->received - in_page)) ||
+        !w->dev->program(w->dev->ctx, w->base, w->first, FLASH_DEV_PAGE_BYTES)) {
+        w->failed = true;
+        return false;
+    }
+    return true;
+}
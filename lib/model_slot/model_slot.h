@@ -0,0 +1,110 @@
+#ifndef MODEL_SLOT_H
+#define MODEL_SLOT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lib/recorder/flash_dev.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================
+// SLOTS DE MODELO NO FLASH
+// Dois slots de 64 KB logo abaixo da região do gravador guardam imagens de
+// modelo: cabeçalho de 32 bytes + flatbuffer .tflite. O firmware continua
+// com o modelo embarcado (modelo_predator.h) até um slot válido ser
+// carregado pelo tflm_wrapper (tflm_swap_*). Um envio novo vai sempre para
+// o slot que não está em uso, então o modelo ativo nunca é sobrescrito.
+//
+// Cabeçalho (little-endian):
+//   magic "PGMD" | versão do cabeçalho u16 | bytes do cabeçalho u16 |
+//   versão do schema TFLite u32 | bytes do modelo u32 | crc32 do modelo u32 |
+//   arena medida u32 | geração u32 | crc32 dos 28 bytes anteriores u32
+// ============================================================
+
+#define MODEL_SLOT_COUNT          2
+#define MODEL_SLOT_BYTES          (64u * 1024u)
+#define MODEL_SLOT_REGION_BYTES   (MODEL_SLOT_COUNT * MODEL_SLOT_BYTES)
+#define MODEL_SLOT_MAGIC          0x444D4750u  // "PGMD"
+#define MODEL_SLOT_HEADER_VERSION 1u
+#define MODEL_SLOT_HEADER_BYTES   32u
+#define MODEL_SLOT_MAX_MODEL      (MODEL_SLOT_BYTES - MODEL_SLOT_HEADER_BYTES)
+
+typedef struct {
+    uint32_t schema_version;  // TFLITE_SCHEMA_VERSION do modelo
+    uint32_t model_bytes;
+    uint32_t model_crc32;
+    uint32_t arena_bytes;     // Arena medida pelo model_pack (0 = desconhecida)
+    uint32_t generation;      // Maior = mais novo; decide o slot no boot
+} ModelSlotHeader;
+
+typedef enum {
+    MODEL_SLOT_OK = 0,
+    MODEL_SLOT_EMPTY,         // Flash apagado
+    MODEL_SLOT_BAD_MAGIC,
+    MODEL_SLOT_BAD_HEADER,    // Versão, tamanho ou CRC do cabeçalho
+    MODEL_SLOT_BAD_SIZE,      // Modelo maior que o slot ou que a imagem
+    MODEL_SLOT_BAD_SCHEMA,
+    MODEL_SLOT_BAD_CRC,       // Conteúdo do modelo
+} ModelSlotStatus;
+
+const char *model_slot_status_name(ModelSlotStatus s);
+
+// CRC-32 (polinômio do zlib), encadeável: comece com crc = 0
+uint32_t model_slot_crc32(uint32_t crc, const uint8_t *data, size_t len);
+
+// Monta a imagem em out (cap >= cabeçalho + modelo); retorna os bytes escritos ou 0
+uint32_t model_slot_pack(const uint8_t *model, uint32_t model_bytes, uint32_t schema_version,
+                         uint32_t arena_bytes, uint32_t generation, uint8_t *out, uint32_t cap);
+
+// Confere só o cabeçalho (barato): magic, versão, CRC do cabeçalho, tamanho
+// contra image_len e o schema esperado. O CRC do modelo fica para quem chama,
+// em partes (ver tflm_swap_service).
+ModelSlotStatus model_slot_check_header(const uint8_t *image, uint32_t image_len,
+                                        uint32_t expected_schema, ModelSlotHeader *out);
+
+// Slot com cabeçalho válido e maior geração; -1 se nenhum
+int model_slot_newest(const uint8_t *const images[MODEL_SLOT_COUNT], uint32_t expected_schema,
+                      ModelSlotHeader *out);
+
+// ============================================================
+// GRAVAÇÃO INCREMENTAL DE UM SLOT (upload pela serial)
+// Os bytes chegam em pedaços de qualquer tamanho; cada setor é apagado quando
+// a escrita chega nele e as páginas são programadas inteiras. O cabeçalho é
+// a última página programada, então uma queda no meio deixa o slot inválido.
+// ============================================================
+typedef struct {
+    const FlashDevice *dev;
+    uint32_t base;            // Offset do slot na região
+    uint32_t total;           // Bytes esperados (cabeçalho + modelo)
+    uint32_t received;
+    uint8_t page[FLASH_DEV_PAGE_BYTES];
+    uint8_t first[FLASH_DEV_PAGE_BYTES];  // Página do cabeçalho, programada por último
+    bool failed;
+} ModelSlotWriter;
+
+bool model_slot_writer_begin(ModelSlotWriter *w, const FlashDevice *dev, int slot, uint32_t total);
+bool model_slot_writer_put(ModelSlotWriter *w, const uint8_t *data, uint32_t len);
+// Programa a última página (completada com 0xFF); false se algo falhou ou faltam bytes
+bool model_slot_writer_finish(ModelSlotWriter *w);
+
+// ============================================================
+// PLATAFORMA
+// model_slot_rp2040.c: XIP + flash_range_* abaixo do gravador
+// model_slot_file.c:   arquivo em PREDAGUARD_MODEL_SLOTS mapeado com mmap
+// ============================================================
+
+// Região dos dois slots; false se não houver
+bool model_slot_platform_flash(FlashDevice *out);
+
+// Imagem do slot mapeada em memória (o flatbuffer é usado direto daqui)
+const uint8_t *model_slot_platform_image(int slot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MODEL_SLOT_H
@@ -0,0 +1,46 @@
+// Backend host: os slots são um arquivo em PREDAGUARD_MODEL_SLOTS (simulador de
+// NOR do gravador) mapeado com mmap compartilhado, então as gravações feitas
+// pelo FlashDevice aparecem na imagem como no XIP do Pico.
+#define _POSIX_C_SOURCE 200809L
+
+#include "lib/model_slot/model_slot.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+
+#include "lib/recorder/flash_file.h"
+
+static FlashFile file;
+static FlashDevice dev;
+static bool file_open = false;
+static const uint8_t *mapped = NULL;
+
+static bool open_slots(void) {
+    if (file_open) return true;
+    const char *path = getenv("PREDAGUARD_MODEL_SLOTS");
+    if (!path || !*path) return false;
+    if (!flash_file_open(&file, path, MODEL_SLOT_REGION_BYTES, false, &dev)) {
+        fprintf(stderr, "[MODELO] Não foi possível abrir %s\n", path);
+        return false;
+    }
+    void *p = mmap(NULL, MODEL_SLOT_REGION_BYTES, PROT_READ, MAP_SHARED, file.fd, 0);
+    if (p == MAP_FAILED) {
+        flash_file_close(&file);
+        return false;
+    }
+    mapped = (const uint8_t *)p;
+    file_open = true;
+    return true;
+}
+
+bool model_slot_platform_flash(FlashDevice *out) {
+    if (!open_slots()) return false;
+    *out = dev;
+    return true;
+}
+
+const uint8_t *model_slot_platform_image(int slot) {
+    if (slot < 0 || slot >= MODEL_SLOT_COUNT || !open_slots()) return NULL;
+    return mapped + (uint32_t)slot * MODEL_SLOT_BYTES;
+}
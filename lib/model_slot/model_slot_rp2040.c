@@ -0,0 +1,19 @@
+// Backend do RP2040: os dois slots ficam logo abaixo da região do gravador e
+// o modelo é lido direto pelo XIP, sem cópia para a RAM.
+#include "lib/model_slot/model_slot.h"
+
+#include "hardware/flash.h"
+#include "lib/recorder/flash_rp2040.h"
+#include "lib/recorder/recorder.h"
+#include "pico/stdlib.h"
+
+#define SLOTS_OFFSET (PICO_FLASH_SIZE_BYTES - RECORDER_REGION_BYTES - MODEL_SLOT_REGION_BYTES)
+
+bool model_slot_platform_flash(FlashDevice *out) {
+    return flash_rp2040_region(out, SLOTS_OFFSET, MODEL_SLOT_REGION_BYTES);
+}
+
+const uint8_t *model_slot_platform_image(int slot) {
+    if (slot < 0 || slot >= MODEL_SLOT_COUNT) return NULL;
+    return (const uint8_t *)(XIP_BASE + SLOTS_OFFSET + (uint32_t)slot * MODEL_SLOT_BYTES);
+}
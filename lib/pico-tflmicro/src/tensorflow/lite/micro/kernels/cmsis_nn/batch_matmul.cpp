@@ -28,6 +28,7 @@ limitations under the License.
 #include "tensorflow/lite/micro/kernels/kernel_util.h"
 #include "tensorflow/lite/micro/micro_arena_constants.h"
 #include "tensorflow/lite/micro/micro_log.h"
+#include "tensorflow/lite/micro/pico/parallel_for.h"
 
 namespace tflite {
 namespace {
@@ -38,6 +39,9 @@ struct OpData {
   cmsis_nn_dims output_shape;
 
   int buffer_idx;
+
+  // Pico: whether Eval may split the CMSIS-NN kernel across both cores.
+  bool parallel;
 };
 
 cmsis_nn_dims FillVariableShape(int32_t rank, int32_t* tensor_dims) {
@@ -269,6 +273,8 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
 
   data->output_shape = FillVariableShape(
       output_rank, reinterpret_cast<int32_t*>(output->dims->data));
+  data->parallel = micro_context->UseParallelKernels(
+      static_cast<int64_t>(NumElements(output)) * accum_dim_lhs);
 
   int buf_size = 0;
   if (lhs_input->type != kTfLiteFloat32 && rhs_input->type != kTfLiteFloat32) {
@@ -338,6 +344,7 @@ TfLiteStatus EvalInt8(TfLiteContext* context, TfLiteNode* node) {
   OpData& data = *(static_cast<OpData*>(node->user_data));
   const auto* params =
       static_cast<const TfLiteBatchMatMulParams*>(node->builtin_data);
+  tflm_parallel_set_enabled(data.parallel);
 
   RuntimeShape rhs_shape = tflite::micro::GetTensorShape(original_rhs_input);
   RuntimeShape lhs_shape = tflite::micro::GetTensorShape(original_lhs_input);
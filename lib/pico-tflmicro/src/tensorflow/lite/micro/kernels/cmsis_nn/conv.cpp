@@ -26,6 +26,7 @@ limitations under the License.
 #include "tensorflow/lite/kernels/padding.h"
 #include "tensorflow/lite/micro/kernels/kernel_util.h"
 #include "tensorflow/lite/micro/micro_log.h"
+#include "tensorflow/lite/micro/pico/parallel_for.h"
 
 namespace tflite {
 namespace {
@@ -35,6 +36,9 @@ struct OpData {
 
   // Index to buffer for optimizations if applicable.
   int buffer_idx;
+
+  // Pico: whether Eval may split the CMSIS-NN kernel across both cores.
+  bool parallel;
 };
 
 void* Init(TfLiteContext* context, const char* buffer, size_t length) {
@@ -119,6 +123,10 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
   output_dims.w = output->dims->data[2];
   output_dims.c = output->dims->data[3];
 
+  data->parallel = micro_context->UseParallelKernels(
+      static_cast<int64_t>(output_dims.n) * output_dims.h * output_dims.w *
+      output_dims.c * filter_dims.h * filter_dims.w * filter_dims.c);
+
   if (input->type == kTfLiteInt8 || input->type == kTfLiteInt16) {
     const int num_channels = filter->dims->data[kConvQuantizedDimension];
     data->reference_op_data.per_channel_output_multiplier =
@@ -249,6 +257,8 @@ TfLiteStatus EvalQuantizedPerChannel(TfLiteContext* context, TfLiteNode* node,
                                      const TfLiteEvalTensor* filter,
                                      const TfLiteEvalTensor* bias,
                                      TfLiteEvalTensor* output) {
+  tflm_parallel_set_enabled(data.parallel);
+
   cmsis_nn_conv_params conv_params;
   conv_params.dilation.h = params.dilation_height_factor;
   conv_params.dilation.w = params.dilation_width_factor;
@@ -28,6 +28,7 @@ limitations under the License.
 #include "tensorflow/lite/micro/kernels/conv.h"
 #include "tensorflow/lite/micro/kernels/kernel_util.h"
 #include "tensorflow/lite/micro/micro_log.h"
+#include "tensorflow/lite/micro/pico/parallel_for.h"
 
 namespace tflite {
 namespace {
@@ -37,6 +38,9 @@ struct OpData {
 
   // Index to buffer for optimizations if applicable.
   int buffer_idx;
+
+  // Pico: whether Eval may split the CMSIS-NN kernel across both cores.
+  bool parallel;
 };
 
 // Always inline for optimal code size.
@@ -167,6 +171,10 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
     output_dims.w = output_width;
     output_dims.c = output_depth;
 
+    data->parallel = micro_context->UseParallelKernels(
+        static_cast<int64_t>(output_dims.n) * output_dims.h * output_dims.w *
+        output_dims.c * filter_dims.h * filter_dims.w);
+
     cmsis_nn_dw_conv_params dw_conv_params;
     dw_conv_params.padding.h = data->reference_op_data.padding.height;
     dw_conv_params.padding.w = data->reference_op_data.padding.width;
@@ -270,6 +278,8 @@ void EvalQuantizedPerChannel(TfLiteContext* context, TfLiteNode* node,
                              const TfLiteEvalTensor* filter,
                              const TfLiteEvalTensor* bias,
                              TfLiteEvalTensor* output) {
+  tflm_parallel_set_enabled(data.parallel);
+
   cmsis_nn_dw_conv_params dw_conv_params;
   cmsis_nn_per_channel_quant_params quant_params;
   cmsis_nn_dims input_dims;
@@ -28,6 +28,7 @@ limitations under the License.
 #include "tensorflow/lite/micro/kernels/kernel_util.h"
 #include "tensorflow/lite/micro/micro_arena_constants.h"
 #include "tensorflow/lite/micro/micro_log.h"
+#include "tensorflow/lite/micro/pico/parallel_for.h"
 
 namespace tflite {
 namespace {
@@ -44,6 +45,9 @@ struct OpData {
   int32_t batches;
   int32_t accum_depth;
   int32_t output_depth;
+
+  // Pico: whether Eval may split the CMSIS-NN kernel across both cores.
+  bool parallel;
 };
 
 void* Init(TfLiteContext* context, const char* buffer, size_t length) {
@@ -103,6 +107,9 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
   data->accum_depth = filter_shape.Dims(filter_dim_count - 1);
   data->batches = FlatSizeSkipDim(output_shape, output_dim_count - 1);
   data->output_depth = output_shape.Dims(output_dim_count - 1);
+  data->parallel = micro_context->UseParallelKernels(
+      static_cast<int64_t>(data->batches) * data->accum_depth *
+      data->output_depth);
 
   // Set buffer index to a reset value
   data->buffer_idx = -1;
@@ -270,6 +277,8 @@ TfLiteStatus EvalQuantizedInt8(TfLiteContext* context, TfLiteNode* node,
                                const TfLiteEvalTensor* filter,
                                const TfLiteEvalTensor* bias,
                                TfLiteEvalTensor* output) {
+  tflm_parallel_set_enabled(data.parallel);
+
   const RuntimeShape output_shape = tflite::micro::GetTensorShape(output);
   const int output_dim_count = output_shape.DimensionsCount();
 
@@ -27,6 +27,7 @@ limitations under the License.
 #include "tensorflow/lite/micro/kernels/kernel_util.h"
 #include "tensorflow/lite/micro/micro_log.h"
 #include "tensorflow/lite/micro/micro_utils.h"
+#include "tensorflow/lite/micro/pico/parallel_for.h"
 
 namespace tflite {
 namespace {
@@ -49,6 +50,9 @@ struct CmsisNnOpDataSvdf {
   int output_zero_point;
   int activation_state_zero_point;
   int32_t* kernel_sums;
+
+  // Pico: whether Eval may split the CMSIS-NN kernel across both cores.
+  bool parallel;
 };
 
 void* Init(TfLiteContext* context, const char* buffer, size_t length) {
@@ -135,6 +139,9 @@ TfLiteStatus CmsisNnPrepareSvdf(TfLiteContext* context, TfLiteNode* node) {
 
   TFLITE_DCHECK(node->user_data != nullptr);
   CmsisNnOpDataSvdf* data = static_cast<CmsisNnOpDataSvdf*>(node->user_data);
+  data->parallel = micro_context->UseParallelKernels(
+      static_cast<int64_t>(batch_size) * num_filters *
+      (input_size + memory_size));
 
   if (input->type == kTfLiteInt8) {
     TF_LITE_ENSURE_EQ(context, weights_feature->type, kTfLiteInt8);
@@ -248,6 +255,8 @@ TfLiteStatus EvalIntegerSVDF(TfLiteContext* context, TfLiteNode* node,
                              TfLiteEvalTensor* activation_state_tensor,
                              TfLiteEvalTensor* output_tensor,
                              const CmsisNnOpDataSvdf& data) {
+  tflm_parallel_set_enabled(data.parallel);
+
   cmsis_nn_dims input_dims;
   input_dims.n = input_tensor->dims->data[0];
   input_dims.h = input_tensor->dims->data[1];
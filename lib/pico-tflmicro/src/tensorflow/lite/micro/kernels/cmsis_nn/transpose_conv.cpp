@@ -27,6 +27,7 @@ limitations under the License.
 #include "tensorflow/lite/kernels/padding.h"
 #include "tensorflow/lite/micro/kernels/kernel_util.h"
 #include "tensorflow/lite/micro/micro_log.h"
+#include "tensorflow/lite/micro/pico/parallel_for.h"
 
 namespace tflite {
 namespace {
@@ -58,6 +59,9 @@ struct OpData {
   // Multiplier and shift arrays are required for the int8 implementation.
   int32_t* per_channel_output_multiplier;
   int32_t* per_channel_output_shift;
+
+  // Pico: whether Eval may split the CMSIS-NN kernel across both cores.
+  bool parallel;
 };
 
 inline PaddingType RuntimePaddingType(TfLitePadding padding) {
@@ -236,6 +240,10 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
     filter_dims.w = filter_shape.Dims(2);
     filter_dims.c = input_depth;
 
+    data->parallel = micro_context->UseParallelKernels(
+        static_cast<int64_t>(input_dims.n) * input_dims.h * input_dims.w *
+        input_dims.c * filter_dims.h * filter_dims.w * filter_dims.n);
+
     const size_t buf_size = arm_transpose_conv_s8_get_buffer_size(
         &conv_params, &input_dims, &filter_dims, &output_dims);
     TFLITE_DCHECK(context->RequestScratchBufferInArena(
@@ -306,6 +314,8 @@ TfLiteStatus EvalQuantizedPerChannel(TfLiteContext* context, TfLiteNode* node,
                                      const TfLiteEvalTensor* filter,
                                      const TfLiteEvalTensor* bias,
                                      TfLiteEvalTensor* output) {
+  tflm_parallel_set_enabled(data.parallel);
+
   cmsis_nn_transpose_conv_params conv_params;
   conv_params.dilation.h = 1;
   conv_params.dilation.w = 1;
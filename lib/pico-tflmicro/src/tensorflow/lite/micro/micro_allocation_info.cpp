@@ -254,21 +254,30 @@ TfLiteStatus AllocationInfoBuilder::MarkAllocationLifetimes(
     UpdateLastUsed(current, allocation_scope_count_);
   }
 
+  const uint16_t* lane_partner = allocations[subgraph_idx].lane_partner;
   for (uint32_t i = 0; i < operators_size; i++) {
     // Each operator has a new allocation scope.
     allocation_scope_count_++;
     const auto* op = subgraph->operators()->Get(i);
+    // A node hoisted into the lane of an earlier node runs at the scope of
+    // that node, so its outputs and scratch buffers are created there. The
+    // planner never hoists across a control flow op, so scopes in between are
+    // one per operator.
+    int hoist = 0;
+    if (lane_partner != nullptr && lane_partner[i] < i) {
+      hoist = i - lane_partner[i];
+    }
     // Figure out when the first creation and use of each tensor is.
     for (size_t n = 0; op->outputs() != nullptr && n < op->outputs()->size();
          ++n) {
       const int tensor_index = op->outputs()->Get(n);
       AllocationInfo* current = &subgraph_allocation_info[tensor_index];
-      UpdateFirstCreated(current, allocation_scope_count_);
+      UpdateFirstCreated(current, allocation_scope_count_ - hoist);
     }
 
     // Keep track of scope count before any subgraphs, so that scratch buffers'
     // lifetime within a control flow op properly overlaps with all subgraphs.
-    int start_allocation_scope_count = allocation_scope_count_;
+    int start_allocation_scope_count = allocation_scope_count_ - hoist;
 
     // Control flow operators can invoke subgraphs. Plan these subgraphs
     // before continuing on to the rest of the graph.
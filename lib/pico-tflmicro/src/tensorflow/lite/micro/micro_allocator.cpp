@@ -33,6 +33,7 @@ limitations under the License.
 #include "tensorflow/lite/micro/micro_allocation_info.h"
 #include "tensorflow/lite/micro/micro_arena_constants.h"
 #include "tensorflow/lite/micro/micro_log.h"
+#include "tensorflow/lite/micro/pico/parallel_for.h"
 #include "tensorflow/lite/micro/tflite_bridge/flatbuffer_conversions_bridge.h"
 #include "tensorflow/lite/schema/schema_generated.h"
 
@@ -654,6 +655,10 @@ SubgraphAllocations* MicroAllocator::StartModelAllocation(const Model* model) {
     MicroPrintf("Failed to allocate memory for model metadata.");
     return nullptr;
   }
+  for (size_t subgraph_idx = 0; subgraph_idx < model->subgraphs()->size();
+       subgraph_idx++) {
+    output[subgraph_idx].lane_partner = nullptr;
+  }
 
   if (
 #ifdef USE_TFLM_COMPRESSION
@@ -844,10 +849,9 @@ void MicroAllocator::DeallocateTempTfLiteTensor(TfLiteTensor* tensor) {
         reinterpret_cast<TfLiteAffineQuantization*>(
             tensor->quantization.params);
 
-    non_persistent_buffer_allocator_->DeallocateTemp(
+    TempAllocator()->DeallocateTemp(
         reinterpret_cast<uint8_t*>(quantization->zero_point));
-    non_persistent_buffer_allocator_->DeallocateTemp(
-        reinterpret_cast<uint8_t*>(quantization));
+    TempAllocator()->DeallocateTemp(reinterpret_cast<uint8_t*>(quantization));
   }
 
   // Clear the data in case someone still access tensor arena by mistake
@@ -855,8 +859,7 @@ void MicroAllocator::DeallocateTempTfLiteTensor(TfLiteTensor* tensor) {
   tensor->quantization.params = nullptr;
   tensor->data.data = nullptr;
   tensor->dims = nullptr;
-  non_persistent_buffer_allocator_->DeallocateTemp(
-      reinterpret_cast<uint8_t*>(tensor));
+  TempAllocator()->DeallocateTemp(reinterpret_cast<uint8_t*>(tensor));
 }
 
 TfLiteTensor* MicroAllocator::AllocateTempTfLiteTensor(
@@ -868,9 +871,9 @@ TfLiteTensor* MicroAllocator::AllocateTempTfLiteTensor(
   // This value is allocated from temporary arena space. It is guaranteed to be
   // around for at least the scope of the calling function. Since this struct
   // allocation takes place in temp space, no need to own or cleanup.
-  TfLiteTensor* tensor = reinterpret_cast<TfLiteTensor*>(
-      non_persistent_buffer_allocator_->AllocateTemp(sizeof(TfLiteTensor),
-                                                     alignof(TfLiteTensor)));
+  TfLiteTensor* tensor =
+      reinterpret_cast<TfLiteTensor*>(TempAllocator()->AllocateTemp(
+          sizeof(TfLiteTensor), alignof(TfLiteTensor)));
 
   // Populate any fields from the flatbuffer, since this TfLiteTensor struct is
   // allocated in the temp section of the arena, ensure that additional
@@ -899,21 +902,54 @@ TfLiteTensor* MicroAllocator::AllocateTempTfLiteTensor(
 }
 
 uint8_t* MicroAllocator::AllocateTempBuffer(size_t size, size_t alignment) {
-  return non_persistent_buffer_allocator_->AllocateTemp(size, alignment);
+  return TempAllocator()->AllocateTemp(size, alignment);
 }
 
 void MicroAllocator::DeallocateTempBuffer(uint8_t* buffer) {
-  non_persistent_buffer_allocator_->DeallocateTemp(buffer);
+  TempAllocator()->DeallocateTemp(buffer);
 }
 
 TfLiteStatus MicroAllocator::ResetTempAllocations() {
+  if (lane_temp_allocator_ != nullptr) {
+    TF_LITE_ENSURE_STATUS(lane_temp_allocator_->ResetTempAllocations());
+  }
   return non_persistent_buffer_allocator_->ResetTempAllocations();
 }
 
 bool MicroAllocator::IsAllTempDeallocated() {
+  if (lane_temp_allocator_ != nullptr &&
+      !lane_temp_allocator_->IsAllTempDeallocated()) {
+    return false;
+  }
   return non_persistent_buffer_allocator_->IsAllTempDeallocated();
 }
 
+TfLiteStatus MicroAllocator::AllocateLaneTempMemory(size_t bytes) {
+  if (lane_temp_allocator_ != nullptr) {
+    return kTfLiteOk;
+  }
+  uint8_t* buffer = persistent_buffer_allocator_->AllocatePersistentBuffer(
+      bytes, MicroArenaBufferAlignment());
+  uint8_t* allocator_buffer =
+      persistent_buffer_allocator_->AllocatePersistentBuffer(
+          sizeof(SingleArenaBufferAllocator),
+          alignof(SingleArenaBufferAllocator));
+  if (buffer == nullptr || allocator_buffer == nullptr) {
+    MicroPrintf("Failed to allocate %u bytes of lane temp memory.", bytes);
+    return kTfLiteError;
+  }
+  lane_temp_allocator_ =
+      new (allocator_buffer) SingleArenaBufferAllocator(buffer, bytes);
+  return kTfLiteOk;
+}
+
+INonPersistentBufferAllocator* MicroAllocator::TempAllocator() {
+  if (lane_temp_allocator_ != nullptr && tflm_parallel_worker() != 0) {
+    return lane_temp_allocator_;
+  }
+  return non_persistent_buffer_allocator_;
+}
+
 #ifdef USE_TFLM_COMPRESSION
 
 TfLiteStatus MicroAllocator::AllocateCompressedTensorsList(
@@ -1103,8 +1139,7 @@ TfLiteStatus MicroAllocator::PopulateTfLiteTensorFromFlatbuffer(
   // allocations in the tail can be recorded. Once the interpreter has APIs for
   // accessing buffers on TfLiteEvalTensor this method can be dropped.
   return internal::InitializeTfLiteTensorFromFlatbuffer(
-      persistent_buffer_allocator_, non_persistent_buffer_allocator_,
-      allocate_temp,
+      persistent_buffer_allocator_, TempAllocator(), allocate_temp,
       *model->subgraphs()->Get(subgraph_idx)->tensors()->Get(tensor_index),
       model->buffers(), tensor);
 }
@@ -1133,6 +1168,15 @@ TfLiteStatus MicroAllocator::CommitStaticMemoryPlan(
   TF_LITE_ENSURE_STATUS(
       builder.GetOfflinePlannedOffsets(&offline_planner_offsets));
 
+  // Offline planned offsets were computed for the original order, so nodes
+  // can not be hoisted into another lane.
+  if (offline_planner_offsets != nullptr) {
+    for (size_t subgraph_idx = 0; subgraph_idx < model->subgraphs()->size();
+         subgraph_idx++) {
+      allocations[subgraph_idx].lane_partner = nullptr;
+    }
+  }
+
   // We allocate buffers for variable tensors here since the offline planner
   // offsets are conviently available here.
   for (size_t subgraph_idx = 0; subgraph_idx < model->subgraphs()->size();
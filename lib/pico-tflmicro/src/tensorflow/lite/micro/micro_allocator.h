@@ -100,6 +100,11 @@ struct SubgraphAllocations {
 #ifdef USE_TFLM_COMPRESSION
   CompressedTensorList compressed;
 #endif  // USE_TFLM_COMPRESSION
+  // Pico: two-lane schedule planned by MicroInterpreterGraph, one entry per
+  // operator, or nullptr when the subgraph runs in order on one core. A node
+  // whose entry is itself runs alone, a greater index is the node it runs
+  // together with, and a smaller one is the node it was hoisted to.
+  uint16_t* lane_partner;
 };
 
 // Allocator responsible for allocating memory for all intermediate tensors
@@ -235,6 +240,12 @@ class MicroAllocator {
   // already deallocated.
   virtual bool IsAllTempDeallocated();
 
+  // Pico: reserves `bytes` of persistent memory for the temp allocations made
+  // on core 1 while two nodes run at once, so they do not race with core 0 on
+  // the temp section of the head. Temp allocations made on core 0 are not
+  // affected.
+  TfLiteStatus AllocateLaneTempMemory(size_t bytes);
+
   // Allocates persistent buffer which has the same life time as the allocator.
   // The memory is immediately available and is allocated from the tail of the
   // arena.
@@ -335,10 +346,16 @@ class MicroAllocator {
   // the head section.
   internal::ScratchBufferRequest* GetScratchBufferRequests();
 
+  // Returns the allocator serving temp allocations for the calling core.
+  INonPersistentBufferAllocator* TempAllocator();
+
   // A simple memory allocator that always allocate from the arena tail or head.
   INonPersistentBufferAllocator* non_persistent_buffer_allocator_;
   IPersistentBufferAllocator* persistent_buffer_allocator_;
 
+  // Temp allocations made on core 1, see AllocateLaneTempMemory().
+  INonPersistentBufferAllocator* lane_temp_allocator_ = nullptr;
+
   // Allocator used to allocate persistent builtin data.
   TfLiteBridgeBuiltinDataAllocator* builtin_data_allocator_ =
       nullptr;  // Initialized as nullptr to prevent any possible issues related
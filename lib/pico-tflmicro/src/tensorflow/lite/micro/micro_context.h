@@ -167,6 +167,19 @@ class MicroContext {
     return nullptr;
   }
 
+  // Pico: allows kernels to split their work across both cores
+  // (tensorflow/lite/micro/pico/parallel_for.h) for nodes doing at least
+  // min_macs multiply-accumulates per Invoke. Kernels read it in Prepare, so
+  // it can only be set during the MicroInterpreter kInit state.
+  virtual TfLiteStatus SetParallelKernels(bool enabled, int64_t min_macs) {
+    return kTfLiteError;
+  }
+
+  // Pico: whether a node doing `macs` multiply-accumulates per Invoke should
+  // run its kernel on both cores. Kernels call it in Prepare and keep the
+  // answer, so Invoke only passes it on to tflm_parallel_set_enabled.
+  virtual bool UseParallelKernels(int64_t macs) const { return false; }
+
  private:
   TF_LITE_REMOVE_VIRTUAL_DELETE
 };
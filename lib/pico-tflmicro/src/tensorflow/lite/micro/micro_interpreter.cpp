@@ -228,6 +228,11 @@ TfLiteStatus MicroInterpreter::AllocateTensors() {
 
   micro_context_.SetScratchBufferHandles(scratch_buffer_handles_);
 
+  if (graph_.HasParallelLanes()) {
+    TF_LITE_ENSURE_STATUS(
+        allocator_.AllocateLaneTempMemory(TFLM_LANE_TEMP_BYTES));
+  }
+
   // TODO(b/162311891): Drop these allocations when the interpreter supports
   // handling buffers from TfLiteEvalTensor.
   input_tensors_ =
@@ -339,6 +344,20 @@ TfLiteStatus MicroInterpreter::SetAlternateProfiler(
   return micro_context_.SetAlternateProfiler(alt_profiler);
 }
 
+TfLiteStatus MicroInterpreter::SetParallelKernels(bool enabled,
+                                                  int64_t min_macs) {
+  return micro_context_.SetParallelKernels(enabled, min_macs);
+}
+
+TfLiteStatus MicroInterpreter::SetParallelLanes(bool enabled) {
+  if (micro_context_.GetInterpreterState() !=
+      MicroInterpreterContext::InterpreterState::kInit) {
+    return kTfLiteError;
+  }
+  graph_.SetParallelLanes(enabled);
+  return kTfLiteOk;
+}
+
 #ifdef USE_TFLM_COMPRESSION
 
 TfLiteStatus MicroInterpreter::SetDecompressionMemory(
@@ -160,6 +160,23 @@ class MicroInterpreter {
   // decompression subsystem.
   TfLiteStatus SetAlternateProfiler(MicroProfilerInterface* alt_profiler);
 
+  // Pico: lets the kernels of nodes doing at least min_macs
+  // multiply-accumulates per Invoke run on both cores, or keeps every kernel
+  // on the calling core when enabled is false. Decided per node at Prepare,
+  // so it must be called before AllocateTensors. Defaults to enabled with
+  // TFLM_PARALLEL_MIN_MACS.
+  TfLiteStatus SetParallelKernels(bool enabled,
+                                  int64_t min_macs = TFLM_PARALLEL_MIN_MACS);
+
+  // Pico: runs pairs of independent nodes, such as the branches of an
+  // inception block, one on each core (see
+  // MicroInterpreterGraph::SetParallelLanes). Off by default: the outputs of
+  // a node run early stay in the arena longer, so the arena can grow, and
+  // TFLM_LANE_TEMP_BYTES more are reserved when some pair is kept. Nodes that
+  // use both cores in their kernel are never paired. Must be called before
+  // AllocateTensors.
+  TfLiteStatus SetParallelLanes(bool enabled);
+
 #ifdef USE_TFLM_COMPRESSION
 
   // Set the alternate decompression memory regions.
@@ -277,4 +277,28 @@ MicroProfilerInterface* MicroInterpreterContext::GetAlternateProfiler() const {
   return alt_profiler_;
 }
 
+TfLiteStatus MicroInterpreterContext::SetParallelKernels(bool enabled,
+                                                         int64_t min_macs) {
+  if (state_ != InterpreterState::kInit) {
+    return kTfLiteError;
+  }
+
+  parallel_kernels_ = enabled;
+  parallel_min_macs_ = min_macs;
+  return kTfLiteOk;
+}
+
+bool MicroInterpreterContext::UseParallelKernels(int64_t macs) const {
+#ifdef TF_LITE_PICO_MULTICORE
+  const bool parallel = parallel_kernels_ && macs >= parallel_min_macs_;
+  if (parallel && state_ == InterpreterState::kPrepare) {
+    // Both cores are busy with this node, keep it out of the lanes.
+    graph_.MarkNodeUsesBothCores();
+  }
+  return parallel;
+#else
+  return false;
+#endif
+}
+
 }  // namespace tflite
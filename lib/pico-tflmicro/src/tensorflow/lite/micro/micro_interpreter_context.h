@@ -21,6 +21,7 @@ limitations under the License.
 #include "tensorflow/lite/micro/micro_context.h"
 #include "tensorflow/lite/micro/micro_interpreter_graph.h"
 #include "tensorflow/lite/micro/micro_log.h"
+#include "tensorflow/lite/micro/pico/parallel_for.h"
 
 namespace tflite {
 
@@ -159,6 +160,14 @@ class MicroInterpreterContext : public MicroContext {
   // decompression subsystem.
   MicroProfilerInterface* GetAlternateProfiler() const override;
 
+  // Pico: both cores for nodes of at least min_macs multiply-accumulates.
+  // Can only be called during the MicroInterpreter kInit state.
+  TfLiteStatus SetParallelKernels(bool enabled, int64_t min_macs) override;
+
+  // Always false when built with TF_LITE_PICO_SINGLE_CORE. A node told true
+  // at Prepare is never paired in the parallel lanes of the graph.
+  bool UseParallelKernels(int64_t macs) const override;
+
  private:
   MicroAllocator& allocator_;
   MicroInterpreterGraph& graph_;
@@ -168,6 +177,8 @@ class MicroInterpreterContext : public MicroContext {
   ScratchBufferHandle* scratch_buffer_handles_ = nullptr;
   void* external_context_payload_ = nullptr;
   MicroProfilerInterface* alt_profiler_ = nullptr;
+  bool parallel_kernels_ = true;
+  int64_t parallel_min_macs_ = TFLM_PARALLEL_MIN_MACS;
 
 #ifdef USE_TFLM_COMPRESSION
 
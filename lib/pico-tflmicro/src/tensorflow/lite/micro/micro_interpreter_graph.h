@@ -22,6 +22,19 @@ limitations under the License.
 #include "tensorflow/lite/micro/micro_resource_variable.h"
 #include "tensorflow/lite/schema/schema_generated.h"
 
+// Pico: how many operators past a node PlanLanes looks for an independent one
+// to run with it on the other core. The outputs of a hoisted node stay in the
+// arena from its partner onwards, so a longer reach can grow the arena.
+#ifndef TFLM_LANE_LOOKAHEAD
+#define TFLM_LANE_LOOKAHEAD 8
+#endif
+
+// Pico: bytes reserved for the temp allocations of nodes running on core 1
+// (see MicroAllocator::AllocateLaneTempMemory).
+#ifndef TFLM_LANE_TEMP_BYTES
+#define TFLM_LANE_TEMP_BYTES 1024
+#endif
+
 namespace tflite {
 
 // Abstracts the details of interacting with the tflite::Model.
@@ -44,7 +57,8 @@ class MicroInterpreterGraph : public MicroGraph {
   virtual TfLiteStatus InitSubgraphs();
 
   // Calls TFLMRegistration->Prepare for every operator in every subgraph
-  // in the model.
+  // in the model. With parallel lanes enabled, then plans which nodes run
+  // together on both cores.
   virtual TfLiteStatus PrepareSubgraphs();
 
   // Calls TFLMRegistration->Reset for every operator in every subgraph in
@@ -98,7 +112,39 @@ class MicroInterpreterGraph : public MicroGraph {
   // Get the resource variables for this TFLM graph.
   MicroResourceVariables* GetResourceVariables() { return resource_variables_; }
 
+  // Pico: lets PrepareSubgraphs pair independent nodes that are at most
+  // TFLM_LANE_LOOKAHEAD operators apart, so that InvokeSubgraph runs each pair
+  // on both cores and joins before the next node. Must be set before
+  // PrepareSubgraphs. No effect with TF_LITE_PICO_SINGLE_CORE or
+  // USE_TFLM_COMPRESSION.
+  void SetParallelLanes(bool enabled) { parallel_lanes_ = enabled; }
+
+  // Pico: called while the current node prepares if its kernel splits its own
+  // work across both cores. Such a node is never paired.
+  void MarkNodeUsesBothCores();
+
+  // Pico: true if some subgraph still runs nodes in pairs. Only final once
+  // the memory plan is committed, which drops the pairs of offline plans.
+  bool HasParallelLanes();
+
  private:
+  // Allocates the lane schedule of every subgraph, with every node alone.
+  TfLiteStatus AllocateLaneSchedules();
+
+  // Greedily pairs each node with the first later node that does not depend
+  // on it or on anything still to run between them.
+  void PlanLanes(int subgraph_idx);
+
+  // Control flow, resource variable ops and nodes with variable inputs are
+  // never paired, nor hoisted over.
+  bool IsLaneBarrier(int subgraph_idx, uint32_t node_idx);
+
+  // Calls TFLMRegistration->Invoke for one node.
+  TfLiteStatus InvokeNode(int subgraph_idx, uint32_t node_idx);
+
+  // tflm_parallel_fn invoking the nodes of a pair.
+  static void InvokeLaneItems(int32_t begin, int32_t end, void* ctx);
+
   TfLiteContext* context_;
   const Model* model_;
   MicroAllocator* allocator_;
@@ -106,6 +152,7 @@ class MicroInterpreterGraph : public MicroGraph {
   int current_subgraph_index_;
   uint32_t current_operator_index_;
   MicroResourceVariables* resource_variables_;
+  bool parallel_lanes_ = false;
   const flatbuffers::Vector<flatbuffers::Offset<SubGraph>>* subgraphs_ =
       nullptr;  // Initialized as nullptr to prevent any possible issues
                 // related to accessing uninitialized memory.
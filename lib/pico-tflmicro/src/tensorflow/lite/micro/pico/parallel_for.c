@@ -0,0 +1,205 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Raspberry Pi Pico-specific implementation of the dual core helper.
+
+#include "tensorflow/lite/micro/pico/parallel_for.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef TF_LITE_PICO_MULTICORE
+// These are headers from the RP2's SDK.
+#include "hardware/sync.h"   // NOLINT
+#include "pico/multicore.h"  // NOLINT
+#include "pico/stdlib.h"     // NOLINT
+#endif
+
+static TflmParallelStats g_stats;
+static bool g_enabled = true;
+
+#ifdef TF_LITE_PICO_MULTICORE
+
+// FIFO words. A pointer does not fit a FIFO word on the host build, so the
+// job itself lives in g_job and the FIFO only carries the command.
+enum {
+  kParallelRun = 0x4A4F4221u,
+  kParallelStop = 0x53544F50u,
+  kParallelDone = 0x444F4E45u,
+};
+
+typedef struct {
+  tflm_parallel_fn fn;
+  void* ctx;
+  int32_t next;  // First unclaimed item, guarded by g_lock.
+  int32_t end;
+  int32_t chunk;
+} ParallelJob;
+
+typedef struct {
+  uint32_t chunks;
+  uint32_t busy_us;
+} WorkerRun;
+
+static ParallelJob g_job;
+static WorkerRun g_core1_run;
+// The M0+ has no atomic read-modify-write, so chunks are claimed under one of
+// the hardware spinlocks.
+static spin_lock_t* g_lock = NULL;
+static bool g_worker_running = false;
+static bool g_in_job = false;
+
+// Inside a job both cores may run nested calls inline at once, so the count
+// is taken under the lock.
+static void count_inline_run(void) {
+  if (!g_in_job) {
+    g_stats.inline_runs++;
+    return;
+  }
+  const uint32_t saved_irq = spin_lock_blocking(g_lock);
+  g_stats.inline_runs++;
+  spin_unlock(g_lock, saved_irq);
+}
+
+// Claims and runs chunks until the range is exhausted.
+static WorkerRun run_chunks(void) {
+  WorkerRun run = {0, 0};
+  for (;;) {
+    const uint32_t saved_irq = spin_lock_blocking(g_lock);
+    const int32_t begin = g_job.next;
+    const int32_t end =
+        g_job.end - begin > g_job.chunk ? begin + g_job.chunk : g_job.end;
+    g_job.next = end;
+    spin_unlock(g_lock, saved_irq);
+    if (begin >= end) {
+      return run;
+    }
+    const uint32_t t0 = time_us_32();
+    g_job.fn(begin, end, g_job.ctx);
+    run.busy_us += time_us_32() - t0;
+    run.chunks++;
+  }
+}
+
+// Runs from RAM, with the inline FIFO calls, so that between jobs core 1
+// does not fetch from XIP. flash_safe_execute on core 0 (sample recorder,
+// model slots) only pauses a core registered as a lockout victim, and the
+// lockout handler would take over the FIFO this worker listens on; parked
+// here, core 1 is safe while the flash is erased or programmed. Only
+// run_chunks, during a job, runs from flash.
+static void __not_in_flash_func(core1_parallel_worker)(void) {
+  for (;;) {
+    // Sleeps in WFE until core 0 pushes a command.
+    const uint32_t cmd = multicore_fifo_pop_blocking_inline();
+    if (cmd == kParallelRun) {
+      g_core1_run = run_chunks();
+      __atomic_thread_fence(__ATOMIC_RELEASE);
+    }
+    multicore_fifo_push_blocking_inline(kParallelDone);
+    if (cmd == kParallelStop) {
+      return;
+    }
+  }
+}
+
+void tflm_parallel_for(int32_t begin, int32_t end, tflm_parallel_fn fn,
+                       void* ctx) {
+  if (!g_enabled || end - begin < 2 || g_in_job || get_core_num() != 0) {
+    count_inline_run();
+    if (end > begin) {
+      fn(begin, end, ctx);
+    }
+    return;
+  }
+  if (!g_worker_running) {
+    if (g_lock == NULL) {
+      g_lock = spin_lock_init(spin_lock_claim_unused(true));
+    }
+    multicore_launch_core1(core1_parallel_worker);
+    g_worker_running = true;
+    g_stats.launches++;
+  }
+  g_in_job = true;
+  g_stats.jobs++;
+
+  const int32_t chunks = TFLM_PARALLEL_WORKERS * TFLM_PARALLEL_CHUNKS_PER_WORKER;
+  const int32_t chunk = (end - begin + chunks - 1) / chunks;
+  g_job.fn = fn;
+  g_job.ctx = ctx;
+  g_job.next = begin;
+  g_job.end = end;
+  g_job.chunk = chunk > 0 ? chunk : 1;
+  const uint32_t t0 = time_us_32();
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  multicore_fifo_push_blocking(kParallelRun);
+
+  const WorkerRun core0_run = run_chunks();
+
+  // Blocks until core 1 has run out of chunks too.
+  multicore_fifo_pop_blocking();
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  const uint32_t elapsed_us = time_us_32() - t0;
+  const WorkerRun runs[TFLM_PARALLEL_WORKERS] = {core0_run, g_core1_run};
+  for (int i = 0; i < TFLM_PARALLEL_WORKERS; ++i) {
+    g_stats.chunks[i] += runs[i].chunks;
+    g_stats.busy_us[i] += runs[i].busy_us;
+    g_stats.idle_us[i] +=
+        elapsed_us > runs[i].busy_us ? elapsed_us - runs[i].busy_us : 0;
+  }
+  g_in_job = false;
+}
+
+int tflm_parallel_worker(void) { return (int)get_core_num(); }
+
+void tflm_parallel_stop(void) {
+  if (!g_worker_running || get_core_num() != 0) {
+    return;
+  }
+  multicore_fifo_push_blocking(kParallelStop);
+  multicore_fifo_pop_blocking();
+  multicore_reset_core1();
+  g_worker_running = false;
+}
+
+#else  // TF_LITE_PICO_MULTICORE
+
+void tflm_parallel_for(int32_t begin, int32_t end, tflm_parallel_fn fn,
+                       void* ctx) {
+  g_stats.inline_runs++;
+  if (end > begin) {
+    fn(begin, end, ctx);
+  }
+}
+
+int tflm_parallel_worker(void) { return 0; }
+
+void tflm_parallel_stop(void) {}
+
+#endif  // TF_LITE_PICO_MULTICORE
+
+void tflm_parallel_set_enabled(bool enabled) {
+#ifdef TF_LITE_PICO_MULTICORE
+  // Kernels running on the lanes of a job (see MicroInterpreterGraph) would
+  // otherwise write it from both cores. Their calls run inline anyway.
+  if (g_in_job) {
+    return;
+  }
+#endif
+  g_enabled = enabled;
+}
+
+void tflm_parallel_get_stats(TflmParallelStats* stats) { *stats = g_stats; }
+
+void tflm_parallel_reset_stats(void) {
+  const TflmParallelStats zero = {0};
+  g_stats = zero;
+}
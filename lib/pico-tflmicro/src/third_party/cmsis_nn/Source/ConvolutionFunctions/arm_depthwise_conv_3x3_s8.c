@@ -31,6 +31,7 @@
 
 #include "third_party/cmsis_nn/Include/arm_nnfunctions.h"
 #include "third_party/cmsis_nn/Include/arm_nnsupportfunctions.h"
+#include "tensorflow/lite/micro/pico/parallel_for.h"
 
 /**
  *  @ingroup Public
@@ -41,58 +42,51 @@
  * @{
  */
 
+typedef struct
+{
+    const cmsis_nn_dw_conv_params *dw_conv_params;
+    const cmsis_nn_per_channel_quant_params *quant_params;
+    const cmsis_nn_dims *input_dims;
+    const int8_t *input;
+    const int8_t *kernel;
+    const int32_t *bias;
+    const cmsis_nn_dims *output_dims;
+    int8_t *output;
+} DepthwiseConv3x3Args;
+
 /*
- * Optimized s8 depthwise convolution function with constraint that
- * in_channel == out_channel and kernel_x == kernel_y == 3 with pads at most 1
- *
- *  Refer prototype header file for details.
- *
+ * Output rows [out_h_begin, out_h_end) of the convolution in ctx. Run through
+ * tflm_parallel_for, so each core writes a disjoint range of rows.
  */
-
-arm_cmsis_nn_status arm_depthwise_conv_3x3_s8(const cmsis_nn_context *ctx,
-                                              const cmsis_nn_dw_conv_params *dw_conv_params,
-                                              const cmsis_nn_per_channel_quant_params *quant_params,
-                                              const cmsis_nn_dims *input_dims,
-                                              const int8_t *input,
-                                              const cmsis_nn_dims *filter_dims,
-                                              const int8_t *kernel,
-                                              const cmsis_nn_dims *bias_dims,
-                                              const int32_t *bias,
-                                              const cmsis_nn_dims *output_dims,
-                                              int8_t *output)
+static void depthwise_conv_3x3_s8_rows(int32_t out_h_begin, int32_t out_h_end, void *ctx)
 {
-    (void)ctx;
-    (void)bias_dims;
-
-    const int32_t input_x = input_dims->w;
-    const int32_t input_y = input_dims->h;
-    const int32_t input_ch = input_dims->c;
-    const int32_t output_ch = output_dims->c;
+    const DepthwiseConv3x3Args *args = (const DepthwiseConv3x3Args *)ctx;
+    const cmsis_nn_dw_conv_params *dw_conv_params = args->dw_conv_params;
+    const int8_t *input = args->input;
+    const int8_t *kernel = args->kernel;
+    const int32_t *bias = args->bias;
+    int8_t *output = args->output;
+
+    const int32_t input_x = args->input_dims->w;
+    const int32_t input_y = args->input_dims->h;
+    const int32_t input_ch = args->input_dims->c;
+    const int32_t output_ch = args->output_dims->c;
     const int32_t pad_x = dw_conv_params->padding.w;
     const int32_t pad_y = dw_conv_params->padding.h;
     const int32_t stride_x = dw_conv_params->stride.w;
     const int32_t stride_y = dw_conv_params->stride.h;
-    const int32_t *output_shift = quant_params->shift;
-    const int32_t *output_mult = quant_params->multiplier;
-    const int32_t output_x = output_dims->w;
-    const int32_t output_y = output_dims->h;
+    const int32_t *output_shift = args->quant_params->shift;
+    const int32_t *output_mult = args->quant_params->multiplier;
+    const int32_t output_x = args->output_dims->w;
     const int32_t output_offset = dw_conv_params->output_offset;
     const int32_t input_offset = dw_conv_params->input_offset;
     const int32_t output_activation_min = dw_conv_params->activation.min;
     const int32_t output_activation_max = dw_conv_params->activation.max;
 
-    /* Check input constraints input_ch == output_ch */
-    if (input_ch != output_ch)
-    {
-        return ARM_CMSIS_NN_ARG_ERROR;
-    }
-    /* Check input constraints pad_x <= 1 */
-    if (pad_x > 1 || filter_dims->w != 3 || filter_dims->h != 3)
-    {
-        return ARM_CMSIS_NN_ARG_ERROR;
-    }
     const int32_t *bias_base = bias;
-    for (int32_t in_h = -pad_y, out_h = 0, out_idx = 0; out_h < output_y; in_h += stride_y, ++out_h)
+    for (int32_t in_h = out_h_begin * stride_y - pad_y, out_h = out_h_begin, out_idx = out_h_begin * output_x * output_ch;
+         out_h < out_h_end;
+         in_h += stride_y, ++out_h)
     {
         for (int32_t in_w = -pad_x, out_w = 0, ker_h_start = MAX(0, -in_h); out_w < output_x; in_w += stride_x, ++out_w)
         {
@@ -272,6 +266,54 @@ arm_cmsis_nn_status arm_depthwise_conv_3x3_s8(const cmsis_nn_context *ctx,
             }
         }
     }
+}
+
+/*
+ * Optimized s8 depthwise convolution function with constraint that
+ * in_channel == out_channel and kernel_x == kernel_y == 3 with pads at most 1
+ *
+ *  Refer prototype header file for details.
+ *
+ */
+
+arm_cmsis_nn_status arm_depthwise_conv_3x3_s8(const cmsis_nn_context *ctx,
+                                              const cmsis_nn_dw_conv_params *dw_conv_params,
+                                              const cmsis_nn_per_channel_quant_params *quant_params,
+                                              const cmsis_nn_dims *input_dims,
+                                              const int8_t *input,
+                                              const cmsis_nn_dims *filter_dims,
+                                              const int8_t *kernel,
+                                              const cmsis_nn_dims *bias_dims,
+                                              const int32_t *bias,
+                                              const cmsis_nn_dims *output_dims,
+                                              int8_t *output)
+{
+    (void)ctx;
+    (void)bias_dims;
+
+    const int32_t input_ch = input_dims->c;
+    const int32_t output_ch = output_dims->c;
+    const int32_t pad_x = dw_conv_params->padding.w;
+
+    /* Check input constraints input_ch == output_ch */
+    if (input_ch != output_ch)
+    {
+        return ARM_CMSIS_NN_ARG_ERROR;
+    }
+    /* Check input constraints pad_x <= 1 */
+    if (pad_x > 1 || filter_dims->w != 3 || filter_dims->h != 3)
+    {
+        return ARM_CMSIS_NN_ARG_ERROR;
+    }
+
+    DepthwiseConv3x3Args args = {
+        dw_conv_params, quant_params, input_dims, input, kernel, bias, output_dims, output};
+#if defined(TF_LITE_PICO_MULTICORE)
+    /* Both cores claim chunks of output rows until none are left. */
+    tflm_parallel_for(0, output_dims->h, depthwise_conv_3x3_s8_rows, &args);
+#else
+    depthwise_conv_3x3_s8_rows(0, output_dims->h, &args);
+#endif
 
     /* Return to application */
     return ARM_CMSIS_NN_SUCCESS;
@@ -30,6 +30,7 @@
 
 #include "third_party/cmsis_nn/Include/arm_nnfunctions.h"
 #include "third_party/cmsis_nn/Include/arm_nnsupportfunctions.h"
+#include "tensorflow/lite/micro/pico/parallel_for.h"
 
 /**
  *  @ingroup NNConv
@@ -69,7 +70,8 @@ int32_t arm_depthwise_conv_s8_opt_get_buffer_size_mve(const cmsis_nn_dims *input
 
 int32_t arm_depthwise_conv_s8_opt_get_buffer_size_dsp(const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims)
 {
-    return (input_dims->c * filter_dims->w * filter_dims->h) * sizeof(int16_t);
+    /* One im2col column per core, see arm_depthwise_conv_s8_opt */
+    return (input_dims->c * filter_dims->w * filter_dims->h) * sizeof(int16_t) * TFLM_PARALLEL_WORKERS;
 }
 
 int32_t arm_depthwise_conv_s8_opt_get_buffer_size(const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims)
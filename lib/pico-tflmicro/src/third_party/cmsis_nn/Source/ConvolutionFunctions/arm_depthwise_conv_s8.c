@@ -30,6 +30,7 @@
 
 #include "third_party/cmsis_nn/Include/arm_nnfunctions.h"
 #include "third_party/cmsis_nn/Include/arm_nnsupportfunctions.h"
+#include "tensorflow/lite/micro/pico/parallel_for.h"
 
 /**
  *  @ingroup Public
@@ -62,7 +63,8 @@ depthwise_conv_s8_mult_4(const int8_t *input,
                          const int32_t *output_shift,
                          const int32_t *output_mult,
                          const int32_t output_x,
-                         const int32_t output_y,
+                         const int32_t out_h_begin,
+                         const int32_t out_h_end,
                          const int32_t output_offset,
                          const int32_t input_offset,
                          const int32_t output_activation_min,
@@ -73,7 +75,9 @@ depthwise_conv_s8_mult_4(const int8_t *input,
     const int32_t *shift_base = output_shift;
     const int8_t *kernel_base = kernel;
 
-    for (int32_t in_h = -pad_y, out_h = 0; out_h < output_y; in_h += stride_y, ++out_h)
+    output += out_h_begin * output_x * output_ch;
+    for (int32_t in_h = out_h_begin * stride_y - pad_y, out_h = out_h_begin; out_h < out_h_end;
+         in_h += stride_y, ++out_h)
     {
         for (int32_t in_w = -pad_x, out_w = 0, ker_h_start = MAX(0, -in_h); out_w < output_x; in_w += stride_x, ++out_w)
         {
@@ -152,7 +156,8 @@ depthwise_conv_s8_mult_4(const int8_t *input,
 }
 
 static void depthwise_conv_s8_generic(const int8_t *input,
-                                      const uint16_t input_batches,
+                                      const int32_t row_begin,
+                                      const int32_t row_end,
                                       const uint16_t input_x,
                                       const uint16_t input_y,
                                       const uint16_t input_ch,
@@ -180,12 +185,13 @@ static void depthwise_conv_s8_generic(const int8_t *input,
 
 {
     (void)output_ch;
-    int i_out = 0;
-    int i_batch;
+    /* Rows are numbered across batches: row = batch * output_y + i_out_y */
+    int i_out = row_begin * output_x * input_ch * ch_mult;
+    input += (row_begin / output_y) * (input_x * input_y * input_ch);
 
-    for (i_batch = 0; i_batch < input_batches; i_batch++)
+    for (int32_t i_row = row_begin; i_row < row_end; i_row++)
     {
-        for (int i_out_y = 0; i_out_y < output_y; i_out_y++)
+        const int i_out_y = i_row % output_y;
         {
             const int16_t base_idx_y = (i_out_y * stride_y) - pad_y;
             for (int i_out_x = 0; i_out_x < output_x; i_out_x++)
@@ -259,43 +265,48 @@ static void depthwise_conv_s8_generic(const int8_t *input,
             }
         }
         /* Advance to the next batch */
-        input += (input_x * input_y * input_ch);
+        if (i_out_y == output_y - 1)
+        {
+            input += (input_x * input_y * input_ch);
+        }
     }
 }
 
+typedef struct
+{
+    const cmsis_nn_dw_conv_params *dw_conv_params;
+    const cmsis_nn_per_channel_quant_params *quant_params;
+    const cmsis_nn_dims *input_dims;
+    const int8_t *input;
+    const cmsis_nn_dims *filter_dims;
+    const int8_t *kernel;
+    const int32_t *bias;
+    const cmsis_nn_dims *output_dims;
+    int8_t *output;
+    int use_mult_4;
+} DepthwiseConvArgs;
+
 /*
- *  Basic s8 depthwise convolution function.
- *
- *  Refer header file for details.
- *  Optimization using DSP extension is not available for the generic case where channel multiplier is > 1.
- *
+ * Output rows [row_begin, row_end) of the convolution in ctx, numbered across
+ * batches. Run through tflm_parallel_for, so each core writes a disjoint range
+ * of rows.
  */
-arm_cmsis_nn_status arm_depthwise_conv_s8(const cmsis_nn_context *ctx,
-                                          const cmsis_nn_dw_conv_params *dw_conv_params,
-                                          const cmsis_nn_per_channel_quant_params *quant_params,
-                                          const cmsis_nn_dims *input_dims,
-                                          const int8_t *input,
-                                          const cmsis_nn_dims *filter_dims,
-                                          const int8_t *kernel,
-                                          const cmsis_nn_dims *bias_dims,
-                                          const int32_t *bias,
-                                          const cmsis_nn_dims *output_dims,
-                                          int8_t *output)
+static void depthwise_conv_s8_rows(int32_t row_begin, int32_t row_end, void *ctx)
 {
-    const uint16_t dilation_x = dw_conv_params->dilation.w;
-    const uint16_t dilation_y = dw_conv_params->dilation.h;
-
-    (void)bias_dims;
-    (void)ctx;
+    const DepthwiseConvArgs *args = (const DepthwiseConvArgs *)ctx;
+    const cmsis_nn_dw_conv_params *dw_conv_params = args->dw_conv_params;
+    const cmsis_nn_per_channel_quant_params *quant_params = args->quant_params;
+    const cmsis_nn_dims *input_dims = args->input_dims;
+    const cmsis_nn_dims *filter_dims = args->filter_dims;
+    const cmsis_nn_dims *output_dims = args->output_dims;
 
-    if (dw_conv_params->ch_mult % 4 == 0 && input_dims->n == 1 && dw_conv_params->dilation.w == 1 &&
-        dw_conv_params->dilation.h == 1)
+    if (args->use_mult_4)
     {
-        depthwise_conv_s8_mult_4(input,
+        depthwise_conv_s8_mult_4(args->input,
                                  input_dims->w,
                                  input_dims->h,
                                  input_dims->c,
-                                 kernel,
+                                 args->kernel,
                                  output_dims->c,
                                  dw_conv_params->ch_mult,
                                  filter_dims->w,
@@ -304,12 +315,13 @@ arm_cmsis_nn_status arm_depthwise_conv_s8(const cmsis_nn_context *ctx,
                                  dw_conv_params->padding.h,
                                  dw_conv_params->stride.w,
                                  dw_conv_params->stride.h,
-                                 bias,
-                                 output,
+                                 args->bias,
+                                 args->output,
                                  quant_params->shift,
                                  quant_params->multiplier,
                                  output_dims->w,
-                                 output_dims->h,
+                                 row_begin,
+                                 row_end,
                                  dw_conv_params->output_offset,
                                  dw_conv_params->input_offset,
                                  dw_conv_params->activation.min,
@@ -317,12 +329,13 @@ arm_cmsis_nn_status arm_depthwise_conv_s8(const cmsis_nn_context *ctx,
     }
     else
     {
-        depthwise_conv_s8_generic(input,
-                                  input_dims->n,
+        depthwise_conv_s8_generic(args->input,
+                                  row_begin,
+                                  row_end,
                                   input_dims->w,
                                   input_dims->h,
                                   input_dims->c,
-                                  kernel,
+                                  args->kernel,
                                   output_dims->c,
                                   dw_conv_params->ch_mult,
                                   filter_dims->w,
@@ -331,8 +344,8 @@ arm_cmsis_nn_status arm_depthwise_conv_s8(const cmsis_nn_context *ctx,
                                   dw_conv_params->padding.h,
                                   dw_conv_params->stride.w,
                                   dw_conv_params->stride.h,
-                                  bias,
-                                  output,
+                                  args->bias,
+                                  args->output,
                                   quant_params->shift,
                                   quant_params->multiplier,
                                   output_dims->w,
@@ -341,9 +354,52 @@ arm_cmsis_nn_status arm_depthwise_conv_s8(const cmsis_nn_context *ctx,
                                   dw_conv_params->input_offset,
                                   dw_conv_params->activation.min,
                                   dw_conv_params->activation.max,
-                                  dilation_x,
-                                  dilation_y);
+                                  dw_conv_params->dilation.w,
+                                  dw_conv_params->dilation.h);
     }
+}
+
+/*
+ *  Basic s8 depthwise convolution function.
+ *
+ *  Refer header file for details.
+ *  Optimization using DSP extension is not available for the generic case where channel multiplier is > 1.
+ *
+ */
+arm_cmsis_nn_status arm_depthwise_conv_s8(const cmsis_nn_context *ctx,
+                                          const cmsis_nn_dw_conv_params *dw_conv_params,
+                                          const cmsis_nn_per_channel_quant_params *quant_params,
+                                          const cmsis_nn_dims *input_dims,
+                                          const int8_t *input,
+                                          const cmsis_nn_dims *filter_dims,
+                                          const int8_t *kernel,
+                                          const cmsis_nn_dims *bias_dims,
+                                          const int32_t *bias,
+                                          const cmsis_nn_dims *output_dims,
+                                          int8_t *output)
+{
+    (void)bias_dims;
+    (void)ctx;
+
+    DepthwiseConvArgs args = {dw_conv_params,
+                              quant_params,
+                              input_dims,
+                              input,
+                              filter_dims,
+                              kernel,
+                              bias,
+                              output_dims,
+                              output,
+                              dw_conv_params->ch_mult % 4 == 0 && input_dims->n == 1 &&
+                                  dw_conv_params->dilation.w == 1 && dw_conv_params->dilation.h == 1};
+    const int32_t rows = args.use_mult_4 ? output_dims->h : input_dims->n * output_dims->h;
+
+#if defined(TF_LITE_PICO_MULTICORE)
+    /* Both cores claim chunks of output rows until none are left. */
+    tflm_parallel_for(0, rows, depthwise_conv_s8_rows, &args);
+#else
+    depthwise_conv_s8_rows(0, rows, &args);
+#endif
 
     /* Return to application */
     return ARM_CMSIS_NN_SUCCESS;
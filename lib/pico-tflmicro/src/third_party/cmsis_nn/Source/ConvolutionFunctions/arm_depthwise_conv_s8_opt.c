@@ -31,6 +31,7 @@
 
 #include "third_party/cmsis_nn/Include/arm_nnfunctions.h"
 #include "third_party/cmsis_nn/Include/arm_nnsupportfunctions.h"
+#include "tensorflow/lite/micro/pico/parallel_for.h"
 
 /**
  *  @ingroup Public
@@ -41,175 +42,53 @@
  * @{
  */
 
+#if defined(ARM_MATH_DSP) && !defined(ARM_MATH_MVEI)
+typedef struct
+{
+    const cmsis_nn_dw_conv_params *dw_conv_params;
+    const cmsis_nn_per_channel_quant_params *quant_params;
+    const cmsis_nn_dims *input_dims;
+    const int8_t *input;
+    const cmsis_nn_dims *filter_dims;
+    const int8_t *kernel;
+    const int32_t *bias;
+    const cmsis_nn_dims *output_dims;
+    int8_t *output;
+    int16_t *buffer;
+} DepthwiseConvOptArgs;
+
 /*
- * Optimized s8 depthwise convolution function with constraint that in_channel equals out_channel
- *
- *  Refer prototype header file for details.
- *
+ * Output rows [out_y_begin, out_y_end) of the convolution in ctx. Run through
+ * tflm_parallel_for, so each core writes a disjoint range of rows; the buffer
+ * holds one im2col column per worker.
  */
-
-arm_cmsis_nn_status arm_depthwise_conv_s8_opt(const cmsis_nn_context *ctx,
-                                              const cmsis_nn_dw_conv_params *dw_conv_params,
-                                              const cmsis_nn_per_channel_quant_params *quant_params,
-                                              const cmsis_nn_dims *input_dims,
-                                              const int8_t *input,
-                                              const cmsis_nn_dims *filter_dims,
-                                              const int8_t *kernel,
-                                              const cmsis_nn_dims *bias_dims,
-                                              const int32_t *bias,
-                                              const cmsis_nn_dims *output_dims,
-                                              int8_t *output)
+static void depthwise_conv_s8_opt_rows(int32_t out_y_begin, int32_t out_y_end, void *ctx)
 {
-    const int32_t input_ch = input_dims->c;
-    const int32_t output_ch = output_dims->c;
-
-    /* Check depth multiplier is 1 */
-    if (input_ch != output_ch)
-    {
-        return ARM_CMSIS_NN_ARG_ERROR;
-    }
-
-    if (ctx->buf == NULL && arm_depthwise_conv_s8_opt_get_buffer_size(input_dims, filter_dims) > 0)
-    {
-        return ARM_CMSIS_NN_ARG_ERROR;
-    }
-#ifdef ARM_MATH_DSP
-    (void)bias_dims;
-    const int32_t input_x = input_dims->w;
-    const int32_t input_y = input_dims->h;
-    const int32_t kernel_x = filter_dims->w;
-    const int32_t kernel_y = filter_dims->h;
+    const DepthwiseConvOptArgs *args = (const DepthwiseConvOptArgs *)ctx;
+    const cmsis_nn_dw_conv_params *dw_conv_params = args->dw_conv_params;
+    const int8_t *input = args->input;
+    const int8_t *kernel = args->kernel;
+    const int32_t *bias = args->bias;
+    int8_t *output = args->output;
+    const int32_t input_ch = args->input_dims->c;
+    const int32_t output_ch = args->output_dims->c;
+    const int32_t input_x = args->input_dims->w;
+    const int32_t input_y = args->input_dims->h;
+    const int32_t kernel_x = args->filter_dims->w;
+    const int32_t kernel_y = args->filter_dims->h;
     const int32_t pad_x = dw_conv_params->padding.w;
     const int32_t pad_y = dw_conv_params->padding.h;
     const int32_t stride_x = dw_conv_params->stride.w;
     const int32_t stride_y = dw_conv_params->stride.h;
-    const int32_t *output_shift = quant_params->shift;
-    const int32_t *output_mult = quant_params->multiplier;
-    const int32_t output_x = output_dims->w;
-    const int32_t output_y = output_dims->h;
+    const int32_t *output_shift = args->quant_params->shift;
+    const int32_t *output_mult = args->quant_params->multiplier;
+    const int32_t output_x = args->output_dims->w;
     const int32_t output_offset = dw_conv_params->output_offset;
     const int32_t input_offset = dw_conv_params->input_offset;
     const int32_t output_activation_min = dw_conv_params->activation.min;
     const int32_t output_activation_max = dw_conv_params->activation.max;
-    int16_t *buffer_a = (int16_t *)ctx->buf;
 
-    #ifdef ARM_MATH_MVEI
-    /* Generate two columns from the input tensor */
-    int8_t *lhs_buffer = (int8_t *)buffer_a;
-    int8_t *out = output;
-    int buffer_count = 0;
-    const int32_t kernel_size = kernel_x * kernel_y;
-
-    const int32_t ch_loop = (input_ch + (CH_IN_BLOCK_MVE - 1)) / CH_IN_BLOCK_MVE;
-    int32_t remaining_ch = output_ch;
-    int32_t active_ch = MIN(CH_IN_BLOCK_MVE, remaining_ch);
-    remaining_ch -= CH_IN_BLOCK_MVE;
-
-    for (int i_ch = 0; i_ch < ch_loop; i_ch++)
-    {
-        out = output + i_ch * CH_IN_BLOCK_MVE;
-        const int8_t *input_slice = input + (i_ch * CH_IN_BLOCK_MVE);
-
-        for (int i_out_y = 0, base_idx_y = -pad_y; i_out_y < output_y; base_idx_y += stride_y, i_out_y++)
-        {
-            for (int i_out_x = 0, base_idx_x = -pad_x; i_out_x < output_x; base_idx_x += stride_x, i_out_x++)
-            {
-                for (int i_ker_y = base_idx_y; i_ker_y < base_idx_y + kernel_y; i_ker_y++)
-                {
-                    for (int i_ker_x = base_idx_x; i_ker_x < base_idx_x + kernel_x; i_ker_x++)
-                    {
-                        if (i_ker_y < 0 || i_ker_y >= input_y || i_ker_x < 0 || i_ker_x >= input_x)
-                        {
-                            arm_memset_s8(lhs_buffer, (int8_t)-input_offset, (uint32_t)active_ch);
-                        }
-                        else
-                        {
-                            arm_memcpy_s8(lhs_buffer,
-                                          input_slice + (i_ker_y * input_x + i_ker_x) * input_ch,
-                                          (uint32_t)active_ch);
-                        }
-                        lhs_buffer += CH_IN_BLOCK_MVE;
-                    }
-                }
-                buffer_count++;
-
-                if (buffer_count == 4)
-                {
-                    const int32_t block_offset = i_ch * CH_IN_BLOCK_MVE;
-                    lhs_buffer = (int8_t *)buffer_a;
-
-                    arm_nn_depthwise_conv_nt_t_s8(lhs_buffer,
-                                                  kernel + block_offset,
-                                                  input_offset,
-                                                  active_ch,
-                                                  input_ch,
-                                                  output_shift + block_offset,
-                                                  output_mult + block_offset,
-                                                  output_offset,
-                                                  output_activation_min,
-                                                  output_activation_max,
-                                                  kernel_size,
-                                                  bias + block_offset,
-                                                  out);
-
-                    out += (4 * input_ch);
-                    buffer_count = 0;
-                }
-            }
-        }
-        /* Handle left over buffers */
-        lhs_buffer = (int8_t *)buffer_a;
-
-        int8_t *out_base = out;
-        for (int i_buf = 0; i_buf < buffer_count; i_buf++)
-        {
-            int32_t loop_count = (active_ch + 3) / 4;
-            int32_t num_ch_to_process = active_ch;
-            out = out_base + (i_buf * input_ch);
-            for (int i_loop_cnt = 0, offset = i_ch * CH_IN_BLOCK_MVE; i_loop_cnt < loop_count;
-                 num_ch_to_process -= 4, offset += 4, i_loop_cnt++)
-            {
-                const int8_t *col_0 = lhs_buffer + (kernel_size * CH_IN_BLOCK_MVE * i_buf) + (i_loop_cnt * 4);
-                const int8_t *row_0 = kernel + offset;
-                int32x4_t out_0 = vdupq_n_s32(0);
-                if (bias)
-                {
-                    out_0 = vldrwq_s32(&bias[offset]);
-                }
-
-                for (int i_ker = 0; i_ker < kernel_size; i_ker++)
-                {
-                    const int32x4_t ker_0 = vldrbq_s32(row_0);
-                    int32x4_t ip_0 = vldrbq_s32(col_0);
-                    ip_0 = vaddq_n_s32(ip_0, input_offset);
-                    out_0 += vmulq_s32(ip_0, ker_0);
-
-                    col_0 += CH_IN_BLOCK_MVE;
-                    row_0 += input_ch;
-                }
-
-                const int32x4_t mult = vldrwq_s32(&output_mult[offset]);
-                const int32x4_t shift = vldrwq_s32(&output_shift[offset]);
-
-                out_0 = arm_requantize_mve_32x4(out_0, mult, shift);
-                out_0 = vaddq_n_s32(out_0, output_offset);
-                out_0 = vmaxq_s32(out_0, vdupq_n_s32(output_activation_min));
-                out_0 = vminq_s32(out_0, vdupq_n_s32(output_activation_max));
-                mve_pred16_t p = vctp32q((uint32_t)num_ch_to_process);
-                vstrbq_p_s32(out, out_0, p);
-
-                out += 4;
-            }
-        }
-        buffer_count = 0;
-
-        active_ch = MIN(CH_IN_BLOCK_MVE, remaining_ch);
-        remaining_ch -= CH_IN_BLOCK_MVE;
-    }
-
-    #else // ARM_MATH_DSP
-    /* Run the following code in cores using DSP extension */
-    int16_t *const col_buffer_start = buffer_a;
+    int16_t *const col_buffer_start = args->buffer + tflm_parallel_worker() * (kernel_x * kernel_y * input_ch);
     int16_t *col_buffer = col_buffer_start;
     const int32_t *const bias_start_pos = bias;
     const int32_t *const out_mult_start_pos = output_mult;
@@ -217,7 +96,8 @@ arm_cmsis_nn_status arm_depthwise_conv_s8_opt(const cmsis_nn_context *ctx,
     uint16_t row_count;
     uint16_t row_shift;
 
-    for (int i_out_y = 0; i_out_y < output_y; i_out_y++)
+    output += out_y_begin * output_x * output_ch;
+    for (int i_out_y = out_y_begin; i_out_y < out_y_end; i_out_y++)
     {
         const int16_t base_idx_y = (i_out_y * stride_y) - pad_y;
         for (int i_out_x = 0; i_out_x < output_x; i_out_x++)
@@ -401,6 +281,186 @@ arm_cmsis_nn_status arm_depthwise_conv_s8_opt(const cmsis_nn_context *ctx,
             col_buffer = col_buffer_start;
         }
     }
+}
+#endif
+
+/*
+ * Optimized s8 depthwise convolution function with constraint that in_channel equals out_channel
+ *
+ *  Refer prototype header file for details.
+ *
+ */
+
+arm_cmsis_nn_status arm_depthwise_conv_s8_opt(const cmsis_nn_context *ctx,
+                                              const cmsis_nn_dw_conv_params *dw_conv_params,
+                                              const cmsis_nn_per_channel_quant_params *quant_params,
+                                              const cmsis_nn_dims *input_dims,
+                                              const int8_t *input,
+                                              const cmsis_nn_dims *filter_dims,
+                                              const int8_t *kernel,
+                                              const cmsis_nn_dims *bias_dims,
+                                              const int32_t *bias,
+                                              const cmsis_nn_dims *output_dims,
+                                              int8_t *output)
+{
+    const int32_t input_ch = input_dims->c;
+    const int32_t output_ch = output_dims->c;
+
+    /* Check depth multiplier is 1 */
+    if (input_ch != output_ch)
+    {
+        return ARM_CMSIS_NN_ARG_ERROR;
+    }
+
+    if (ctx->buf == NULL && arm_depthwise_conv_s8_opt_get_buffer_size(input_dims, filter_dims) > 0)
+    {
+        return ARM_CMSIS_NN_ARG_ERROR;
+    }
+#ifdef ARM_MATH_DSP
+    (void)bias_dims;
+
+    #ifdef ARM_MATH_MVEI
+    const int32_t input_x = input_dims->w;
+    const int32_t input_y = input_dims->h;
+    const int32_t kernel_x = filter_dims->w;
+    const int32_t kernel_y = filter_dims->h;
+    const int32_t pad_x = dw_conv_params->padding.w;
+    const int32_t pad_y = dw_conv_params->padding.h;
+    const int32_t stride_x = dw_conv_params->stride.w;
+    const int32_t stride_y = dw_conv_params->stride.h;
+    const int32_t *output_shift = quant_params->shift;
+    const int32_t *output_mult = quant_params->multiplier;
+    const int32_t output_x = output_dims->w;
+    const int32_t output_y = output_dims->h;
+    const int32_t output_offset = dw_conv_params->output_offset;
+    const int32_t input_offset = dw_conv_params->input_offset;
+    const int32_t output_activation_min = dw_conv_params->activation.min;
+    const int32_t output_activation_max = dw_conv_params->activation.max;
+    int16_t *buffer_a = (int16_t *)ctx->buf;
+
+    /* Generate two columns from the input tensor */
+    int8_t *lhs_buffer = (int8_t *)buffer_a;
+    int8_t *out = output;
+    int buffer_count = 0;
+    const int32_t kernel_size = kernel_x * kernel_y;
+
+    const int32_t ch_loop = (input_ch + (CH_IN_BLOCK_MVE - 1)) / CH_IN_BLOCK_MVE;
+    int32_t remaining_ch = output_ch;
+    int32_t active_ch = MIN(CH_IN_BLOCK_MVE, remaining_ch);
+    remaining_ch -= CH_IN_BLOCK_MVE;
+
+    for (int i_ch = 0; i_ch < ch_loop; i_ch++)
+    {
+        out = output + i_ch * CH_IN_BLOCK_MVE;
+        const int8_t *input_slice = input + (i_ch * CH_IN_BLOCK_MVE);
+
+        for (int i_out_y = 0, base_idx_y = -pad_y; i_out_y < output_y; base_idx_y += stride_y, i_out_y++)
+        {
+            for (int i_out_x = 0, base_idx_x = -pad_x; i_out_x < output_x; base_idx_x += stride_x, i_out_x++)
+            {
+                for (int i_ker_y = base_idx_y; i_ker_y < base_idx_y + kernel_y; i_ker_y++)
+                {
+                    for (int i_ker_x = base_idx_x; i_ker_x < base_idx_x + kernel_x; i_ker_x++)
+                    {
+                        if (i_ker_y < 0 || i_ker_y >= input_y || i_ker_x < 0 || i_ker_x >= input_x)
+                        {
+                            arm_memset_s8(lhs_buffer, (int8_t)-input_offset, (uint32_t)active_ch);
+                        }
+                        else
+                        {
+                            arm_memcpy_s8(lhs_buffer,
+                                          input_slice + (i_ker_y * input_x + i_ker_x) * input_ch,
+                                          (uint32_t)active_ch);
+                        }
+                        lhs_buffer += CH_IN_BLOCK_MVE;
+                    }
+                }
+                buffer_count++;
+
+                if (buffer_count == 4)
+                {
+                    const int32_t block_offset = i_ch * CH_IN_BLOCK_MVE;
+                    lhs_buffer = (int8_t *)buffer_a;
+
+                    arm_nn_depthwise_conv_nt_t_s8(lhs_buffer,
+                                                  kernel + block_offset,
+                                                  input_offset,
+                                                  active_ch,
+                                                  input_ch,
+                                                  output_shift + block_offset,
+                                                  output_mult + block_offset,
+                                                  output_offset,
+                                                  output_activation_min,
+                                                  output_activation_max,
+                                                  kernel_size,
+                                                  bias + block_offset,
+                                                  out);
+
+                    out += (4 * input_ch);
+                    buffer_count = 0;
+                }
+            }
+        }
+        /* Handle left over buffers */
+        lhs_buffer = (int8_t *)buffer_a;
+
+        int8_t *out_base = out;
+        for (int i_buf = 0; i_buf < buffer_count; i_buf++)
+        {
+            int32_t loop_count = (active_ch + 3) / 4;
+            int32_t num_ch_to_process = active_ch;
+            out = out_base + (i_buf * input_ch);
+            for (int i_loop_cnt = 0, offset = i_ch * CH_IN_BLOCK_MVE; i_loop_cnt < loop_count;
+                 num_ch_to_process -= 4, offset += 4, i_loop_cnt++)
+            {
+                const int8_t *col_0 = lhs_buffer + (kernel_size * CH_IN_BLOCK_MVE * i_buf) + (i_loop_cnt * 4);
+                const int8_t *row_0 = kernel + offset;
+                int32x4_t out_0 = vdupq_n_s32(0);
+                if (bias)
+                {
+                    out_0 = vldrwq_s32(&bias[offset]);
+                }
+
+                for (int i_ker = 0; i_ker < kernel_size; i_ker++)
+                {
+                    const int32x4_t ker_0 = vldrbq_s32(row_0);
+                    int32x4_t ip_0 = vldrbq_s32(col_0);
+                    ip_0 = vaddq_n_s32(ip_0, input_offset);
+                    out_0 += vmulq_s32(ip_0, ker_0);
+
+                    col_0 += CH_IN_BLOCK_MVE;
+                    row_0 += input_ch;
+                }
+
+                const int32x4_t mult = vldrwq_s32(&output_mult[offset]);
+                const int32x4_t shift = vldrwq_s32(&output_shift[offset]);
+
+                out_0 = arm_requantize_mve_32x4(out_0, mult, shift);
+                out_0 = vaddq_n_s32(out_0, output_offset);
+                out_0 = vmaxq_s32(out_0, vdupq_n_s32(output_activation_min));
+                out_0 = vminq_s32(out_0, vdupq_n_s32(output_activation_max));
+                mve_pred16_t p = vctp32q((uint32_t)num_ch_to_process);
+                vstrbq_p_s32(out, out_0, p);
+
+                out += 4;
+            }
+        }
+        buffer_count = 0;
+
+        active_ch = MIN(CH_IN_BLOCK_MVE, remaining_ch);
+        remaining_ch -= CH_IN_BLOCK_MVE;
+    }
+
+    #else // ARM_MATH_DSP
+    /* Run the following code in cores using DSP extension */
+    DepthwiseConvOptArgs args = {
+        dw_conv_params, quant_params, input_dims, input, filter_dims, kernel, bias, output_dims, output, (int16_t *)ctx->buf};
+        #if defined(TF_LITE_PICO_MULTICORE)
+    /* Both cores claim chunks of output rows, each with its own im2col buffer. */
+    tflm_parallel_for(0, output_dims->h, depthwise_conv_s8_opt_rows, &args);
+        #else
+    depthwise_conv_s8_opt_rows(0, output_dims->h, &args);
+        #endif
     #endif
 #else
     /* Run the following code as reference implementation for Cortex-M0 and Cortex-M3 */
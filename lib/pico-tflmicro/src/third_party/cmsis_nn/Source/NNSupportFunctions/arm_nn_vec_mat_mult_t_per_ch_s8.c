@@ -29,6 +29,17 @@
  * -------------------------------------------------------------------- */
 
 #include "third_party/cmsis_nn/Include/arm_nnsupportfunctions.h"
+#include "tensorflow/lite/micro/pico/parallel_for.h"
+
+/* Output neurons per parallel_for item: the row unrolling of the loops below,
+ * so every chunk but the last keeps their fast path. */
+#if defined(ARM_MATH_MVEI)
+    #define VEC_MAT_ROWS_PER_ITEM 4
+#elif defined(ARM_MATH_DSP)
+    #define VEC_MAT_ROWS_PER_ITEM 2
+#else
+    #define VEC_MAT_ROWS_PER_ITEM 3
+#endif
 
 /**
  * @ingroup groupSupport
@@ -47,29 +58,29 @@
  */
 
 /*
- * s8 vector(lhs) by matrix (transposed) multiplication and per channel quant output
- *
- * Refer header file for details.
- *
+ * Output rows [0, rhs_rows) of the product, with every pointer already
+ * advanced to the first row. arm_nn_vec_mat_mult_t_per_ch_s8 below runs it on a range
+ * of rows from each core; rows are independent, so the split does not change
+ * the result.
  */
 #if !defined(ARM_MATH_MVEI) && defined(ARM_MATH_DSP) && !defined(__ARMCC_VERSION) && !defined(__ICCARM__)
     #pragma GCC optimize("unroll-loops")
 #endif
-arm_cmsis_nn_status arm_nn_vec_mat_mult_t_per_ch_s8(const int8_t *lhs,
-                                                    const int8_t *rhs,
-                                                    const int32_t *kernel_sum,
-                                                    const int32_t *bias,
-                                                    int8_t *dst,
-                                                    const int32_t lhs_offset,
-                                                    const int32_t dst_offset,
-                                                    const int32_t *dst_multiplier,
-                                                    const int32_t *dst_shift,
-                                                    const int32_t rhs_cols,
-                                                    const int32_t rhs_rows,
-                                                    const int32_t activation_min,
-                                                    const int32_t activation_max,
-                                                    const int32_t address_offset,
-                                                    const int32_t rhs_offset)
+static arm_cmsis_nn_status vec_mat_mult_t_per_ch_s8_rows(const int8_t *lhs,
+                                                         const int8_t *rhs,
+                                                         const int32_t *kernel_sum,
+                                                         const int32_t *bias,
+                                                         int8_t *dst,
+                                                         const int32_t lhs_offset,
+                                                         const int32_t dst_offset,
+                                                         const int32_t *dst_multiplier,
+                                                         const int32_t *dst_shift,
+                                                         const int32_t rhs_cols,
+                                                         const int32_t rhs_rows,
+                                                         const int32_t activation_min,
+                                                         const int32_t activation_max,
+                                                         const int32_t address_offset,
+                                                         const int32_t rhs_offset)
 {
     if (rhs_offset)
     {
@@ -726,6 +737,102 @@ arm_cmsis_nn_status arm_nn_vec_mat_mult_t_per_ch_s8(const int8_t *lhs,
     return ARM_CMSIS_NN_SUCCESS;
 }
 
+#if defined(TF_LITE_PICO_MULTICORE)
+typedef struct
+{
+    const int8_t *lhs;
+    const int8_t *rhs;
+    const int32_t *kernel_sum;
+    const int32_t *bias;
+    int8_t *dst;
+    int32_t lhs_offset;
+    int32_t dst_offset;
+    const int32_t *dst_multiplier;
+    const int32_t *dst_shift;
+    int32_t rhs_cols;
+    int32_t rhs_rows;
+    int32_t activation_min;
+    int32_t activation_max;
+    int32_t address_offset;
+    int32_t rhs_offset;
+} VecMatMultPerChArgs;
+
+/*
+ * Items [item_begin, item_end) of the product in ctx, each item a group of
+ * VEC_MAT_ROWS_PER_ITEM output neurons. Run through tflm_parallel_for.
+ */
+static void vec_mat_mult_t_per_ch_s8_items(int32_t item_begin, int32_t item_end, void *ctx)
+{
+    const VecMatMultPerChArgs *args = (const VecMatMultPerChArgs *)ctx;
+    const int32_t row_begin = item_begin * VEC_MAT_ROWS_PER_ITEM;
+    const int32_t row_end = MIN(item_end * VEC_MAT_ROWS_PER_ITEM, args->rhs_rows);
+    vec_mat_mult_t_per_ch_s8_rows(args->lhs,
+                                  args->rhs + row_begin * args->rhs_cols,
+                                  args->kernel_sum ? args->kernel_sum + row_begin : NULL,
+                                  args->bias ? args->bias + row_begin : NULL,
+                                  args->dst + row_begin * args->address_offset,
+                                  args->lhs_offset,
+                                  args->dst_offset,
+                                  args->dst_multiplier + row_begin,
+                                  args->dst_shift + row_begin,
+                                  args->rhs_cols,
+                                  row_end - row_begin,
+                                  args->activation_min,
+                                  args->activation_max,
+                                  args->address_offset,
+                                  args->rhs_offset);
+}
+#endif
+
+/*
+ * s8 vector(lhs) by matrix (transposed) multiplication and per channel quant output
+ *
+ * Refer header file for details.
+ *
+ */
+arm_cmsis_nn_status arm_nn_vec_mat_mult_t_per_ch_s8(const int8_t *lhs,
+                                                    const int8_t *rhs,
+                                                    const int32_t *kernel_sum,
+                                                    const int32_t *bias,
+                                                    int8_t *dst,
+                                                    const int32_t lhs_offset,
+                                                    const int32_t dst_offset,
+                                                    const int32_t *dst_multiplier,
+                                                    const int32_t *dst_shift,
+                                                    const int32_t rhs_cols,
+                                                    const int32_t rhs_rows,
+                                                    const int32_t activation_min,
+                                                    const int32_t activation_max,
+                                                    const int32_t address_offset,
+                                                    const int32_t rhs_offset)
+{
+#if defined(TF_LITE_PICO_MULTICORE)
+    const VecMatMultPerChArgs args = {
+        lhs, rhs, kernel_sum, bias, dst, lhs_offset, dst_offset, dst_multiplier, dst_shift,
+        rhs_cols, rhs_rows, activation_min, activation_max, address_offset, rhs_offset};
+    /* Both cores claim chunks of output neurons until none are left. */
+    const int32_t items = (rhs_rows + VEC_MAT_ROWS_PER_ITEM - 1) / VEC_MAT_ROWS_PER_ITEM;
+    tflm_parallel_for(0, items, vec_mat_mult_t_per_ch_s8_items, (void *)&args);
+    return ARM_CMSIS_NN_SUCCESS;
+#else
+    return vec_mat_mult_t_per_ch_s8_rows(lhs,
+                                         rhs,
+                                         kernel_sum,
+                                         bias,
+                                         dst,
+                                         lhs_offset,
+                                         dst_offset,
+                                         dst_multiplier,
+                                         dst_shift,
+                                         rhs_cols,
+                                         rhs_rows,
+                                         activation_min,
+                                         activation_max,
+                                         address_offset,
+                                         rhs_offset);
+#endif
+}
+
 /**
  * @} end of Doxygen group
  */
@@ -39,14 +39,13 @@
  * @{
  */
 
-// Uncomment this to try the experimental dual core support on the RP2040.
-#define TF_LITE_PICO_MULTICORE
+// Dual core support on the RP2040: TF_LITE_PICO_MULTICORE comes from
+// parallel_for.h, which leaves it undefined when TF_LITE_PICO_SINGLE_CORE is
+// set because the application owns core 1.
+#include "tensorflow/lite/micro/pico/parallel_for.h"
 
 #ifdef TF_LITE_PICO_MULTICORE
 
-#include "pico/stdlib.h"
-#include "pico/multicore.h"
-
 typedef struct {
     int32_t rhs_rows_start;
     int32_t rhs_rows_end;
@@ -66,8 +65,6 @@ typedef struct {
     int32_t lhs_cols_offset;
 } MatMulArgs;
 
-static MatMulArgs g_core1_mat_mul_args;
-
 static void calculate_two_rows(
     const int8_t *lhs,
     const int8_t *rhs,
@@ -291,11 +288,13 @@ static void mat_mul_task(const MatMulArgs* args) {
         lhs_cols_offset);
 }
 
-static void core1_mat_mul_worker(void) {
-    mat_mul_task(&g_core1_mat_mul_args);
-
-    // Signal we're done by pushing a result of zero.
-    multicore_fifo_push_blocking(ARM_CMSIS_NN_SUCCESS);
+// parallel_for callback: items are pairs of rhs rows, since the kernel
+// computes two rows at a time.
+static void mat_mul_row_pairs(int32_t pair_begin, int32_t pair_end, void *ctx) {
+    MatMulArgs args = *(const MatMulArgs *)ctx;
+    args.rhs_rows_start = pair_begin * 2;
+    args.rhs_rows_end = pair_end * 2;
+    mat_mul_task(&args);
 }
 
 #endif  // TF_LITE_PICO_MULTICORE
@@ -886,8 +885,6 @@ arm_cmsis_nn_status arm_nn_mat_mult_nt_t_s8(const int8_t *lhs,
 
 #if defined(TF_LITE_PICO_MULTICORE)
 
-    const int32_t mid_range = (rhs_rows / 4) * 2;
-
     MatMulArgs shared_args;
     shared_args.lhs = lhs;
     shared_args.rhs = rhs;
@@ -904,29 +901,9 @@ arm_cmsis_nn_status arm_nn_mat_mult_nt_t_s8(const int8_t *lhs,
     shared_args.activation_max = activation_max;
     shared_args.lhs_cols_offset = lhs_cols_offset;
 
-    MatMulArgs core0_args = shared_args;
-    core0_args.rhs_rows_start = 0;
-    core0_args.rhs_rows_end = mid_range;
-
-    MatMulArgs core1_args = shared_args;
-    core1_args.rhs_rows_start = mid_range;
-    core1_args.rhs_rows_end = rhs_rows - 1;
-
-    // Start the second core working.
-    g_core1_mat_mul_args = core1_args;
-
-    multicore_reset_core1();
-    multicore_launch_core1(core1_mat_mul_worker);
-
-    // Do the processing on the first core.
-    mat_mul_task(&core0_args);
-
-    // A result of ARM_CMSIS_NN_SUCCESS means success. Blocks until core 1 is
-    // done.
-    const uint32_t core1_result = multicore_fifo_pop_blocking();
-    if (core1_result != ARM_CMSIS_NN_SUCCESS) {
-        return core1_result;
-    }
+    // Both cores claim chunks of row pairs until none are left; returns once
+    // both are done. An odd last row is handled below.
+    tflm_parallel_for(0, rhs_rows / 2, mat_mul_row_pairs, &shared_args);
 
     const int32_t rows_processed = (rhs_rows / 2) * 2;
     const int8_t* new_rhs = rhs + (rows_processed * rhs_cols);
@@ -0,0 +1,527 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/micro/micro_interpreter_graph.h"
+
+#include <algorithm>
+
+#include "third_party/flatbuffers/include/flatbuffers/flatbuffers.h"
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/kernels/internal/compatibility.h"
+#include "tensorflow/lite/micro/flatbuffer_utils.h"
+#include "tensorflow/lite/micro/memory_helpers.h"
+#include "tensorflow/lite/micro/micro_log.h"
+#include "tensorflow/lite/micro/micro_profiler.h"
+#include "tensorflow/lite/micro/pico/parallel_for.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+#ifdef USE_TFLM_COMPRESSION
+
+#include "tensorflow/lite/micro/micro_context.h"
+
+#endif  // USE_TFLM_COMPRESSION
+
+namespace tflite {
+namespace {
+
+const char* OpNameFromRegistration(const TFLMRegistration* registration) {
+  if (registration->builtin_code == BuiltinOperator_CUSTOM) {
+    return registration->custom_name;
+  } else {
+    return EnumNameBuiltinOperator(BuiltinOperator(registration->builtin_code));
+  }
+}
+
+// Lane schedule entry of a node whose kernel uses both cores on its own.
+// Only set between Prepare and PlanLanes.
+constexpr uint16_t kLaneOwnKernel = 0xFFFF;
+
+// The two nodes of a pair and what their invoke returned.
+struct LaneLevel {
+  MicroInterpreterGraph* graph;
+  int subgraph_idx;
+  uint32_t nodes[2];
+  TfLiteStatus statuses[2];
+};
+
+bool ContainsTensor(const flatbuffers::Vector<int32_t>* tensors,
+                    int32_t tensor_index) {
+  for (size_t n = 0; tensors != nullptr && n < tensors->size(); ++n) {
+    if (tensors->Get(n) == tensor_index) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// True if `later` reads a tensor `earlier` writes, or writes one it uses.
+bool DependsOn(const Operator* later, const Operator* earlier) {
+  for (size_t n = 0; later->inputs() != nullptr && n < later->inputs()->size();
+       ++n) {
+    const int32_t tensor_index = later->inputs()->Get(n);
+    if (tensor_index >= 0 && ContainsTensor(earlier->outputs(), tensor_index)) {
+      return true;
+    }
+  }
+  for (size_t n = 0;
+       later->outputs() != nullptr && n < later->outputs()->size(); ++n) {
+    const int32_t tensor_index = later->outputs()->Get(n);
+    if (ContainsTensor(earlier->inputs(), tensor_index) ||
+        ContainsTensor(earlier->outputs(), tensor_index)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+MicroInterpreterGraph::MicroInterpreterGraph(
+    TfLiteContext* context, const Model* model, MicroAllocator* allocator,
+    MicroResourceVariables* resource_variables)
+    : context_(context),
+      model_(model),
+      allocator_(allocator),
+      current_subgraph_index_(0),
+      current_operator_index_(0),
+      resource_variables_(resource_variables) {
+  if (model != nullptr) {
+    subgraphs_ = model->subgraphs();
+  }
+}
+
+MicroInterpreterGraph::~MicroInterpreterGraph() {}
+
+TfLiteStatus MicroInterpreterGraph::InitSubgraphs() {
+  int previous_subgraph_idx = current_subgraph_index_;
+  uint32_t previous_operator_idx = current_operator_index_;
+
+  for (size_t subgraph_idx = 0; subgraph_idx < subgraphs_->size();
+       subgraph_idx++) {
+    current_subgraph_index_ = subgraph_idx;
+    uint32_t operators_size = NumSubgraphOperators(model_, subgraph_idx);
+    for (current_operator_index_ = 0; current_operator_index_ < operators_size;
+         ++current_operator_index_) {
+      TfLiteNode* node = &(subgraph_allocations_[subgraph_idx]
+                               .node_and_registrations[current_operator_index_]
+                               .node);
+      const TFLMRegistration* registration =
+          subgraph_allocations_[subgraph_idx]
+              .node_and_registrations[current_operator_index_]
+              .registration;
+      size_t init_data_size;
+      const char* init_data;
+      if (registration->builtin_code == BuiltinOperator_CUSTOM) {
+        init_data = reinterpret_cast<const char*>(node->custom_initial_data);
+        init_data_size = node->custom_initial_data_size;
+      } else {
+        init_data = reinterpret_cast<const char*>(node->builtin_data);
+        init_data_size = 0;
+      }
+      if (registration->init) {
+        node->user_data =
+            registration->init(context_, init_data, init_data_size);
+      }
+    }
+  }
+  current_subgraph_index_ = previous_subgraph_idx;
+  current_operator_index_ = previous_operator_idx;
+
+  return kTfLiteOk;
+}
+
+TfLiteStatus MicroInterpreterGraph::PrepareSubgraphs() {
+  int previous_subgraph_idx = current_subgraph_index_;
+  uint32_t previous_operator_idx = current_operator_index_;
+  if (parallel_lanes_) {
+    TF_LITE_ENSURE_STATUS(AllocateLaneSchedules());
+  }
+  for (size_t subgraph_idx = 0; subgraph_idx < subgraphs_->size();
+       subgraph_idx++) {
+    current_subgraph_index_ = subgraph_idx;
+    uint32_t operators_size = NumSubgraphOperators(model_, subgraph_idx);
+    for (current_operator_index_ = 0; current_operator_index_ < operators_size;
+         ++current_operator_index_) {
+      TfLiteNode* node = &(subgraph_allocations_[subgraph_idx]
+                               .node_and_registrations[current_operator_index_]
+                               .node);
+      const TFLMRegistration* registration =
+          subgraph_allocations_[subgraph_idx]
+              .node_and_registrations[current_operator_index_]
+              .registration;
+      if (registration->prepare != nullptr) {
+        TfLiteStatus prepare_status = registration->prepare(context_, node);
+        if (prepare_status != kTfLiteOk) {
+          MicroPrintf("Node %s (number %df) failed to prepare with status %d",
+                      OpNameFromRegistration(registration),
+                      current_operator_index_, prepare_status);
+          return kTfLiteError;
+        }
+#ifdef USE_TFLM_COMPRESSION
+        GetMicroContext(context_)->ResetDecompressionMemoryAllocations();
+#endif  // USE_TFLM_COMPRESSION
+      }
+      allocator_->FinishPrepareNodeAllocations(
+          /*node_id=*/current_operator_index_);
+    }
+    PlanLanes(subgraph_idx);
+  }
+  current_subgraph_index_ = previous_subgraph_idx;
+  current_operator_index_ = previous_operator_idx;
+  return kTfLiteOk;
+}
+
+TfLiteStatus MicroInterpreterGraph::ResetSubgraphs() {
+  int previous_subgraph_idx = current_subgraph_index_;
+  uint32_t previous_operator_idx = current_operator_index_;
+
+  for (size_t subgraph_idx = 0; subgraph_idx < subgraphs_->size();
+       subgraph_idx++) {
+    current_subgraph_index_ = subgraph_idx;
+    uint32_t operators_size = NumSubgraphOperators(model_, subgraph_idx);
+    for (current_operator_index_ = 0; current_operator_index_ < operators_size;
+         ++current_operator_index_) {
+      TfLiteNode* node = &(subgraph_allocations_[subgraph_idx]
+                               .node_and_registrations[current_operator_index_]
+                               .node);
+      const TFLMRegistration* registration =
+          subgraph_allocations_[subgraph_idx]
+              .node_and_registrations[current_operator_index_]
+              .registration;
+      // registration is allocated outside the interpreter, so double check to
+      // make sure it's not nullptr;
+      if (registration != nullptr && registration->reset != nullptr) {
+        registration->reset(context_, node->user_data);
+      }
+    }
+  }
+  current_subgraph_index_ = previous_subgraph_idx;
+  current_operator_index_ = previous_operator_idx;
+
+  return kTfLiteOk;
+}
+
+TfLiteStatus MicroInterpreterGraph::FreeSubgraphs() {
+  int previous_subgraph_idx = current_subgraph_index_;
+  uint32_t previous_operator_idx = current_operator_index_;
+
+  for (size_t subgraph_idx = 0; subgraph_idx < subgraphs_->size();
+       subgraph_idx++) {
+    current_subgraph_index_ = subgraph_idx;
+    uint32_t operators_size = NumSubgraphOperators(model_, subgraph_idx);
+    for (current_operator_index_ = 0; current_operator_index_ < operators_size;
+         ++current_operator_index_) {
+      TfLiteNode* node = &(subgraph_allocations_[subgraph_idx]
+                               .node_and_registrations[current_operator_index_]
+                               .node);
+      const TFLMRegistration* registration =
+          subgraph_allocations_[subgraph_idx]
+              .node_and_registrations[current_operator_index_]
+              .registration;
+      // registration is allocated outside the interpreter, so double check to
+      // make sure it's not nullptr;
+      if (registration != nullptr && registration->free != nullptr) {
+        registration->free(context_, node->user_data);
+      }
+    }
+  }
+  current_subgraph_index_ = previous_subgraph_idx;
+  current_operator_index_ = previous_operator_idx;
+
+  return kTfLiteOk;
+}
+
+TfLiteStatus MicroInterpreterGraph::InvokeSubgraph(int subgraph_idx) {
+  int previous_subgraph_idx = current_subgraph_index_;
+  uint32_t previous_operator_idx = current_operator_index_;
+  current_subgraph_index_ = subgraph_idx;
+
+  if (static_cast<size_t>(subgraph_idx) >= subgraphs_->size()) {
+    MicroPrintf("Accessing subgraph %d but only %d subgraphs found",
+                subgraph_idx, subgraphs_->size());
+    return kTfLiteError;
+  }
+  uint32_t operators_size = NumSubgraphOperators(model_, subgraph_idx);
+  // The profiler is not safe to use from both cores, so with one attached the
+  // nodes run in their original order, which the memory plan also allows.
+  const uint16_t* lane_partner =
+      context_->profiler == nullptr
+          ? subgraph_allocations_[subgraph_idx].lane_partner
+          : nullptr;
+  for (current_operator_index_ = 0; current_operator_index_ < operators_size;
+       ++current_operator_index_) {
+    LaneLevel level = {this, subgraph_idx, {current_operator_index_}, {}};
+    int level_size = 1;
+    if (lane_partner != nullptr) {
+      const uint32_t partner = lane_partner[current_operator_index_];
+      if (partner < current_operator_index_) {
+        // Already ran together with the node it was hoisted to.
+        continue;
+      }
+      if (partner > current_operator_index_) {
+        level.nodes[level_size++] = partner;
+      }
+    }
+    if (level_size == 1) {
+      level.statuses[0] = InvokeNode(subgraph_idx, current_operator_index_);
+    } else {
+      // Kernel calls to tflm_parallel_for made from either lane run inline.
+      tflm_parallel_set_enabled(true);
+      tflm_parallel_for(0, level_size, InvokeLaneItems, &level);
+    }
+#ifdef USE_TFLM_COMPRESSION
+    GetMicroContext(context_)->ResetDecompressionMemoryAllocations();
+#endif  // USE_TFLM_COMPRESSION
+
+    // All TfLiteTensor structs used in the kernel are allocated from temp
+    // memory in the allocator. This creates a chain of allocations in the
+    // temp section. The call below resets the chain of allocations to
+    // prepare for the next call.
+    allocator_->ResetTempAllocations();
+
+    for (int n = 0; n < level_size; ++n) {
+      const TfLiteStatus invoke_status = level.statuses[n];
+      if (invoke_status == kTfLiteError) {
+        MicroPrintf("Node %s (number %d) failed to invoke with status %d",
+                    OpNameFromRegistration(
+                        subgraph_allocations_[subgraph_idx]
+                            .node_and_registrations[level.nodes[n]]
+                            .registration),
+                    level.nodes[n], invoke_status);
+        return kTfLiteError;
+      } else if (invoke_status != kTfLiteOk) {
+        return invoke_status;
+      }
+    }
+  }
+  current_subgraph_index_ = previous_subgraph_idx;
+  current_operator_index_ = previous_operator_idx;
+  return kTfLiteOk;
+}
+
+TfLiteStatus MicroInterpreterGraph::InvokeNode(int subgraph_idx,
+                                               uint32_t node_idx) {
+  TfLiteNode* node =
+      &(subgraph_allocations_[subgraph_idx].node_and_registrations[node_idx].node);
+  const TFLMRegistration* registration =
+      subgraph_allocations_[subgraph_idx]
+          .node_and_registrations[node_idx]
+          .registration;
+
+// This ifdef is needed (even though ScopedMicroProfiler itself is a no-op with
+// -DTF_LITE_STRIP_ERROR_STRINGS) because the function OpNameFromRegistration is
+// only defined for builds with the error strings.
+#if !defined(TF_LITE_STRIP_ERROR_STRINGS)
+  ScopedMicroProfiler scoped_profiler(
+      OpNameFromRegistration(registration),
+      reinterpret_cast<MicroProfilerInterface*>(context_->profiler));
+#endif
+
+  TFLITE_DCHECK(registration->invoke);
+  return registration->invoke(context_, node);
+}
+
+void MicroInterpreterGraph::InvokeLaneItems(int32_t begin, int32_t end,
+                                            void* ctx) {
+  LaneLevel* level = static_cast<LaneLevel*>(ctx);
+  for (int32_t n = begin; n < end; ++n) {
+    level->statuses[n] =
+        level->graph->InvokeNode(level->subgraph_idx, level->nodes[n]);
+  }
+}
+
+TfLiteStatus MicroInterpreterGraph::AllocateLaneSchedules() {
+#if defined(TF_LITE_PICO_MULTICORE) && !defined(USE_TFLM_COMPRESSION)
+  for (size_t subgraph_idx = 0; subgraph_idx < subgraphs_->size();
+       subgraph_idx++) {
+    const uint32_t operators_size = NumSubgraphOperators(model_, subgraph_idx);
+    if (operators_size < 2 || operators_size >= kLaneOwnKernel) {
+      continue;
+    }
+    uint16_t* lane_partner =
+        static_cast<uint16_t*>(allocator_->AllocatePersistentBuffer(
+            sizeof(uint16_t) * operators_size));
+    if (lane_partner == nullptr) {
+      MicroPrintf("Failed to allocate the lane schedule of subgraph %d",
+                  subgraph_idx);
+      return kTfLiteError;
+    }
+    for (uint32_t i = 0; i < operators_size; ++i) {
+      lane_partner[i] = i;
+    }
+    subgraph_allocations_[subgraph_idx].lane_partner = lane_partner;
+  }
+#endif
+  return kTfLiteOk;
+}
+
+void MicroInterpreterGraph::MarkNodeUsesBothCores() {
+  uint16_t* lane_partner =
+      subgraph_allocations_[current_subgraph_index_].lane_partner;
+  if (lane_partner != nullptr) {
+    lane_partner[current_operator_index_] = kLaneOwnKernel;
+  }
+}
+
+bool MicroInterpreterGraph::IsLaneBarrier(int subgraph_idx,
+                                          uint32_t node_idx) {
+  switch (subgraph_allocations_[subgraph_idx]
+              .node_and_registrations[node_idx]
+              .registration->builtin_code) {
+    case BuiltinOperator_IF:
+    case BuiltinOperator_WHILE:
+    case BuiltinOperator_CALL_ONCE:
+    case BuiltinOperator_VAR_HANDLE:
+    case BuiltinOperator_READ_VARIABLE:
+    case BuiltinOperator_ASSIGN_VARIABLE:
+      return true;
+    default:
+      break;
+  }
+  const SubGraph* subgraph = subgraphs_->Get(subgraph_idx);
+  const Operator* op = subgraph->operators()->Get(node_idx);
+  for (size_t n = 0; op->inputs() != nullptr && n < op->inputs()->size();
+       ++n) {
+    const int32_t tensor_index = op->inputs()->Get(n);
+    if (tensor_index >= 0 &&
+        subgraph->tensors()->Get(tensor_index)->is_variable()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void MicroInterpreterGraph::PlanLanes(int subgraph_idx) {
+  uint16_t* lane_partner = subgraph_allocations_[subgraph_idx].lane_partner;
+  if (lane_partner == nullptr) {
+    return;
+  }
+  const auto* operators = subgraphs_->Get(subgraph_idx)->operators();
+  const uint32_t operators_size = NumSubgraphOperators(model_, subgraph_idx);
+  bool paired = false;
+  // Nodes are only hoisted past the last hoisted one. Everything before it has
+  // run by the time its pair joins, so a candidate only needs to be checked
+  // against the nodes between it and the node leading the pair.
+  uint32_t first_candidate = 0;
+  for (uint32_t i = 0; i < operators_size; ++i) {
+    if (lane_partner[i] != i || IsLaneBarrier(subgraph_idx, i)) {
+      continue;
+    }
+    const uint32_t last_candidate =
+        std::min<uint32_t>(operators_size - 1, i + TFLM_LANE_LOOKAHEAD);
+    for (uint32_t j = i + 1; j <= last_candidate; ++j) {
+      if (IsLaneBarrier(subgraph_idx, j)) {
+        break;
+      }
+      if (j < first_candidate || lane_partner[j] != j) {
+        continue;
+      }
+      bool independent = true;
+      for (uint32_t k = i; k < j && independent; ++k) {
+        // Nodes hoisted to an earlier pair have already run.
+        if (lane_partner[k] >= k) {
+          independent = !DependsOn(operators->Get(j), operators->Get(k));
+        }
+      }
+      if (independent) {
+        lane_partner[i] = j;
+        lane_partner[j] = i;
+        first_candidate = j + 1;
+        paired = true;
+        break;
+      }
+    }
+  }
+  for (uint32_t i = 0; i < operators_size; ++i) {
+    if (lane_partner[i] == kLaneOwnKernel) {
+      lane_partner[i] = i;
+    }
+  }
+  if (!paired) {
+    subgraph_allocations_[subgraph_idx].lane_partner = nullptr;
+  }
+}
+
+bool MicroInterpreterGraph::HasParallelLanes() {
+  for (size_t subgraph_idx = 0; subgraph_idx < subgraphs_->size();
+       subgraph_idx++) {
+    if (subgraph_allocations_[subgraph_idx].lane_partner != nullptr) {
+      return true;
+    }
+  }
+  return false;
+}
+
+TfLiteStatus MicroInterpreterGraph::ResetVariableTensors() {
+  for (size_t subgraph_idx = 0; subgraph_idx < subgraphs_->size();
+       subgraph_idx++) {
+    const SubGraph* subgraph = (*subgraphs_)[subgraph_idx];
+    for (size_t i = 0; i < subgraph->tensors()->size(); ++i) {
+      auto* tensor = subgraph->tensors()->Get(i);
+      if (tensor->is_variable()) {
+        size_t buffer_size;
+        TF_LITE_ENSURE_STATUS(TfLiteEvalTensorByteLength(
+            &subgraph_allocations_[subgraph_idx].tensors[i], &buffer_size));
+
+        int value = 0;
+        if (tensor->type() == tflite::TensorType_INT8) {
+          value = tensor->quantization()->zero_point()->Get(0);
+        }
+        memset(subgraph_allocations_[subgraph_idx].tensors[i].data.raw, value,
+               buffer_size);
+      }
+    }
+  }
+  if (resource_variables_ != nullptr) {
+    resource_variables_->ResetAll();
+  }
+
+  return kTfLiteOk;
+}
+
+int MicroInterpreterGraph::NumSubgraphs() {
+  return model_->subgraphs()->size();
+}
+
+void MicroInterpreterGraph::SetSubgraphAllocations(
+    SubgraphAllocations* subgraph_allocations) {
+  subgraph_allocations_ = subgraph_allocations;
+}
+
+size_t MicroInterpreterGraph::NumSubgraphInputs(int subgraph_idx) {
+  return model_->subgraphs()->Get(subgraph_idx)->inputs()->size();
+}
+
+TfLiteEvalTensor* MicroInterpreterGraph::GetSubgraphInput(int subgraph_idx,
+                                                          int input_idx) {
+  int tensor_idx =
+      model_->subgraphs()->Get(subgraph_idx)->inputs()->Get(input_idx);
+  return &subgraph_allocations_[subgraph_idx].tensors[tensor_idx];
+}
+
+size_t MicroInterpreterGraph::NumSubgraphOutputs(int subgraph_idx) {
+  return model_->subgraphs()->Get(subgraph_idx)->outputs() == nullptr
+             ? 0
+             : model_->subgraphs()->Get(subgraph_idx)->outputs()->size();
+}
+
+TfLiteEvalTensor* MicroInterpreterGraph::GetSubgraphOutput(int subgraph_idx,
+                                                           int output_idx) {
+  int tensor_idx =
+      model_->subgraphs()->Get(subgraph_idx)->outputs()->Get(output_idx);
+  return &subgraph_allocations_[subgraph_idx].tensors[tensor_idx];
+}
+
+}  // namespace tflite
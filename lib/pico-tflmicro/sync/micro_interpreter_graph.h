@@ -0,0 +1,165 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_MICRO_MICRO_INTERPRETER_GRAPH_H_
+#define TENSORFLOW_LITE_MICRO_MICRO_INTERPRETER_GRAPH_H_
+
+#include "tensorflow/lite/micro/micro_allocator.h"
+#include "tensorflow/lite/micro/micro_common.h"
+#include "tensorflow/lite/micro/micro_graph.h"
+#include "tensorflow/lite/micro/micro_resource_variable.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+// Pico: how many operators past a node PlanLanes looks for an independent one
+// to run with it on the other core. The outputs of a hoisted node stay in the
+// arena from its partner onwards, so a longer reach can grow the arena.
+#ifndef TFLM_LANE_LOOKAHEAD
+#define TFLM_LANE_LOOKAHEAD 8
+#endif
+
+// Pico: bytes reserved for the temp allocations of nodes running on core 1
+// (see MicroAllocator::AllocateLaneTempMemory).
+#ifndef TFLM_LANE_TEMP_BYTES
+#define TFLM_LANE_TEMP_BYTES 1024
+#endif
+
+namespace tflite {
+
+// Abstracts the details of interacting with the tflite::Model.
+//
+// Provides methods to access, initialize, prepare, invoke and free any
+// subgraph in the tflite::Graph.
+class MicroInterpreterGraph : public MicroGraph {
+ public:
+  // The lifetime of the context, model, allocator and resource_variables must
+  // be at least as long as that of the graph object, since the this class may
+  // need to access them at any time. If resource_variables is a nullptr,
+  // GetResourceVariables will return a nullptr.
+  MicroInterpreterGraph(TfLiteContext* context, const Model* model,
+                        MicroAllocator* allocator,
+                        MicroResourceVariables* resource_variables);
+  virtual ~MicroInterpreterGraph();
+
+  // Sets up builtin data and calls TFLMRegistration->Init for every
+  // operator in every subgraph in the model.
+  virtual TfLiteStatus InitSubgraphs();
+
+  // Calls TFLMRegistration->Prepare for every operator in every subgraph
+  // in the model. With parallel lanes enabled, then plans which nodes run
+  // together on both cores.
+  virtual TfLiteStatus PrepareSubgraphs();
+
+  // Calls TFLMRegistration->Reset for every operator in every subgraph in
+  // the model.
+  virtual TfLiteStatus ResetSubgraphs();
+
+  // Calls TFLMRegistration->Free for every operator in every subgraph in
+  // the model.
+  virtual TfLiteStatus FreeSubgraphs();
+
+  // Calls TFLMRegistration->Invoke for every operator in a single subgraph
+  // in the model.
+  virtual TfLiteStatus InvokeSubgraph(int subgraph_idx);
+
+  // Zeros out all variable tensors in all subgraphs in the model.
+  virtual TfLiteStatus ResetVariableTensors();
+
+  // Number of tensor inputs to a specified subgraph in the model.
+  virtual size_t NumSubgraphInputs(int subgraph_idx);
+
+  // Get the specified input tensor of a specified subgraph in the model.
+  virtual TfLiteEvalTensor* GetSubgraphInput(int subgraph_idx, int input_idx);
+
+  // Number of tensor outputs from a specified subgraph in the model.
+  virtual size_t NumSubgraphOutputs(int subgraph_idx);
+
+  // Get the specified output tensor of a specified subgraph in the model.
+  virtual TfLiteEvalTensor* GetSubgraphOutput(int subgraph_idx, int output_idx);
+
+  // Number of subgraphs in the model.
+  virtual int NumSubgraphs();
+
+  // Hook to pass in subgraph allocations tracked within the interpreter,
+  // allowing MicroInterpreterGraph to init / prepare / invoke subgraphs in the
+  // model.
+  void SetSubgraphAllocations(SubgraphAllocations* subgraph_allocations);
+
+  // Get the current subgraph index. Within an on operator, this is guaranteed
+  // to be the subgraph of that operator.
+  int GetCurrentSubgraphIndex() { return current_subgraph_index_; }
+
+  // Get the current operator index inside a subgraph.
+  // The couple GetCurrentSubgraphIndex GetCurrentSubgraphIndex creates a unique
+  // identifier of the operator inside the subgraph
+  int GetCurrentOperatorIndex() { return current_operator_index_; }
+
+  // Gets the list of allocations for each subgraph. This is the source of truth
+  // for all per-subgraph allocation data.
+  SubgraphAllocations* GetAllocations() { return subgraph_allocations_; }
+
+  // Get the resource variables for this TFLM graph.
+  MicroResourceVariables* GetResourceVariables() { return resource_variables_; }
+
+  // Pico: lets PrepareSubgraphs pair independent nodes that are at most
+  // TFLM_LANE_LOOKAHEAD operators apart, so that InvokeSubgraph runs each pair
+  // on both cores and joins before the next node. Must be set before
+  // PrepareSubgraphs. No effect with TF_LITE_PICO_SINGLE_CORE or
+  // USE_TFLM_COMPRESSION.
+  void SetParallelLanes(bool enabled) { parallel_lanes_ = enabled; }
+
+  // Pico: called while the current node prepares if its kernel splits its own
+  // work across both cores. Such a node is never paired.
+  void MarkNodeUsesBothCores();
+
+  // Pico: true if some subgraph still runs nodes in pairs. Only final once
+  // the memory plan is committed, which drops the pairs of offline plans.
+  bool HasParallelLanes();
+
+ private:
+  // Allocates the lane schedule of every subgraph, with every node alone.
+  TfLiteStatus AllocateLaneSchedules();
+
+  // Greedily pairs each node with the first later node that does not depend
+  // on it or on anything still to run between them.
+  void PlanLanes(int subgraph_idx);
+
+  // Control flow, resource variable ops and nodes with variable inputs are
+  // never paired, nor hoisted over.
+  bool IsLaneBarrier(int subgraph_idx, uint32_t node_idx);
+
+  // Calls TFLMRegistration->Invoke for one node.
+  TfLiteStatus InvokeNode(int subgraph_idx, uint32_t node_idx);
+
+  // tflm_parallel_fn invoking the nodes of a pair.
+  static void InvokeLaneItems(int32_t begin, int32_t end, void* ctx);
+
+  TfLiteContext* context_;
+  const Model* model_;
+  MicroAllocator* allocator_;
+  SubgraphAllocations* subgraph_allocations_ = nullptr;
+  int current_subgraph_index_;
+  uint32_t current_operator_index_;
+  MicroResourceVariables* resource_variables_;
+  bool parallel_lanes_ = false;
+  const flatbuffers::Vector<flatbuffers::Offset<SubGraph>>* subgraphs_ =
+      nullptr;  // Initialized as nullptr to prevent any possible issues
+                // related to accessing uninitialized memory.
+
+  TF_LITE_REMOVE_VIRTUAL_DELETE
+};
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_MICRO_MICRO_INTERPRETER_GRAPH_H_
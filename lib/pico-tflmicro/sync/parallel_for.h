@@ -0,0 +1,104 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Raspberry Pi Pico-specific dual core helper for the kernels.
+//
+// Core 1 runs a persistent worker that is launched on the first parallel
+// call and then sleeps on the inter-core FIFO waiting for jobs, so a kernel
+// only pays for one FIFO round trip instead of a core reset and relaunch.
+// The host build runs the same code, with core 1 emulated by a thread.
+//
+// Define TF_LITE_PICO_SINGLE_CORE when the application owns core 1; every
+// parallel_for call then runs inline on the calling core. At runtime the
+// interpreter picks per node whether its kernel may use both cores (see
+// MicroContext::UseParallelKernels) and the kernel passes that choice on
+// through tflm_parallel_set_enabled.
+
+#ifndef TENSORFLOW_LITE_MICRO_PICO_PARALLEL_FOR_H_
+#define TENSORFLOW_LITE_MICRO_PICO_PARALLEL_FOR_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#if !defined(TF_LITE_PICO_SINGLE_CORE)
+#define TF_LITE_PICO_MULTICORE
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Processes the items in [begin, end). Must be safe to run concurrently on
+// disjoint ranges.
+typedef void (*tflm_parallel_fn)(int32_t begin, int32_t end, void* ctx);
+
+// Runs fn over [begin, end) on both cores and returns once all items are
+// done. The range is cut in chunks that each core claims from a shared
+// counter, so a core slowed down by flash or interrupts just takes fewer of
+// them. fn is called once per chunk, in no particular order. Runs inline when
+// multicore is disabled, when called from core 1, from inside another
+// parallel_for, or when there is less than two items.
+void tflm_parallel_for(int32_t begin, int32_t end, tflm_parallel_fn fn,
+                       void* ctx);
+
+// Allows the next parallel_for calls on core 0 to use core 1 (the default)
+// or keeps them on core 0, until the next call to this function. Kernels set
+// it at the start of Eval from the flag they computed at Prepare. Ignored
+// while a parallel_for is running, since nested calls run inline anyway.
+void tflm_parallel_set_enabled(bool enabled);
+
+// Smallest node, in multiply-accumulates per Invoke, that MicroContext lets
+// use both cores by default. Below it the FIFO round trip and the chunk
+// claims cost about as much as the work saved. A starting point to tune on
+// the board, not a measured crossover.
+#ifndef TFLM_PARALLEL_MIN_MACS
+#define TFLM_PARALLEL_MIN_MACS 4096
+#endif
+
+// Chunks per worker for a range: more balances better, fewer claims cost
+// less. Each chunk has at least one item.
+#ifndef TFLM_PARALLEL_CHUNKS_PER_WORKER
+#define TFLM_PARALLEL_CHUNKS_PER_WORKER 8
+#endif
+
+// Number of workers a parallel_for can run on, and the index of the one
+// running the caller, for kernels that need a scratch buffer per worker.
+#ifdef TF_LITE_PICO_MULTICORE
+#define TFLM_PARALLEL_WORKERS 2
+#else
+#define TFLM_PARALLEL_WORKERS 1
+#endif
+int tflm_parallel_worker(void);
+
+// Stops the core 1 worker and gives the core back to the application. The
+// next parallel_for launches it again.
+void tflm_parallel_stop(void);
+
+typedef struct {
+  uint32_t launches;     // Times the core 1 worker was started.
+  uint32_t jobs;         // Calls split across both cores.
+  uint32_t inline_runs;  // Calls that ran on the calling core only.
+  // Per worker, over the jobs: chunks claimed, time spent running them, and
+  // time left waiting for the other core before the job returned.
+  uint32_t chunks[TFLM_PARALLEL_WORKERS];
+  uint64_t busy_us[TFLM_PARALLEL_WORKERS];
+  uint64_t idle_us[TFLM_PARALLEL_WORKERS];
+} TflmParallelStats;
+
+void tflm_parallel_get_stats(TflmParallelStats* stats);
+void tflm_parallel_reset_stats(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // TENSORFLOW_LITE_MICRO_PICO_PARALLEL_FOR_H_
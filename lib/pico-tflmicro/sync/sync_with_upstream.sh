@@ -62,6 +62,31 @@ sync/create_tests.py ${TFLM_REPO_DIR}/tflite-micro .
 cp sync/micro_time.cpp src/tensorflow/lite/micro/micro_time.cpp
 cp sync/system_setup.cpp src/tensorflow/lite/micro/system_setup.cpp
 cp sync/arm_nn_mat_mult_nt_t_s8.c src/third_party/cmsis_nn/Source/NNSupportFunctions/arm_nn_mat_mult_nt_t_s8.c
+cp sync/arm_nn_vec_mat_mult_t_s8.c src/third_party/cmsis_nn/Source/NNSupportFunctions/arm_nn_vec_mat_mult_t_s8.c
+cp sync/arm_nn_vec_mat_mult_t_per_ch_s8.c src/third_party/cmsis_nn/Source/NNSupportFunctions/arm_nn_vec_mat_mult_t_per_ch_s8.c
+cp sync/arm_depthwise_conv_3x3_s8.c src/third_party/cmsis_nn/Source/ConvolutionFunctions/arm_depthwise_conv_3x3_s8.c
+cp sync/arm_depthwise_conv_get_buffer_sizes_s8.c src/third_party/cmsis_nn/Source/ConvolutionFunctions/arm_depthwise_conv_get_buffer_sizes_s8.c
+cp sync/arm_depthwise_conv_s8.c src/third_party/cmsis_nn/Source/ConvolutionFunctions/arm_depthwise_conv_s8.c
+cp sync/arm_depthwise_conv_s8_opt.c src/third_party/cmsis_nn/Source/ConvolutionFunctions/arm_depthwise_conv_s8_opt.c
+mkdir -p src/tensorflow/lite/micro/pico
+cp sync/parallel_for.h src/tensorflow/lite/micro/pico
+cp sync/parallel_for.c src/tensorflow/lite/micro/pico
+cp sync/micro_context.h src/tensorflow/lite/micro/micro_context.h
+cp sync/micro_interpreter.h src/tensorflow/lite/micro/micro_interpreter.h
+cp sync/micro_interpreter.cpp src/tensorflow/lite/micro/micro_interpreter.cpp
+cp sync/micro_interpreter_context.h src/tensorflow/lite/micro/micro_interpreter_context.h
+cp sync/micro_interpreter_context.cpp src/tensorflow/lite/micro/micro_interpreter_context.cpp
+cp sync/micro_interpreter_graph.h src/tensorflow/lite/micro/micro_interpreter_graph.h
+cp sync/micro_interpreter_graph.cpp src/tensorflow/lite/micro/micro_interpreter_graph.cpp
+cp sync/micro_allocator.h src/tensorflow/lite/micro/micro_allocator.h
+cp sync/micro_allocator.cpp src/tensorflow/lite/micro/micro_allocator.cpp
+cp sync/micro_allocation_info.cpp src/tensorflow/lite/micro/micro_allocation_info.cpp
+cp sync/cmsis_nn_conv.cpp src/tensorflow/lite/micro/kernels/cmsis_nn/conv.cpp
+cp sync/cmsis_nn_depthwise_conv.cpp src/tensorflow/lite/micro/kernels/cmsis_nn/depthwise_conv.cpp
+cp sync/cmsis_nn_fully_connected.cpp src/tensorflow/lite/micro/kernels/cmsis_nn/fully_connected.cpp
+cp sync/cmsis_nn_transpose_conv.cpp src/tensorflow/lite/micro/kernels/cmsis_nn/transpose_conv.cpp
+cp sync/cmsis_nn_svdf.cpp src/tensorflow/lite/micro/kernels/cmsis_nn/svdf.cpp
+cp sync/cmsis_nn_batch_matmul.cpp src/tensorflow/lite/micro/kernels/cmsis_nn/batch_matmul.cpp
 mkdir -p src/tensorflow/lite/micro/benchmarks
 cp sync/micro_benchmark.h src/tensorflow/lite/micro/benchmarks
 
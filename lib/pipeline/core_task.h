@@ -0,0 +1,31 @@
+#ifndef CORE_TASK_H
+#define CORE_TASK_H
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================
+// TAREFA NO SEGUNDO CORE
+// Uma função de longa duração no core 1: multicore_launch_core1 no RP2040
+// (core_task_multicore.c) ou std::thread no host (core_task_thread.cpp),
+// onde a thread se registra como core 1 no shim do Pico SDK.
+// Enquanto a tarefa roda, o core 1 é dela: nada mais pode chamar
+// multicore_reset_core1 (ver TF_LITE_PICO_SINGLE_CORE no CMSIS-NN).
+// ============================================================
+
+typedef void (*CoreTaskEntry)(void *arg);
+
+// false se já há uma tarefa rodando
+bool core_task_launch(CoreTaskEntry entry, void *arg);
+
+// Espera a tarefa retornar (ela precisa ter um jeito de ser parada)
+void core_task_join(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,34 @@
+// Backend do RP2040: a tarefa roda no core 1 e, ao retornar, avisa pelo FIFO.
+#include "core_task.h"
+
+#include "pico/multicore.h"
+
+#define CORE_TASK_DONE 0xC0DE7A5Ku
+
+static CoreTaskEntry task_entry;
+static void *task_arg;
+static bool task_running = false;
+
+static void core1_trampoline(void) {
+    // Permite ao core 0 pausar este core durante gravações no flash
+    // (flash_safe_execute), já que a tarefa roda do XIP
+    multicore_lockout_victim_init();
+    task_entry(task_arg);
+    multicore_fifo_push_blocking(CORE_TASK_DONE);
+}
+
+bool core_task_launch(CoreTaskEntry entry, void *arg) {
+    if (task_running) return false;
+    task_entry = entry;
+    task_arg = arg;
+    task_running = true;
+    multicore_launch_core1(core1_trampoline);
+    return true;
+}
+
+void core_task_join(void) {
+    if (!task_running) return;
+    while (multicore_fifo_pop_blocking() != CORE_TASK_DONE) {
+    }
+    task_running = false;
+}
@@ -0,0 +1,33 @@
+// Backend host: a tarefa roda em uma std::thread registrada como core 1.
+#include "core_task.h"
+
+#include <atomic>
+#include <thread>
+
+#include "host/host_core.h"
+
+// No heap: o replay termina com exit() de dentro da própria tarefa, e o
+// destrutor de uma std::thread ainda associada chamaria std::terminate.
+static std::thread *task_thread = nullptr;
+
+bool core_task_launch(CoreTaskEntry entry, void *arg) {
+    if (task_thread) return false;
+    std::atomic<bool> entered{false};
+    task_thread = new std::thread([entry, arg, &entered] {
+        host_core_enter(1);
+        entered.store(true);
+        entry(arg);
+        host_core_leave();
+    });
+    // Só retorna com o core 1 registrado: antes disso o __wfe do core 0
+    // acharia o core 1 parado e adiantaria o relógio virtual
+    while (!entered.load()) std::this_thread::yield();
+    return true;
+}
+
+void core_task_join(void) {
+    if (!task_thread) return;
+    task_thread->join();
+    delete task_thread;
+    task_thread = nullptr;
+}
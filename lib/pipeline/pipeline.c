@@ -0,0 +1,36 @@
+#include "pipeline.h"
+
+#include <stdio.h>
+
+#include "hardware/sync.h"
+
+void pipeline_init(Pipeline *p) {
+    spsc_init(&p->queue, p->slots, sizeof(PipelineSample), PIPELINE_QUEUE_DEPTH);
+    p->starved = false;
+    p->stalls = 0;
+}
+
+bool pipeline_push(Pipeline *p, const PipelineSample *s) {
+    const bool ok = spsc_push(&p->queue, s);
+    if (ok) __sev();
+    return ok;
+}
+
+bool pipeline_pop(Pipeline *p, PipelineSample *out) {
+    if (spsc_pop(&p->queue, out)) {
+        p->starved = false;
+        return true;
+    }
+    if (!p->starved) p->stalls++;
+    p->starved = true;
+    return false;
+}
+
+void pipeline_report(const Pipeline *p) {
+    const SpscQueue *q = &p->queue;
+    printf("[PIPELINE] fila %lu/%lu (máx %lu) | amostras %lu | consumidas %lu | "
+           "descartes %lu | esperas core0 %lu\n",
+           (unsigned long)spsc_depth(q), (unsigned long)q->capacity,
+           (unsigned long)q->max_depth, (unsigned long)q->pushed,
+           (unsigned long)q->popped, (unsigned long)q->dropped, (unsigned long)p->stalls);
+}
@@ -0,0 +1,54 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "lib/features/features.h"
+#include "lib/pipeline/spsc_queue.h"
+#include "lib/sensors/sensors.h"
+
+// ============================================================
+// PIPELINE ENTRE OS CORES
+// Core 1: tick do alarme, leitura dos sensores, janelas e pré-processamento.
+// Core 0: inferência, debounce, LEDs e telemetria.
+// As amostras prontas passam por uma fila SPSC sem espera; o core 1 nunca
+// bloqueia (fila cheia = descarte) e o core 0 dorme em WFE com a fila vazia
+// (o push faz __sev).
+// ============================================================
+
+#define PIPELINE_QUEUE_DEPTH 8   // Potência de 2
+
+// Amostra pronta para a inferência (também usada no modo de um core só)
+typedef struct {
+    uint32_t seq;                   // Tick do agendador
+    uint64_t due_us;                // Instante ideal na grade do alarme
+    SensorReadings readings;
+    bool quantized;                 // true: inputs_q; false: inputs
+    int8_t inputs_q[2];
+    uint32_t model_epoch;           // tflm_model_epoch() na quantização de inputs_q
+    float inputs[FEAT_NUM_FEATURES];
+    int16_t trend_centi_c_min;      // Tendência de ΔT (0,01 °C/min)
+    uint16_t sensores_us;           // Estágios já medidos na aquisição
+    uint16_t preproc_us;
+} PipelineSample;
+
+typedef struct {
+    SpscQueue queue;
+    PipelineSample slots[PIPELINE_QUEUE_DEPTH];
+    // Consumidor
+    bool starved;                   // Último pop achou a fila vazia
+    uint32_t stalls;                // Vezes em que o core 0 ficou esperando amostra
+} Pipeline;
+
+void pipeline_init(Pipeline *p);
+
+// Core 1: enfileira e acorda o core 0; false = fila cheia, descartada
+bool pipeline_push(Pipeline *p, const PipelineSample *s);
+
+// Core 0: false com a fila vazia (conta uma espera por sequência de vazios)
+bool pipeline_pop(Pipeline *p, PipelineSample *out);
+
+void pipeline_report(const Pipeline *p);
+
+#endif
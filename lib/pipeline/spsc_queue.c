@@ -0,0 +1,42 @@
+#include "spsc_queue.h"
+
+#include <string.h>
+
+static inline uint32_t load_acquire(const uint32_t *p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+static inline void store_release(uint32_t *p, uint32_t v) { __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+
+bool spsc_init(SpscQueue *q, void *slots, uint32_t slot_size, uint32_t capacity) {
+    memset(q, 0, sizeof(*q));
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) return false;
+    q->slots = (uint8_t *)slots;
+    q->slot_size = slot_size;
+    q->capacity = capacity;
+    return true;
+}
+
+bool spsc_push(SpscQueue *q, const void *item) {
+    const uint32_t head = q->head;
+    const uint32_t depth = head - load_acquire(&q->tail);
+    if (depth == q->capacity) {
+        q->dropped++;
+        return false;
+    }
+    memcpy(q->slots + (size_t)(head & (q->capacity - 1)) * q->slot_size, item, q->slot_size);
+    store_release(&q->head, head + 1);
+    q->pushed++;
+    if (depth + 1 > q->max_depth) q->max_depth = depth + 1;
+    return true;
+}
+
+bool spsc_pop(SpscQueue *q, void *out) {
+    const uint32_t tail = q->tail;
+    if (load_acquire(&q->head) == tail) return false;
+    memcpy(out, q->slots + (size_t)(tail & (q->capacity - 1)) * q->slot_size, q->slot_size);
+    store_release(&q->tail, tail + 1);
+    q->popped++;
+    return true;
+}
+
+uint32_t spsc_depth(const SpscQueue *q) {
+    return load_acquire(&q->head) - load_acquire(&q->tail);
+}
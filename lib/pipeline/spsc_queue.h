@@ -0,0 +1,42 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ============================================================
+// FILA SPSC SEM ESPERA
+// Um produtor (core 1) e um consumidor (core 0), sem trava nem laço de
+// repetição: push e pop terminam em passos fixos. Fila cheia = o item é
+// descartado e contado; fila vazia = pop retorna false.
+//
+// Índices livres (não mascarados): head - tail = itens ocupados. Cada lado
+// escreve só o próprio índice (release) e lê o do outro (acquire), então os
+// dados do slot ficam visíveis antes do índice que os publica.
+// Os contadores também têm um único escritor cada.
+// ============================================================
+
+typedef struct {
+    uint8_t *slots;             // capacity * slot_size bytes, do chamador
+    uint32_t slot_size;
+    uint32_t capacity;          // Potência de 2
+    uint32_t head;              // Escrito só pelo produtor
+    uint32_t tail;              // Escrito só pelo consumidor
+    // Produtor
+    uint32_t pushed;
+    uint32_t dropped;
+    uint32_t max_depth;         // Maior ocupação vista logo após um push
+    // Consumidor
+    uint32_t popped;
+} SpscQueue;
+
+// false se capacity não é potência de 2
+bool spsc_init(SpscQueue *q, void *slots, uint32_t slot_size, uint32_t capacity);
+
+bool spsc_push(SpscQueue *q, const void *item);
+bool spsc_pop(SpscQueue *q, void *out);
+
+// Ocupação instantânea (aproximada se lida do outro lado)
+uint32_t spsc_depth(const SpscQueue *q);
+
+#endif
@@ -0,0 +1,46 @@
+#include "preproc.h"
+
+#include <math.h>
+
+// Gera mult/bias/shift para q = delta_raw * units_per_code / (std * scale) - mean / (std * scale) + zp
+static void feature_init(PreprocFeature *f, double units_per_code,
+                         double mean, double std, double scale, int zero_point) {
+    const double m = units_per_code / (std * scale);
+
+    // Maior shift que mantém mult em 31 bits
+    int exponent;
+    frexp(m, &exponent);  // m = frac * 2^exponent, frac em [0.5, 1)
+    f->shift = 30 - exponent;
+    f->mult = (int32_t)llround(ldexp(m, f->shift));
+
+    const double b = (double)zero_point - mean / (std * scale) + 0.5;
+    f->bias = (int64_t)llround(ldexp(b, f->shift));
+}
+
+bool preproc_fixed_init(PreprocFixed *p,
+                        float mean_delta_t, float std_delta_t,
+                        float mean_delta_u, float std_delta_u,
+                        float input_scale, int input_zero_point) {
+    if (!(input_scale > 0.0f)) {
+        return false;
+    }
+    feature_init(&p->delta_t, 200.0 / AHT20_RAW_FULL_SCALE,
+                 mean_delta_t, std_delta_t, input_scale, input_zero_point);
+    feature_init(&p->delta_u, 100.0 / AHT20_RAW_FULL_SCALE,
+                 mean_delta_u, std_delta_u, input_scale, input_zero_point);
+    return true;
+}
+
+static inline int8_t quantize_feature(const PreprocFeature *f, int32_t delta_raw) {
+    // |delta_raw| < 2^20 e |mult| < 2^31: o produto cabe com folga em 64 bits
+    int64_t acc = (int64_t)delta_raw * f->mult + f->bias;
+    int32_t q = (int32_t)(acc >> f->shift);  // shift aritmético = floor; o +0.5 do bias arredonda
+    if (q < -128) q = -128;
+    if (q > 127) q = 127;
+    return (int8_t)q;
+}
+
+void preproc_fixed_quantize(const PreprocFixed *p, const SensorReadings *r, int8_t out[2]) {
+    out[0] = quantize_feature(&p->delta_t, (int32_t)r->raw_temp_1 - (int32_t)r->raw_temp_2);
+    out[1] = quantize_feature(&p->delta_u, (int32_t)r->raw_humidity_1 - (int32_t)r->raw_humidity_2);
+}
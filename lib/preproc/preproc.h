@@ -0,0 +1,41 @@
+#ifndef PREPROC_H
+#define PREPROC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "lib/sensors/sensors.h"
+
+// ============================================================
+// PRÉ-PROCESSAMENTO EM PONTO FIXO
+// Códigos brutos do AHT20 -> diferencial -> z-score -> int8 quantizado,
+// tudo dobrado em um multiplicador e um bias inteiros por feature:
+//
+//   q = clamp(((raw_exaustao - raw_ambiente) * mult + bias) >> shift, -128, 127)
+//
+// O offset de -50 °C da temperatura some no diferencial. Os coeficientes são
+// gerados uma vez (no init) a partir das constantes de normalização e dos
+// parâmetros de quantização da entrada do modelo; o loop não usa float.
+// ============================================================
+
+typedef struct {
+    int32_t mult;   // Escala do código bruto para unidades de q, em Q(shift)
+    int64_t bias;   // zp - mean / (std * scale), em Q(shift), já com +0.5 de arredondamento
+    int32_t shift;
+} PreprocFeature;
+
+typedef struct {
+    PreprocFeature delta_t;
+    PreprocFeature delta_u;
+} PreprocFixed;
+
+// Retorna false se input_scale <= 0 (modelo com entrada float: não há o que quantizar)
+bool preproc_fixed_init(PreprocFixed *p,
+                        float mean_delta_t, float std_delta_t,
+                        float mean_delta_u, float std_delta_u,
+                        float input_scale, int input_zero_point);
+
+// out[0] = ΔT quantizado, out[1] = ΔU quantizado
+void preproc_fixed_quantize(const PreprocFixed *p, const SensorReadings *r, int8_t out[2]);
+
+#endif
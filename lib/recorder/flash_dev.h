@@ -0,0 +1,30 @@
+#ifndef FLASH_DEV_H
+#define FLASH_DEV_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ============================================================
+// REGIÃO DE FLASH NOR
+// O gravador só enxerga uma região reservada através desta interface:
+// flash_rp2040.c (XIP + flash_range_*) no Pico, flash_file.c (arquivo com
+// semântica de NOR) no host. Offsets relativos ao início da região.
+//
+// Regras de NOR que o simulador também aplica:
+//   - erase: setores inteiros, tudo vira 0xFF
+//   - program: páginas inteiras, só leva bits de 1 para 0 (reprogramar a
+//     mesma página com mais dados é permitido se os bytes antigos se repetem)
+// ============================================================
+
+#define FLASH_DEV_PAGE_BYTES    256u
+#define FLASH_DEV_SECTOR_BYTES  4096u
+
+typedef struct {
+    uint32_t size;      // Bytes da região, múltiplo de FLASH_DEV_SECTOR_BYTES
+    bool (*read)(void *ctx, uint32_t offset, uint8_t *dst, uint32_t len);
+    bool (*program)(void *ctx, uint32_t offset, const uint8_t *src, uint32_t len);
+    bool (*erase)(void *ctx, uint32_t offset, uint32_t len);
+    void *ctx;
+} FlashDevice;
+
+#endif
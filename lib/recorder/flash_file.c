@@ -0,0 +1,152 @@
+// Backend host do gravador: região de flash simulada em arquivo (ver flash_file.h).
+// recorder_platform_flash usa o arquivo em PREDAGUARD_FLASH, se definido.
+#define _POSIX_C_SOURCE 200809L
+
+#include "flash_file.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "lib/recorder/recorder.h"
+
+static bool file_read(void *ctx, uint32_t offset, uint8_t *dst, uint32_t len) {
+    FlashFile *f = (FlashFile *)ctx;
+    if (f->dead || (uint64_t)offset + len > f->size) return false;
+    return pread(f->fd, dst, len, offset) == (ssize_t)len;
+}
+
+static uint32_t next_random(FlashFile *f) {
+    f->rng = f->rng * 1664525u + 1013904223u;
+    return f->rng >> 8;
+}
+
+// Aplica até o orçamento; false se a energia caiu no meio
+static bool spend(FlashFile *f, uint32_t len, uint32_t *applied) {
+    if (f->budget < 0 || (int64_t)len <= f->budget) {
+        if (f->budget >= 0) f->budget -= len;
+        *applied = len;
+        return true;
+    }
+    *applied = (uint32_t)f->budget;
+    f->budget = 0;
+    f->dead = true;
+    return false;
+}
+
+static bool file_program(void *ctx, uint32_t offset, const uint8_t *src, uint32_t len) {
+    FlashFile *f = (FlashFile *)ctx;
+    if (f->dead || f->read_only || offset % FLASH_DEV_PAGE_BYTES || len % FLASH_DEV_PAGE_BYTES ||
+        (uint64_t)offset + len > f->size) {
+        return false;
+    }
+    uint8_t cur[FLASH_DEV_PAGE_BYTES];
+    for (uint32_t p = 0; p < len; p += FLASH_DEV_PAGE_BYTES) {
+        if (pread(f->fd, cur, sizeof(cur), offset + p) != (ssize_t)sizeof(cur)) return false;
+        uint32_t applied;
+        const bool whole = spend(f, FLASH_DEV_PAGE_BYTES, &applied);
+        for (uint32_t i = 0; i < FLASH_DEV_PAGE_BYTES; i++) {
+            const uint8_t want = src[p + i];
+            if ((cur[i] & want) != want) f->nor_violations++;
+            if (i < applied) {
+                cur[i] &= want;
+            } else if (i == applied) {
+                cur[i] &= (uint8_t)(want | next_random(f)); // Bits do corte pela metade
+            }
+        }
+        if (pwrite(f->fd, cur, sizeof(cur), offset + p) != (ssize_t)sizeof(cur)) return false;
+        f->programmed_bytes += applied;
+        if (!whole) return false;
+        f->page_programs++;
+    }
+    return true;
+}
+
+static bool file_erase(void *ctx, uint32_t offset, uint32_t len) {
+    FlashFile *f = (FlashFile *)ctx;
+    if (f->dead || f->read_only || offset % FLASH_DEV_SECTOR_BYTES ||
+        len % FLASH_DEV_SECTOR_BYTES || (uint64_t)offset + len > f->size) {
+        return false;
+    }
+    uint8_t ones[FLASH_DEV_SECTOR_BYTES];
+    memset(ones, 0xFF, sizeof(ones));
+    for (uint32_t s = 0; s < len; s += FLASH_DEV_SECTOR_BYTES) {
+        uint32_t applied;
+        const bool whole = spend(f, FLASH_DEV_SECTOR_BYTES, &applied);
+        if (applied && pwrite(f->fd, ones, applied, offset + s) != (ssize_t)applied) return false;
+        f->erased_bytes += applied;
+        const uint32_t sector = (offset + s) / FLASH_DEV_SECTOR_BYTES;
+        if (sector < FLASH_FILE_MAX_SECTORS) f->erase_counts[sector]++;
+        if (!whole) return false;
+        f->sector_erases++;
+    }
+    return true;
+}
+
+bool flash_file_open(FlashFile *f, const char *path, uint32_t size, bool read_only,
+                     FlashDevice *out) {
+    memset(f, 0, sizeof(*f));
+    f->budget = -1;
+    f->read_only = read_only;
+    f->fd = open(path, read_only ? O_RDONLY : O_RDWR | O_CREAT, 0644);
+    if (f->fd < 0) return false;
+
+    struct stat st;
+    if (fstat(f->fd, &st) != 0) {
+        flash_file_close(f);
+        return false;
+    }
+    if (size == 0) size = (uint32_t)st.st_size;
+    if ((uint64_t)st.st_size < size) {
+        // Parte nova do arquivo = flash apagado
+        if (read_only) {
+            flash_file_close(f);
+            return false;
+        }
+        uint8_t ones[FLASH_DEV_SECTOR_BYTES];
+        memset(ones, 0xFF, sizeof(ones));
+        for (uint64_t pos = (uint64_t)st.st_size; pos < size; pos += sizeof(ones)) {
+            const size_t n = size - pos < sizeof(ones) ? (size_t)(size - pos) : sizeof(ones);
+            if (pwrite(f->fd, ones, n, (off_t)pos) != (ssize_t)n) {
+                flash_file_close(f);
+                return false;
+            }
+        }
+    }
+    f->size = size;
+    out->size = size;
+    out->read = file_read;
+    out->program = file_program;
+    out->erase = file_erase;
+    out->ctx = f;
+    return true;
+}
+
+void flash_file_close(FlashFile *f) {
+    if (f->fd >= 0) close(f->fd);
+    f->fd = -1;
+}
+
+void flash_file_cut_power_after(FlashFile *f, uint32_t bytes, uint32_t seed) {
+    f->budget = bytes;
+    f->rng = seed;
+}
+
+bool recorder_platform_flash(FlashDevice *out) {
+    static FlashFile file;
+    const char *path = getenv("PREDAGUARD_FLASH");
+    if (!path || !*path) return false;
+    if (!flash_file_open(&file, path, RECORDER_REGION_BYTES, false, out)) {
+        fprintf(stderr, "[REC] Não foi possível abrir %s\n", path);
+        return false;
+    }
+    return true;
+}
+
+void recorder_platform_dump_write(void *ctx, const uint8_t *data, size_t len) {
+    (void)ctx;
+    fwrite(data, 1, len, stdout);
+}
@@ -0,0 +1,52 @@
+#ifndef FLASH_FILE_H
+#define FLASH_FILE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "lib/recorder/flash_dev.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================
+// SIMULADOR DE FLASH NOR EM ARQUIVO (host)
+// Program faz AND com o conteúdo (só 1 -> 0) e exige páginas inteiras;
+// erase exige setores inteiros. Para testar queda de energia, um orçamento
+// de bytes gravados/apagados corta a operação no meio: os bytes antes do
+// corte são aplicados, o byte do corte fica com bits aleatórios e o
+// dispositivo "desliga" (tudo falha) até ser reaberto.
+// ============================================================
+
+#define FLASH_FILE_MAX_SECTORS 1024
+
+typedef struct {
+    int fd;
+    uint32_t size;
+    bool read_only;
+    int64_t budget;             // Bytes até o corte de energia; < 0 = sem corte
+    bool dead;
+    uint32_t rng;
+    // Estatísticas
+    uint64_t programmed_bytes;
+    uint64_t erased_bytes;
+    uint32_t page_programs;
+    uint32_t sector_erases;
+    uint32_t nor_violations;    // Program tentou levar bit 0 -> 1 (erro do chamador)
+    uint32_t erase_counts[FLASH_FILE_MAX_SECTORS];
+} FlashFile;
+
+// size 0: usa o tamanho do arquivo. Arquivo novo ou menor é completado com 0xFF.
+bool flash_file_open(FlashFile *f, const char *path, uint32_t size, bool read_only,
+                     FlashDevice *out);
+void flash_file_close(FlashFile *f);
+
+// Corta a energia depois de `bytes` bytes gravados ou apagados
+void flash_file_cut_power_after(FlashFile *f, uint32_t bytes, uint32_t seed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,80 @@
+// Backend do RP2040: região reservada no fim do flash, lida pelo XIP e
+// gravada com flash_range_* dentro de flash_safe_execute (o outro core e as
+// interrupções param enquanto o XIP está desligado; o worker de core 1 do
+// CMSIS-NN não para, mas espera entre jobs em código na RAM, ver
+// parallel_for.c). Um apagamento de setor
+// leva ~45 ms; com 26 bytes por amostra isso ocorre a cada ~150 amostras.
+#include "lib/recorder/flash_rp2040.h"
+#include "lib/recorder/recorder.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "hardware/flash.h"
+#include "pico/flash.h"
+#include "pico/stdio_usb.h"
+#include "pico/stdlib.h"
+
+#define REGION_OFFSET (PICO_FLASH_SIZE_BYTES - RECORDER_REGION_BYTES)
+#define SAFE_EXECUTE_TIMEOUT_MS 100u
+
+extern char __flash_binary_end;
+
+// O ctx do FlashDevice é o offset da região no flash
+#define CTX_OFFSET(ctx) ((uint32_t)(uintptr_t)(ctx))
+
+typedef struct {
+    uint32_t offset;
+    const uint8_t *src;
+    uint32_t len;
+} FlashOp;
+
+static void do_program(void *param) {
+    const FlashOp *op = (const FlashOp *)param;
+    flash_range_program(op->offset, op->src, op->len);
+}
+
+static void do_erase(void *param) {
+    const FlashOp *op = (const FlashOp *)param;
+    flash_range_erase(op->offset, op->len);
+}
+
+static bool rp_read(void *ctx, uint32_t offset, uint8_t *dst, uint32_t len) {
+    memcpy(dst, (const uint8_t *)(XIP_BASE + CTX_OFFSET(ctx) + offset), len);
+    return true;
+}
+
+static bool rp_program(void *ctx, uint32_t offset, const uint8_t *src, uint32_t len) {
+    FlashOp op = {CTX_OFFSET(ctx) + offset, src, len};
+    return flash_safe_execute(do_program, &op, SAFE_EXECUTE_TIMEOUT_MS) == PICO_OK;
+}
+
+static bool rp_erase(void *ctx, uint32_t offset, uint32_t len) {
+    FlashOp op = {CTX_OFFSET(ctx) + offset, NULL, len};
+    return flash_safe_execute(do_erase, &op, SAFE_EXECUTE_TIMEOUT_MS) == PICO_OK;
+}
+
+bool flash_rp2040_region(FlashDevice *out, uint32_t offset, uint32_t size) {
+    const uint32_t binary_end = (uint32_t)((uintptr_t)&__flash_binary_end - XIP_BASE);
+    if (binary_end > offset) {
+        printf("[FLASH] ERRO: firmware (%lu bytes) invade a região em 0x%08lx\n",
+               (unsigned long)binary_end, (unsigned long)offset);
+        return false;
+    }
+    out->size = size;
+    out->read = rp_read;
+    out->program = rp_program;
+    out->erase = rp_erase;
+    out->ctx = (void *)(uintptr_t)offset;
+    return true;
+}
+
+bool recorder_platform_flash(FlashDevice *out) {
+    return flash_rp2040_region(out, REGION_OFFSET, RECORDER_REGION_BYTES);
+}
+
+// Só pelo USB e sem tradução de \n: a UART0 é da telemetria
+void recorder_platform_dump_write(void *ctx, const uint8_t *data, size_t len) {
+    (void)ctx;
+    stdio_usb.out_chars((const char *)data, (int)len);
+}
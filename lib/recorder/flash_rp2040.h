@@ -0,0 +1,13 @@
+#ifndef FLASH_RP2040_H
+#define FLASH_RP2040_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "lib/recorder/flash_dev.h"
+
+// Região [offset, offset + size) do flash interno como FlashDevice (leitura
+// pelo XIP, escrita em flash_safe_execute). false se o firmware invade a região.
+bool flash_rp2040_region(FlashDevice *out, uint32_t offset, uint32_t size);
+
+#endif
@@ -0,0 +1,368 @@
+#include "recorder.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define PAGES_PER_SECTOR (FLASH_DEV_SECTOR_BYTES / FLASH_DEV_PAGE_BYTES)
+
+// ============================================================
+// CODIFICAÇÃO
+// ============================================================
+static uint16_t crc16(const uint8_t *data, size_t len) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static void put_u16(uint8_t *p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static void put_u32(uint8_t *p, uint32_t v) { put_u16(p, (uint16_t)v); put_u16(p + 2, (uint16_t)(v >> 16)); }
+static uint16_t get_u16(const uint8_t *p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint32_t get_u32(const uint8_t *p) { return get_u16(p) | ((uint32_t)get_u16(p + 2) << 16); }
+
+// Quadro completo em out (len + RECORDER_FRAME_OVERHEAD bytes)
+static void encode_frame(const uint8_t *payload, uint8_t len, uint8_t *out) {
+    out[0] = RECORDER_SYNC;
+    out[1] = len;
+    memcpy(out + 2, payload, len);
+    put_u16(out + 2 + len, crc16(out + 1, (size_t)len + 1));
+}
+
+// Quadro válido no início de p (com até `avail` bytes)? Retorna o tamanho ou 0
+static uint32_t check_frame(const uint8_t *p, uint32_t avail) {
+    if (avail < RECORDER_FRAME_OVERHEAD || p[0] != RECORDER_SYNC) return 0;
+    const uint32_t len = p[1];
+    if (len > RECORDER_MAX_PAYLOAD || len + RECORDER_FRAME_OVERHEAD > avail) return 0;
+    if (get_u16(p + 2 + len) != crc16(p + 1, len + 1)) return 0;
+    return len + RECORDER_FRAME_OVERHEAD;
+}
+
+typedef struct {
+    uint32_t seq;
+    uint32_t erases;
+} SectorHeader;
+
+static void encode_header(const SectorHeader *h, uint8_t out[RECORDER_HEADER_BYTES]) {
+    put_u32(out, RECORDER_MAGIC);
+    put_u32(out + 4, h->seq);
+    put_u32(out + 8, h->erases);
+    put_u16(out + 12, 0xFFFF);
+    put_u16(out + 14, crc16(out, 14));
+}
+
+static bool read_header(const Recorder *r, uint32_t sector, SectorHeader *h) {
+    uint8_t raw[RECORDER_HEADER_BYTES];
+    if (!r->dev.read(r->dev.ctx, sector * FLASH_DEV_SECTOR_BYTES, raw, sizeof(raw))) return false;
+    if (get_u32(raw) != RECORDER_MAGIC || get_u16(raw + 14) != crc16(raw, 14)) return false;
+    h->seq = get_u32(raw + 4);
+    h->erases = get_u32(raw + 8);
+    return true;
+}
+
+static uint32_t page_offset(uint32_t sector, uint32_t page) {
+    return sector * FLASH_DEV_SECTOR_BYTES + page * FLASH_DEV_PAGE_BYTES;
+}
+
+// ============================================================
+// ESCRITA
+// ============================================================
+static bool program_page(Recorder *r) {
+    if (!r->dev.program(r->dev.ctx, page_offset(r->sector, r->page), r->buf, FLASH_DEV_PAGE_BYTES)) {
+        r->stats.flash_errors++;
+        return false;
+    }
+    r->stats.programmed_bytes += FLASH_DEV_PAGE_BYTES;
+    r->stats.page_programs++;
+    r->flushed = r->used;
+    return true;
+}
+
+// Apaga o setor e monta o cabeçalho no buffer: ele vai para o flash junto
+// com os primeiros registros da página 0. Sem cabeçalho o setor é ignorado
+// na abertura, o que só perde o que ainda estava em RAM.
+static bool start_sector(Recorder *r, uint32_t sector) {
+    SectorHeader h = {r->has_sector ? r->seq + 1 : 1, 1};
+    SectorHeader old;
+    if (read_header(r, sector, &old)) h.erases = old.erases + 1;
+
+    if (!r->dev.erase(r->dev.ctx, sector * FLASH_DEV_SECTOR_BYTES, FLASH_DEV_SECTOR_BYTES)) {
+        r->stats.flash_errors++;
+        return false;
+    }
+    r->stats.sector_erases++;
+
+    r->sector = sector;
+    r->seq = h.seq;
+    r->page = 0;
+    r->has_sector = true;
+    memset(r->buf, 0xFF, sizeof(r->buf));
+    encode_header(&h, r->buf);
+    r->used = RECORDER_HEADER_BYTES;
+    r->flushed = 0;
+    return true;
+}
+
+static bool next_page(Recorder *r) {
+    if (r->page + 1 == PAGES_PER_SECTOR) return start_sector(r, (r->sector + 1) % r->num_sectors);
+    r->page++;
+    memset(r->buf, 0xFF, sizeof(r->buf));
+    r->used = r->flushed = 0;
+    return true;
+}
+
+bool recorder_append(Recorder *r, const void *payload, uint8_t len) {
+    if (len > RECORDER_MAX_PAYLOAD) return false;
+    const uint32_t frame = (uint32_t)len + RECORDER_FRAME_OVERHEAD;
+    if (!r->has_sector && !start_sector(r, 0)) return false;
+    if (r->used + frame > FLASH_DEV_PAGE_BYTES) {
+        // Página cheia: uma única gravação para todos os registros dela
+        if (r->flushed < r->used && !program_page(r)) return false;
+        if (!next_page(r)) return false;
+    }
+    encode_frame((const uint8_t *)payload, len, r->buf + r->used);
+    r->used += frame;
+    r->stats.records++;
+    r->stats.payload_bytes += len;
+    return true;
+}
+
+bool recorder_flush(Recorder *r) {
+    if (!r->has_sector || r->flushed == r->used) return true;
+    return program_page(r);
+}
+
+bool recorder_erase_all(Recorder *r) {
+    for (uint32_t s = 0; s < r->num_sectors; s++) {
+        if (!r->dev.erase(r->dev.ctx, s * FLASH_DEV_SECTOR_BYTES, FLASH_DEV_SECTOR_BYTES)) {
+            r->stats.flash_errors++;
+            return false;
+        }
+        r->stats.sector_erases++;
+    }
+    r->has_sector = false;
+    r->used = r->flushed = 0;
+    return true;
+}
+
+// ============================================================
+// ABERTURA (recuperação)
+// ============================================================
+typedef enum { PAGE_OPEN, PAGE_TORN } PageState;
+
+// Percorre os registros a partir de `start`; *end = fim do prefixo válido
+static PageState scan_page(const uint8_t *page, uint32_t start, uint32_t *end) {
+    uint32_t pos = start;
+    while (pos < FLASH_DEV_PAGE_BYTES && page[pos] != 0xFF) {
+        const uint32_t n = check_frame(page + pos, FLASH_DEV_PAGE_BYTES - pos);
+        if (n == 0) break;
+        pos += n;
+    }
+    *end = pos;
+    for (uint32_t i = pos; i < FLASH_DEV_PAGE_BYTES; i++) {
+        if (page[i] != 0xFF) return PAGE_TORN;
+    }
+    return PAGE_OPEN;
+}
+
+bool recorder_open(Recorder *r, const FlashDevice *dev) {
+    memset(r, 0, sizeof(*r));
+    r->dev = *dev;
+    if (dev->size < 2 * FLASH_DEV_SECTOR_BYTES || dev->size % FLASH_DEV_SECTOR_BYTES != 0) return false;
+    r->num_sectors = dev->size / FLASH_DEV_SECTOR_BYTES;
+    memset(r->buf, 0xFF, sizeof(r->buf));
+
+    // Setor mais novo: maior seq (comparação com volta do contador)
+    for (uint32_t s = 0; s < r->num_sectors; s++) {
+        SectorHeader h;
+        if (!read_header(r, s, &h)) continue;
+        if (!r->has_sector || (int32_t)(h.seq - r->seq) > 0) {
+            r->has_sector = true;
+            r->sector = s;
+            r->seq = h.seq;
+        }
+    }
+    if (!r->has_sector) return true;
+
+    // Última página gravada: as seguintes estão apagadas (uma página deixada
+    // com sobra por um registro que não coube não é mais reaberta)
+    uint32_t last = 0;
+    for (uint32_t page = 0; page < PAGES_PER_SECTOR; page++) {
+        if (!r->dev.read(r->dev.ctx, page_offset(r->sector, page), r->buf, FLASH_DEV_PAGE_BYTES)) {
+            r->stats.flash_errors++;
+            return false;
+        }
+        bool erased = true;
+        for (uint32_t i = 0; i < FLASH_DEV_PAGE_BYTES && erased; i++) erased = r->buf[i] == 0xFF;
+        if (erased) break;
+        last = page;
+    }
+    r->dev.read(r->dev.ctx, page_offset(r->sector, last), r->buf, FLASH_DEV_PAGE_BYTES);
+    uint32_t end;
+    if (scan_page(r->buf, last == 0 ? RECORDER_HEADER_BYTES : 0, &end) == PAGE_OPEN) {
+        // Continua na mesma página, depois do último registro
+        r->page = last;
+        r->used = r->flushed = end;
+    } else {
+        // Rasgada por uma queda no meio da gravação: o prefixo válido fica,
+        // a escrita segue na página seguinte
+        r->stats.torn_pages++;
+        r->page = last;
+        r->used = r->flushed = FLASH_DEV_PAGE_BYTES;
+    }
+
+    RecorderCursor c;
+    uint8_t payload[RECORDER_MAX_PAYLOAD];
+    uint8_t len;
+    recorder_cursor_init(&c, r);
+    while (recorder_cursor_next(&c, payload, &len)) r->stats.recovered_records++;
+    return true;
+}
+
+// ============================================================
+// LEITURA
+// ============================================================
+static bool cursor_enter_sector(RecorderCursor *c) {
+    SectorHeader h;
+    c->sector_valid = read_header(c->r, c->sector, &h);
+    c->offset = RECORDER_HEADER_BYTES;
+    c->loaded = UINT32_MAX;
+    return c->sector_valid;
+}
+
+void recorder_cursor_init(RecorderCursor *c, const Recorder *r) {
+    c->r = r;
+    c->visited = r->has_sector ? 0 : r->num_sectors;
+    c->sector = r->has_sector ? (r->sector + 1) % r->num_sectors : 0;
+    if (r->has_sector) cursor_enter_sector(c);
+}
+
+bool recorder_cursor_next(RecorderCursor *c, uint8_t *payload, uint8_t *len) {
+    const Recorder *r = c->r;
+    uint8_t *page = c->page;
+    while (c->visited < r->num_sectors) {
+        while (c->sector_valid && c->offset < FLASH_DEV_SECTOR_BYTES) {
+            const uint32_t page_start = c->offset & ~(FLASH_DEV_PAGE_BYTES - 1);
+            const uint32_t in_page = c->offset - page_start;
+            if (c->loaded != page_start) {
+                if (!r->dev.read(r->dev.ctx, c->sector * FLASH_DEV_SECTOR_BYTES + page_start, page,
+                                 FLASH_DEV_PAGE_BYTES)) {
+                    return false;
+                }
+                c->loaded = page_start;
+            }
+            const uint32_t n = check_frame(page + in_page, FLASH_DEV_PAGE_BYTES - in_page);
+            if (n == 0) {
+                // 0xFF (fim dos registros) ou página rasgada: segue na próxima
+                c->offset = page_start + FLASH_DEV_PAGE_BYTES;
+                continue;
+            }
+            *len = page[in_page + 1];
+            memcpy(payload, page + in_page + 2, *len);
+            c->offset += n;
+            return true;
+        }
+        c->visited++;
+        c->sector = (c->sector + 1) % r->num_sectors;
+        if (c->visited < r->num_sectors) cursor_enter_sector(c);
+    }
+    return false;
+}
+
+uint32_t recorder_dump(Recorder *r, void (*write)(void *ctx, const uint8_t *data, size_t len),
+                       void *ctx) {
+    recorder_flush(r);
+    RecorderCursor c;
+    uint8_t payload[RECORDER_MAX_PAYLOAD];
+    uint8_t frame[RECORDER_MAX_PAYLOAD + RECORDER_FRAME_OVERHEAD];
+    uint8_t len;
+    uint32_t count = 0;
+    recorder_cursor_init(&c, r);
+    while (recorder_cursor_next(&c, payload, &len)) {
+        encode_frame(payload, len, frame);
+        write(ctx, frame, (size_t)len + RECORDER_FRAME_OVERHEAD);
+        count++;
+    }
+    return count;
+}
+
+size_t recorder_frame_decode(const uint8_t *buf, size_t len, uint8_t *payload, uint8_t *plen,
+                             bool *found) {
+    *found = false;
+    size_t i = 0;
+    for (; i < len; i++) {
+        if (buf[i] != RECORDER_SYNC) continue;
+        const size_t avail = len - i;
+        if (avail < 2 || (buf[i + 1] <= RECORDER_MAX_PAYLOAD &&
+                          avail < (size_t)buf[i + 1] + RECORDER_FRAME_OVERHEAD)) {
+            return i; // Talvez um quadro incompleto
+        }
+        const uint32_t n = check_frame(buf + i, avail > FLASH_DEV_PAGE_BYTES ? FLASH_DEV_PAGE_BYTES
+                                                                           : (uint32_t)avail);
+        if (n == 0) continue;
+        if (i > 0) return i; // Primeiro descarta o lixo antes do sync
+        *plen = buf[i + 1];
+        memcpy(payload, buf + i + 2, *plen);
+        *found = true;
+        return n;
+    }
+    return i;
+}
+
+// ============================================================
+// ESTATÍSTICAS
+// ============================================================
+void recorder_wear(const Recorder *r, uint32_t *min_erases, uint32_t *max_erases) {
+    *min_erases = UINT32_MAX;
+    *max_erases = 0;
+    for (uint32_t s = 0; s < r->num_sectors; s++) {
+        SectorHeader h;
+        const uint32_t erases = read_header(r, s, &h) ? h.erases : 0;
+        if (erases < *min_erases) *min_erases = erases;
+        if (erases > *max_erases) *max_erases = erases;
+    }
+}
+
+float recorder_write_amplification(const Recorder *r) {
+    if (r->stats.payload_bytes == 0) return 0.0f;
+    return (float)r->stats.programmed_bytes / (float)r->stats.payload_bytes;
+}
+
+void recorder_report(const Recorder *r) {
+    uint32_t wear_min, wear_max;
+    recorder_wear(r, &wear_min, &wear_max);
+    printf("[REC] registros %lu (+%lu recuperados) | %lu páginas, %lu apagamentos | "
+           "amplificação %.2fx | desgaste %lu..%lu | páginas rasgadas %lu | erros %lu\n",
+           (unsigned long)r->stats.records, (unsigned long)r->stats.recovered_records,
+           (unsigned long)r->stats.page_programs, (unsigned long)r->stats.sector_erases,
+           recorder_write_amplification(r), (unsigned long)wear_min, (unsigned long)wear_max,
+           (unsigned long)r->stats.torn_pages, (unsigned long)r->stats.flash_errors);
+}
+
+// ============================================================
+// AMOSTRA
+// ============================================================
+void recorder_sample_encode(const RecorderSample *s, uint8_t out[RECORDER_SAMPLE_BYTES]) {
+    put_u32(out, s->timestamp_ms);
+    put_u32(out + 4, s->raw_temp_1);
+    put_u32(out + 8, s->raw_humidity_1);
+    put_u32(out + 12, s->raw_temp_2);
+    put_u32(out + 16, s->raw_humidity_2);
+    out[20] = s->class_index;
+    out[21] = s->confidence;
+}
+
+bool recorder_sample_decode(const uint8_t *payload, uint8_t len, RecorderSample *s) {
+    if (len != RECORDER_SAMPLE_BYTES) return false;
+    s->timestamp_ms = get_u32(payload);
+    s->raw_temp_1 = get_u32(payload + 4);
+    s->raw_humidity_1 = get_u32(payload + 8);
+    s->raw_temp_2 = get_u32(payload + 12);
+    s->raw_humidity_2 = get_u32(payload + 16);
+    s->class_index = payload[20];
+    s->confidence = payload[21];
+    return true;
+}
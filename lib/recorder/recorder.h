@@ -0,0 +1,130 @@
+#ifndef RECORDER_H
+#define RECORDER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lib/recorder/flash_dev.h"
+
+// ============================================================
+// GRAVADOR DE AMOSTRAS EM FLASH (LOG CIRCULAR)
+// Registros vão para um buffer de uma página em RAM; a página só é gravada
+// cheia (ou em recorder_flush), então o append é O(1) e o flash recebe
+// escritas do tamanho da página. Os setores são usados em círculo: ao
+// chegar ao fim da região o setor mais antigo é apagado, o que distribui
+// os apagamentos por igual (wear leveling).
+//
+// Setor: cabeçalho de 16 bytes no início da página 0 (gravado com ela)
+//   u32 magic "PGLG" | u32 seq do setor | u32 apagamentos | u16 0xFFFF | u16 CRC
+// Registro: u8 sync 0x5A | u8 len | payload | u16 CRC-16/CCITT de len+payload
+//   Registros não cruzam páginas; 0xFF no lugar do sync = fim da página.
+//
+// Queda de energia: na abertura o setor de seq mais alto é varrido; uma
+// página com prefixo válido seguido de 0xFF continua de onde parou, uma
+// página rasgada (lixo depois do prefixo) é abandonada. Perde-se no máximo
+// o que estava no buffer em RAM.
+// ============================================================
+
+#define RECORDER_REGION_BYTES   (256u * 1024u)  // Região reservada (64 setores)
+#define RECORDER_MAGIC          0x474C4750u  // "PGLG"
+#define RECORDER_HEADER_BYTES   16u
+#define RECORDER_SYNC           0x5A
+#define RECORDER_FRAME_OVERHEAD 4u
+#define RECORDER_MAX_PAYLOAD    (FLASH_DEV_PAGE_BYTES - RECORDER_HEADER_BYTES - RECORDER_FRAME_OVERHEAD)
+
+typedef struct {
+    uint32_t records;           // Registros aceitos por recorder_append
+    uint32_t payload_bytes;
+    uint32_t programmed_bytes;  // Bytes enviados ao flash (páginas inteiras)
+    uint32_t page_programs;
+    uint32_t sector_erases;
+    uint32_t recovered_records; // Achados na abertura
+    uint32_t torn_pages;        // Páginas abandonadas na abertura
+    uint32_t flash_errors;
+} RecorderStats;
+
+typedef struct {
+    FlashDevice dev;
+    uint32_t num_sectors;
+    bool has_sector;            // false: região vazia, o 1º append inicia o setor 0
+    uint32_t sector;            // Setor de escrita
+    uint32_t seq;               // Seq do setor de escrita
+    uint32_t page;              // Página de escrita dentro do setor
+    uint8_t buf[FLASH_DEV_PAGE_BYTES];
+    uint32_t used;              // Bytes ocupados em buf (inclui o cabeçalho na página 0)
+    uint32_t flushed;           // Bytes de buf já gravados
+    RecorderStats stats;
+} Recorder;
+
+// Varre a região e posiciona a escrita depois do último registro válido.
+// Não escreve no flash. false se a região não tem o tamanho certo.
+bool recorder_open(Recorder *r, const FlashDevice *dev);
+
+// Copia o registro para o buffer; grava a página anterior se ela encheu.
+// false se o payload é grande demais ou o flash falhou.
+bool recorder_append(Recorder *r, const void *payload, uint8_t len);
+
+// Grava a página parcial (ela continua sendo preenchida depois)
+bool recorder_flush(Recorder *r);
+
+// Apaga a região inteira
+bool recorder_erase_all(Recorder *r);
+
+// Menor e maior contagem de apagamentos entre os setores com cabeçalho
+void recorder_wear(const Recorder *r, uint32_t *min_erases, uint32_t *max_erases);
+
+// Bytes gravados no flash por byte de payload
+float recorder_write_amplification(const Recorder *r);
+
+void recorder_report(const Recorder *r);
+
+// ---- Leitura, do registro mais antigo ao mais novo (só o que está no flash) ----
+typedef struct {
+    const Recorder *r;
+    uint32_t visited;           // Setores já percorridos
+    uint32_t sector;
+    uint32_t offset;            // Próximo byte dentro do setor
+    bool sector_valid;
+    uint8_t page[FLASH_DEV_PAGE_BYTES];
+    uint32_t loaded;            // Offset da página em `page` (UINT32_MAX: nenhuma)
+} RecorderCursor;
+
+void recorder_cursor_init(RecorderCursor *c, const Recorder *r);
+bool recorder_cursor_next(RecorderCursor *c, uint8_t *payload, uint8_t *len);
+
+// Envia os registros (quadros completos, como estão no flash) a `write`.
+// Retorna quantos registros saíram.
+uint32_t recorder_dump(Recorder *r, void (*write)(void *ctx, const uint8_t *data, size_t len),
+                       void *ctx);
+
+// Procura o próximo quadro válido em buf (dump capturado). Mesma convenção
+// de telemetry_decode: retorna quantos bytes consumir; *found indica se
+// payload/len foram preenchidos; 0 = faltam dados.
+size_t recorder_frame_decode(const uint8_t *buf, size_t len, uint8_t *payload, uint8_t *plen,
+                             bool *found);
+
+// ---- Amostra gravada pelo firmware ----
+#define RECORDER_SAMPLE_BYTES 22u
+
+typedef struct {
+    uint32_t timestamp_ms;
+    uint32_t raw_temp_1;        // Códigos brutos de 20 bits do AHT20
+    uint32_t raw_humidity_1;
+    uint32_t raw_temp_2;
+    uint32_t raw_humidity_2;
+    uint8_t class_index;        // Classe prevista pelo modelo
+    uint8_t confidence;         // 0..255
+} RecorderSample;
+
+void recorder_sample_encode(const RecorderSample *s, uint8_t out[RECORDER_SAMPLE_BYTES]);
+bool recorder_sample_decode(const uint8_t *payload, uint8_t len, RecorderSample *s);
+
+// Plataforma: região reservada no fim do flash (flash_rp2040.c) ou arquivo
+// em PREDAGUARD_FLASH (flash_file.c). false = sem gravador.
+bool recorder_platform_flash(FlashDevice *out);
+
+// Plataforma: saída do dump (USB CDC cru no Pico, stdout no host)
+void recorder_platform_dump_write(void *ctx, const uint8_t *data, size_t len);
+
+#endif
@@ -0,0 +1,111 @@
+#include "scheduler.h"
+
+#include <string.h>
+
+#include "hardware/sync.h"
+
+// Roda no contexto do alarme (IRQ): só conta o tick e acorda o WFE
+static bool on_tick(repeating_timer_t *rt) {
+    SampleScheduler *s = (SampleScheduler *)rt->user_data;
+    s->ticks_fired++;
+    __sev();
+    return true;
+}
+
+bool sched_init(SampleScheduler *s, uint32_t period_us) {
+    memset(s, 0, sizeof(*s));
+    s->period_us = period_us;
+    s->start_us = time_us_64();
+    return add_repeating_timer_us(-(int64_t)period_us, on_tick, s, &s->timer);
+}
+
+void sched_stop(SampleScheduler *s) {
+    cancel_repeating_timer(&s->timer);
+}
+
+uint64_t sched_wait_tick(SampleScheduler *s) {
+    uint64_t now = time_us_64();
+    if (s->ticks_handled > 0) s->busy_us += now - s->busy_since_us;
+
+    uint32_t fired;
+    while ((fired = s->ticks_fired) == s->ticks_handled) {
+        __wfe();
+    }
+    if (fired - s->ticks_handled > 1) s->overruns += fired - s->ticks_handled - 1;
+    s->ticks_handled = fired;
+
+    now = time_us_64();
+    const uint64_t due = s->start_us + (uint64_t)fired * s->period_us;
+    const uint32_t late = now > due ? (uint32_t)(now - due) : 0;
+    s->jitter_us[s->jitter_count % SCHED_JITTER_WINDOW] = late;
+    s->jitter_count++;
+    if (late > s->jitter_max_us) s->jitter_max_us = late;
+    s->busy_since_us = now;
+    return due;
+}
+
+bool sched_push(SampleScheduler *s, uint64_t due_us, const SensorReadings *r) {
+    if (s->queue_count == SCHED_QUEUE_DEPTH) {
+        s->dropped++;
+        return false;
+    }
+    ScheduledSample *slot = &s->queue[(s->queue_head + s->queue_count) % SCHED_QUEUE_DEPTH];
+    slot->seq = s->ticks_handled;
+    slot->due_us = due_us;
+    slot->acquired_us = time_us_64();
+    slot->readings = *r;
+    s->queue_count++;
+    s->samples++;
+    return true;
+}
+
+void sched_drop(SampleScheduler *s) {
+    s->dropped++;
+}
+
+bool sched_pop(SampleScheduler *s, ScheduledSample *out) {
+    if (s->queue_count == 0) return false;
+    *out = s->queue[s->queue_head];
+    s->queue_head = (s->queue_head + 1) % SCHED_QUEUE_DEPTH;
+    s->queue_count--;
+    return true;
+}
+
+void sched_jitter(const SampleScheduler *s, SchedJitter *out) {
+    uint32_t sorted[SCHED_JITTER_WINDOW];
+    const uint32_t n = s->jitter_count < SCHED_JITTER_WINDOW ? s->jitter_count : SCHED_JITTER_WINDOW;
+    memset(out, 0, sizeof(*out));
+    if (n == 0) return;
+
+    // Ordenação por inserção: a janela é pequena e o relatório é raro
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t v = s->jitter_us[i];
+        uint32_t j = i;
+        while (j > 0 && sorted[j - 1] > v) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = v;
+    }
+    // Percentil por posto mais próximo
+    out->p50_us = sorted[(n * 50 + 99) / 100 - 1];
+    out->p90_us = sorted[(n * 90 + 99) / 100 - 1];
+    out->p99_us = sorted[(n * 99 + 99) / 100 - 1];
+    out->max_us = s->jitter_max_us;
+}
+
+float sched_utilization(const SampleScheduler *s) {
+    if (s->ticks_handled == 0) return 0.0f;
+    return (float)s->busy_us / ((float)s->ticks_handled * (float)s->period_us);
+}
+
+void sched_report(const SampleScheduler *s) {
+    SchedJitter j;
+    sched_jitter(s, &j);
+    printf("[SCHED] período %lu us | ticks %lu | amostras %lu | overruns %lu | descartes %lu | "
+           "jitter p50 %lu p90 %lu p99 %lu max %lu us | ocupação %.1f%%\n",
+           (unsigned long)s->period_us, (unsigned long)s->ticks_handled,
+           (unsigned long)s->samples, (unsigned long)s->overruns, (unsigned long)s->dropped,
+           (unsigned long)j.p50_us, (unsigned long)j.p90_us, (unsigned long)j.p99_us,
+           (unsigned long)j.max_us, sched_utilization(s) * 100.0f);
+}
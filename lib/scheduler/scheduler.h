@@ -0,0 +1,87 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "pico/stdlib.h"
+#include "lib/sensors/sensors.h"
+
+// ============================================================
+// AGENDADOR DE AMOSTRAGEM
+// Um alarme de hardware (add_repeating_timer_us com atraso negativo = taxa
+// fixa) marca a grade de amostragem; o callback só conta o tick. O loop
+// espera o tick, coleta a leitura e a enfileira para a inferência. Trabalho
+// lento não desloca a grade: aparece como jitter e, passando de um período,
+// como overrun.
+//
+// No build host o alarme corre no relógio virtual (ver host/include/pico/time.h).
+// ============================================================
+
+#define SCHED_QUEUE_DEPTH     4    // Amostras aguardando a inferência
+#define SCHED_JITTER_WINDOW   128  // Atrasos guardados para os percentis
+
+typedef struct {
+    uint32_t seq;              // Número do tick (1 = primeiro)
+    uint64_t due_us;           // Instante ideal na grade do alarme
+    uint64_t acquired_us;      // Quando a leitura foi coletada
+    SensorReadings readings;
+} ScheduledSample;
+
+typedef struct {
+    uint32_t p50_us;
+    uint32_t p90_us;
+    uint32_t p99_us;
+    uint32_t max_us;           // Desde o início, não só da janela
+} SchedJitter;
+
+typedef struct {
+    uint32_t period_us;
+    uint64_t start_us;
+    repeating_timer_t timer;
+    volatile uint32_t ticks_fired;   // Escrito só pelo callback do alarme
+    uint32_t ticks_handled;
+
+    // Fila aquisição -> inferência
+    ScheduledSample queue[SCHED_QUEUE_DEPTH];
+    uint8_t queue_head;
+    uint8_t queue_count;
+
+    // Estatísticas
+    uint32_t samples;          // Amostras enfileiradas
+    uint32_t overruns;         // Ticks perdidos: o loop chegou depois do tick seguinte
+    uint32_t dropped;          // Ticks sem amostra: sensor não pronto ou fila cheia
+    uint64_t busy_us;          // Tempo entre pegar o tick e voltar a esperar
+    uint64_t busy_since_us;
+    uint32_t jitter_us[SCHED_JITTER_WINDOW];
+    uint32_t jitter_count;
+    uint32_t jitter_max_us;
+} SampleScheduler;
+
+// Inicia o alarme com o período dado; false se não houver alarme livre
+bool sched_init(SampleScheduler *s, uint32_t period_us);
+void sched_stop(SampleScheduler *s);
+
+// Espera o próximo tick (WFE) e retorna o instante ideal dele. Ticks vencidos
+// enquanto o loop trabalhava contam como overrun; o mais recente é o atendido.
+uint64_t sched_wait_tick(SampleScheduler *s);
+
+// Enfileira a leitura do tick; com a fila cheia a amostra é descartada
+bool sched_push(SampleScheduler *s, uint64_t due_us, const SensorReadings *r);
+
+// Tick atendido sem leitura (ex.: conversão do AHT20 ainda em curso)
+void sched_drop(SampleScheduler *s);
+
+// Próxima amostra para a inferência; false com a fila vazia
+bool sched_pop(SampleScheduler *s, ScheduledSample *out);
+
+// Percentis do atraso entre o tick e a coleta, na janela mais recente
+void sched_jitter(const SampleScheduler *s, SchedJitter *out);
+
+// Fração do período ocupada pelo loop (0..1), base para a folga
+float sched_utilization(const SampleScheduler *s);
+
+// Uma linha com período, ticks, overruns, descartes, jitter e ocupação
+void sched_report(const SampleScheduler *s);
+
+#endif
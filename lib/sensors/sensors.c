@@ -1,5 +1,8 @@
 #include "sensors.h"
 
+static AHT20_Async aht_1;  // I2C0
+static AHT20_Async aht_2;  // I2C1
+
 void init_i2c_sensor() {
     // Inicializa I2C0 para primeiro sensor AHT20
     i2c_init(I2C_PORT_0, 400 * 1000);
@@ -24,33 +27,67 @@ void init_aht20() {
     // Inicializa sensor 2 (I2C1)
     aht20_reset(I2C_PORT_1);
     aht20_init(I2C_PORT_1);
+
+    aht20_async_init(&aht_1, I2C_PORT_0);
+    aht20_async_init(&aht_2, I2C_PORT_1);
 }
 
-SensorReadings get_sensor_readings() {
-    SensorReadings data;
-    AHT20_Data aht1, aht2;
+void sensors_start_conversion() {
+    // Dispara os dois sensores juntos: as conversões correm em paralelo
+    aht20_async_start(&aht_1);
+    aht20_async_start(&aht_2);
+}
+
+bool sensors_poll(SensorReadings *out) {
+    AHT20_AsyncState s1 = aht20_async_poll(&aht_1);
+    AHT20_AsyncState s2 = aht20_async_poll(&aht_2);
+    if (s1 == AHT20_ASYNC_CONVERTING || s2 == AHT20_ASYNC_CONVERTING) {
+        return false;
+    }
 
-    // Lê sensor 1 (I2C0)
-    if (aht20_read(I2C_PORT_0, &aht1)) {
-        data.aht_temp_1 = aht1.temperature;
-        data.humidity_1 = aht1.humidity;
+    if (s1 == AHT20_ASYNC_READY) {
+        out->aht_temp_1 = aht_1.data.temperature;
+        out->humidity_1 = aht_1.data.humidity;
+        out->raw_temp_1 = aht_1.data.raw_temperature;
+        out->raw_humidity_1 = aht_1.data.raw_humidity;
     } else {
-        data.aht_temp_1 = 0;
-        data.humidity_1 = 0;
+        out->aht_temp_1 = 0;
+        out->humidity_1 = 0;
+        out->raw_temp_1 = AHT20_RAW_TEMP_ZERO_C;
+        out->raw_humidity_1 = 0;
     }
 
-    // Lê sensor 2 (I2C1)
-    if (aht20_read(I2C_PORT_1, &aht2)) {
-        data.aht_temp_2 = aht2.temperature;
-        data.humidity_2 = aht2.humidity;
+    if (s2 == AHT20_ASYNC_READY) {
+        out->aht_temp_2 = aht_2.data.temperature;
+        out->humidity_2 = aht_2.data.humidity;
+        out->raw_temp_2 = aht_2.data.raw_temperature;
+        out->raw_humidity_2 = aht_2.data.raw_humidity;
     } else {
-        data.aht_temp_2 = 0;
-        data.humidity_2 = 0;
+        out->aht_temp_2 = 0;
+        out->humidity_2 = 0;
+        out->raw_temp_2 = AHT20_RAW_TEMP_ZERO_C;
+        out->raw_humidity_2 = 0;
     }
 
+    aht_1.state = AHT20_ASYNC_IDLE;
+    aht_2.state = AHT20_ASYNC_IDLE;
+
     // Debug (descomente conforme necessário):
-    // printf("AHT20 #1 - Temp: %.2f C, Humidity: %.2f %%\n", data.aht_temp_1, data.humidity_1);
-    // printf("AHT20 #2 - Temp: %.2f C, Humidity: %.2f %%\n\n", data.aht_temp_2, data.humidity_2);
+    // printf("AHT20 #1 - Temp: %.2f C, Humidity: %.2f %%\n", out->aht_temp_1, out->humidity_1);
+    // printf("AHT20 #2 - Temp: %.2f C, Humidity: %.2f %%\n\n", out->aht_temp_2, out->humidity_2);
 
+    return true;
+}
+
+SensorReadings sensors_wait_readings() {
+    SensorReadings data;
+    while (!sensors_poll(&data)) {
+        sleep_ms(1);
+    }
     return data;
-}
\ No newline at end of file
+}
+
+SensorReadings get_sensor_readings() {
+    sensors_start_conversion();
+    return sensors_wait_readings();
+}
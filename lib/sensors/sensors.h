@@ -22,10 +22,23 @@ typedef struct {
     float humidity_1;   // Sensor 1
     float aht_temp_2;   // Sensor 2
     float humidity_2;   // Sensor 2
+    // Códigos brutos de 20 bits do AHT20 (mesma leitura, sem conversão para float)
+    uint32_t raw_temp_1;
+    uint32_t raw_humidity_1;
+    uint32_t raw_temp_2;
+    uint32_t raw_humidity_2;
 } SensorReadings;
 
 void init_i2c_sensor();
 void init_aht20();
+
+// Leitura bloqueante (dispara e aguarda os dois sensores em paralelo)
 SensorReadings get_sensor_readings();
 
-#endif
\ No newline at end of file
+// Leitura sobreposta: dispara a conversão nos dois barramentos ao mesmo tempo,
+// o loop faz outro trabalho e coleta depois. Sensor com falha lê 0, como antes.
+void sensors_start_conversion();
+bool sensors_poll(SensorReadings *out);   // true quando os dois terminaram
+SensorReadings sensors_wait_readings();
+
+#endif
\ No newline at end of file
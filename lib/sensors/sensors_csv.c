@@ -0,0 +1,144 @@
+// Backend de sensores para o build host: reproduz capturas *_differential_bruto.csv
+// (timestamp,t_ex,u_ex,t_amb,u_amb,...) através de get_sensor_readings().
+//
+// PREDAGUARD_CSV   lista de arquivos separados por ':' (padrão: as três capturas
+//                  de Notebooks/Data)
+// PREDAGUARD_LOOPS número de passadas sobre a lista (padrão: 1)
+//
+// Ao fim do replay o relatório do host_bench é impresso e o processo encerra.
+#include "sensors.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "host/host_bench.h"
+
+#ifndef PREDAGUARD_DATA_DIR
+#define PREDAGUARD_DATA_DIR "Notebooks/Data"
+#endif
+
+#define MAX_CSV_FILES 16
+#define MAX_PATH_LEN  512
+
+static char csv_paths[MAX_CSV_FILES][MAX_PATH_LEN];
+static int csv_count = 0;
+static int csv_index = 0;
+static int loops_left = 1;
+static FILE *csv_file = NULL;
+
+static void add_csv_path(const char *path, size_t len) {
+    if (csv_count >= MAX_CSV_FILES || len == 0 || len >= MAX_PATH_LEN) return;
+    memcpy(csv_paths[csv_count], path, len);
+    csv_paths[csv_count][len] = '\0';
+    csv_count++;
+}
+
+void init_i2c_sensor() {
+    const char *list = getenv("PREDAGUARD_CSV");
+    if (list && *list) {
+        const char *p = list;
+        while (*p) {
+            const char *sep = strchr(p, ':');
+            size_t len = sep ? (size_t)(sep - p) : strlen(p);
+            add_csv_path(p, len);
+            p += len + (sep ? 1 : 0);
+        }
+    } else {
+        static const char *const defaults[] = {
+            PREDAGUARD_DATA_DIR "/idle_differential_bruto.csv",
+            PREDAGUARD_DATA_DIR "/gaming_differential_bruto.csv",
+            PREDAGUARD_DATA_DIR "/obstrucao_differential_bruto.csv",
+        };
+        for (size_t i = 0; i < sizeof(defaults) / sizeof(defaults[0]); i++) {
+            add_csv_path(defaults[i], strlen(defaults[i]));
+        }
+    }
+
+    const char *loops = getenv("PREDAGUARD_LOOPS");
+    if (loops && atoi(loops) > 0) loops_left = atoi(loops);
+}
+
+void init_aht20() {
+    csv_index = 0;
+}
+
+// Código bruto de 20 bits mais próximo do valor gravado na captura
+static uint32_t aht20_encode(float value, float offset, float span) {
+    float code = (value + offset) * (float)AHT20_RAW_FULL_SCALE / span + 0.5f;
+    if (code <= 0.0f) return 0;
+    if (code >= (float)(AHT20_RAW_FULL_SCALE - 1)) return AHT20_RAW_FULL_SCALE - 1;
+    return (uint32_t)code;
+}
+
+static uint32_t aht20_encode_temperature(float t) { return aht20_encode(t, 50.0f, 200.0f); }
+static uint32_t aht20_encode_humidity(float h) { return aht20_encode(h, 0.0f, 100.0f); }
+
+// Abre o próximo arquivo da lista; false quando o replay terminou.
+static bool open_next_csv(void) {
+    while (true) {
+        if (csv_index >= csv_count) {
+            if (--loops_left <= 0) return false;
+            csv_index = 0;
+        }
+        const char *path = csv_paths[csv_index++];
+        csv_file = fopen(path, "r");
+        if (csv_file) return true;
+        fprintf(stderr, "[CSV] Não foi possível abrir %s\n", path);
+    }
+}
+
+// Próxima linha válida do replay; encerra o processo no fim
+static SensorReadings next_csv_row(void) {
+    SensorReadings data;
+    char line[256];
+
+    while (true) {
+        if (!csv_file && !open_next_csv()) {
+            host_bench_finish();
+        }
+        if (!fgets(line, sizeof(line), csv_file)) {
+            fclose(csv_file);
+            csv_file = NULL;
+            continue;
+        }
+
+        // timestamp, t_ex, u_ex, t_amb, u_amb; linhas que não parseiam (ex.: cabeçalho) são ignoradas
+        char *p = line;
+        char *end;
+        float fields[5];
+        int n = 0;
+        for (; n < 5; n++) {
+            fields[n] = strtof(p, &end);
+            if (end == p || (*end != ',' && n < 4)) break;
+            p = end + 1;
+        }
+        if (n < 5) continue;
+
+        data.aht_temp_1 = fields[1];
+        data.humidity_1 = fields[2];
+        data.aht_temp_2 = fields[3];
+        data.humidity_2 = fields[4];
+        data.raw_temp_1 = aht20_encode_temperature(fields[1]);
+        data.raw_humidity_1 = aht20_encode_humidity(fields[2]);
+        data.raw_temp_2 = aht20_encode_temperature(fields[3]);
+        data.raw_humidity_2 = aht20_encode_humidity(fields[4]);
+        return data;
+    }
+}
+
+// No replay não há conversão: a amostra fica pronta assim que é pedida
+void sensors_start_conversion() {
+}
+
+bool sensors_poll(SensorReadings *out) {
+    *out = next_csv_row();
+    return true;
+}
+
+SensorReadings sensors_wait_readings() {
+    return next_csv_row();
+}
+
+SensorReadings get_sensor_readings() {
+    return next_csv_row();
+}
@@ -0,0 +1,169 @@
+#include "telemetry.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "lib/aht20/aht20.h"
+
+#define RING_MASK (TELEMETRY_RING_BYTES - 1)
+_Static_assert((TELEMETRY_RING_BYTES & RING_MASK) == 0, "TELEMETRY_RING_BYTES deve ser potência de 2");
+
+// Índices livres (não mascarados): head - tail = bytes ocupados. Cada lado
+// publica o próprio índice com release e lê o do outro com acquire.
+static inline uint32_t load_acquire(const uint32_t *p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+static inline void store_release(uint32_t *p, uint32_t v) { __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+
+void telemetry_init(Telemetry *t, TelemetryMode mode, const TelemetrySink *sink) {
+    memset(t, 0, sizeof(*t));
+    t->mode = mode;
+    if (sink) t->sink = *sink;
+}
+
+uint32_t telemetry_pending(const Telemetry *t) {
+    return load_acquire(&t->head) - load_acquire(&t->tail);
+}
+
+uint16_t telemetry_stage_us(uint32_t us) {
+    return us > 0xFFFFu ? 0xFFFFu : (uint16_t)us;
+}
+
+int16_t telemetry_centi(float value) {
+    const float v = value * 100.0f;
+    if (v >= 32767.0f) return 32767;
+    if (v <= -32768.0f) return -32768;
+    return (int16_t)(v < 0.0f ? v - 0.5f : v + 0.5f);
+}
+
+// ============================================================
+// CODIFICAÇÃO
+// ============================================================
+uint16_t telemetry_crc16(const uint8_t *data, size_t len) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static void put_u16(uint8_t *p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static void put_u32(uint8_t *p, uint32_t v) { put_u16(p, (uint16_t)v); put_u16(p + 2, (uint16_t)(v >> 16)); }
+static uint16_t get_u16(const uint8_t *p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint32_t get_u32(const uint8_t *p) { return get_u16(p) | ((uint32_t)get_u16(p + 2) << 16); }
+
+void telemetry_encode(const TelemetryRecord *rec, uint8_t out[TELEMETRY_RECORD_BYTES]) {
+    out[0] = TELEMETRY_SYNC;
+    out[1] = TELEMETRY_VERSION;
+    put_u16(out + 2, rec->seq);
+    put_u32(out + 4, rec->timestamp_ms);
+    put_u32(out + 8, (uint32_t)rec->delta_t_raw);
+    put_u32(out + 12, (uint32_t)rec->delta_u_raw);
+    out[16] = rec->class_index;
+    out[17] = rec->confidence;
+    for (int i = 0; i < TELEMETRY_NUM_STAGES; i++) put_u16(out + 18 + 2 * i, rec->stage_us[i]);
+    put_u16(out + 26, (uint16_t)rec->trend_centi_c_min);
+    put_u16(out + 28, telemetry_crc16(out, 28));
+}
+
+size_t telemetry_decode(const uint8_t *buf, size_t len, TelemetryRecord *rec, bool *found) {
+    *found = false;
+    size_t i = 0;
+    for (; i < len; i++) {
+        if (buf[i] != TELEMETRY_SYNC) continue;
+        if (len - i < TELEMETRY_RECORD_BYTES) return i; // Talvez um registro incompleto
+        const uint8_t *p = buf + i;
+        if (p[1] != TELEMETRY_VERSION || get_u16(p + 28) != telemetry_crc16(p, 28)) continue;
+        if (i > 0) return i; // Primeiro descarta o lixo antes do sync
+
+        rec->seq = get_u16(p + 2);
+        rec->timestamp_ms = get_u32(p + 4);
+        rec->delta_t_raw = (int32_t)get_u32(p + 8);
+        rec->delta_u_raw = (int32_t)get_u32(p + 12);
+        rec->class_index = p[16];
+        rec->confidence = p[17];
+        for (int s = 0; s < TELEMETRY_NUM_STAGES; s++) rec->stage_us[s] = get_u16(p + 18 + 2 * s);
+        rec->trend_centi_c_min = (int16_t)get_u16(p + 26);
+        *found = true;
+        return TELEMETRY_RECORD_BYTES;
+    }
+    return i;
+}
+
+int telemetry_format_text(const TelemetryRecord *rec, char *buf, size_t size) {
+    static const char *const estados[] = {
+        "Estado: IDLE", "Estado: GAMING", "⚠️ ALERTA: ANOMALIA/OBSTRUÇÃO!",
+    };
+    const char *estado = rec->class_index < 3 ? estados[rec->class_index] : "Estado: ?";
+    return snprintf(buf, size, "ΔT: %.2f°C | ΔU: %.2f%% | Trend ΔT: %+.2f°C/min  -> %s (%.1f%%)\n",
+                    rec->delta_t_raw * (200.0 / AHT20_RAW_FULL_SCALE),
+                    rec->delta_u_raw * (100.0 / AHT20_RAW_FULL_SCALE),
+                    rec->trend_centi_c_min / 100.0, estado, rec->confidence * (100.0 / 255.0));
+}
+
+// ============================================================
+// ANEL (produtor)
+// ============================================================
+bool telemetry_push(Telemetry *t, TelemetryRecord *rec) {
+    const uint32_t head = t->head;
+    if (TELEMETRY_RING_BYTES - (head - load_acquire(&t->tail)) < TELEMETRY_RECORD_BYTES) {
+        t->dropped++;
+        return false;
+    }
+    rec->seq = t->next_seq++;
+    uint8_t bytes[TELEMETRY_RECORD_BYTES];
+    telemetry_encode(rec, bytes);
+    for (int i = 0; i < TELEMETRY_RECORD_BYTES; i++) t->ring[(head + i) & RING_MASK] = bytes[i];
+    store_release(&t->head, head + TELEMETRY_RECORD_BYTES);
+    t->written++;
+    return true;
+}
+
+// ============================================================
+// SERVIÇO (consumidor)
+// ============================================================
+static void service_text(Telemetry *t) {
+    uint32_t tail = t->tail;
+    const uint32_t head = load_acquire(&t->head);
+    while (head - tail >= TELEMETRY_RECORD_BYTES) {
+        uint8_t bytes[TELEMETRY_RECORD_BYTES];
+        for (int i = 0; i < TELEMETRY_RECORD_BYTES; i++) bytes[i] = t->ring[(tail + i) & RING_MASK];
+        tail += TELEMETRY_RECORD_BYTES;
+        store_release(&t->tail, tail);
+
+        TelemetryRecord rec;
+        bool found;
+        telemetry_decode(bytes, sizeof(bytes), &rec, &found);
+        char line[128];
+        if (found && telemetry_format_text(&rec, line, sizeof(line)) > 0) fputs(line, stdout);
+    }
+}
+
+static void service_binary(Telemetry *t) {
+    if (!t->sink.send) return;
+    // No máximo duas voltas: fim do anel e depois o começo
+    for (int round = 0; round < 2; round++) {
+        if (t->in_flight) {
+            if (!t->sink.ready(t->sink.ctx)) return;
+            store_release(&t->tail, t->tail + t->in_flight);
+            t->in_flight = 0;
+        }
+        const uint32_t tail = t->tail;
+        const uint32_t used = load_acquire(&t->head) - tail;
+        if (used == 0) return;
+        const uint32_t offset = tail & RING_MASK;
+        const uint32_t contiguous = TELEMETRY_RING_BYTES - offset;
+        t->in_flight = (uint32_t)t->sink.send(t->sink.ctx, &t->ring[offset],
+                                              used < contiguous ? used : contiguous);
+        if (t->in_flight == 0) return;
+    }
+}
+
+void telemetry_service(Telemetry *t) {
+    if (t->mode == TELEMETRY_TEXT) {
+        service_text(t);
+    } else {
+        service_binary(t);
+    }
+}
@@ -0,0 +1,114 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================================
+// TELEMETRIA BINÁRIA
+// Um registro de 30 bytes por amostra no lugar da linha de printf com %.2f.
+// O loop só codifica o registro em um anel SPSC sem trava; quem esvazia o anel
+// é telemetry_service(), chamada na folga antes do próximo tick, entregando
+// blocos contíguos a um "sink" que não bloqueia (DMA para a UART no Pico,
+// arquivo no host). Anel cheio = registro descartado e contado, nunca espera.
+//
+// Formato (little-endian):
+//   0  u8  sync (0xA5)          16  u8  classe
+//   1  u8  versão (1)           17  u8  confiança (0..255 = 0..100%)
+//   2  u16 seq                  18  u16 estágio sensores (us, saturado)
+//   4  u32 timestamp (ms)       20  u16 estágio preproc
+//   8  i32 ΔT bruto (códigos)   22  u16 estágio inferência
+//   12 i32 ΔU bruto (códigos)   24  u16 estágio saída
+//                               26  i16 tendência ΔT (0,01 °C/min)
+//                               28  u16 CRC-16/CCITT dos bytes 0..27
+// sync + CRC permitem ao decodificador ressincronizar no meio de texto.
+//
+// Modo texto (opcional): o mesmo anel, mas o serviço formata cada registro
+// na linha legível de antes e imprime com printf.
+// ============================================================
+
+#define TELEMETRY_SYNC          0xA5
+#define TELEMETRY_VERSION       1
+#define TELEMETRY_RECORD_BYTES  30
+#define TELEMETRY_RING_BYTES    1024   // Potência de 2; ~34 registros
+
+typedef enum {
+    TELEMETRY_STAGE_SENSORES = 0,
+    TELEMETRY_STAGE_PREPROC,
+    TELEMETRY_STAGE_INFERENCIA,
+    TELEMETRY_STAGE_SAIDA,
+    TELEMETRY_NUM_STAGES
+} TelemetryStage;
+
+typedef struct {
+    uint16_t seq;
+    uint32_t timestamp_ms;
+    int32_t delta_t_raw;        // raw_temp_1 - raw_temp_2
+    int32_t delta_u_raw;        // raw_humidity_1 - raw_humidity_2
+    uint8_t class_index;
+    uint8_t confidence;         // Probabilidade * 255
+    uint16_t stage_us[TELEMETRY_NUM_STAGES];
+    int16_t trend_centi_c_min;  // Tendência de ΔT em 0,01 °C/min
+} TelemetryRecord;
+
+// Saída do anel. send() inicia o envio sem bloquear e retorna quantos bytes
+// aceitou (0 = ocupado); os bytes aceitos ficam intocados até ready().
+typedef struct {
+    size_t (*send)(void *ctx, const uint8_t *data, size_t len);
+    bool (*ready)(void *ctx);
+    void *ctx;
+} TelemetrySink;
+
+typedef enum {
+    TELEMETRY_BINARY = 0,
+    TELEMETRY_TEXT,
+} TelemetryMode;
+
+typedef struct {
+    TelemetryMode mode;
+    TelemetrySink sink;
+    uint8_t ring[TELEMETRY_RING_BYTES];
+    uint32_t head;              // Escrito só pelo produtor (loop)
+    uint32_t tail;              // Escrito só pelo consumidor (serviço)
+    uint32_t in_flight;         // Bytes entregues ao sink e ainda não liberados
+    uint16_t next_seq;
+    uint32_t written;
+    uint32_t dropped;
+} Telemetry;
+
+// sink pode ser NULL no modo texto
+void telemetry_init(Telemetry *t, TelemetryMode mode, const TelemetrySink *sink);
+
+// Produtor: codifica e enfileira; false (e dropped++) com o anel cheio.
+// Preenche rec->seq.
+bool telemetry_push(Telemetry *t, TelemetryRecord *rec);
+
+// Consumidor: entrega o que houver ao sink (ou imprime, no modo texto)
+void telemetry_service(Telemetry *t);
+
+// Bytes aguardando envio
+uint32_t telemetry_pending(const Telemetry *t);
+
+// Sink da plataforma: DMA para a UART0 no Pico (telemetry_uart_dma.c) ou
+// arquivo em PREDAGUARD_TELEMETRY no host (telemetry_file.c). false = sem
+// saída binária, use o modo texto.
+bool telemetry_platform_sink(TelemetrySink *out);
+
+// ---- Codificação (também usada pelo decodificador host) ----
+uint16_t telemetry_crc16(const uint8_t *data, size_t len);
+void telemetry_encode(const TelemetryRecord *rec, uint8_t out[TELEMETRY_RECORD_BYTES]);
+
+// Procura o próximo registro válido em buf. Retorna quantos bytes consumir:
+// com *found = true o registro está em *rec; com *found = false os bytes
+// consumidos são lixo (ou 0 se faltam dados para decidir).
+size_t telemetry_decode(const uint8_t *buf, size_t len, TelemetryRecord *rec, bool *found);
+
+// Linha legível (mesmo texto do printf original, com \n); retorna o tamanho
+int telemetry_format_text(const TelemetryRecord *rec, char *buf, size_t size);
+
+// Saturações usadas pelo produtor
+uint16_t telemetry_stage_us(uint32_t us);
+int16_t  telemetry_centi(float value);   // value * 100, arredondado e saturado
+
+#endif
@@ -0,0 +1,34 @@
+// Sink de telemetria do build host: grava os registros binários no arquivo
+// indicado por PREDAGUARD_TELEMETRY (sem a variável, o firmware usa o modo
+// texto). A escrita é síncrona, então o sink está sempre pronto.
+#include "telemetry.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static FILE *telemetry_file = NULL;
+
+static size_t file_send(void *ctx, const uint8_t *data, size_t len) {
+    size_t n = fwrite(data, 1, len, (FILE *)ctx);
+    fflush((FILE *)ctx);
+    return n;
+}
+
+static bool file_ready(void *ctx) {
+    (void)ctx;
+    return true;
+}
+
+bool telemetry_platform_sink(TelemetrySink *out) {
+    const char *path = getenv("PREDAGUARD_TELEMETRY");
+    if (!path || !*path) return false;
+    if (!telemetry_file) telemetry_file = fopen(path, "wb");
+    if (!telemetry_file) {
+        fprintf(stderr, "[TELEMETRIA] Não foi possível abrir %s\n", path);
+        return false;
+    }
+    out->send = file_send;
+    out->ready = file_ready;
+    out->ctx = telemetry_file;
+    return true;
+}
@@ -0,0 +1,47 @@
+// Sink de telemetria do firmware: um canal de DMA empurra o bloco do anel
+// para a FIFO de TX da UART0, pacejado pelo DREQ, sem CPU no caminho.
+// No modo binário o stdio fica só na USB (ver CMakeLists.txt): a UART0 é
+// inteira do DMA, sem texto intercalado nos registros nem uart_putc bloqueante
+// disputando a FIFO de TX.
+#include "telemetry.h"
+
+#include "hardware/dma.h"
+#include "hardware/gpio.h"
+#include "hardware/uart.h"
+
+static int dma_chan = -1;
+
+static size_t dma_send(void *ctx, const uint8_t *data, size_t len) {
+    (void)ctx;
+    if (dma_channel_is_busy((uint)dma_chan)) return 0;
+    dma_channel_set_read_addr((uint)dma_chan, data, false);
+    dma_channel_set_trans_count((uint)dma_chan, len, true);
+    return len;
+}
+
+static bool dma_ready(void *ctx) {
+    (void)ctx;
+    return !dma_channel_is_busy((uint)dma_chan);
+}
+
+bool telemetry_platform_sink(TelemetrySink *out) {
+    if (dma_chan < 0) {
+        dma_chan = dma_claim_unused_channel(false);
+        if (dma_chan < 0) return false;
+
+        // Sem stdio na UART0, ninguém mais a inicializa
+        uart_init(uart0, PICO_DEFAULT_UART_BAUD_RATE);
+        gpio_set_function(PICO_DEFAULT_UART_TX_PIN, GPIO_FUNC_UART);
+
+        dma_channel_config cfg = dma_channel_get_default_config((uint)dma_chan);
+        channel_config_set_transfer_data_size(&cfg, DMA_SIZE_8);
+        channel_config_set_read_increment(&cfg, true);
+        channel_config_set_write_increment(&cfg, false);
+        channel_config_set_dreq(&cfg, DREQ_UART0_TX);
+        dma_channel_configure((uint)dma_chan, &cfg, &uart_get_hw(uart0)->dr, NULL, 0, false);
+    }
+    out->send = dma_send;
+    out->ready = dma_ready;
+    out->ctx = NULL;
+    return true;
+}
@@ -1,16 +1,507 @@
 #include <stdio.h>
 #include "pico/stdlib.h"
 #include "lib/sensors/sensors.h"
+#include "lib/buttons/buttons.h"
+#include "lib/events/events.h"
+#include "lib/features/features.h"
+#include "lib/model_slot/model_slot.h"
+#include "lib/pipeline/pipeline.h"
+#include "lib/preproc/preproc.h"
+#include "lib/recorder/recorder.h"
+#include "lib/scheduler/scheduler.h"
+#include "lib/telemetry/telemetry.h"
 #include "tflm_wrapper.h"
-#include "modelo_predator.h" // Onde estará o seu novo modelo exportado
+#include "modelo_predator_norm.h"
+#ifdef PREDAGUARD_PIPELINE
+#include "hardware/sync.h"
+#include "lib/pipeline/core_task.h"
+#endif
+#ifdef PREDAGUARD_GATE
+#include "lib/gate/gate.h"
+#include "modelo_predator_gate.h"
+#endif
+#include "lib/latency/latency.h"
 
 // ============================================================
 // CONSTANTES DE NORMALIZAÇÃO (Z-SCORE)
 // ============================================================
-const float MEAN_DELTA_T = 15.65084995f;
-const float STD_DELTA_T  = 6.99135624f;
-const float MEAN_DELTA_U = -38.53349043f;
-const float STD_DELTA_U  = 12.27171964f;
+// Geradas pelo host/tools/dataset_build junto com o dataset de treino
+const float MEAN_DELTA_T = MODELO_NORM_MEAN_DELTA_T;
+const float STD_DELTA_T  = MODELO_NORM_STD_DELTA_T;
+const float MEAN_DELTA_U = MODELO_NORM_MEAN_DELTA_U;
+const float STD_DELTA_U  = MODELO_NORM_STD_DELTA_U;
+
+// ============================================================
+// AMOSTRAGEM
+// Período fixo do alarme. O AHT20 leva 80 ms por conversão, então o limite
+// prático é ~12 Hz; o relatório [SCHED] mostra a folga antes de encurtar.
+// ============================================================
+#define SAMPLE_PERIOD_US   500000u  // 2 Hz
+#define SCHED_REPORT_TICKS 120u     // Relatório a cada minuto
+#define FEAT_WINDOW_SAMPLES 20u     // Janela das features temporais (10 s)
+#define STABLE_THRESHOLD 3          // Leituras iguais necessárias para trocar o LED
+
+// ============================================================
+// AQUISIÇÃO (core 1 no modo pipeline)
+// ============================================================
+typedef struct {
+    SampleScheduler scheduler;
+    FeatureEngine features;
+    PreprocFixed preproc;
+    bool preproc_int8;      // Modelo int8 só de ΔT/ΔU: direto dos códigos brutos
+    uint32_t model_epoch;   // Troca de modelo para a qual o preproc foi montado
+    int num_inputs;
+    FeatNormalization norm;
+} Acquisition;
+
+// Constantes do ponto fixo para a quantização de entrada do modelo ativo
+static bool preproc_for_active_model(PreprocFixed *p) {
+    return preproc_fixed_init(p, MEAN_DELTA_T, STD_DELTA_T, MEAN_DELTA_U, STD_DELTA_U,
+                              tflm_input_scale(), tflm_input_zero_point());
+}
+
+// 3-5. Espera o tick, lê os sensores e prepara as entradas do modelo.
+// false quando o tick não rendeu amostra.
+static bool acquire_sample(Acquisition *acq, PipelineSample *out) {
+    // 3. Aquisição no tick do alarme: a grade não depende do trabalho abaixo
+    const uint64_t due_us = sched_wait_tick(&acq->scheduler);
+    SensorReadings lida;
+    LATENCY_BEGIN(lat_i2c);
+    if (sensors_poll(&lida)) {
+        sensors_start_conversion(); // Próxima conversão sobrepõe inferência/serial
+        sched_push(&acq->scheduler, due_us, &lida);
+    } else {
+        sched_drop(&acq->scheduler); // Conversão ainda em curso: período curto demais
+    }
+    const uint32_t sensores_us = LATENCY_END(LAT_I2C, lat_i2c);
+
+    if (acq->scheduler.ticks_handled % SCHED_REPORT_TICKS == 0) sched_report(&acq->scheduler);
+
+    ScheduledSample amostra;
+    if (!sched_pop(&acq->scheduler, &amostra)) return false;
+    out->seq = amostra.seq;
+    out->due_us = amostra.due_us;
+    out->readings = amostra.readings;
+
+    // 4. Cálculo do Diferencial (Física do Problema), em códigos brutos nas janelas
+    LATENCY_BEGIN(lat_preproc);
+    feat_engine_push(&acq->features, &out->readings);
+
+    // 5. Pré-processamento (Normalização idêntica ao Treino)
+    //    Entrada int8: códigos brutos -> tensor em ponto fixo; entrada float: z-score em float
+    //    + features da janela
+    //    Depois de uma troca de modelo a quantização de entrada pode ser outra
+    const uint32_t epoch = tflm_model_epoch();
+    if (epoch != acq->model_epoch) {
+        acq->model_epoch = epoch;
+        if (acq->preproc_int8) preproc_for_active_model(&acq->preproc);
+    }
+    out->model_epoch = epoch;
+    out->quantized = acq->preproc_int8;
+    if (acq->preproc_int8) {
+        preproc_fixed_quantize(&acq->preproc, &out->readings, out->inputs_q);
+    } else {
+        feat_engine_model_inputs(&acq->features, &out->readings, &acq->norm, out->inputs,
+                                 acq->num_inputs);
+    }
+    out->trend_centi_c_min =
+        telemetry_centi(feat_engine_trend_delta_t(&acq->features, SAMPLE_PERIOD_US));
+    out->sensores_us = telemetry_stage_us(sensores_us);
+    out->preproc_us = telemetry_stage_us(LATENCY_END(LAT_PREPROC, lat_preproc));
+    return true;
+}
+
+// ============================================================
+// INFERÊNCIA E SAÍDA (sempre no core 0)
+// ============================================================
+typedef struct {
+    int current_state;      // Estado estável atual exibido pelos LEDs
+    int stable_count;       // Contador de leituras consecutivas iguais
+    Telemetry telemetry;
+    Recorder *recorder;     // NULL: sem gravador em flash
+    struct ModelSlots *modelos; // NULL: sem slots de modelo
+    EventQueue *eventos;    // Interrupções (botões) tratadas no loop
+    PreprocFixed preproc;   // Quantização do modelo ativo, para amostras de antes de uma troca
+    uint32_t inferencias;
+#ifdef PREDAGUARD_GATE
+    Gate gate;              // Regiões conferidas para o modelo embarcado
+    uint32_t gate_epoch;    // Troca de modelo para a qual o portão foi ligado/desligado
+#endif
+} Output;
+
+static void cache_report(void) {
+    TflmCacheStats st;
+    tflm_cache_stats(&st);
+    if (st.bypass) {
+        printf("[CACHE] desligado: %lu inferências diretas\n", (unsigned long)st.bypassed);
+        return;
+    }
+    printf("[CACHE] %lu consultas, %lu acertos (%lu%%), %lu Invokes | economia ~%lu us\n",
+           (unsigned long)st.lookups, (unsigned long)st.hits,
+           (unsigned long)(st.lookups ? 100u * st.hits / st.lookups : 0u),
+           (unsigned long)st.misses, (unsigned long)st.saved_us);
+}
+
+// Divisão dos kernels entre os cores desde o último relatório: blocos pegos e
+// tempo ocupado/ocioso de cada core, para ajustar o tamanho dos blocos
+static void core_report(void) {
+    TflmCoreStats st;
+    tflm_core_stats(&st);
+    printf("[TFLM] %lu chamadas nos dois cores, %lu em um core só\n",
+           (unsigned long)st.jobs, (unsigned long)st.inline_runs);
+    for (int i = 0; i < 2; i++) {
+        printf("[TFLM] core %d: %lu blocos, ocupado %lu us, ocioso %lu us\n", i,
+               (unsigned long)st.chunks[i], (unsigned long)st.busy_us[i],
+               (unsigned long)st.idle_us[i]);
+    }
+    tflm_core_reset_stats();
+}
+
+static void inference_report(const Output *saida) {
+#ifdef PREDAGUARD_GATE
+    gate_report(&saida->gate);
+#else
+    (void)saida;
+#endif
+    cache_report();
+}
+
+// Eventos enfileirados pelas ISRs, tratados aqui fora da interrupção
+static void service_events(EventQueue *q) {
+    Event ev;
+    while (event_pop(q, &ev)) {
+        buttons_handle(&ev);
+    }
+}
+
+// Envio da telemetria na folga; a latência só conta voltas com algo no anel
+static void service_telemetry(Telemetry *t) {
+    if (t->head == t->tail) {
+        telemetry_service(t);
+        return;
+    }
+    LATENCY_BEGIN(lat_serial);
+    telemetry_service(t);
+    LATENCY_END(LAT_SERIAL, lat_serial);
+}
+
+// 6-8. Classifica a amostra, aplica o debounce nos LEDs e enfileira a telemetria
+static void infer_and_output(Output *saida, const PipelineSample *amostra) {
+    // 6. Inferência
+    TflmDecision decisao; // classe 0: IDLE, 1: GAMING, 2: ANOMALIA
+    uint8_t confianca_portao = 0;
+    LATENCY_BEGIN(lat_inferencia);
+#ifdef PREDAGUARD_GATE
+    // Amostra dentro de um aglomerado conhecido: decide sem o interpreter.
+    // As regiões valem só para o modelo de onde saíram; a cada troca confere.
+    const uint32_t epoch = tflm_model_epoch();
+    if (epoch != saida->gate_epoch) {
+        saida->gate_epoch = epoch;
+        gate_select_model(&saida->gate, tflm_model_crc32());
+        gate_report(&saida->gate);
+    }
+    decisao.class_index = gate_apply(&saida->gate, &amostra->readings, &confianca_portao);
+    decisao.confidence_q = 0;
+    const bool pelo_portao = decisao.class_index >= 0;
+#else
+    const bool pelo_portao = false;
+#endif
+    if (!pelo_portao) {
+        if (amostra->quantized && amostra->model_epoch != tflm_model_epoch()) {
+            // Quantizada para o modelo anterior a uma troca (ainda na fila do pipeline)
+            int8_t requantizada[2];
+            preproc_fixed_quantize(&saida->preproc, &amostra->readings, requantizada);
+            tflm_classify_quantized(requantizada, &decisao);
+        } else if (amostra->quantized) {
+            tflm_classify_quantized(amostra->inputs_q, &decisao);
+        } else {
+            tflm_classify(amostra->inputs, &decisao);
+        }
+    }
+    const uint32_t inferencia_us = LATENCY_END(LAT_INFERENCIA, lat_inferencia);
+
+    // 7. Pós-processamento: o argmax já vem de tflm_classify
+    int predicao = decisao.class_index;
+
+    // Hysteresis / debounce simples: exige N leituras consecutivas iguais antes de trocar o LED
+    LATENCY_BEGIN(lat_gpio);
+    if (predicao != saida->current_state) {
+        saida->stable_count++;
+        if (saida->stable_count >= STABLE_THRESHOLD) {
+            saida->current_state = predicao;
+            saida->stable_count = 0;
+            // Atualiza TODOS os LEDs explicitamente para evitar estados residuais
+            switch (saida->current_state) {
+                case 0: // IDLE
+                    gpio_put(12, 1); // azul ON
+                    gpio_put(11, 0); // verde OFF
+                    gpio_put(13, 0); // vermelho OFF
+                    break;
+                case 1: // GAMING
+                    gpio_put(12, 0); // azul OFF
+                    gpio_put(11, 1); // verde ON
+                    gpio_put(13, 0); // vermelho OFF
+                    break;
+                case 2: // ANOMALIA
+                    gpio_put(12, 0); // azul OFF
+                    gpio_put(11, 0); // verde OFF
+                    gpio_put(13, 1); // vermelho ON
+                    break;
+            }
+        }
+    } else {
+        saida->stable_count = 0; // mantém estado atual, zera contador
+    }
+    const uint32_t gpio_us = LATENCY_END(LAT_GPIO, lat_gpio);
+
+    // 8. Telemetria: só codifica no anel (texto ou binário sai na folga)
+    LATENCY_BEGIN(lat_telemetria);
+    const SensorReadings *data = &amostra->readings;
+    TelemetryRecord registro;
+    registro.timestamp_ms = (uint32_t)(amostra->due_us / 1000u);
+    registro.delta_t_raw = (int32_t)data->raw_temp_1 - (int32_t)data->raw_temp_2;
+    registro.delta_u_raw = (int32_t)data->raw_humidity_1 - (int32_t)data->raw_humidity_2;
+    registro.class_index = (uint8_t)predicao;
+    registro.confidence = pelo_portao ? confianca_portao
+                                      : (uint8_t)(tflm_decision_confidence(&decisao) * 255.0f + 0.5f);
+    registro.stage_us[TELEMETRY_STAGE_SENSORES] = amostra->sensores_us;
+    registro.stage_us[TELEMETRY_STAGE_PREPROC] = amostra->preproc_us;
+    registro.stage_us[TELEMETRY_STAGE_INFERENCIA] = telemetry_stage_us(inferencia_us);
+    registro.stage_us[TELEMETRY_STAGE_SAIDA] =
+        telemetry_stage_us(gpio_us + (time_us_32() - lat_telemetria));
+    registro.trend_centi_c_min = amostra->trend_centi_c_min;
+    telemetry_push(&saida->telemetry, &registro);
+
+    // 9. Gravação da amostra bruta no flash (buffer em RAM, página a página)
+    if (saida->recorder) {
+        RecorderSample gravada = {
+            (uint32_t)(amostra->due_us / 1000u),
+            data->raw_temp_1, data->raw_humidity_1, data->raw_temp_2, data->raw_humidity_2,
+            (uint8_t)predicao, registro.confidence,
+        };
+        uint8_t payload[RECORDER_SAMPLE_BYTES];
+        recorder_sample_encode(&gravada, payload);
+        recorder_append(saida->recorder, payload, RECORDER_SAMPLE_BYTES);
+    }
+    LATENCY_END(LAT_TELEMETRIA, lat_telemetria);
+    // Do tick agendado até aqui (o timer de 32 bits dá a mesma diferença)
+    LATENCY_END(LAT_AMOSTRA, (uint32_t)amostra->due_us);
+    if (++saida->inferencias % SCHED_REPORT_TICKS == 0) inference_report(saida);
+}
+
+// ============================================================
+// MODELOS EM SLOTS DO FLASH
+// O modelo novo é preparado em passos entre as amostras e entra no lugar do
+// ativo entre duas inferências, sem parar o monitoramento.
+// ============================================================
+#define MODEL_UPLOAD_BUDGET     8192u     // Bytes lidos da serial por volta do loop
+#define MODEL_UPLOAD_TIMEOUT_US 5000000u  // Silêncio que aborta um envio
+
+typedef struct ModelSlots {
+    FlashDevice flash;
+    int active_slot;        // -1: modelo embarcado
+    int pending_slot;       // Slot em preparação, -1 se nenhum
+    bool uploading;
+    int upload_slot;
+    ModelSlotWriter writer;
+    uint8_t header[MODEL_SLOT_HEADER_BYTES];  // Chega primeiro e diz o tamanho
+    uint32_t header_fill;
+    uint32_t last_byte_us;
+} ModelSlots;
+
+static void model_swap_from_slot(ModelSlots *m, int slot) {
+    if (tflm_swap_begin(model_slot_platform_image(slot), MODEL_SLOT_BYTES) == 0) {
+        m->pending_slot = slot;
+        printf("[MODELO] preparando o slot %d\n", slot);
+    } else {
+        printf("[MODELO] slot %d recusado\n", slot);
+        tflm_swap_cancel();
+    }
+}
+
+// Um passo da preparação; troca assim que o modelo novo está pronto
+static void service_model_swap(Output *saida) {
+    ModelSlots *m = saida->modelos;
+    if (!m || m->pending_slot < 0) return;
+    const TflmSwapState estado = tflm_swap_service();
+    if (estado == TFLM_SWAP_READY && tflm_swap_commit() == 0) {
+        m->active_slot = m->pending_slot;
+        preproc_for_active_model(&saida->preproc);
+        TflmSwapStats st;
+        tflm_swap_stats(&st);
+        printf("[MODELO] slot %d ativo: preparo %lu us em %lu passos (máx %lu us), troca %lu us, "
+               "arena %d+%d bytes\n", m->active_slot, (unsigned long)st.prepare_us,
+               (unsigned long)st.service_calls, (unsigned long)st.max_step_us,
+               (unsigned long)st.commit_us, st.active_arena_bytes,
+               st.peak_arena_bytes - st.active_arena_bytes);
+        m->pending_slot = -1;
+    } else if (estado == TFLM_SWAP_FAILED) {
+        tflm_swap_cancel();
+        m->pending_slot = -1;
+    }
+}
+
+static void model_report(const ModelSlots *m) {
+    TflmSwapStats st;
+    tflm_swap_stats(&st);
+    printf("[MODELO] ativo: %s%d | trocas %lu, recusadas %lu | arena %d de %d bytes, pico %d\n",
+           m->active_slot < 0 ? "embarcado" : "slot ", m->active_slot < 0 ? 0 : m->active_slot,
+           (unsigned long)st.swaps, (unsigned long)st.rejected, st.active_arena_bytes,
+           st.arena_capacity_bytes, st.peak_arena_bytes);
+    for (int i = 0; i < MODEL_SLOT_COUNT; i++) {
+        ModelSlotHeader h;
+        const ModelSlotStatus s = model_slot_check_header(model_slot_platform_image(i),
+                                                          MODEL_SLOT_BYTES, TFLM_MODEL_SCHEMA_VERSION, &h);
+        if (s == MODEL_SLOT_OK) {
+            printf("[MODELO] slot %d: geração %lu, %lu bytes, arena %lu\n", i,
+                   (unsigned long)h.generation, (unsigned long)h.model_bytes,
+                   (unsigned long)h.arena_bytes);
+        } else {
+            printf("[MODELO] slot %d: %s\n", i, model_slot_status_name(s));
+        }
+    }
+}
+
+static void model_upload_abort(ModelSlots *m, const char *motivo) {
+    printf("[MODELO] envio abortado: %s\n", motivo);
+    m->uploading = false;
+}
+
+// 'U' + imagem do host/tools/model_pack. Sempre no slot que não está em uso.
+static void model_upload_start(ModelSlots *m) {
+    if (m->pending_slot >= 0) {
+        printf("[MODELO] troca em andamento, envio recusado\n");
+        return;
+    }
+    m->uploading = true;
+    m->upload_slot = m->active_slot == 0 ? 1 : 0;
+    m->header_fill = 0;
+    m->last_byte_us = time_us_32();
+    printf("[MODELO] aguardando imagem para o slot %d\n", m->upload_slot);
+}
+
+// Consome o que já chegou pela serial, sem esperar; no fim prepara a troca
+static void model_upload_service(ModelSlots *m) {
+    for (uint32_t n = 0; n < MODEL_UPLOAD_BUDGET; n++) {
+        const int c = getchar_timeout_us(0);
+        if (c == PICO_ERROR_TIMEOUT) break;
+        m->last_byte_us = time_us_32();
+        const uint8_t byte = (uint8_t)c;
+        if (m->header_fill < MODEL_SLOT_HEADER_BYTES) {
+            m->header[m->header_fill++] = byte;
+            if (m->header_fill < MODEL_SLOT_HEADER_BYTES) continue;
+            ModelSlotHeader h;
+            const ModelSlotStatus s = model_slot_check_header(m->header, MODEL_SLOT_BYTES, TFLM_MODEL_SCHEMA_VERSION, &h);
+            if (s != MODEL_SLOT_OK) {
+                model_upload_abort(m, model_slot_status_name(s));
+                return;
+            }
+            if (!model_slot_writer_begin(&m->writer, &m->flash, m->upload_slot,
+                                         MODEL_SLOT_HEADER_BYTES + h.model_bytes) ||
+                !model_slot_writer_put(&m->writer, m->header, MODEL_SLOT_HEADER_BYTES)) {
+                model_upload_abort(m, "erro de flash");
+                return;
+            }
+            continue;
+        }
+        if (!model_slot_writer_put(&m->writer, &byte, 1)) {
+            model_upload_abort(m, "erro de flash");
+            return;
+        }
+        if (m->writer.received == m->writer.total) {
+            m->uploading = false;
+            if (!model_slot_writer_finish(&m->writer)) {
+                printf("[MODELO] envio abortado: erro de flash\n");
+                return;
+            }
+            printf("[MODELO] slot %d gravado (%lu bytes)\n", m->upload_slot,
+                   (unsigned long)m->writer.total);
+            model_swap_from_slot(m, m->upload_slot);
+            return;
+        }
+    }
+    if (time_us_32() - m->last_byte_us > MODEL_UPLOAD_TIMEOUT_US) {
+        model_upload_abort(m, "tempo esgotado");
+    }
+}
+
+// Comandos de um caractere pela serial (USB):
+//   D  dump binário das amostras gravadas (host/tools/recorder_export)
+//   X  apaga o gravador
+//   R  relatório do gravador
+//   U  recebe uma imagem de modelo (host/tools/model_pack) e troca para ela
+//   M  relatório dos modelos (e do portão/cache de inferência)
+//   E  fila de eventos das interrupções (pior tempo de ISR)
+//   P  divisão dos kernels do TFLM entre os cores (zera em seguida)
+//   L  histogramas de latência por estágio (com PREDAGUARD_LATENCY)
+//   Z  mesmos histogramas, zerados em seguida
+static void handle_serial_command(Output *saida) {
+    if (saida->modelos && saida->modelos->uploading) {
+        model_upload_service(saida->modelos);
+        return;
+    }
+    const int c = getchar_timeout_us(0);
+    if (c == PICO_ERROR_TIMEOUT) return;
+    if (saida->recorder) {
+        switch (c) {
+            case 'D': {
+                printf("[REC] dump inicio\n");
+                const uint32_t n = recorder_dump(saida->recorder, recorder_platform_dump_write, NULL);
+                printf("[REC] dump fim: %lu registros\n", (unsigned long)n);
+                break;
+            }
+            case 'X':
+                printf("[REC] apagando...\n");
+                recorder_erase_all(saida->recorder);
+                recorder_report(saida->recorder);
+                break;
+            case 'R':
+                recorder_report(saida->recorder);
+                break;
+        }
+    }
+    if (saida->modelos) {
+        switch (c) {
+            case 'U':
+                model_upload_start(saida->modelos);
+                break;
+            case 'M':
+                model_report(saida->modelos);
+                inference_report(saida);
+                break;
+        }
+    }
+    if (c == 'E') event_report(saida->eventos);
+    if (c == 'P') core_report();
+#ifdef PREDAGUARD_LATENCY
+    switch (c) {
+        case 'L':
+            latency_dump();
+            break;
+        case 'Z':
+            latency_dump();
+            latency_reset();
+            break;
+    }
+#endif
+}
+
+#ifdef PREDAGUARD_PIPELINE
+typedef struct {
+    Acquisition *acq;
+    Pipeline *pipeline;
+} AcquisitionTask;
+
+// Core 1: produz amostras para sempre; fila cheia descarta, nunca espera
+static void acquisition_task(void *arg) {
+    AcquisitionTask *task = (AcquisitionTask *)arg;
+    while (true) {
+        PipelineSample amostra;
+        if (acquire_sample(task->acq, &amostra)) pipeline_push(task->pipeline, &amostra);
+    }
+}
+#endif
+
 int main() {
     stdio_init_all();
     sleep_ms(2000); // Delay para abrir o monitor serial
@@ -19,86 +510,139 @@ int main() {
     gpio_init(11); gpio_set_dir(11, GPIO_OUT); // LED verde
     gpio_init(13); gpio_set_dir(13, GPIO_OUT); // LED vermelho (ANOMALIA)
 
+    // Botões: a ISR só enfileira, o loop trata (service_events)
+    static EventQueue eventos;
+    event_queue_init(&eventos);
+    init_buttons(&eventos, EVENT_LANE_IRQ);
+
     // 1. Inicialização do Hardware
     init_i2c_sensor(); // Deve inicializar I2C0 (Exaustão) e I2C1 (Ambiente)
     init_aht20();
     gpio_put(11, 1); // LED verde ON para indicar que o modelo foi carregado com sucesso+
     // 2. Inicialização da IA
-    if (tflm_init() != 0) {
+    // Só a decisão (argmax) é usada no loop: o softmax final não precisa rodar
+    if (tflm_init_ex(TFLM_STRIP_SOFTMAX) != 0) {
         printf("Erro ao carregar o modelo TFLite!\n");
         return -1;
     }
     
+#ifdef PREDAGUARD_CACHE_EPSILON
+    // Reuso aproximado: entrada a até PREDAGUARD_CACHE_EPSILON (unidades do
+    // tensor de entrada) da última calculada, no máximo 8 amostras seguidas
+    const TflmCachePolicy politica = {TFLM_CACHE_EPSILON, PREDAGUARD_CACHE_EPSILON, 8};
+    tflm_cache_configure(&politica);
+#endif
+
+    static Acquisition acq;
+    acq.num_inputs = tflm_input_count();
+    acq.preproc_int8 = acq.num_inputs == 2 && preproc_for_active_model(&acq.preproc);
+    acq.model_epoch = tflm_model_epoch();
+
+    // Janelas deslizantes de ΔT/ΔU: tendência na serial e, em modelos temporais,
+    // entradas extras (ver a ordem em lib/features/features.h)
+    feat_engine_init(&acq.features, FEAT_WINDOW_SAMPLES);
+    acq.norm = (FeatNormalization){MEAN_DELTA_T, STD_DELTA_T, MEAN_DELTA_U, STD_DELTA_U};
+    if (acq.num_inputs > FEAT_NUM_FEATURES) {
+        printf("Modelo espera %d entradas, o motor de features gera %d!\n", acq.num_inputs, FEAT_NUM_FEATURES);
+        return -1;
+    }
+
+    // Telemetria: binária pelo sink da plataforma (DMA na UART0); texto se não
+    // houver sink ou com PREDAGUARD_TELEMETRY_TEXT
+    static Output saida;
+    saida.current_state = -1;
+    saida.stable_count = 0;
+    saida.eventos = &eventos;
+    saida.preproc = acq.preproc;
+#ifdef PREDAGUARD_GATE
+    gate_init(&saida.gate, &modelo_gate);
+    saida.gate_epoch = tflm_model_epoch();
+    gate_select_model(&saida.gate, tflm_model_crc32());
+    gate_report(&saida.gate);
+#endif
+#ifdef PREDAGUARD_TELEMETRY_TEXT
+    telemetry_init(&saida.telemetry, TELEMETRY_TEXT, NULL);
+#else
+    TelemetrySink sink;
+    if (telemetry_platform_sink(&sink)) {
+        telemetry_init(&saida.telemetry, TELEMETRY_BINARY, &sink);
+    } else {
+        telemetry_init(&saida.telemetry, TELEMETRY_TEXT, NULL);
+    }
+#endif
+
+    // Gravador de amostras: região reservada no fim do flash (arquivo em
+    // PREDAGUARD_FLASH no host); retoma depois do último registro válido
+    static Recorder recorder;
+    FlashDevice flash;
+    saida.recorder = NULL;
+    if (recorder_platform_flash(&flash) && recorder_open(&recorder, &flash)) {
+        saida.recorder = &recorder;
+        recorder_report(&recorder);
+    }
+
+    // Slots de modelo abaixo do gravador (arquivo em PREDAGUARD_MODEL_SLOTS no
+    // host): o mais novo válido substitui o embarcado depois de preparado, já
+    // com o loop rodando
+    static ModelSlots modelos;
+    saida.modelos = NULL;
+    if (model_slot_platform_flash(&modelos.flash)) {
+        modelos.active_slot = -1;
+        modelos.pending_slot = -1;
+        saida.modelos = &modelos;
+        const uint8_t *imagens[MODEL_SLOT_COUNT];
+        for (int i = 0; i < MODEL_SLOT_COUNT; i++) imagens[i] = model_slot_platform_image(i);
+        const int slot = model_slot_newest(imagens, TFLM_MODEL_SCHEMA_VERSION, NULL);
+        if (slot >= 0) model_swap_from_slot(&modelos, slot);
+    }
+
     printf("PredaGuard iniciado: Monitoramento Diferencial Ativo\n");
 
-    int current_state = -1; // Estado estável atual exibido pelos LEDs
-    int stable_count = 0;   // Contador de leituras consecutivas iguais
-    const int STABLE_THRESHOLD = 3; // Número de leituras necessárias para aceitar uma mudança
+    // Dispara a primeira conversão; as seguintes correm entre os ticks
+    sensors_start_conversion();
+
+    if (!sched_init(&acq.scheduler, SAMPLE_PERIOD_US)) {
+        printf("Erro ao iniciar o alarme de amostragem!\n");
+        return -1;
+    }
+
+#ifdef PREDAGUARD_PIPELINE
+    // Core 1 fica com a aquisição; aqui só inferência e saída
+    static Pipeline pipeline;
+    pipeline_init(&pipeline);
+    static AcquisitionTask task;
+    task.acq = &acq;
+    task.pipeline = &pipeline;
+    core_task_launch(acquisition_task, &task);
 
+    uint32_t consumidas = 0;
     while (true) {
-        // 3. Leitura dos Sensores
-        SensorReadings data = get_sensor_readings();
-
-        // 4. Cálculo do Diferencial (Física do Problema)
-        float deltaT = data.aht_temp_1 - data.aht_temp_2;
-        float deltaU = data.humidity_1 - data.humidity_2;
-
-
-        // 5. Pré-processamento (Normalização idêntica ao Treino)
-        float z_temp = (deltaT - MEAN_DELTA_T) / STD_DELTA_T;
-        float z_umid = (deltaU - MEAN_DELTA_U) / STD_DELTA_U;
-        // 6. Inferência
-        float inputs[2] = {z_temp, z_umid};
-        float outputs[3]; // [0]: IDLE, [1]: GAMING, [2]: ANOMALIA
-        
-        tflm_predict(inputs, outputs);
-
-        // 7. Pós-processamento: Identifica a maior probabilidade
-        int predicao = 0;
-        float confiança = outputs[0];
-        for (int i = 1; i < 3; i++) {
-            if (outputs[i] > confiança) {
-                confiança = outputs[i];
-                predicao = i;
-            }
-        }
+        // Folga: a telemetria sai daqui, nunca do meio do processamento
+        service_telemetry(&saida.telemetry);
+        handle_serial_command(&saida);
+        service_events(&eventos);
+        service_model_swap(&saida);
 
-        // 8. Feedback via Serial
-        printf("ΔT: %.2f°C | ΔU: %.2f%% | Trend ΔT: %.2f°C  -> ", deltaT, deltaU);
-        if (predicao == 0) printf("Estado: IDLE (%.1f%%)\n", confiança*100);
-        else if (predicao == 1) printf("Estado: GAMING (%.1f%%)\n", confiança*100);
-        else if (predicao == 2) printf("⚠️ ALERTA: ANOMALIA/OBSTRUÇÃO! (%.1f%%)\n", confiança*100);
-
-        // Hysteresis / debounce simples: exige N leituras consecutivas iguais antes de trocar o LED
-        if (predicao != current_state) {
-            stable_count++;
-            if (stable_count >= STABLE_THRESHOLD) {
-                current_state = predicao;
-                stable_count = 0;
-                // Atualiza TODOS os LEDs explicitamente para evitar estados residuais
-                switch (current_state) {
-                    case 0: // IDLE
-                        gpio_put(12, 1); // azul ON
-                        gpio_put(11, 0); // verde OFF
-                        gpio_put(13, 0); // vermelho OFF
-                        break;
-                    case 1: // GAMING
-                        gpio_put(12, 0); // azul OFF
-                        gpio_put(11, 1); // verde ON
-                        gpio_put(13, 0); // vermelho OFF
-                        break;
-                    case 2: // ANOMALIA
-                        gpio_put(12, 0); // azul OFF
-                        gpio_put(11, 0); // verde OFF
-                        gpio_put(13, 1); // vermelho ON
-                        break;
-                }
-            }
-        } else {
-            stable_count = 0; // mantém estado atual, zera contador
+        PipelineSample amostra;
+        if (!pipeline_pop(&pipeline, &amostra)) {
+            __wfe(); // Acorda no push do core 1 (ou no alarme)
+            continue;
         }
+        infer_and_output(&saida, &amostra);
+        if (++consumidas % SCHED_REPORT_TICKS == 0) pipeline_report(&pipeline);
+    }
+#else
+    while (true) {
+        // Folga antes do tick: a telemetria sai daqui, nunca do meio do loop
+        service_telemetry(&saida.telemetry);
+        handle_serial_command(&saida);
+        service_events(&eventos);
+        service_model_swap(&saida);
 
-        sleep_ms(500); // Monitoramento a cada 0.5 segundos
+        PipelineSample amostra;
+        if (!acquire_sample(&acq, &amostra)) continue;
+        infer_and_output(&saida, &amostra);
     }
+#endif
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,12 @@
+#ifndef MODELO_PREDATOR_ARENA_H
+#define MODELO_PREDATOR_ARENA_H
+
+// Gerado por host/tools/arena_sizer a partir de modelo_predator.h. Não edite.
+// Persistente: 1128 bytes, não persistente: 96 bytes (scratch: 0 bytes)
+
+#define MODELO_ARENA_MODEL_LEN  2964u
+#define MODELO_ARENA_MODEL_HASH 0x7d6ec7bcu
+#define MODELO_ARENA_MIN_BYTES  2000
+#define MODELO_ARENA_SIZE       2208  // mínimo + 10%, alinhado a 16
+
+#endif // MODELO_PREDATOR_ARENA_H
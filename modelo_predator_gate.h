@@ -0,0 +1,21 @@
+#ifndef MODELO_PREDATOR_GATE_H
+#define MODELO_PREDATOR_GATE_H
+
+// Gerado por host/tools/gate_fit a partir de modelo_predator.h e do dataset de
+// treino. Não edite.
+
+#include "lib/gate/gate.h"
+
+static const GateParams modelo_gate = {
+    GATE_MAHALANOBIS, 3, 0x9a52d1ddu,
+    {
+        // IDLE
+        {{21535, -271242}, {40492, -175518}, {31013, -223380}, 1, 912179, 176673, 35773, 890604418498ll, 255},
+        // GAMING
+        {{94557, -499464}, {105336, -454296}, {99947, -476880}, 0, 650805, 105594, 37060, 10163611150054ll, 255},
+        // ANOMALIA
+        {{107155, -537598}, {123258, -486200}, {115207, -511899}, 0, 555269, 168262, 54499, 2318585470454ll, 255},
+    },
+};
+
+#endif // MODELO_PREDATOR_GATE_H
@@ -0,0 +1,13 @@
+#ifndef MODELO_PREDATOR_NORM_H
+#define MODELO_PREDATOR_NORM_H
+
+// Gerado por host/tools/dataset_build a partir de dataset_pronto_treino.csv. Não edite.
+// 4965 amostras balanceadas (1655 por classe, 3 classes) de 4965 válidas.
+// Z-score das entradas do modelo: média e desvio populacional (StandardScaler)
+
+#define MODELO_NORM_MEAN_DELTA_T  15.65084995f
+#define MODELO_NORM_STD_DELTA_T   6.99135624f
+#define MODELO_NORM_MEAN_DELTA_U  -38.53349043f
+#define MODELO_NORM_STD_DELTA_U   12.27171964f
+
+#endif // MODELO_PREDATOR_NORM_H
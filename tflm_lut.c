@@ -0,0 +1,177 @@
+// Backend de tflm_wrapper.h baseado em tabela (ver tflm_lut.h).
+// Substitui tflm_wrapper.cpp no link: sem interpreter, sem arena.
+#include "tflm_wrapper.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "lib/model_slot/model_slot.h"
+#include "modelo_predator.h"
+#include "modelo_predator_lut.h"
+#include "tflm_lut.h"
+
+#define LUT_NUM_CLASSES 3
+
+static bool lut_ready = false;
+static int8_t input_q[2];          // "Tensor" de entrada (tflm_input_ptr)
+static TflmDecision last_decision;
+
+int tflm_init(void) {
+    return tflm_init_ex(0);
+}
+
+int tflm_init_ex(uint32_t flags) {
+    (void)flags; // Não há softmax para remover
+    uint32_t hash = tflm_lut_model_hash(modelo_tflite, modelo_tflite_len);
+    if (hash != MODELO_LUT_MODEL_HASH) {
+        printf("[LUT] ERRO: tabela gerada para outro modelo (hash %08x, esperado %08x)\n",
+               (unsigned)hash, (unsigned)MODELO_LUT_MODEL_HASH);
+        return 7;
+    }
+    printf("[LUT] Tabela de decisão carregada (%u bytes)\n", (unsigned)sizeof(modelo_lut));
+    lut_ready = true;
+    return 0;
+}
+
+static inline void lookup(const int8_t* q, TflmDecision* out) {
+    const uint32_t idx = tflm_lut_index(q[0], q[1]);
+#if MODELO_LUT_CONFIDENCE_BITS > 0
+    const uint8_t entry = modelo_lut[idx];
+    out->class_index = entry & TFLM_LUT_CLASS_MASK;
+    out->confidence_q = (int8_t)(entry >> TFLM_LUT_CONF_SHIFT);
+#else
+    out->class_index = (modelo_lut[idx >> 2] >> ((idx & 3) * 2)) & TFLM_LUT_CLASS_MASK;
+    out->confidence_q = 0;
+#endif
+}
+
+static void quantize_inputs(const float* input_data) {
+    for (int i = 0; i < 2; i++) {
+        long q = lroundf(input_data[i] / MODELO_LUT_INPUT_SCALE) + MODELO_LUT_INPUT_ZERO_POINT;
+        input_q[i] = (int8_t)(q < -128 ? -128 : (q > 127 ? 127 : q));
+    }
+}
+
+int tflm_classify_quantized(const int8_t* q, TflmDecision* out) {
+    if (!lut_ready) return 1;
+    lookup(q, out);
+    return 0;
+}
+
+int tflm_classify(const float* input_data, TflmDecision* out) {
+    if (!lut_ready) return 1;
+    quantize_inputs(input_data);
+    lookup(input_q, out);
+    return 0;
+}
+
+float tflm_decision_confidence(const TflmDecision* d) {
+#if MODELO_LUT_CONFIDENCE_BITS > 0
+    return (float)d->confidence_q / (float)TFLM_LUT_CONF_MAX;
+#else
+    (void)d;
+    return 0.0f; // Tabela só com classe
+#endif
+}
+
+// Saída "estilo tflm_predict": a tabela só guarda a classe vencedora e sua
+// probabilidade; as demais classes ficam em 0.
+static void decision_to_outputs(const TflmDecision* d, float* output_data) {
+    for (int i = 0; i < LUT_NUM_CLASSES; i++) output_data[i] = 0.0f;
+    output_data[d->class_index] = tflm_decision_confidence(d);
+}
+
+int8_t* tflm_predict(float* input_data, float* output_data) {
+    TflmDecision d;
+    if (tflm_classify(input_data, &d) == 0) decision_to_outputs(&d, output_data);
+    return NULL;
+}
+
+int tflm_predict_quantized(const int8_t* q, float* output_data) {
+    TflmDecision d;
+    if (tflm_classify_quantized(q, &d) != 0) return 1;
+    decision_to_outputs(&d, output_data);
+    return 0;
+}
+
+int8_t* tflm_input_ptr(int* nbytes) {
+    if (nbytes) *nbytes = (int)sizeof(input_q);
+    return input_q;
+}
+
+int8_t* tflm_output_ptr(int* nbytes) {
+    if (nbytes) *nbytes = 0;
+    return NULL; // Não há tensor de saída; use tflm_classify
+}
+
+int   tflm_input_count(void) { return 2; }
+float tflm_input_scale(void) { return MODELO_LUT_INPUT_SCALE; }
+int   tflm_input_zero_point(void) { return MODELO_LUT_INPUT_ZERO_POINT; }
+float tflm_output_scale(void) { return 0.0f; }
+int   tflm_output_zero_point(void) { return 0; }
+
+int tflm_invoke(void) {
+    if (!lut_ready) return 1;
+    lookup(input_q, &last_decision);
+    return 0;
+}
+
+int tflm_arena_used_bytes(void) {
+    return 0;
+}
+
+// A tabela reproduz o modelo embarcado (conferido pelo hash no init)
+uint32_t tflm_model_crc32(void) {
+    return lut_ready ? model_slot_crc32(0, modelo_tflite, modelo_tflite_len) : 0;
+}
+
+// A tabela é compilada para um modelo: não há troca em execução
+int tflm_swap_begin(const uint8_t* image, uint32_t image_len) {
+    (void)image;
+    (void)image_len;
+    return 1;
+}
+
+TflmSwapState tflm_swap_service(void) { return TFLM_SWAP_IDLE; }
+int tflm_swap_commit(void) { return 1; }
+void tflm_swap_cancel(void) {}
+uint32_t tflm_model_epoch(void) { return 0; }
+
+void tflm_swap_stats(TflmSwapStats* out) {
+    memset(out, 0, sizeof(*out));
+}
+
+// Sem Invoke para amortizar: o lote é uma consulta por linha
+int tflm_batch_init(int rows) { return lut_ready && rows > 0 ? 0 : 1; }
+int tflm_batch_capacity(void) { return lut_ready ? 1 : 0; }
+int tflm_batch_arena_used_bytes(void) { return 0; }
+
+int tflm_classify_batch(const float* inputs, int rows, TflmDecision* out) {
+    if (!lut_ready) return 1;
+    for (int r = 0; r < rows; r++) {
+        quantize_inputs(inputs + 2 * r);
+        lookup(input_q, &out[r]);
+    }
+    return 0;
+}
+
+// A consulta à tabela já é mais barata que qualquer cache
+void tflm_cache_configure(const TflmCachePolicy* policy) {
+    (void)policy;
+}
+
+void tflm_cache_stats(TflmCacheStats* out) {
+    memset(out, 0, sizeof(*out));
+    out->bypass = true;
+}
+
+void tflm_cache_reset_stats(void) {}
+
+// Sem kernels para dividir entre os cores
+void tflm_core_stats(TflmCoreStats* out) {
+    memset(out, 0, sizeof(*out));
+}
+
+void tflm_core_reset_stats(void) {}
@@ -0,0 +1,45 @@
+#pragma once
+#include <stdint.h>
+
+// ============================================================
+// TABELA DE DECISÃO (modelo -> lookup)
+// O modelo tem duas entradas; quantizadas em int8 o domínio inteiro tem
+// 65.536 pontos. host/tools/lut_compiler roda o interpreter em todos eles e
+// gera modelo_predator_lut.h. O backend tflm_lut.c implementa a API de
+// tflm_wrapper.h com uma leitura de tabela por inferência, sem interpreter
+// nem arena.
+//
+// Entrada com confiança: 1 byte = classe (bits 1..0) | confiança (bits 7..4)
+// Só classe:             4 entradas de 2 bits por byte
+// ============================================================
+
+#define TFLM_LUT_ENTRIES        65536u
+#define TFLM_LUT_CLASS_MASK     0x03u
+#define TFLM_LUT_CONF_SHIFT     4
+#define TFLM_LUT_CONF_MAX       15u
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Índice do par (q0, q1) de entradas int8
+static inline uint32_t tflm_lut_index(int8_t q0, int8_t q1) {
+    return ((uint32_t)(uint8_t)q0 << 8) | (uint8_t)q1;
+}
+
+static inline uint8_t tflm_lut_pack(int class_index, uint8_t conf_nibble) {
+    return (uint8_t)((class_index & TFLM_LUT_CLASS_MASK) | (conf_nibble << TFLM_LUT_CONF_SHIFT));
+}
+
+// Hash FNV-1a do modelo: liga a tabela ao modelo de onde foi gerada
+static inline uint32_t tflm_lut_model_hash(const unsigned char* data, unsigned int len) {
+    uint32_t h = 2166136261u;
+    for (unsigned int i = 0; i < len; i++) {
+        h = (h ^ data[i]) * 16777619u;
+    }
+    return h;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,26 @@
+#pragma once
+// Operadores registrados no resolver do firmware. Compartilhado entre
+// tflm_wrapper.cpp e as ferramentas host que precisam montar exatamente o
+// mesmo grafo (host/tools/arena_sizer.cpp).
+#include "tensorflow/lite/micro/micro_mutable_op_resolver.h"
+
+static constexpr int kTflmMaxOps = 16;
+using TflmOpResolver = tflite::MicroMutableOpResolver<kTflmMaxOps>;
+
+// Tudo menos o SOFTMAX, que o wrapper registra à parte (TFLM_STRIP_SOFTMAX)
+inline void tflm_add_ops_except_softmax(TflmOpResolver& resolver) {
+    resolver.AddConv2D();
+    resolver.AddMean();
+    resolver.AddFullyConnected();
+    resolver.AddReshape();
+    resolver.AddQuantize();
+    resolver.AddDequantize();
+    resolver.AddAdd();
+    resolver.AddMul();
+    resolver.AddPack();
+    resolver.AddUnpack();
+    resolver.AddSqueeze();
+    resolver.AddExpandDims();
+    resolver.AddMaxPool2D();
+    resolver.AddAveragePool2D();
+}
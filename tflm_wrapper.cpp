@@ -1,176 +1,918 @@
 #include "tflm_wrapper.h"
 
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <atomic>
+#include <new>
+
+#include "lib/latency/latency.h"
+#include "lib/model_slot/model_slot.h"
 #include "modelo_predator.h"
+#include "modelo_predator_arena.h"
+#include "tflm_ops.h"
 
+#include "tensorflow/compiler/mlir/lite/schema/schema_utils.h"
+#include "tensorflow/lite/micro/kernels/kernel_util.h"
+#include "tensorflow/lite/micro/memory_helpers.h"
+#include "tensorflow/lite/micro/micro_context.h"
 #include "tensorflow/lite/micro/micro_interpreter.h"
-#include "tensorflow/lite/micro/micro_mutable_op_resolver.h"
+#include "tensorflow/lite/micro/pico/parallel_for.h"
 #include "tensorflow/lite/schema/schema_generated.h"
+#include "pico/time.h"
 //#include "tensorflow/lite/version.h"
 
-// Arena (ajuste se precisar)
-// RP2040 tem 264KB RAM total. Usar 64KB para a arena deixa espaço para o resto do programa
-static constexpr int kTensorArenaSize = 64 * 1024;
-alignas(16) static uint8_t tensor_arena[kTensorArenaSize];
+// Arena dimensionada pelo host/tools/arena_sizer (modelo_predator_arena.h):
+// mínimo medido com o RecordingMicroAllocator + margem. Regenere ao trocar o modelo.
+// Modelos carregados de um slot precisam caber na mesma arena; um retreino
+// maior pede -DTFLM_ARENA_SIZE=<bytes> (o model_pack grava a medida no cabeçalho).
+static_assert(modelo_tflite_len == MODELO_ARENA_MODEL_LEN,
+              "modelo_predator_arena.h foi gerado para outro modelo: rode host/tools/arena_sizer");
+#ifndef TFLM_ARENA_SIZE
+#define TFLM_ARENA_SIZE MODELO_ARENA_SIZE
+#endif
+static constexpr int kTensorArenaSize = TFLM_ARENA_SIZE;
+static_assert(TFLM_MODEL_SCHEMA_VERSION == TFLITE_SCHEMA_VERSION, "atualize TFLM_MODEL_SCHEMA_VERSION");
+static_assert(kTensorArenaSize >= MODELO_ARENA_SIZE, "TFLM_ARENA_SIZE menor que a arena do modelo embarcado");
 
-static const tflite::Model* model_ptr = nullptr;
-static tflite::MicroInterpreter* interpreter_ptr = nullptr;
-static TfLiteTensor* input_ptr = nullptr;
-static TfLiteTensor* output_ptr = nullptr;
+// ============================================================
+// INSTÂNCIAS
+// Cada TflmEngine tem resolver, interpreter e arena próprios. Há duas: a
+// ativa atende as inferências e a outra prepara o próximo modelo
+// (tflm_swap_*). Resolver e interpreter são construídos no lugar, sem heap.
+// ============================================================
+struct TflmEngine {
+    const tflite::Model* model;
+    TflmOpResolver* resolver;
+    tflite::MicroInterpreter* interpreter;
+    TfLiteTensor* input;
+    TfLiteTensor* output;
+    bool softmax_stripped;
+    bool stateful;             // Tensores variáveis: o cache de resultados não se aplica
+    uint32_t model_crc32;      // CRC-32 do flatbuffer (model_slot_crc32)
+    float logits_scale;        // Quantização dos logits (entrada do softmax)
+    int logits_zero_point;
+    const uint8_t* model_data; // Flatbuffer de onde a instância foi montada
+    uint32_t model_len;
+    uint8_t* arena;
+    int arena_bytes;
+    alignas(TflmOpResolver) uint8_t resolver_storage[sizeof(TflmOpResolver)];
+    alignas(tflite::MicroInterpreter) uint8_t interpreter_storage[sizeof(tflite::MicroInterpreter)];
+};
 
-// Inicialização do TFLM
-extern "C" int tflm_init(void) {
-    printf("[TFLM] Iniciando inicialização...\n");
-    
-    model_ptr = tflite::GetModel(modelo_tflite);
-    if (!model_ptr) {
+static TflmEngine engines[2];
+alignas(16) static uint8_t engine_arenas[2][kTensorArenaSize];
+static TflmEngine* active = nullptr;
+static uint32_t engine_flags = 0;     // Flags de tflm_init_ex, repetidas em cada troca
+
+// Incrementada a cada troca, depois de `active` (release). Quem roda em outro
+// core lê a época (acquire) antes de consultar a quantização do modelo ativo.
+static std::atomic<uint32_t> model_epoch{0};
+
+// Instância em AllocateTensors: o Prepare do passthrough grava nela
+static TflmEngine* preparing = nullptr;
+
+static void cache_invalidate(void);  // Resultados guardados valem só para o modelo ativo
+
+// ============================================================
+// SOFTMAX FINAL REMOVIDO (TFLM_STRIP_SOFTMAX)
+// Softmax é monotônico: não muda o argmax. O kernel abaixo substitui o SOFTMAX
+// e só copia os logits para a saída; a confiança é calculada sob demanda
+// em tflm_decision_confidence().
+// ============================================================
+static TfLiteStatus LogitsPassthroughPrepare(TfLiteContext* context, TfLiteNode* node) {
+    tflite::MicroContext* micro_context = tflite::GetMicroContext(context);
+    TfLiteTensor* input = micro_context->AllocateTempInputTensor(node, 0);
+    TF_LITE_ENSURE(context, input != nullptr);
+    preparing->logits_scale = input->params.scale;
+    preparing->logits_zero_point = input->params.zero_point;
+    micro_context->DeallocateTempTfLiteTensor(input);
+    return kTfLiteOk;
+}
+
+static TfLiteStatus LogitsPassthroughEval(TfLiteContext* context, TfLiteNode* node) {
+    const TfLiteEvalTensor* input = tflite::micro::GetEvalInput(context, node, 0);
+    TfLiteEvalTensor* output = tflite::micro::GetEvalOutput(context, node, 0);
+    size_t bytes = 0;
+    TF_LITE_ENSURE_OK(context, tflite::TfLiteEvalTensorByteLength(input, &bytes));
+    memcpy(output->data.raw, input->data.raw, bytes);
+    return kTfLiteOk;
+}
+
+// true se o modelo tem exatamente um SOFTMAX e ele é o último operador,
+// produzindo a saída do grafo
+static bool has_trailing_softmax(const tflite::Model* model) {
+    const tflite::SubGraph* subgraph = model->subgraphs()->Get(0);
+    const auto* ops = subgraph->operators();
+    if (!ops || ops->size() == 0 || !subgraph->outputs() || subgraph->outputs()->size() != 1) {
+        return false;
+    }
+    int softmax_count = 0;
+    for (uint32_t i = 0; i < ops->size(); i++) {
+        const tflite::OperatorCode* code = model->operator_codes()->Get(ops->Get(i)->opcode_index());
+        if (tflite::GetBuiltinCode(code) == tflite::BuiltinOperator_SOFTMAX) softmax_count++;
+    }
+    const tflite::Operator* last = ops->Get(ops->size() - 1);
+    const tflite::OperatorCode* last_code = model->operator_codes()->Get(last->opcode_index());
+    return softmax_count == 1 &&
+           tflite::GetBuiltinCode(last_code) == tflite::BuiltinOperator_SOFTMAX &&
+           last->outputs()->size() == 1 &&
+           last->outputs()->Get(0) == subgraph->outputs()->Get(0);
+}
+
+// Tensores variáveis ou operadores de variável: a saída depende das chamadas
+// anteriores, então a mesma entrada pode dar outro resultado
+static bool model_has_state(const tflite::Model* model) {
+    for (uint32_t g = 0; g < model->subgraphs()->size(); g++) {
+        const auto* tensors = model->subgraphs()->Get(g)->tensors();
+        for (uint32_t i = 0; tensors && i < tensors->size(); i++) {
+            if (tensors->Get(i)->is_variable()) return true;
+        }
+    }
+    for (uint32_t i = 0; i < model->operator_codes()->size(); i++) {
+        switch (tflite::GetBuiltinCode(model->operator_codes()->Get(i))) {
+            case tflite::BuiltinOperator_VAR_HANDLE:
+            case tflite::BuiltinOperator_READ_VARIABLE:
+            case tflite::BuiltinOperator_ASSIGN_VARIABLE:
+            case tflite::BuiltinOperator_CALL_ONCE:
+                return true;
+            default:
+                break;
+        }
+    }
+    return false;
+}
+
+static void engine_teardown(TflmEngine* e) {
+    if (e->interpreter) e->interpreter->~MicroInterpreter();
+    if (e->resolver) e->resolver->~TflmOpResolver();
+    e->interpreter = nullptr;
+    e->resolver = nullptr;
+    e->model = nullptr;
+    e->input = e->output = nullptr;
+}
+
+// Monta resolver + interpreter de `model_data` na instância e aloca os tensores.
+// Retorna 0 se OK ou o código de erro de tflm_init_ex; verbose imprime o passo a passo.
+static int engine_setup(TflmEngine* e, const uint8_t* model_data, uint32_t flags, bool verbose) {
+    engine_teardown(e);
+    e->model_data = model_data;
+    e->softmax_stripped = false;
+    e->logits_scale = 0.0f;
+    e->logits_zero_point = 0;
+
+    e->model = tflite::GetModel(model_data);
+    if (!e->model) {
         printf("[TFLM] ERRO: Falha ao obter modelo (GetModel retornou nullptr)\n");
         return 1;
     }
-    printf("[TFLM] Modelo obtido com sucesso\n");
+    if (verbose) printf("[TFLM] Modelo obtido com sucesso\n");
 
-    if (model_ptr->version() != TFLITE_SCHEMA_VERSION) {
+    if (e->model->version() != TFLITE_SCHEMA_VERSION) {
         printf("[TFLM] ERRO: Versão do schema mismatch (esperado %u, obtido %u)\n", 
-               TFLITE_SCHEMA_VERSION, model_ptr->version());
+               TFLITE_SCHEMA_VERSION, e->model->version());
         return 2;
     }
 
     // Resolver com mais operadores (suporta mais tipos de modelos)
-    static tflite::MicroMutableOpResolver<16> resolver;
-    resolver.AddConv2D();
-    resolver.AddMean();
-    resolver.AddFullyConnected();
-    resolver.AddSoftmax();
-    resolver.AddReshape();
-    resolver.AddQuantize();
-    resolver.AddDequantize();
-    resolver.AddAdd();
-    resolver.AddMul();
-    resolver.AddPack();
-    resolver.AddUnpack();
-    resolver.AddSqueeze();
-    resolver.AddExpandDims();
-    resolver.AddMaxPool2D();
-    resolver.AddAveragePool2D();
+    e->resolver = new (e->resolver_storage) TflmOpResolver();
+    tflm_add_ops_except_softmax(*e->resolver);
+    if ((flags & TFLM_STRIP_SOFTMAX) && has_trailing_softmax(e->model)) {
+        e->resolver->AddSoftmax(tflite::micro::RegisterOp(
+            nullptr, LogitsPassthroughPrepare, LogitsPassthroughEval));
+        e->softmax_stripped = true;
+        if (verbose) printf("[TFLM] Softmax final removido (modo decisão)\n");
+    } else {
+        e->resolver->AddSoftmax();
+    }
     
-    printf("[TFLM] Resolver inicializado\n");
+    if (verbose) printf("[TFLM] Resolver inicializado\n");
 
-    // Interpreter estático (evita new em alguns cenários)
-    static tflite::MicroInterpreter static_interpreter(
-        model_ptr, resolver, tensor_arena, kTensorArenaSize
+    // Interpreter construído na própria instância (sem new no heap)
+    e->interpreter = new (e->interpreter_storage) tflite::MicroInterpreter(
+        e->model, *e->resolver, e->arena, e->arena_bytes
     );
-    interpreter_ptr = &static_interpreter;
+    // Antes do AllocateTensors: cada nó decide no Prepare
+    e->interpreter->SetParallelKernels(!(flags & TFLM_SINGLE_CORE_KERNELS));
 
-    TfLiteStatus alloc_status = interpreter_ptr->AllocateTensors();
+    preparing = e;
+    TfLiteStatus alloc_status = e->interpreter->AllocateTensors();
+    preparing = nullptr;
     if (alloc_status != kTfLiteOk) {
         printf("[TFLM] ERRO: AllocateTensors falhou (status=%d)\n", (int)alloc_status);
         printf("[TFLM] Arena disponível: %d bytes, arena usada: %d bytes\n", 
-               kTensorArenaSize, (int)interpreter_ptr->arena_used_bytes());
+               e->arena_bytes, (int)e->interpreter->arena_used_bytes());
         return 3;
     }
-    printf("[TFLM] Tensores alocados. Arena usada: %d bytes\n", 
-           (int)interpreter_ptr->arena_used_bytes());
+    if (verbose) {
+        printf("[TFLM] Tensores alocados. Arena usada: %d bytes\n", 
+               (int)e->interpreter->arena_used_bytes());
+    }
 
-    input_ptr  = interpreter_ptr->input(0);
-    output_ptr = interpreter_ptr->output(0);
-    if (!input_ptr || !output_ptr) {
-        printf("[TFLM] ERRO: input_ptr=%p, output_ptr=%p\n", input_ptr, output_ptr);
+    e->input  = e->interpreter->input(0);
+    e->output = e->interpreter->output(0);
+    if (!e->input || !e->output) {
+        printf("[TFLM] ERRO: input_ptr=%p, output_ptr=%p\n", e->input, e->output);
         return 4;
     }
 
-    printf("[TFLM] Input tensor: type=%d (int8=%d, float32=%d), bytes=%d\n", 
-           input_ptr->type, kTfLiteInt8, kTfLiteFloat32, input_ptr->bytes);
-    printf("[TFLM] Output tensor: type=%d (int8=%d, float32=%d), bytes=%d\n",
-           output_ptr->type, kTfLiteInt8, kTfLiteFloat32, output_ptr->bytes);
+    if (verbose) {
+        printf("[TFLM] Input tensor: type=%d (int8=%d, float32=%d), bytes=%d\n", 
+               e->input->type, kTfLiteInt8, kTfLiteFloat32, e->input->bytes);
+        printf("[TFLM] Output tensor: type=%d (int8=%d, float32=%d), bytes=%d\n",
+               e->output->type, kTfLiteInt8, kTfLiteFloat32, e->output->bytes);
+    }
 
     // PERMITIR float32 além de int8
-    if (input_ptr->type != kTfLiteInt8 && input_ptr->type != kTfLiteFloat32) {
+    if (e->input->type != kTfLiteInt8 && e->input->type != kTfLiteFloat32) {
         printf("[TFLM] AVISO: Input tipo inesperado! (esperado int8 ou float32, obtido %d)\n", 
-               input_ptr->type);
+               e->input->type);
         return 5;
     }
-    if (output_ptr->type != kTfLiteInt8 && output_ptr->type != kTfLiteFloat32) {
+    if (e->output->type != kTfLiteInt8 && e->output->type != kTfLiteFloat32) {
         printf("[TFLM] AVISO: Output tipo inesperado! (esperado int8 ou float32, obtido %d)\n", 
-               output_ptr->type);
+               e->output->type);
         return 6;
     }
 
+    e->stateful = model_has_state(e->model);
+    if (verbose && e->stateful) printf("[TFLM] Modelo com estado: cache de resultados desligado\n");
+    return 0;
+}
+
+// Inicialização do TFLM
+extern "C" int tflm_init(void) {
+    return tflm_init_ex(0);
+}
+
+extern "C" int tflm_init_ex(uint32_t flags) {
+    printf("[TFLM] Iniciando inicialização...\n");
+    engine_flags = flags;
+    for (int i = 0; i < 2; i++) {
+        engines[i].arena = engine_arenas[i];
+        engines[i].arena_bytes = kTensorArenaSize;
+    }
+    const int status = engine_setup(&engines[0], modelo_tflite, flags, true);
+    if (status != 0) {
+        engine_teardown(&engines[0]);
+        return status;
+    }
+    engines[0].model_len = modelo_tflite_len;
+    engines[0].model_crc32 = model_slot_crc32(0, modelo_tflite, modelo_tflite_len);
+    active = &engines[0];
+    cache_invalidate();
     printf("[TFLM] Inicialização concluída com sucesso!\n");
     return 0;
 }
 
-extern "C" int8_t* tflm_predict(float* input_data, float* output_data) {
-    if (!interpreter_ptr || !input_ptr || !output_ptr) {
-        printf("[TFLM] ERRO: Interpreter ou tensores não inicializados\n");
-        return nullptr;
+// ============================================================
+// CACHE DE RESULTADOS
+// Em repouso amostras seguidas costumam gerar o mesmo tensor de entrada. Antes
+// do Invoke os bytes da entrada são procurados em uma tabela de mapeamento
+// direto (TFLM_CACHE_ENTRIES posições, FNV-1a); num acerto os bytes de saída
+// guardados voltam para o tensor de saída e o interpreter não roda. Quem lê a
+// saída depois (argmax, confiança, desquantização) não percebe a diferença.
+//
+// TFLM_CACHE_EPSILON reusa a última saída calculada enquanto cada entrada
+// estiver a até epsilon (em unidades reais) da entrada que a gerou, por no
+// máximo max_reuse chamadas seguidas. Modelos com estado sempre passam direto.
+// ============================================================
+#ifndef TFLM_CACHE_ENTRIES
+#define TFLM_CACHE_ENTRIES 16
+#endif
+#define TFLM_CACHE_MAX_BYTES 32   // Entrada e saída maiores que isso: sem cache
+static_assert((TFLM_CACHE_ENTRIES & (TFLM_CACHE_ENTRIES - 1)) == 0, "TFLM_CACHE_ENTRIES deve ser potência de 2");
+
+struct CacheEntry {
+    bool valid;
+    uint8_t input[TFLM_CACHE_MAX_BYTES];
+    uint8_t output[TFLM_CACHE_MAX_BYTES];
+};
+
+static struct {
+    TflmCachePolicy policy = {TFLM_CACHE_EXACT, 0.0f, 0};
+    CacheEntry entries[TFLM_CACHE_ENTRIES];
+    CacheEntry last;            // Última saída calculada (modo epsilon)
+    uint32_t reuse_run;         // Reusos seguidos de `last`
+    TflmCacheStats stats;
+} cache;
+
+static void cache_invalidate(void) {
+    for (CacheEntry& e : cache.entries) e.valid = false;
+    cache.last.valid = false;
+    cache.reuse_run = 0;
+}
+
+static uint32_t fnv1a(const uint8_t* data, size_t len) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) h = (h ^ data[i]) * 16777619u;
+    return h;
+}
+
+// Todas as entradas a até epsilon das que geraram `last`?
+static bool within_epsilon(const TfLiteTensor* in, const uint8_t* last) {
+    const float eps = cache.policy.epsilon;
+    if (in->type == kTfLiteInt8) {
+        const int8_t* a = in->data.int8;
+        const int8_t* b = (const int8_t*)last;
+        for (size_t i = 0; i < in->bytes; i++) {
+            if (fabsf((float)(a[i] - b[i]) * in->params.scale) > eps) return false;
+        }
+        return true;
+    }
+    const float* a = in->data.f;
+    float b;
+    for (size_t i = 0; i < in->bytes / sizeof(float); i++) {
+        memcpy(&b, last + i * sizeof(float), sizeof(float));
+        if (fabsf(a[i] - b) > eps) return false;
     }
+    return true;
+}
 
-    // Preencher o tensor de entrada (suporta int8 e float32)
-    if (input_ptr->type == kTfLiteInt8) {
-        int8_t* input_int8 = input_ptr->data.int8;
-        for (size_t i = 0; i < input_ptr->bytes; i++) {
-            input_int8[i] = (int8_t)(input_data[i] / input_ptr->params.scale + input_ptr->params.zero_point);
+// Invoke com o cache na frente
+static TfLiteStatus cached_invoke(TflmEngine* e) {
+    const size_t in_bytes = e->input->bytes;
+    const size_t out_bytes = e->output->bytes;
+    if (cache.policy.mode == TFLM_CACHE_OFF || e->stateful || in_bytes > TFLM_CACHE_MAX_BYTES ||
+        out_bytes > TFLM_CACHE_MAX_BYTES) {
+        cache.stats.bypassed++;
+        LATENCY_BEGIN(lat_invoke);
+        const TfLiteStatus status = e->interpreter->Invoke();
+        LATENCY_END(LAT_INVOKE, lat_invoke);
+        return status;
+    }
+    const uint8_t* in = (const uint8_t*)e->input->data.raw;
+    uint8_t* out = (uint8_t*)e->output->data.raw;
+    cache.stats.lookups++;
+
+    CacheEntry* slot = nullptr;
+    if (cache.policy.mode == TFLM_CACHE_EPSILON) {
+        if (cache.last.valid && (cache.policy.max_reuse == 0 || cache.reuse_run < cache.policy.max_reuse) &&
+            within_epsilon(e->input, cache.last.input)) {
+            memcpy(out, cache.last.output, out_bytes);
+            cache.reuse_run++;
+            cache.stats.hits++;
+            return kTfLiteOk;
         }
-    } else if (input_ptr->type == kTfLiteFloat32) {
-        float* input_float = input_ptr->data.f;
-        for (size_t i = 0; i < input_ptr->bytes / sizeof(float); i++) {
-            input_float[i] = input_data[i];
+    } else {
+        slot = &cache.entries[fnv1a(in, in_bytes) & (TFLM_CACHE_ENTRIES - 1)];
+        if (slot->valid && memcmp(slot->input, in, in_bytes) == 0) {
+            memcpy(out, slot->output, out_bytes);
+            cache.stats.hits++;
+            return kTfLiteOk;
         }
     }
 
+    // A chave sai antes do Invoke: o planner pode reusar o buffer da entrada
+    // para ativações intermediárias
+    uint8_t key[TFLM_CACHE_MAX_BYTES];
+    memcpy(key, in, in_bytes);
+    LATENCY_BEGIN(lat_invoke);
+    const TfLiteStatus status = e->interpreter->Invoke();
+    cache.stats.invoke_us += LATENCY_END(LAT_INVOKE, lat_invoke);
+    cache.stats.misses++;
+    if (status != kTfLiteOk) return status;
+
+    if (slot && slot->valid) cache.stats.evictions++;
+    CacheEntry* fill = slot ? slot : &cache.last;
+    fill->valid = true;
+    memcpy(fill->input, key, in_bytes);
+    memcpy(fill->output, out, out_bytes);
+    cache.reuse_run = 0;
+    return kTfLiteOk;
+}
+
+extern "C" void tflm_cache_configure(const TflmCachePolicy* policy) {
+    cache.policy = *policy;
+    cache_invalidate();
+}
+
+extern "C" void tflm_cache_stats(TflmCacheStats* out) {
+    *out = cache.stats;
+    out->bypass = active && (active->stateful || cache.policy.mode == TFLM_CACHE_OFF);
+    // Economia estimada: cada acerto vale um Invoke médio dos que rodaram
+    out->saved_us = cache.stats.misses
+                        ? (uint64_t)cache.stats.hits * cache.stats.invoke_us / cache.stats.misses
+                        : 0;
+}
+
+extern "C" void tflm_cache_reset_stats(void) {
+    memset(&cache.stats, 0, sizeof(cache.stats));
+}
+
+extern "C" void tflm_core_stats(TflmCoreStats* out) {
+    TflmParallelStats st;
+    tflm_parallel_get_stats(&st);
+    memset(out, 0, sizeof(*out));
+    out->jobs = st.jobs;
+    out->inline_runs = st.inline_runs;
+    for (int i = 0; i < TFLM_PARALLEL_WORKERS; i++) {
+        out->chunks[i] = st.chunks[i];
+        out->busy_us[i] = st.busy_us[i];
+        out->idle_us[i] = st.idle_us[i];
+    }
+}
+
+extern "C" void tflm_core_reset_stats(void) {
+    tflm_parallel_reset_stats();
+}
+
+// Invoke + leitura da saída (comum aos dois caminhos de entrada). 0 se OK.
+static int invoke_and_read_outputs(float* output_data) {
     // Invocar o modelo
-    TfLiteStatus invoke_status = interpreter_ptr->Invoke();
+    TfLiteStatus invoke_status = cached_invoke(active);
     if (invoke_status != kTfLiteOk) {
         printf("[TFLM] ERRO: Invoke falhou (status=%d)\n", (int)invoke_status);
-        return nullptr;
+        return 3;
     }
 
     // Ler o tensor de saída (suporta int8 e float32)
-    if (output_ptr->type == kTfLiteInt8) {
-        int8_t* output_int8 = output_ptr->data.int8;
-        for (size_t i = 0; i < output_ptr->bytes; i++) {
-            output_data[i] = (output_int8[i] - output_ptr->params.zero_point) * output_ptr->params.scale;
+    if (active->output->type == kTfLiteInt8) {
+        int8_t* output_int8 = active->output->data.int8;
+        for (size_t i = 0; i < active->output->bytes; i++) {
+            output_data[i] = (output_int8[i] - active->output->params.zero_point) * active->output->params.scale;
         }
-    } else if (output_ptr->type == kTfLiteFloat32) {
-        float* output_float = output_ptr->data.f;
-        for (size_t i = 0; i < output_ptr->bytes / sizeof(float); i++) {
+    } else if (active->output->type == kTfLiteFloat32) {
+        float* output_float = active->output->data.f;
+        for (size_t i = 0; i < active->output->bytes / sizeof(float); i++) {
             output_data[i] = output_float[i];
         }
     }
+    return 0;
+}
+
+extern "C" int8_t* tflm_predict(float* input_data, float* output_data) {
+    if (!active) {
+        printf("[TFLM] ERRO: Interpreter ou tensores não inicializados\n");
+        return nullptr;
+    }
+
+    // Preencher o tensor de entrada (suporta int8 e float32)
+    if (active->input->type == kTfLiteInt8) {
+        // Arredonda e satura como o conversor do TFLite (o cast direto truncava e dava wrap)
+        int8_t* input_int8 = active->input->data.int8;
+        for (size_t i = 0; i < active->input->bytes; i++) {
+            long q = lroundf(input_data[i] / active->input->params.scale) + active->input->params.zero_point;
+            input_int8[i] = (int8_t)(q < -128 ? -128 : (q > 127 ? 127 : q));
+        }
+    } else if (active->input->type == kTfLiteFloat32) {
+        float* input_float = active->input->data.f;
+        for (size_t i = 0; i < active->input->bytes / sizeof(float); i++) {
+            input_float[i] = input_data[i];
+        }
+    }
 
+    invoke_and_read_outputs(output_data);
     return nullptr; // Retorna nullptr pois os dados já estão em output_data
 }
 
+extern "C" int tflm_predict_quantized(const int8_t* input_q, float* output_data) {
+    if (!active) {
+        printf("[TFLM] ERRO: Interpreter ou tensores não inicializados\n");
+        return 1;
+    }
+    if (active->input->type != kTfLiteInt8) {
+        return 2; // Modelo com entrada float: use tflm_predict
+    }
+
+    int8_t* input_int8 = active->input->data.int8;
+    for (size_t i = 0; i < active->input->bytes; i++) {
+        input_int8[i] = input_q[i];
+    }
+    return invoke_and_read_outputs(output_data);
+}
+
+static int element_count(const TfLiteTensor* t) {
+    return (int)(t->type == kTfLiteInt8 ? t->bytes : t->bytes / sizeof(float));
+}
+
+// Entrada em unidades reais -> tensor (int8 arredondado e saturado, ou float)
+static void fill_input(TfLiteTensor* t, const float* input_data, size_t count) {
+    if (t->type == kTfLiteInt8) {
+        int8_t* input_int8 = t->data.int8;
+        for (size_t i = 0; i < count; i++) {
+            long q = lroundf(input_data[i] / t->params.scale) + t->params.zero_point;
+            input_int8[i] = (int8_t)(q < -128 ? -128 : (q > 127 ? 127 : q));
+        }
+    } else {
+        memcpy(t->data.f, input_data, count * sizeof(float));
+    }
+}
+
+// Argmax direto na linha `row` do tensor de saída, sem desquantizar
+static void argmax_row(const TfLiteTensor* output, int row, int classes, TflmDecision* out) {
+    int best = 0;
+    if (output->type == kTfLiteInt8) {
+        const int8_t* q = output->data.int8 + row * classes;
+        for (int i = 1; i < classes; i++) {
+            if (q[i] > q[best]) best = i;
+        }
+        out->confidence_q = q[best];
+    } else {
+        const float* f = output->data.f + row * classes;
+        for (int i = 1; i < classes; i++) {
+            if (f[i] > f[best]) best = i;
+        }
+        out->confidence_q = 0;
+    }
+    out->class_index = best;
+}
+
+static int read_decision(TflmDecision* out) {
+    argmax_row(active->output, 0, element_count(active->output), out);
+    return 0;
+}
+
+extern "C" int tflm_classify(const float* input_data, TflmDecision* out) {
+    if (!active) {
+        printf("[TFLM] ERRO: Interpreter ou tensores não inicializados\n");
+        return 1;
+    }
+    fill_input(active->input, input_data, element_count(active->input));
+    if (cached_invoke(active) != kTfLiteOk) {
+        printf("[TFLM] ERRO: Invoke falhou\n");
+        return 3;
+    }
+    return read_decision(out);
+}
+
+extern "C" int tflm_classify_quantized(const int8_t* input_q, TflmDecision* out) {
+    if (!active) {
+        printf("[TFLM] ERRO: Interpreter ou tensores não inicializados\n");
+        return 1;
+    }
+    if (active->input->type != kTfLiteInt8) {
+        return 2; // Modelo com entrada float: use tflm_classify
+    }
+    memcpy(active->input->data.int8, input_q, active->input->bytes);
+    if (cached_invoke(active) != kTfLiteOk) {
+        printf("[TFLM] ERRO: Invoke falhou\n");
+        return 3;
+    }
+    return read_decision(out);
+}
+
+// Valor real do elemento i da saída (probabilidade, ou logit com softmax removido)
+static float output_value(int i) {
+    if (active->output->type == kTfLiteInt8) {
+        float scale = active->softmax_stripped ? active->logits_scale : active->output->params.scale;
+        int zero_point = active->softmax_stripped ? active->logits_zero_point : active->output->params.zero_point;
+        return (active->output->data.int8[i] - zero_point) * scale;
+    }
+    return active->output->data.f[i];
+}
+
+extern "C" float tflm_decision_confidence(const TflmDecision* d) {
+    if (!active) return 0.0f;
+    if (!active->softmax_stripped) {
+        return output_value(d->class_index);
+    }
+    // Softmax só da classe vencedora: 1 / sum(exp(l_i - l_max))
+    const int n = active->output->type == kTfLiteInt8 ? (int)active->output->bytes
+                                                  : (int)(active->output->bytes / sizeof(float));
+    const float best = output_value(d->class_index);
+    float sum = 0.0f;
+    for (int i = 0; i < n; i++) {
+        sum += expf(output_value(i) - best);
+    }
+    return 1.0f / sum;
+}
+
 extern "C" int8_t* tflm_input_ptr(int* nbytes) {
-    if (!input_ptr) return nullptr;
-    if (nbytes) *nbytes = input_ptr->bytes;
-    return input_ptr->data.int8;
+    if (!active) return nullptr;
+    if (nbytes) *nbytes = active->input->bytes;
+    return active->input->data.int8;
 }
 
 extern "C" int8_t* tflm_output_ptr(int* nbytes) {
-    if (!output_ptr) return nullptr;
-    if (nbytes) *nbytes = output_ptr->bytes;
-    return output_ptr->data.int8;
+    if (!active) return nullptr;
+    if (nbytes) *nbytes = active->output->bytes;
+    return active->output->data.int8;
+}
+
+extern "C" int tflm_input_count(void) {
+    if (!active) return 0;
+    return (int)(active->input->type == kTfLiteInt8 ? active->input->bytes : active->input->bytes / sizeof(float));
 }
 
 extern "C" float tflm_input_scale(void) {
-    return input_ptr ? input_ptr->params.scale : 0.0f;
+    return active ? active->input->params.scale : 0.0f;
 }
 extern "C" int tflm_input_zero_point(void) {
-    return input_ptr ? input_ptr->params.zero_point : 0;
+    return active ? active->input->params.zero_point : 0;
 }
 extern "C" float tflm_output_scale(void) {
-    return output_ptr ? output_ptr->params.scale : 0.0f;
+    return active ? active->output->params.scale : 0.0f;
 }
 extern "C" int tflm_output_zero_point(void) {
-    return output_ptr ? output_ptr->params.zero_point : 0;
+    return active ? active->output->params.zero_point : 0;
 }
 
 extern "C" int tflm_invoke(void) {
-    if (!interpreter_ptr) return 1;
-    return (interpreter_ptr->Invoke() == kTfLiteOk) ? 0 : 2;
+    if (!active) return 1;
+    return (cached_invoke(active) == kTfLiteOk) ? 0 : 2;
+}
+
+extern "C" uint32_t tflm_model_crc32(void) {
+    return active ? active->model_crc32 : 0;
 }
 
 extern "C" int tflm_arena_used_bytes(void) {
-    if (!interpreter_ptr) return -1;
-    return (int)interpreter_ptr->arena_used_bytes();
+    if (!active) return -1;
+    return (int)active->interpreter->arena_used_bytes();
+}
+
+// ============================================================
+// INFERÊNCIA EM LOTE (lib/fleet)
+// O TFLM não redimensiona tensores em execução. tflm_batch_init copia o
+// flatbuffer do modelo ativo para RAM, troca a primeira dimensão (1) das
+// ativações pelo tamanho do lote (até TFLM_BATCH_MAX, em geral o número de
+// canais) e monta a cópia em uma instância própria. Um
+// Invoke classifica então o lote inteiro: o custo fixo por chamada (percorrer
+// o grafo, despacho e checagens dos kernels) é pago uma vez e o
+// FULLY_CONNECTED percorre as linhas dentro do kernel. Cada linha é calculada
+// como no Invoke de uma linha só; o lote não passa pelo cache de resultados.
+//
+// Só operadores que tratam a primeira dimensão como lote independente são
+// aceitos (um RESHAPE, por exemplo, tem a forma fixa em um tensor constante).
+// ============================================================
+#ifndef TFLM_BATCH_MAX
+#define TFLM_BATCH_MAX 0   // Sem lote: a instância e as cópias não ocupam RAM
+#endif
+#ifndef TFLM_BATCH_ARENA_SIZE
+#define TFLM_BATCH_ARENA_SIZE (kTensorArenaSize + TFLM_BATCH_MAX * 128)
+#endif
+#ifndef TFLM_BATCH_MODEL_BYTES
+#define TFLM_BATCH_MODEL_BYTES (2 * MODELO_ARENA_MODEL_LEN)
+#endif
+
+#if TFLM_BATCH_MAX > 0
+static struct {
+    TflmEngine engine;
+    bool ready;
+    int rows;                   // Linhas por Invoke
+    uint32_t source_crc32;      // Modelo ativo de onde a cópia saiu
+    alignas(16) uint8_t model[TFLM_BATCH_MODEL_BYTES];
+    alignas(16) uint8_t arena[TFLM_BATCH_ARENA_SIZE];
+} batch;
+
+static bool batch_safe_op(tflite::BuiltinOperator op) {
+    switch (op) {
+        case tflite::BuiltinOperator_FULLY_CONNECTED:
+        case tflite::BuiltinOperator_SOFTMAX:
+        case tflite::BuiltinOperator_QUANTIZE:
+        case tflite::BuiltinOperator_DEQUANTIZE:
+        case tflite::BuiltinOperator_ADD:
+        case tflite::BuiltinOperator_MUL:
+        case tflite::BuiltinOperator_CONV_2D:
+        case tflite::BuiltinOperator_MAX_POOL_2D:
+        case tflite::BuiltinOperator_AVERAGE_POOL_2D:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Lote na primeira dimensão de todo tensor não constante que começa em 1.
+// O flatbuffer está em RAM: o vetor de shape é alterado no lugar.
+static bool batch_resize(const tflite::Model* model, int rows) {
+    if (model->subgraphs()->size() != 1) return false;
+    for (uint32_t i = 0; i < model->operator_codes()->size(); i++) {
+        if (!batch_safe_op(tflite::GetBuiltinCode(model->operator_codes()->Get(i)))) return false;
+    }
+    const auto* tensors = model->subgraphs()->Get(0)->tensors();
+    for (uint32_t i = 0; i < tensors->size(); i++) {
+        const tflite::Tensor* t = tensors->Get(i);
+        const tflite::Buffer* buf = model->buffers()->Get(t->buffer());
+        if ((buf && buf->data() && buf->data()->size() > 0) || t->is_variable()) continue;
+        if (!t->shape() || t->shape()->size() == 0 || t->shape()->Get(0) != 1) continue;
+        const_cast<flatbuffers::Vector<int32_t>*>(t->shape())->Mutate(0, rows);
+    }
+    return true;
+}
+
+extern "C" int tflm_batch_init(int rows) {
+    batch.ready = false;
+    engine_teardown(&batch.engine);
+    if (!active || rows < 1 || rows > TFLM_BATCH_MAX) return 1;
+    if (active->model_len > sizeof(batch.model)) {
+        printf("[TFLM] Lote: modelo de %lu bytes não cabe na cópia (TFLM_BATCH_MODEL_BYTES)\n",
+               (unsigned long)active->model_len);
+        return 2;
+    }
+    memcpy(batch.model, active->model_data, active->model_len);
+    if (!batch_resize(tflite::GetModel(batch.model), rows)) {
+        printf("[TFLM] Lote: o modelo tem operador que mistura linhas\n");
+        return 3;
+    }
+    TflmEngine* e = &batch.engine;
+    e->arena = batch.arena;
+    e->arena_bytes = sizeof(batch.arena);
+    if (engine_setup(e, batch.model, engine_flags, false) != 0) {
+        engine_teardown(e);
+        return 4;
+    }
+    if (e->input->type != active->input->type ||
+        element_count(e->input) != rows * element_count(active->input) ||
+        element_count(e->output) != rows * element_count(active->output)) {
+        printf("[TFLM] Lote: entradas/saídas não escalaram com o lote\n");
+        engine_teardown(e);
+        return 5;
+    }
+    e->model_len = active->model_len;
+    e->model_crc32 = active->model_crc32;
+    batch.rows = rows;
+    batch.source_crc32 = active->model_crc32;
+    batch.ready = true;
+    printf("[TFLM] Lote de %d linhas: arena %d de %d bytes\n", rows,
+           (int)e->interpreter->arena_used_bytes(), e->arena_bytes);
+    return 0;
+}
+
+extern "C" int tflm_batch_capacity(void) {
+    return batch.ready ? batch.rows : 0;
+}
+
+extern "C" int tflm_classify_batch(const float* inputs, int rows, TflmDecision* out) {
+    if (!active) return 1;
+    // Depois de uma troca a cópia é do modelo anterior
+    if (!batch.ready) return 2;
+    if (batch.source_crc32 != active->model_crc32 && tflm_batch_init(batch.rows) != 0) return 2;
+    TflmEngine* e = &batch.engine;
+    const int capacity = batch.rows;
+    const int features = element_count(active->input);
+    const int classes = element_count(active->output);
+    for (int first = 0; first < rows; first += capacity) {
+        const int n = rows - first < capacity ? rows - first : capacity;
+        fill_input(e->input, inputs + (size_t)first * features, (size_t)n * features);
+        if (n < capacity) {
+            // Linhas sobrando: entrada zero, resultado descartado
+            const size_t row_bytes = e->input->bytes / capacity;
+            memset((uint8_t*)e->input->data.raw + n * row_bytes, 0, (capacity - n) * row_bytes);
+        }
+        if (e->interpreter->Invoke() != kTfLiteOk) {
+            printf("[TFLM] ERRO: Invoke do lote falhou\n");
+            return 3;
+        }
+        for (int r = 0; r < n; r++) argmax_row(e->output, r, classes, &out[first + r]);
+    }
+    return 0;
+}
+
+extern "C" int tflm_batch_arena_used_bytes(void) {
+    return batch.ready ? (int)batch.engine.interpreter->arena_used_bytes() : -1;
+}
+#else
+extern "C" int tflm_batch_init(int rows) {
+    (void)rows;
+    return 1;
+}
+extern "C" int tflm_batch_capacity(void) { return 0; }
+extern "C" int tflm_classify_batch(const float* inputs, int rows, TflmDecision* out) {
+    (void)inputs; (void)rows; (void)out;
+    return 1;
+}
+extern "C" int tflm_batch_arena_used_bytes(void) { return -1; }
+#endif
+
+// ============================================================
+// TROCA DE MODELO EM EXECUÇÃO
+// tflm_swap_begin só confere o cabeçalho. tflm_swap_service faz um passo por
+// chamada (CRC em blocos de TFLM_SWAP_CRC_CHUNK, depois verificação do
+// flatbuffer + AllocateTensors na instância reserva), então o loop continua
+// amostrando enquanto o próximo modelo é preparado. tflm_swap_commit só troca
+// o ponteiro da instância ativa: a inferência seguinte já usa o modelo novo.
+// ============================================================
+#ifndef TFLM_SWAP_CRC_CHUNK
+#define TFLM_SWAP_CRC_CHUNK 4096u
+#endif
+
+static struct {
+    TflmSwapState state;
+    const uint8_t* image;
+    ModelSlotHeader header;
+    uint32_t checked;           // Bytes do modelo já no CRC
+    uint32_t crc;
+    TflmSwapStats stats;
+} swap;
+
+static TflmEngine* standby_engine(void) {
+    return active == &engines[0] ? &engines[1] : &engines[0];
+}
+
+static TflmSwapState swap_fail(const char* reason) {
+    printf("[TFLM] Troca recusada: %s\n", reason);
+    engine_teardown(standby_engine());
+    swap.stats.rejected++;
+    swap.stats.last_error = reason;
+    swap.state = TFLM_SWAP_FAILED;
+    return swap.state;
+}
+
+extern "C" int tflm_swap_begin(const uint8_t* image, uint32_t image_len) {
+    if (!active) return 1;
+    if (swap.state == TFLM_SWAP_CHECKING || swap.state == TFLM_SWAP_PREPARING ||
+        swap.state == TFLM_SWAP_READY) {
+        return 2; // Já existe uma troca em andamento
+    }
+    const ModelSlotStatus status =
+        model_slot_check_header(image, image_len, TFLM_MODEL_SCHEMA_VERSION, &swap.header);
+    if (status != MODEL_SLOT_OK) {
+        swap_fail(model_slot_status_name(status));
+        return 3;
+    }
+    if (swap.header.arena_bytes > (uint32_t)kTensorArenaSize) {
+        swap_fail("arena medida maior que TFLM_ARENA_SIZE");
+        return 4;
+    }
+    swap.image = image;
+    swap.checked = 0;
+    swap.crc = 0;
+    swap.stats.prepare_us = 0;
+    swap.stats.max_step_us = 0;
+    swap.stats.service_calls = 0;
+    swap.stats.last_error = nullptr;
+    swap.state = TFLM_SWAP_CHECKING;
+    return 0;
+}
+
+static TflmSwapState swap_step(void) {
+    const uint8_t* model_data = swap.image + MODEL_SLOT_HEADER_BYTES;
+    if (swap.state == TFLM_SWAP_CHECKING) {
+        uint32_t n = swap.header.model_bytes - swap.checked;
+        if (n > TFLM_SWAP_CRC_CHUNK) n = TFLM_SWAP_CRC_CHUNK;
+        swap.crc = model_slot_crc32(swap.crc, model_data + swap.checked, n);
+        swap.checked += n;
+        if (swap.checked < swap.header.model_bytes) return swap.state;
+        if (swap.crc != swap.header.model_crc32) {
+            return swap_fail(model_slot_status_name(MODEL_SLOT_BAD_CRC));
+        }
+        swap.state = TFLM_SWAP_PREPARING;
+        return swap.state;
+    }
+
+    // PREPARING: estrutura do flatbuffer, alocação e compatibilidade com o ativo
+    flatbuffers::Verifier verifier(model_data, swap.header.model_bytes);
+    if (!tflite::VerifyModelBuffer(verifier)) return swap_fail("flatbuffer inválido");
+    TflmEngine* e = standby_engine();
+    if (engine_setup(e, model_data, engine_flags, false) != 0) {
+        return swap_fail("modelo não aloca na arena");
+    }
+    e->model_len = swap.header.model_bytes;
+    e->model_crc32 = swap.crc;
+    if (e->input->type != active->input->type ||
+        element_count(e->input) != element_count(active->input) ||
+        element_count(e->output) != element_count(active->output)) {
+        return swap_fail("entradas/saídas diferentes do modelo ativo");
+    }
+    if (e->input->type == kTfLiteInt8 && !(e->input->params.scale > 0.0f)) {
+        return swap_fail("quantização de entrada inválida");
+    }
+    const int peak = (int)(active->interpreter->arena_used_bytes() + e->interpreter->arena_used_bytes());
+    if (peak > swap.stats.peak_arena_bytes) swap.stats.peak_arena_bytes = peak;
+    swap.state = TFLM_SWAP_READY;
+    return swap.state;
+}
+
+extern "C" TflmSwapState tflm_swap_service(void) {
+    if (swap.state != TFLM_SWAP_CHECKING && swap.state != TFLM_SWAP_PREPARING) return swap.state;
+    const uint32_t t0 = time_us_32();
+    const TflmSwapState state = swap_step();
+    const uint32_t dt = time_us_32() - t0;
+    swap.stats.prepare_us += dt;
+    if (dt > swap.stats.max_step_us) swap.stats.max_step_us = dt;
+    swap.stats.service_calls++;
+    return state;
+}
+
+extern "C" int tflm_swap_commit(void) {
+    if (swap.state != TFLM_SWAP_READY) return 1;
+    const uint32_t t0 = time_us_32();
+    TflmEngine* old = active;
+    active = standby_engine();
+    cache_invalidate();
+    model_epoch.store(model_epoch.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    engine_teardown(old);
+    swap.stats.commit_us = time_us_32() - t0;
+    swap.stats.swaps++;
+    swap.state = TFLM_SWAP_IDLE;
+    return 0;
+}
+
+extern "C" void tflm_swap_cancel(void) {
+    if (swap.state == TFLM_SWAP_IDLE) return;
+    if (swap.state != TFLM_SWAP_FAILED) engine_teardown(standby_engine());
+    swap.state = TFLM_SWAP_IDLE;
+}
+
+extern "C" uint32_t tflm_model_epoch(void) {
+    return model_epoch.load(std::memory_order_acquire);
+}
+
+extern "C" void tflm_swap_stats(TflmSwapStats* out) {
+    *out = swap.stats;
+    out->state = swap.state;
+    out->arena_capacity_bytes = kTensorArenaSize;
+    out->active_arena_bytes = active ? (int)active->interpreter->arena_used_bytes() : 0;
 }
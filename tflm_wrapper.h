@@ -1,4 +1,5 @@
 #pragma once
+#include <stdbool.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -8,6 +9,17 @@ extern "C" {
 // Retorna 0 se OK, !=0 se erro
 int  tflm_init(void);
 
+// Flags de tflm_init_ex
+#define TFLM_STRIP_SOFTMAX (1u << 0)  // Troca o SOFTMAX final por cópia dos logits
+#define TFLM_SINGLE_CORE_KERNELS (1u << 1)  // Nenhum kernel usa o core 1
+
+// Igual a tflm_init, com opções. Com TFLM_STRIP_SOFTMAX o softmax final (se for
+// o único do modelo) não roda no Invoke; o argmax não muda. Sem
+// TFLM_SINGLE_CORE_KERNELS, cada nó decide no Prepare se divide o kernel entre
+// os cores: só os de TFLM_PARALLEL_MIN_MACS multiplicações ou mais (definição
+// de compilação do pico-tflmicro).
+int  tflm_init_ex(uint32_t flags);
+
 // Ponteiro para o buffer de entrada (INT8) e quantidade de bytes
 int8_t*  tflm_input_ptr(int* nbytes);
 
@@ -16,6 +28,27 @@ int8_t*  tflm_output_ptr(int* nbytes);
 
 int8_t* tflm_predict(float* input_data, float* output_data);
 
+// Inferência com a entrada já quantizada (ver lib/preproc). Só para modelos
+// com entrada int8; retorna 0 se OK, !=0 se erro ou se a entrada for float.
+int tflm_predict_quantized(const int8_t* input_q, float* output_data);
+
+// Decisão direto do tensor de saída: argmax sem desquantizar nem softmax
+typedef struct {
+    int    class_index;   // Classe vencedora
+    int8_t confidence_q;  // Saída int8 da classe vencedora (0 em modelos com saída float)
+} TflmDecision;
+
+// Retornam 0 se OK, !=0 se erro
+int tflm_classify(const float* input_data, TflmDecision* out);
+int tflm_classify_quantized(const int8_t* input_q, TflmDecision* out);
+
+// Probabilidade da classe vencedora em float, calculada só quando pedida
+// (telemetria). Com o softmax removido, aplica o softmax só sobre os logits.
+float tflm_decision_confidence(const TflmDecision* d);
+
+// Número de features de entrada do modelo (elementos do tensor de entrada)
+int   tflm_input_count(void);
+
 // Quantização (scale e zero_point) de input/output
 float tflm_input_scale(void);
 int   tflm_input_zero_point(void);
@@ -28,6 +61,105 @@ int  tflm_invoke(void);
 // Diagnóstico
 int  tflm_arena_used_bytes(void);
 
+// CRC-32 (model_slot_crc32) do flatbuffer do modelo ativo: liga ao modelo o
+// que foi gerado no host para ele (ex.: regiões do lib/gate)
+uint32_t tflm_model_crc32(void);
+
+// Cache de resultados na frente do Invoke (todas as funções de inferência)
+typedef enum {
+    TFLM_CACHE_OFF = 0,
+    TFLM_CACHE_EXACT,       // Mesmos bytes de entrada -> mesma saída (padrão)
+    TFLM_CACHE_EPSILON,     // Reusa a última saída se a entrada mudou até epsilon
+} TflmCacheMode;
+
+typedef struct {
+    TflmCacheMode mode;
+    float epsilon;          // TFLM_CACHE_EPSILON: tolerância por entrada, em unidades reais
+    uint32_t max_reuse;     // TFLM_CACHE_EPSILON: reusos seguidos antes de um Invoke (0 = sem limite)
+} TflmCachePolicy;
+
+typedef struct {
+    uint32_t lookups;       // Chamadas que consultaram o cache
+    uint32_t hits;          // Invokes evitados
+    uint32_t misses;        // Invokes executados pelo cache
+    uint32_t evictions;     // Posições sobrescritas por outra entrada
+    uint32_t bypassed;      // Chamadas sem cache (desligado, modelo com estado ou tensores grandes)
+    uint64_t invoke_us;     // Tempo dos Invokes executados
+    uint64_t saved_us;      // Estimativa: acertos x Invoke médio
+    bool bypass;            // Modelo ativo sempre passa direto (estado ou cache desligado)
+} TflmCacheStats;
+
+// Troca a política e esvazia o cache
+void tflm_cache_configure(const TflmCachePolicy* policy);
+void tflm_cache_stats(TflmCacheStats* out);
+void tflm_cache_reset_stats(void);
+
+// Inferência em lote (lib/fleet): o modelo ativo com a dimensão de lote
+// trocada para `rows` linhas, até TFLM_BATCH_MAX (definição de compilação;
+// 0 = sem lote). 0 se OK; !=0 sem lote, se um operador mistura linhas ou se
+// não coube na arena do lote (TFLM_BATCH_ARENA_SIZE).
+int tflm_batch_init(int rows);
+// Linhas por Invoke (0 se o lote não está montado)
+int tflm_batch_capacity(void);
+// Classifica `rows` entradas (rows x tflm_input_count floats, em sequência)
+// em Invokes de tflm_batch_capacity linhas; mesma decisão de tflm_classify
+// linha a linha. Depois de uma troca de modelo o lote é remontado. 0 se OK.
+int tflm_classify_batch(const float* inputs, int rows, TflmDecision* out);
+int tflm_batch_arena_used_bytes(void);
+
+// Kernels divididos entre os dois cores (pico-tflmicro parallel_for). O core 1
+// fica zerado quando o pico-tflmicro é compilado para um core só.
+typedef struct {
+    uint32_t jobs;          // Chamadas divididas entre os cores
+    uint32_t inline_runs;   // Chamadas que rodaram só no core que chamou
+    uint32_t chunks[2];     // Blocos de linhas pegos por core
+    uint64_t busy_us[2];    // Tempo rodando blocos, por core
+    uint64_t idle_us[2];    // Tempo esperando o outro core no fim de cada chamada
+} TflmCoreStats;
+
+void tflm_core_stats(TflmCoreStats* out);
+void tflm_core_reset_stats(void);
+
+// Versão do schema TFLite aceita nas imagens de slot (TFLITE_SCHEMA_VERSION)
+#define TFLM_MODEL_SCHEMA_VERSION 3u
+
+// Troca do modelo em execução a partir de uma imagem de slot (lib/model_slot).
+// O modelo novo é preparado em uma segunda instância enquanto o ativo continua
+// respondendo; precisa ter o mesmo tipo e número de entradas e saídas.
+typedef enum {
+    TFLM_SWAP_IDLE = 0,
+    TFLM_SWAP_CHECKING,     // CRC do modelo, em blocos
+    TFLM_SWAP_PREPARING,    // Flatbuffer + AllocateTensors na instância reserva
+    TFLM_SWAP_READY,        // Pronto: tflm_swap_commit entre duas inferências
+    TFLM_SWAP_FAILED,       // Recusado; o modelo ativo não mudou
+} TflmSwapState;
+
+typedef struct {
+    TflmSwapState state;
+    uint32_t swaps;             // Trocas concluídas
+    uint32_t rejected;          // Imagens recusadas
+    const char* last_error;     // Motivo da última recusa (NULL se nenhuma)
+    uint32_t service_calls;     // Passos da última preparação
+    uint32_t prepare_us;        // CPU gasta na última preparação (soma dos passos)
+    uint32_t max_step_us;       // Passo mais longo: atraso máximo imposto ao loop
+    uint32_t commit_us;         // Duração da última troca
+    int arena_capacity_bytes;   // Arena de cada instância
+    int active_arena_bytes;
+    int peak_arena_bytes;       // Maior soma das duas arenas em uso durante uma troca
+} TflmSwapStats;
+
+// 0 se o cabeçalho foi aceito e a preparação começou
+int tflm_swap_begin(const uint8_t* image, uint32_t image_len);
+// Um passo da preparação; chame entre inferências até READY ou FAILED
+TflmSwapState tflm_swap_service(void);
+// Troca a instância ativa; 0 se trocou
+int tflm_swap_commit(void);
+// Descarta a preparação em curso (ou limpa o estado FAILED)
+void tflm_swap_cancel(void);
+// Número de trocas já feitas; muda quando a quantização de entrada pode ter mudado
+uint32_t tflm_model_epoch(void);
+void tflm_swap_stats(TflmSwapStats* out);
+
 #ifdef __cplusplus
 }
 #endif